@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "print.h"
 #include "debug.h"
 #include "timer.h"
+#include "perf.h"
 #include "matrix.h"
 #include "led.h"
 #include "host.h"
@@ -145,13 +146,9 @@ uint8_t matrix_scan(void) {
         matrix_is_mod = false;
     }
 
-    uint16_t timer;
-    timer = timer_read();
+    PERF_START(host);
     usb_host.Task();
-    timer = timer_elapsed(timer);
-    if (timer > 100) {
-        dprintf("host.Task: %d\n", timer);
-    }
+    PERF_STOP(host, perfUsbHost);
 
     static uint8_t usb_state = 0;
     if (usb_state != usb_host.getUsbTaskState()) {
@@ -1,10 +1,15 @@
 
 #include "animation.h"
 #include "animation_utils.h"
+#include "animation_arena.h"
 #include "timer.h"
+#include "perf.h"
+#include "trace.h"
 #include "../../utils.h"
 #include "../eeconfig_backlight.h"
 #include "../key_led_map.h"
+#include "../led_health.h"
+#include "../../virt_ser_stream.h"
 #include "breathing.h"
 #include "sweep.h"
 #include "type_o_circles.h"
@@ -36,20 +41,27 @@
 #define HSV_COLOR_STEP 8
 #define MINIMAL_DELAY_TIME_MS 10
 #define ANIMATION_SUSPEND_TIMEOUT (10L * 60L * 1000L)
+// periods of delay_in_ms one frame may catch up with, a longer stall is skipped
+#ifndef ANIMATION_MAX_FRAME_STEPS
+#define ANIMATION_MAX_FRAME_STEPS 8
+#endif
+#define ANIMATION_STATS_WINDOW_MS 1000
+// key rows drawn per call of animate() by sliced animations
+#ifndef ANIMATION_SLICE_ROWS
+#define ANIMATION_SLICE_ROWS 2
+#endif
+// trace argument of a slice of a frame in progress, ored with its first row
+#define ANIMATION_TRACE_SLICE 0x8000
 
 static animation_names current_animation = animation_type_o_matic;
 static uint32_t last_key_pressed_timestamp = 0;
 static bool suspend_animation_on_idle = true;
+// next key row of a sliced frame, MATRIX_ROWS: no frame in progress
+static uint8_t slice_row = MATRIX_ROWS;
 
-#ifdef DEBUG_ANIMATION
-//#define DEBUG_ANIMATION_SPEED
-#endif
-
-#ifdef DEBUG_ANIMATION_SPEED
-static uint32_t duration_ms = 0;
-static uint32_t elapsed_ms = 0;
-static uint8_t loop_count = 10;
-#endif
+static animation_stats stats[animation_LAST];
+static uint16_t stats_window_timer;
+static uint8_t stats_window_frames;
 
 const char animation_name_string_cycle_all[] PROGMEM = "cycle all";
 const char animation_name_string_cycle_up_down[] PROGMEM = "cycle up down";
@@ -100,6 +112,7 @@ PGM_P animation_name_strings[animation_LAST] = {animation_name_string_cycle_all,
 void initialize_animation(void)
 {
     initLedPosByMatrix();
+    animation_init_key_pwm_lookup();
 
     memset(&animation, 0, sizeof(struct _animation_interface));
 
@@ -137,6 +150,8 @@ animation_names animation_current(void)
 void set_animation(animation_names animation_by_name)
 {
     current_animation = animation_by_name;
+    animation.animationRow = 0;
+    animation.animation_key_event = 0;
 
     if (current_animation >= animation_LAST)
     {
@@ -233,21 +248,31 @@ void animation_previous()
     start_animation();
 }
 
+// the hardware breathing has no animation loop, its engines get the new timing
+static void speed_changed(void)
+{
+    if (animation.is_running && current_animation == animation_breathing)
+        breathing_animation_update_speed();
+}
+
 void animation_set_speed(uint16_t delay_in_ms)
 {
     if (delay_in_ms < MINIMAL_DELAY_TIME_MS)
-        animation.delay_in_ms = MINIMAL_DELAY_TIME_MS;
+        delay_in_ms = MINIMAL_DELAY_TIME_MS;
     animation.delay_in_ms = delay_in_ms;
+    speed_changed();
 }
 
 void animation_increase_speed(void)
 {
     animation.delay_in_ms = decrement16(animation.delay_in_ms, 25, MINIMAL_DELAY_TIME_MS, 1000);
+    speed_changed();
 }
 
 void animation_decrease_speed(void)
 {
     animation.delay_in_ms = increment16(animation.delay_in_ms, 25, MINIMAL_DELAY_TIME_MS, 1000);
+    speed_changed();
 }
 
 void toggle_animation(void)
@@ -276,14 +301,32 @@ void start_animation()
     if (animation.is_running || animation.is_suspended)
         return;
 
+    // a stream from the host has the arena, the animation takes it back
+    virtser_stream_stop();
+
     if (animation.animationStart)
         animation.animationStart();
 
+    // every animation starts with animation_prepare(), without room in the arena it does not run
+    if (!animation_is_prepared())
+    {
+        dprintf("start_animation: not prepared\n");
+        // an allocation before the one that failed would stay, nothing stops this animation
+        animation_arena_reset();
+        return;
+    }
+
     animation.is_running = true;
     animation.is_suspended = false;
     animation.loop_timer = timer_read();
     animation.duration_timer = timer_read32();
     last_key_pressed_timestamp = timer_read32();
+
+    stats_window_timer = timer_read();
+    stats_window_frames = 0;
+
+    // keys pressed before the start are not news to the animation
+    led_matrix_event_clear();
 }
 
 void set_and_start_animation(animation_names animation_by_name)
@@ -303,12 +346,17 @@ void stop_animation()
     if (animation.animationStop)
         animation.animationStop();
 
+    animation_arena_reset();
+
     animation.is_running = false;
     animation.is_suspended = false;
     animation.animationStart = 0;
     animation.animationStop = 0;
     animation.animationLoop = 0;
     animation.animation_typematrix_row = 0;
+    animation.animationRow = 0;
+    animation.animation_key_event = 0;
+    slice_row = MATRIX_ROWS;
 }
 
 void suspend_animation()
@@ -331,8 +379,13 @@ void resume_animation()
 
     animation.is_running = true;
     animation.is_suspended = false;
+    // the suspended time is not made up for
+    animation.loop_timer = timer_read();
 
     last_key_pressed_timestamp = timer_read32();
+
+    // keys pressed while suspended are not news to the animation
+    led_matrix_event_clear();
 }
 
 void resume_animation_in_idle_state()
@@ -344,8 +397,11 @@ void resume_animation_in_idle_state()
 
     animation.is_running = true;
     animation.is_suspended = false;
+    animation.loop_timer = timer_read();
 
     last_key_pressed_timestamp -= ANIMATION_SUSPEND_TIMEOUT;
+
+    led_matrix_event_clear();
 }
 
 void animation_decrease_hsv_color(animation_hsv_names hsv_name, HSVColorName color_name)
@@ -376,16 +432,108 @@ void animation_increase_hsv_color(animation_hsv_names hsv_name, HSVColorName col
     }
 }
 
+static void animate_slice(void)
+{
+    for (uint8_t n = 0; n < ANIMATION_SLICE_ROWS && slice_row < MATRIX_ROWS; ++n, ++slice_row)
+    {
+        animation.animationRow(slice_row);
+        animation_upload_after_row(slice_row);
+    }
+}
+
+animation_stats animation_get_stats(animation_names animation_by_name)
+{
+    animation_stats none = {0, 0};
+
+    if (animation_by_name >= animation_LAST)
+        return none;
+    return stats[animation_by_name];
+}
+
+/*
+ * Frames are scheduled on a fixed grid of delay_in_ms. A late frame is not queued, the next
+ * frame covers all periods since the last one (frame_steps) and the skipped ones are counted.
+ */
+static void schedule_frame(uint16_t elapsed)
+{
+    uint16_t delay = animation.delay_in_ms ? animation.delay_in_ms : 1;
+    uint16_t steps = elapsed / delay;
+    animation_stats *current = &stats[current_animation];
+
+    if (steps == 0)
+        steps = 1;
+
+    if (steps > ANIMATION_MAX_FRAME_STEPS)
+    {
+        // a stall, continue from now instead of racing through the lost time
+        animation.loop_timer = timer_read();
+        elapsed = ANIMATION_MAX_FRAME_STEPS * delay;
+        steps = ANIMATION_MAX_FRAME_STEPS;
+    }
+    else
+    {
+        // keeps the remainder, the grid does not drift
+        animation.loop_timer += steps * delay;
+    }
+
+    animation.elapsed_in_ms = elapsed;
+    animation.frame_steps = steps;
+
+    if (current->dropped < 0xFFFF - steps)
+        current->dropped += steps - 1;
+    else
+        current->dropped = 0xFFFF;
+
+    stats_window_frames++;
+    uint16_t window = timer_elapsed(stats_window_timer);
+    if (window >= ANIMATION_STATS_WINDOW_MS)
+    {
+        current->fps = (uint32_t)stats_window_frames * 1000 / window;
+        stats_window_frames = 0;
+        stats_window_timer = timer_read();
+    }
+}
+
+static void dispatch_key_events(void)
+{
+    led_matrix_key_event event;
+
+    while (led_matrix_event_pop(&event))
+    {
+        if (animation.animation_key_event)
+            animation.animation_key_event(&event);
+    }
+}
+
 void animate()
 {
     if (!animation.is_running || animation.animationLoop == 0)
         return;
 
-    if (timer_elapsed(animation.loop_timer) < animation.delay_in_ms)
+    if (led_health_is_scanning())
+        return;
+
+    dispatch_key_events();
+
+    // finish the frame in progress first
+    if (slice_row < MATRIX_ROWS)
+    {
+        TRACE_BEGIN(traceAnimate, ANIMATION_TRACE_SLICE | slice_row);
+        animate_slice();
+        TRACE_END(traceAnimate, 0);
+        return;
+    }
+
+    uint16_t elapsed = timer_elapsed(animation.loop_timer);
+    if (elapsed < animation.delay_in_ms)
         return;
 
     if (suspend_animation_on_idle && timer_elapsed32(last_key_pressed_timestamp) > ANIMATION_SUSPEND_TIMEOUT)
+    {
+        // idle frames are neither drawn nor dropped
+        animation.loop_timer = timer_read();
         return;
+    }
 
 /*
 if (animation.duration_in_ms > 0 && timer_elapsed32(animation.duration_timer) > animation.duration_in_ms)
@@ -395,35 +543,28 @@ if (animation.duration_in_ms > 0 && timer_elapsed32(animation.duration_timer) >
 }
 */
 
-#ifdef DEBUG_ANIMATION_SPEED
-    if (loop_count)
-    {
-        loop_count--;
-        elapsed_ms = timer_read32();
-    }
-    else
+    PERF_START(animate);
+    TRACE_BEGIN(traceAnimate, current_animation);
+    schedule_frame(elapsed);
+    animation.animationLoop();
+
+    if (animation.animationRow)
     {
-        loop_count = 10;
-        duration_ms /= 10;
-        dprintf("avg: %lu\n", duration_ms);
-        duration_ms = 0;
-        elapsed_ms = timer_read32();
+        slice_row = 0;
+        animate_slice();
     }
-#endif
 
-    animation.loop_timer = timer_read();
-    animation.animationLoop();
-
-#ifdef DEBUG_ANIMATION_SPEED
-    duration_ms += timer_elapsed32(elapsed_ms);
-// dprintf("el: %u\n", duration_ms);
-#endif
+    TRACE_END(traceAnimate, 0);
+    PERF_STOP(animate, perfAnimate);
 }
 
 void animation_typematrix_row(uint8_t row_number, matrix_row_t row)
 {
     last_key_pressed_timestamp = timer_read32();
 
+    // keeps track of the row state even if no animation is running
+    led_matrix_event_row(LED_MATRIX_EVENT_SOURCE_LOCAL, row_number, row, timer_read());
+
     if (!animation.is_running)
         return;
 
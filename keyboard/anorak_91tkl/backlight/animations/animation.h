@@ -49,6 +49,15 @@ enum animation_hsv_names_t
 
 typedef enum animation_hsv_names_t animation_hsv_names;
 
+// frame telemetry of an animation
+typedef struct
+{
+    // rendered frames in the last second it ran
+    uint8_t fps;
+    // frames skipped because a frame or the main loop took too long, saturates
+    uint16_t dropped;
+} animation_stats;
+
 void initialize_animation(void);
 void animation_save_state(void);
 
@@ -78,6 +87,7 @@ void animation_decrease_speed(void);
 bool animation_is_running(void);
 
 animation_names animation_current(void);
+animation_stats animation_get_stats(animation_names animation_by_name);
 
 void animation_decrease_hsv_color(animation_hsv_names hsv_name, HSVColorName color_name);
 void animation_increase_hsv_color(animation_hsv_names hsv_name, HSVColorName color_name);
@@ -0,0 +1,53 @@
+
+#include "animation_arena.h"
+#include <string.h>
+
+#ifdef DEBUG_ANIMATION
+#include "debug.h"
+#else
+#include "nodebug.h"
+#endif
+
+static uint8_t arena[ANIMATION_ARENA_SIZE];
+static uint16_t arena_used = 0;
+static uint16_t arena_peak = 0;
+
+void *animation_arena_alloc(uint16_t size)
+{
+    if (size > ANIMATION_ARENA_SIZE - arena_used)
+    {
+        dprintf("ani: arena full, %u + %u\n", arena_used, size);
+        return 0;
+    }
+
+    // first allocation of a new animation
+    if (arena_used == 0)
+        arena_peak = 0;
+
+    void *memory = arena + arena_used;
+    memset(memory, 0, size);
+
+    arena_used += size;
+    if (arena_used > arena_peak)
+        arena_peak = arena_used;
+
+    return memory;
+}
+
+void animation_arena_reset(void)
+{
+    dprintf("ani: arena peak %u of %u\n", arena_peak, ANIMATION_ARENA_SIZE);
+
+    // keep the peak of the last animation for reporting, the next start begins a new one
+    arena_used = 0;
+}
+
+uint16_t animation_arena_used(void)
+{
+    return arena_used;
+}
+
+uint16_t animation_arena_peak(void)
+{
+    return arena_peak;
+}
@@ -0,0 +1,52 @@
+#ifndef KEYBOARD_ANORAK_91TKL_BACKLIGHT_ANIMATIONS_ANIMATION_ARENA_H_
+#define KEYBOARD_ANORAK_91TKL_BACKLIGHT_ANIMATIONS_ANIMATION_ARENA_H_
+
+#include "config.h"
+#include "animation_enable.h"
+#include "../issi/is31fl3733.h"
+#include "led_matrix/led_matrix.h"
+#include <inttypes.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * All memory an animation needs while it runs comes from one static arena.
+ * Allocations are bump allocated and zeroed, everything is released at once
+ * by stop_animation(). There is no free().
+ */
+
+// used by animation_prepare(): led and pwm snapshot of both devices, key press counter
+#define ANIMATION_ARENA_PREPARE_SIZE (2 * (IS31FL3733_LED_ENABLE_SIZE + IS31FL3733_LED_PWM_SIZE) + MATRIX_ROWS * MATRIX_COLS)
+
+// the largest animation budget: the particles of the flame, the position terms of the plasma or the generations and colors of conway
+#if defined(ANIMATION_ENABLE_PARTICLE_SYSTEM)
+#define ANIMATION_ARENA_ANIMATION_SIZE (sizeof(led_matrix_flame_state))
+#elif defined(ANIMATION_ENABLE_FLOATING_PLASMA)
+#define ANIMATION_ARENA_ANIMATION_SIZE (MATRIX_ROWS * MATRIX_COLS * sizeof(uint16_t))
+#else
+#define ANIMATION_ARENA_ANIMATION_SIZE (3 * MATRIX_ROWS * sizeof(matrix_row_t) + MATRIX_ROWS * MATRIX_COLS)
+#endif
+
+#define ANIMATION_ARENA_SIZE (ANIMATION_ARENA_PREPARE_SIZE + ANIMATION_ARENA_ANIMATION_SIZE)
+
+// fails to compile if the budget of an animation does not fit into the arena next to animation_prepare()
+#define ANIMATION_ARENA_BUDGET(name, size) \
+    typedef char animation_arena_budget_##name[((size) + ANIMATION_ARENA_PREPARE_SIZE <= ANIMATION_ARENA_SIZE) ? 1 : -1]
+
+// returns zeroed memory or 0 if the arena is exhausted
+void *animation_arena_alloc(uint16_t size);
+// release everything, called by stop_animation()
+void animation_arena_reset(void);
+
+uint16_t animation_arena_used(void);
+// highest usage of the current or last animation
+uint16_t animation_arena_peak(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KEYBOARD_ANORAK_91TKL_BACKLIGHT_ANIMATIONS_ANIMATION_ARENA_H_ */
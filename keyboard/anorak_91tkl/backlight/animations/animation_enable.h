@@ -1,4 +1,8 @@
 #pragma once
 
 //#define ANIMATION_ENABLE_FLOATING_PLASMA
-//#define ANIMATION_ENABLE_PARTICLE_SYSTEM
+
+// the flame needs flame in LED_MATRIX_ANIMATIONS of the Makefile
+#ifdef LED_MATRIX_ANIMATION_FLAME
+#define ANIMATION_ENABLE_PARTICLE_SYSTEM
+#endif
@@ -0,0 +1,434 @@
+/* Generated by tmk_core/tool/led_layout/led_layout_gen, do not edit.
+ *   led_layout_gen -m key_led_map.h -l key_led_map.c -o animation_lut
+ *
+ * flash bytes per table, only referenced tables are linked:
+ *   key_layout_position              204
+ *   key_layout_polar_center          204
+ *   key_layout_order_polar_center     91
+ *   key_layout_hypot                 444
+ *   key_layout_neighbors             612
+ *   key_layout_order_x                91
+ *   key_layout_order_y                91
+ *   sin_lut                          512
+ *   PlasmaColorSpace                2304
+ *   total                           4553
+ */
+
+#include "animation_lut.h"
+
+const key_layout_point key_layout_position[6][17] PROGMEM = {
+    { {   2,   0 }, {   7,   0 }, {  12,   0 }, {  16,   0 }, {  20,   0 }, {  24,   0 }, {  29,   0 }, {  33,   0 }, {  37,   0 }, {  41,   0 }, {  46,   0 }, {  50,   0 }, {  54,   0 }, {  58,   0 }, {  65,   0 }, {  69,   0 }, {  73,   0 }, },
+    { {   2,   6 }, {   6,   6 }, {  10,   6 }, {  14,   6 }, {  18,   6 }, {  22,   6 }, {  26,   6 }, {  30,   6 }, {  34,   6 }, {  38,   6 }, {  42,   6 }, {  46,   6 }, {  50,   6 }, {  56,   6 }, {  65,   6 }, {  69,   6 }, {  73,   6 }, },
+    { {   3,  10 }, {   8,  10 }, {  12,  10 }, {  16,  10 }, {  20,  10 }, {  24,  10 }, {  28,  10 }, {  32,  10 }, {  36,  10 }, {  40,  10 }, {  44,  10 }, {  48,  10 }, {  52,  10 }, {  57,  10 }, {  65,  10 }, {  69,  10 }, {  73,  10 }, },
+    { {   3,  14 }, {   9,  14 }, {  13,  14 }, {  17,  14 }, {  21,  14 }, {  25,  14 }, {  29,  14 }, {  33,  14 }, {  37,  14 }, {  41,  14 }, {  45,  14 }, {  49,  14 }, {  55,  14 }, { NLED, NLED }, { NLED, NLED }, { NLED, NLED }, { NLED, NLED }, },
+    { {   2,  18 }, {   7,  18 }, {  11,  18 }, {  15,  18 }, {  19,  18 }, {  23,  18 }, {  27,  18 }, {  31,  18 }, {  35,  18 }, {  39,  18 }, {  43,  18 }, {  47,  18 }, {  54,  18 }, { NLED, NLED }, {  65,  18 }, {  69,  18 }, {  73,  18 }, },
+    { {   2,  22 }, {   6,  22 }, {  10,  22 }, {  27,  22 }, { NLED, NLED }, { NLED, NLED }, { NLED, NLED }, { NLED, NLED }, { NLED, NLED }, {  45,  22 }, {  50,  22 }, {  54,  22 }, {  58,  22 }, { NLED, NLED }, {  65,  22 }, {  69,  22 }, {  73,  22 }, },
+};
+
+// center 9.38, 2.75 key units
+
+const key_layout_polar key_layout_polar_center[6][17] PROGMEM = {
+    { { 255, 116 }, { 222, 114 }, { 191, 111 }, { 166, 109 }, { 142, 105 }, { 119, 100 }, {  95,  91 }, {  82,  80 }, {  76,  66 }, {  79,  51 }, {  95,  37 }, { 114,  29 }, { 136,  24 }, { 160,  20 }, { 203,  16 }, { 229,  14 }, { 255,  12 }, },
+    { { 246, 122 }, { 219, 122 }, { 192, 121 }, { 165, 119 }, { 138, 118 }, { 112, 115 }, {  86, 111 }, {  62, 104 }, {  42,  89 }, {  34,  60 }, {  46,  34 }, {  68,  22 }, {  92,  16 }, { 131,  11 }, { 192,   7 }, { 219,   6 }, { 246,   6 }, },
+    { { 237, 127 }, { 203, 127 }, { 175, 126 }, { 148, 126 }, { 120, 126 }, {  93, 125 }, {  66, 124 }, {  38, 121 }, {  12, 104 }, {  18,  16 }, {  45,   6 }, {  72,   4 }, { 100,   3 }, { 134,   2 }, { 189,   1 }, { 216,   1 }, { 244,   1 }, },
+    { { 238, 132 }, { 197, 132 }, { 169, 133 }, { 142, 134 }, { 115, 135 }, {  88, 138 }, {  62, 142 }, {  37, 152 }, {  21, 185 }, {  32, 227 }, {  55, 240 }, {  82, 246 }, { 122, 249 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, },
+    { { 248, 136 }, { 215, 137 }, { 188, 139 }, { 162, 140 }, { 136, 143 }, { 110, 146 }, {  87, 152 }, {  66, 162 }, {  51, 178 }, {  49, 201 }, {  61, 219 }, {  81, 230 }, { 123, 240 }, { 0, 0 }, { 195, 246 }, { 221, 247 }, { 248, 248 }, },
+    { { 255, 140 }, { 229, 142 }, { 203, 144 }, { 104, 161 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, { 0, 0 }, {  91, 216 }, { 114, 227 }, { 136, 232 }, { 160, 236 }, { 0, 0 }, { 203, 240 }, { 229, 242 }, { 255, 244 }, },
+};
+
+const uint8_t key_layout_order_polar_center[KEY_LAYOUT_KEYS] PROGMEM = {
+     42,  43,  59,  60,  26,  58,  41,  25,  44,  27,  77,  76,  61,  78,  24,  57,
+     40,  75,  28,  45,   8,   9,  79,   7,  62,  23,  74,  56,  94,  29,  39,   6,
+     10,  46,  88,  73,  22,  11,  95,  55,   5,  38,  63,  80,  30,  47,  12,  72,
+     96,  21,   4,  54,  37,  13,  97,  71,  20,   3,  53,  36,  70,  48,   2,  19,
+     31,  82,  52,  14,  35,  87,  99,  69,  49,  18,  32,  83,   1,  15,  86, 100,
+     34,  51,  50,  17,  33,  68,  84,   0,  16,  85, 101,
+};
+
+const uint8_t key_layout_hypot[12][37] PROGMEM = {
+    {   0,   2,   4,   6,   8,  10,  12,  14,  16,  18,  20,  22,  24,  26,  28,  30,
+      32,  34,  36,  38,  40,  42,  44,  46,  48,  50,  52,  54,  56,  58,  60,  62,
+      64,  66,  68,  70,  72, },
+    {   2,   3,   4,   6,   8,  10,  12,  14,  16,  18,  20,  22,  24,  26,  28,  30,
+      32,  34,  36,  38,  40,  42,  44,  46,  48,  50,  52,  54,  56,  58,  60,  62,
+      64,  66,  68,  70,  72, },
+    {   4,   4,   6,   7,   9,  11,  13,  15,  16,  18,  20,  22,  24,  26,  28,  30,
+      32,  34,  36,  38,  40,  42,  44,  46,  48,  50,  52,  54,  56,  58,  60,  62,
+      64,  66,  68,  70,  72, },
+    {   6,   6,   7,   8,  10,  12,  13,  15,  17,  19,  21,  23,  25,  27,  29,  31,
+      33,  35,  36,  38,  40,  42,  44,  46,  48,  50,  52,  54,  56,  58,  60,  62,
+      64,  66,  68,  70,  72, },
+    {   8,   8,   9,  10,  11,  13,  14,  16,  18,  20,  22,  23,  25,  27,  29,  31,
+      33,  35,  37,  39,  41,  43,  45,  47,  49,  51,  53,  55,  57,  59,  61,  63,
+      64,  66,  68,  70,  72, },
+    {  10,  10,  11,  12,  13,  14,  16,  17,  19,  21,  22,  24,  26,  28,  30,  32,
+      34,  35,  37,  39,  41,  43,  45,  47,  49,  51,  53,  55,  57,  59,  61,  63,
+      65,  67,  69,  71,  73, },
+    {  12,  12,  13,  13,  14,  16,  17,  18,  20,  22,  23,  25,  27,  29,  30,  32,
+      34,  36,  38,  40,  42,  44,  46,  48,  49,  51,  53,  55,  57,  59,  61,  63,
+      65,  67,  69,  71,  73, },
+    {  14,  14,  15,  15,  16,  17,  18,  20,  21,  23,  24,  26,  28,  30,  31,  33,
+      35,  37,  39,  40,  42,  44,  46,  48,  50,  52,  54,  56,  58,  60,  62,  64,
+      66,  67,  69,  71,  73, },
+    {  16,  16,  16,  17,  18,  19,  20,  21,  23,  24,  26,  27,  29,  31,  32,  34,
+      36,  38,  39,  41,  43,  45,  47,  49,  51,  52,  54,  56,  58,  60,  62,  64,
+      66,  68,  70,  72,  74, },
+    {  18,  18,  18,  19,  20,  21,  22,  23,  24,  25,  27,  28,  30,  32,  33,  35,
+      37,  38,  40,  42,  44,  46,  48,  49,  51,  53,  55,  57,  59,  61,  63,  65,
+      66,  68,  70,  72,  74, },
+    {  20,  20,  20,  21,  22,  22,  23,  24,  26,  27,  28,  30,  31,  33,  34,  36,
+      38,  39,  41,  43,  45,  47,  48,  50,  52,  54,  56,  58,  59,  61,  63,  65,
+      67,  69,  71,  73,  75, },
+    {  22,  22,  22,  23,  23,  24,  25,  26,  27,  28,  30,  31,  33,  34,  36,  37,
+      39,  40,  42,  44,  46,  47,  49,  51,  53,  55,  56,  58,  60,  62,  64,  66,
+      68,  70,  71,  73,  75, },
+};
+
+const uint8_t key_layout_neighbors[6][17][KEY_LAYOUT_NEIGHBORS] PROGMEM = {
+    {
+        {   1,  17, NLED, NLED, NLED, NLED, },
+        {   0,   2, NLED, NLED, NLED, NLED, },
+        {   3,   1, NLED, NLED, NLED, NLED, },
+        {   2,   4, NLED, NLED, NLED, NLED, },
+        {   3,   5, NLED, NLED, NLED, NLED, },
+        {   4,   6, NLED, NLED, NLED, NLED, },
+        {   7,   5, NLED, NLED, NLED, NLED, },
+        {   6,   8, NLED, NLED, NLED, NLED, },
+        {   7,   9, NLED, NLED, NLED, NLED, },
+        {   8,  10, NLED, NLED, NLED, NLED, },
+        {  11,   9,  28, NLED, NLED, NLED, },
+        {  10,  12,  29, NLED, NLED, NLED, },
+        {  11,  13, NLED, NLED, NLED, NLED, },
+        {  12, NLED, NLED, NLED, NLED, NLED, },
+        {  15,  31, NLED, NLED, NLED, NLED, },
+        {  14,  16,  32, NLED, NLED, NLED, },
+        {  15,  33, NLED, NLED, NLED, NLED, },
+    },
+    {
+        {  18,  34,   0, NLED, NLED, NLED, },
+        {  17,  19,  35,  34, NLED, NLED, },
+        {  18,  20,  35,  36, NLED, NLED, },
+        {  19,  21,  36,  37, NLED, NLED, },
+        {  20,  22,  37,  38, NLED, NLED, },
+        {  21,  23,  38,  39, NLED, NLED, },
+        {  22,  24,  39,  40, NLED, NLED, },
+        {  23,  25,  40,  41, NLED, NLED, },
+        {  24,  26,  41,  42, NLED, NLED, },
+        {  25,  27,  42,  43, NLED, NLED, },
+        {  26,  28,  43,  44, NLED, NLED, },
+        {  27,  29,  44,  45,  10, NLED, },
+        {  28,  45,  46,  11,  30, NLED, },
+        {  47,  46,  29, NLED, NLED, NLED, },
+        {  32,  48,  49,  14, NLED, NLED, },
+        {  31,  33,  49,  48,  50,  15, },
+        {  32,  50,  49,  16, NLED, NLED, },
+    },
+    {
+        {  51,  17,  18,  35, NLED, NLED, },
+        {  36,  52,  18,  19,  34, NLED, },
+        {  35,  37,  53,  19,  20,  52, },
+        {  36,  38,  54,  20,  21,  53, },
+        {  37,  39,  55,  21,  22,  54, },
+        {  38,  40,  56,  22,  23,  55, },
+        {  39,  41,  57,  23,  24,  56, },
+        {  40,  42,  58,  24,  25,  57, },
+        {  41,  43,  59,  25,  26,  58, },
+        {  42,  44,  60,  26,  27,  59, },
+        {  43,  45,  61,  27,  28,  60, },
+        {  44,  46,  62,  28,  29,  61, },
+        {  45,  29,  47,  62,  63,  30, },
+        {  30,  63,  46, NLED, NLED, NLED, },
+        {  31,  49,  32, NLED, NLED, NLED, },
+        {  32,  48,  50,  31,  33, NLED, },
+        {  33,  49,  32, NLED, NLED, NLED, },
+    },
+    {
+        {  34,  68,  69,  52, NLED, NLED, },
+        {  53,  35,  69,  70,  36,  51, },
+        {  52,  54,  36,  70,  71,  37, },
+        {  53,  55,  37,  71,  72,  38, },
+        {  54,  56,  38,  72,  73,  39, },
+        {  55,  57,  39,  73,  74,  40, },
+        {  56,  58,  40,  74,  75,  41, },
+        {  57,  59,  41,  75,  76,  42, },
+        {  58,  60,  42,  76,  77,  43, },
+        {  59,  61,  43,  77,  78,  44, },
+        {  60,  62,  44,  78,  79,  45, },
+        {  61,  45,  79,  46,  63, NLED, },
+        {  80,  47,  46,  62, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+    },
+    {
+        {  85,  51,  69,  86, NLED, NLED, },
+        {  70,  86,  52,  68,  87,  51, },
+        {  69,  71,  87,  52,  53, NLED, },
+        {  70,  72,  53,  54, NLED, NLED, },
+        {  71,  73,  54,  55, NLED, NLED, },
+        {  72,  74,  55,  56,  88, NLED, },
+        {  73,  75,  88,  56,  57, NLED, },
+        {  74,  76,  57,  58,  88, NLED, },
+        {  75,  77,  58,  59, NLED, NLED, },
+        {  76,  78,  59,  60, NLED, NLED, },
+        {  77,  79,  60,  61,  94, NLED, },
+        {  78,  61,  62,  94,  95, NLED, },
+        {  96,  63,  95,  97, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        {  83,  99, 100, NLED, NLED, NLED, },
+        {  82,  84, 100,  99, 101, NLED, },
+        {  83, 101, 100, NLED, NLED, NLED, },
+    },
+    {
+        {  68,  86, NLED, NLED, NLED, NLED, },
+        {  85,  87,  69,  68, NLED, NLED, },
+        {  86,  70,  69, NLED, NLED, NLED, },
+        {  74,  73,  75, NLED, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        {  78,  79,  95, NLED, NLED, NLED, },
+        {  96,  79,  94,  80, NLED, NLED, },
+        {  80,  95,  97, NLED, NLED, NLED, },
+        {  96,  80, NLED, NLED, NLED, NLED, },
+        { NLED, NLED, NLED, NLED, NLED, NLED, },
+        {  82, 100,  83, NLED, NLED, NLED, },
+        {  83,  99, 101,  82,  84, NLED, },
+        {  84, 100,  83, NLED, NLED, NLED, },
+    },
+};
+
+const uint8_t key_layout_order_x[KEY_LAYOUT_KEYS] PROGMEM = {
+      0,  17,  68,  85,  34,  51,  18,  86,   1,  69,  35,  52,  19,  87,  70,   2,
+     36,  53,  20,  71,   3,  37,  54,  21,  72,   4,  38,  55,  22,  73,   5,  39,
+     56,  23,  74,  88,  40,   6,  57,  24,  75,  41,   7,  58,  25,  76,  42,   8,
+     59,  26,  77,  43,   9,  60,  27,  78,  44,  61,  94,  10,  28,  79,  45,  62,
+     11,  29,  95,  46,  12,  80,  96,  63,  30,  47,  13,  97,  14,  31,  48,  82,
+     99,  15,  32,  49,  83, 100,  16,  33,  50,  84, 101,
+};
+
+const uint8_t key_layout_order_y[KEY_LAYOUT_KEYS] PROGMEM = {
+      0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15,
+     16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,
+     32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,
+     48,  49,  50,  51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61,  62,  63,
+     68,  69,  70,  71,  72,  73,  74,  75,  76,  77,  78,  79,  80,  82,  83,  84,
+     85,  86,  87,  88,  94,  95,  96,  97,  99, 100, 101,
+};
+
+const uint16_t sin_lut[256] PROGMEM = {
+       0,    0,    1,    1,    2,    4,    6,    8,   10,   12,   15,   19,   22,   26,   30,   34,
+      39,   44,   49,   55,   60,   66,   73,   79,   86,   93,  101,  108,  116,  124,  133,  141,
+     150,  159,  168,  177,  187,  197,  207,  217,  227,  238,  249,  259,  270,  282,  293,  304,
+     316,  327,  339,  351,  363,  375,  387,  399,  412,  424,  436,  449,  461,  474,  486,  499,
+     511,  524,  537,  549,  562,  574,  587,  599,  611,  624,  636,  648,  660,  672,  684,  696,
+     707,  719,  730,  741,  753,  764,  774,  785,  796,  806,  816,  826,  836,  846,  855,  864,
+     873,  882,  890,  899,  907,  915,  922,  930,  937,  944,  950,  957,  963,  968,  974,  979,
+     984,  989,  993,  997, 1001, 1004, 1008, 1011, 1013, 1015, 1017, 1019, 1021, 1022, 1022, 1023,
+    1023, 1023, 1022, 1022, 1021, 1019, 1017, 1015, 1013, 1011, 1008, 1004, 1001,  997,  993,  989,
+     984,  979,  974,  968,  963,  957,  950,  944,  937,  930,  922,  915,  907,  899,  890,  882,
+     873,  864,  855,  846,  836,  826,  816,  806,  796,  785,  774,  764,  753,  741,  730,  719,
+     707,  696,  684,  672,  660,  648,  636,  624,  611,  599,  587,  574,  562,  549,  537,  524,
+     512,  499,  486,  474,  461,  449,  436,  424,  412,  399,  387,  375,  363,  351,  339,  327,
+     316,  304,  293,  282,  270,  259,  249,  238,  227,  217,  207,  197,  187,  177,  168,  159,
+     150,  141,  133,  124,  116,  108,  101,   93,   86,   79,   73,   66,   60,   55,   49,   44,
+      39,   34,   30,   26,   22,   19,   15,   12,   10,    8,    6,    4,    2,    1,    1,    0,
+};
+
+const uint8_t PlasmaColorSpace[3 * 3 * 256] PROGMEM = {
+      0, 255,   0,    1, 254,   0,    2, 253,   0,    3, 252,   0,
+      4, 251,   0,    5, 250,   0,    6, 249,   0,    7, 248,   0,
+      8, 247,   0,    9, 246,   0,   10, 245,   0,   11, 244,   0,
+     12, 243,   0,   13, 242,   0,   14, 241,   0,   15, 240,   0,
+     16, 239,   0,   17, 238,   0,   18, 237,   0,   19, 236,   0,
+     20, 235,   0,   21, 234,   0,   22, 233,   0,   23, 232,   0,
+     24, 231,   0,   25, 230,   0,   26, 229,   0,   27, 228,   0,
+     28, 227,   0,   29, 226,   0,   30, 225,   0,   31, 224,   0,
+     32, 223,   0,   33, 222,   0,   34, 221,   0,   35, 220,   0,
+     36, 219,   0,   37, 218,   0,   38, 217,   0,   39, 216,   0,
+     40, 215,   0,   41, 214,   0,   42, 213,   0,   43, 212,   0,
+     44, 211,   0,   45, 210,   0,   46, 209,   0,   47, 208,   0,
+     48, 207,   0,   49, 206,   0,   50, 205,   0,   51, 204,   0,
+     52, 203,   0,   53, 202,   0,   54, 201,   0,   55, 200,   0,
+     56, 199,   0,   57, 198,   0,   58, 197,   0,   59, 196,   0,
+     60, 195,   0,   61, 194,   0,   62, 193,   0,   63, 192,   0,
+     64, 191,   0,   65, 190,   0,   66, 189,   0,   67, 188,   0,
+     68, 187,   0,   69, 186,   0,   70, 185,   0,   71, 184,   0,
+     72, 183,   0,   73, 182,   0,   74, 181,   0,   75, 180,   0,
+     76, 179,   0,   77, 178,   0,   78, 177,   0,   79, 176,   0,
+     80, 175,   0,   81, 174,   0,   82, 173,   0,   83, 172,   0,
+     84, 171,   0,   85, 170,   0,   86, 169,   0,   87, 168,   0,
+     88, 167,   0,   89, 166,   0,   90, 165,   0,   91, 164,   0,
+     92, 163,   0,   93, 162,   0,   94, 161,   0,   95, 160,   0,
+     96, 159,   0,   97, 158,   0,   98, 157,   0,   99, 156,   0,
+    100, 155,   0,  101, 154,   0,  102, 153,   0,  103, 152,   0,
+    104, 151,   0,  105, 150,   0,  106, 149,   0,  107, 148,   0,
+    108, 147,   0,  109, 146,   0,  110, 145,   0,  111, 144,   0,
+    112, 143,   0,  113, 142,   0,  114, 141,   0,  115, 140,   0,
+    116, 139,   0,  117, 138,   0,  118, 137,   0,  119, 136,   0,
+    120, 135,   0,  121, 134,   0,  122, 133,   0,  123, 132,   0,
+    124, 131,   0,  125, 130,   0,  126, 129,   0,  127, 128,   0,
+    128, 127,   0,  129, 126,   0,  130, 125,   0,  131, 124,   0,
+    132, 123,   0,  133, 122,   0,  134, 121,   0,  135, 120,   0,
+    136, 119,   0,  137, 118,   0,  138, 117,   0,  139, 116,   0,
+    140, 115,   0,  141, 114,   0,  142, 113,   0,  143, 112,   0,
+    144, 111,   0,  145, 110,   0,  146, 109,   0,  147, 108,   0,
+    148, 107,   0,  149, 106,   0,  150, 105,   0,  151, 104,   0,
+    152, 103,   0,  153, 102,   0,  154, 101,   0,  155, 100,   0,
+    156,  99,   0,  157,  98,   0,  158,  97,   0,  159,  96,   0,
+    160,  95,   0,  161,  94,   0,  162,  93,   0,  163,  92,   0,
+    164,  91,   0,  165,  90,   0,  166,  89,   0,  167,  88,   0,
+    168,  87,   0,  169,  86,   0,  170,  85,   0,  171,  84,   0,
+    172,  83,   0,  173,  82,   0,  174,  81,   0,  175,  80,   0,
+    176,  79,   0,  177,  78,   0,  178,  77,   0,  179,  76,   0,
+    180,  75,   0,  181,  74,   0,  182,  73,   0,  183,  72,   0,
+    184,  71,   0,  185,  70,   0,  186,  69,   0,  187,  68,   0,
+    188,  67,   0,  189,  66,   0,  190,  65,   0,  191,  64,   0,
+    192,  63,   0,  193,  62,   0,  194,  61,   0,  195,  60,   0,
+    196,  59,   0,  197,  58,   0,  198,  57,   0,  199,  56,   0,
+    200,  55,   0,  201,  54,   0,  202,  53,   0,  203,  52,   0,
+    204,  51,   0,  205,  50,   0,  206,  49,   0,  207,  48,   0,
+    208,  47,   0,  209,  46,   0,  210,  45,   0,  211,  44,   0,
+    212,  43,   0,  213,  42,   0,  214,  41,   0,  215,  40,   0,
+    216,  39,   0,  217,  38,   0,  218,  37,   0,  219,  36,   0,
+    220,  35,   0,  221,  34,   0,  222,  33,   0,  223,  32,   0,
+    224,  31,   0,  225,  30,   0,  226,  29,   0,  227,  28,   0,
+    228,  27,   0,  229,  26,   0,  230,  25,   0,  231,  24,   0,
+    232,  23,   0,  233,  22,   0,  234,  21,   0,  235,  20,   0,
+    236,  19,   0,  237,  18,   0,  238,  17,   0,  239,  16,   0,
+    240,  15,   0,  241,  14,   0,  242,  13,   0,  243,  12,   0,
+    244,  11,   0,  245,  10,   0,  246,   9,   0,  247,   8,   0,
+    248,   7,   0,  249,   6,   0,  250,   5,   0,  251,   4,   0,
+    252,   3,   0,  253,   2,   0,  254,   1,   0,  255,   0,   0,
+    255,   0,   0,  254,   0,   1,  253,   0,   2,  252,   0,   3,
+    251,   0,   4,  250,   0,   5,  249,   0,   6,  248,   0,   7,
+    247,   0,   8,  246,   0,   9,  245,   0,  10,  244,   0,  11,
+    243,   0,  12,  242,   0,  13,  241,   0,  14,  240,   0,  15,
+    239,   0,  16,  238,   0,  17,  237,   0,  18,  236,   0,  19,
+    235,   0,  20,  234,   0,  21,  233,   0,  22,  232,   0,  23,
+    231,   0,  24,  230,   0,  25,  229,   0,  26,  228,   0,  27,
+    227,   0,  28,  226,   0,  29,  225,   0,  30,  224,   0,  31,
+    223,   0,  32,  222,   0,  33,  221,   0,  34,  220,   0,  35,
+    219,   0,  36,  218,   0,  37,  217,   0,  38,  216,   0,  39,
+    215,   0,  40,  214,   0,  41,  213,   0,  42,  212,   0,  43,
+    211,   0,  44,  210,   0,  45,  209,   0,  46,  208,   0,  47,
+    207,   0,  48,  206,   0,  49,  205,   0,  50,  204,   0,  51,
+    203,   0,  52,  202,   0,  53,  201,   0,  54,  200,   0,  55,
+    199,   0,  56,  198,   0,  57,  197,   0,  58,  196,   0,  59,
+    195,   0,  60,  194,   0,  61,  193,   0,  62,  192,   0,  63,
+    191,   0,  64,  190,   0,  65,  189,   0,  66,  188,   0,  67,
+    187,   0,  68,  186,   0,  69,  185,   0,  70,  184,   0,  71,
+    183,   0,  72,  182,   0,  73,  181,   0,  74,  180,   0,  75,
+    179,   0,  76,  178,   0,  77,  177,   0,  78,  176,   0,  79,
+    175,   0,  80,  174,   0,  81,  173,   0,  82,  172,   0,  83,
+    171,   0,  84,  170,   0,  85,  169,   0,  86,  168,   0,  87,
+    167,   0,  88,  166,   0,  89,  165,   0,  90,  164,   0,  91,
+    163,   0,  92,  162,   0,  93,  161,   0,  94,  160,   0,  95,
+    159,   0,  96,  158,   0,  97,  157,   0,  98,  156,   0,  99,
+    155,   0, 100,  154,   0, 101,  153,   0, 102,  152,   0, 103,
+    151,   0, 104,  150,   0, 105,  149,   0, 106,  148,   0, 107,
+    147,   0, 108,  146,   0, 109,  145,   0, 110,  144,   0, 111,
+    143,   0, 112,  142,   0, 113,  141,   0, 114,  140,   0, 115,
+    139,   0, 116,  138,   0, 117,  137,   0, 118,  136,   0, 119,
+    135,   0, 120,  134,   0, 121,  133,   0, 122,  132,   0, 123,
+    131,   0, 124,  130,   0, 125,  129,   0, 126,  128,   0, 127,
+    127,   0, 128,  126,   0, 129,  125,   0, 130,  124,   0, 131,
+    123,   0, 132,  122,   0, 133,  121,   0, 134,  120,   0, 135,
+    119,   0, 136,  118,   0, 137,  117,   0, 138,  116,   0, 139,
+    115,   0, 140,  114,   0, 141,  113,   0, 142,  112,   0, 143,
+    111,   0, 144,  110,   0, 145,  109,   0, 146,  108,   0, 147,
+    107,   0, 148,  106,   0, 149,  105,   0, 150,  104,   0, 151,
+    103,   0, 152,  102,   0, 153,  101,   0, 154,  100,   0, 155,
+     99,   0, 156,   98,   0, 157,   97,   0, 158,   96,   0, 159,
+     95,   0, 160,   94,   0, 161,   93,   0, 162,   92,   0, 163,
+     91,   0, 164,   90,   0, 165,   89,   0, 166,   88,   0, 167,
+     87,   0, 168,   86,   0, 169,   85,   0, 170,   84,   0, 171,
+     83,   0, 172,   82,   0, 173,   81,   0, 174,   80,   0, 175,
+     79,   0, 176,   78,   0, 177,   77,   0, 178,   76,   0, 179,
+     75,   0, 180,   74,   0, 181,   73,   0, 182,   72,   0, 183,
+     71,   0, 184,   70,   0, 185,   69,   0, 186,   68,   0, 187,
+     67,   0, 188,   66,   0, 189,   65,   0, 190,   64,   0, 191,
+     63,   0, 192,   62,   0, 193,   61,   0, 194,   60,   0, 195,
+     59,   0, 196,   58,   0, 197,   57,   0, 198,   56,   0, 199,
+     55,   0, 200,   54,   0, 201,   53,   0, 202,   52,   0, 203,
+     51,   0, 204,   50,   0, 205,   49,   0, 206,   48,   0, 207,
+     47,   0, 208,   46,   0, 209,   45,   0, 210,   44,   0, 211,
+     43,   0, 212,   42,   0, 213,   41,   0, 214,   40,   0, 215,
+     39,   0, 216,   38,   0, 217,   37,   0, 218,   36,   0, 219,
+     35,   0, 220,   34,   0, 221,   33,   0, 222,   32,   0, 223,
+     31,   0, 224,   30,   0, 225,   29,   0, 226,   28,   0, 227,
+     27,   0, 228,   26,   0, 229,   25,   0, 230,   24,   0, 231,
+     23,   0, 232,   22,   0, 233,   21,   0, 234,   20,   0, 235,
+     19,   0, 236,   18,   0, 237,   17,   0, 238,   16,   0, 239,
+     15,   0, 240,   14,   0, 241,   13,   0, 242,   12,   0, 243,
+     11,   0, 244,   10,   0, 245,    9,   0, 246,    8,   0, 247,
+      7,   0, 248,    6,   0, 249,    5,   0, 250,    4,   0, 251,
+      3,   0, 252,    2,   0, 253,    1,   0, 254,    0,   0, 255,
+      0,   0, 255,    0,   1, 254,    0,   2, 253,    0,   3, 252,
+      0,   4, 251,    0,   5, 250,    0,   6, 249,    0,   7, 248,
+      0,   8, 247,    0,   9, 246,    0,  10, 245,    0,  11, 244,
+      0,  12, 243,    0,  13, 242,    0,  14, 241,    0,  15, 240,
+      0,  16, 239,    0,  17, 238,    0,  18, 237,    0,  19, 236,
+      0,  20, 235,    0,  21, 234,    0,  22, 233,    0,  23, 232,
+      0,  24, 231,    0,  25, 230,    0,  26, 229,    0,  27, 228,
+      0,  28, 227,    0,  29, 226,    0,  30, 225,    0,  31, 224,
+      0,  32, 223,    0,  33, 222,    0,  34, 221,    0,  35, 220,
+      0,  36, 219,    0,  37, 218,    0,  38, 217,    0,  39, 216,
+      0,  40, 215,    0,  41, 214,    0,  42, 213,    0,  43, 212,
+      0,  44, 211,    0,  45, 210,    0,  46, 209,    0,  47, 208,
+      0,  48, 207,    0,  49, 206,    0,  50, 205,    0,  51, 204,
+      0,  52, 203,    0,  53, 202,    0,  54, 201,    0,  55, 200,
+      0,  56, 199,    0,  57, 198,    0,  58, 197,    0,  59, 196,
+      0,  60, 195,    0,  61, 194,    0,  62, 193,    0,  63, 192,
+      0,  64, 191,    0,  65, 190,    0,  66, 189,    0,  67, 188,
+      0,  68, 187,    0,  69, 186,    0,  70, 185,    0,  71, 184,
+      0,  72, 183,    0,  73, 182,    0,  74, 181,    0,  75, 180,
+      0,  76, 179,    0,  77, 178,    0,  78, 177,    0,  79, 176,
+      0,  80, 175,    0,  81, 174,    0,  82, 173,    0,  83, 172,
+      0,  84, 171,    0,  85, 170,    0,  86, 169,    0,  87, 168,
+      0,  88, 167,    0,  89, 166,    0,  90, 165,    0,  91, 164,
+      0,  92, 163,    0,  93, 162,    0,  94, 161,    0,  95, 160,
+      0,  96, 159,    0,  97, 158,    0,  98, 157,    0,  99, 156,
+      0, 100, 155,    0, 101, 154,    0, 102, 153,    0, 103, 152,
+      0, 104, 151,    0, 105, 150,    0, 106, 149,    0, 107, 148,
+      0, 108, 147,    0, 109, 146,    0, 110, 145,    0, 111, 144,
+      0, 112, 143,    0, 113, 142,    0, 114, 141,    0, 115, 140,
+      0, 116, 139,    0, 117, 138,    0, 118, 137,    0, 119, 136,
+      0, 120, 135,    0, 121, 134,    0, 122, 133,    0, 123, 132,
+      0, 124, 131,    0, 125, 130,    0, 126, 129,    0, 127, 128,
+      0, 128, 127,    0, 129, 126,    0, 130, 125,    0, 131, 124,
+      0, 132, 123,    0, 133, 122,    0, 134, 121,    0, 135, 120,
+      0, 136, 119,    0, 137, 118,    0, 138, 117,    0, 139, 116,
+      0, 140, 115,    0, 141, 114,    0, 142, 113,    0, 143, 112,
+      0, 144, 111,    0, 145, 110,    0, 146, 109,    0, 147, 108,
+      0, 148, 107,    0, 149, 106,    0, 150, 105,    0, 151, 104,
+      0, 152, 103,    0, 153, 102,    0, 154, 101,    0, 155, 100,
+      0, 156,  99,    0, 157,  98,    0, 158,  97,    0, 159,  96,
+      0, 160,  95,    0, 161,  94,    0, 162,  93,    0, 163,  92,
+      0, 164,  91,    0, 165,  90,    0, 166,  89,    0, 167,  88,
+      0, 168,  87,    0, 169,  86,    0, 170,  85,    0, 171,  84,
+      0, 172,  83,    0, 173,  82,    0, 174,  81,    0, 175,  80,
+      0, 176,  79,    0, 177,  78,    0, 178,  77,    0, 179,  76,
+      0, 180,  75,    0, 181,  74,    0, 182,  73,    0, 183,  72,
+      0, 184,  71,    0, 185,  70,    0, 186,  69,    0, 187,  68,
+      0, 188,  67,    0, 189,  66,    0, 190,  65,    0, 191,  64,
+      0, 192,  63,    0, 193,  62,    0, 194,  61,    0, 195,  60,
+      0, 196,  59,    0, 197,  58,    0, 198,  57,    0, 199,  56,
+      0, 200,  55,    0, 201,  54,    0, 202,  53,    0, 203,  52,
+      0, 204,  51,    0, 205,  50,    0, 206,  49,    0, 207,  48,
+      0, 208,  47,    0, 209,  46,    0, 210,  45,    0, 211,  44,
+      0, 212,  43,    0, 213,  42,    0, 214,  41,    0, 215,  40,
+      0, 216,  39,    0, 217,  38,    0, 218,  37,    0, 219,  36,
+      0, 220,  35,    0, 221,  34,    0, 222,  33,    0, 223,  32,
+      0, 224,  31,    0, 225,  30,    0, 226,  29,    0, 227,  28,
+      0, 228,  27,    0, 229,  26,    0, 230,  25,    0, 231,  24,
+      0, 232,  23,    0, 233,  22,    0, 234,  21,    0, 235,  20,
+      0, 236,  19,    0, 237,  18,    0, 238,  17,    0, 239,  16,
+      0, 240,  15,    0, 241,  14,    0, 242,  13,    0, 243,  12,
+      0, 244,  11,    0, 245,  10,    0, 246,   9,    0, 247,   8,
+      0, 248,   7,    0, 249,   6,    0, 250,   5,    0, 251,   4,
+      0, 252,   3,    0, 253,   2,    0, 254,   1,    0, 255,   0,
+};
@@ -0,0 +1,54 @@
+/* Generated by tmk_core/tool/led_layout/led_layout_gen, do not edit.
+ *   led_layout_gen -m key_led_map.h -l key_led_map.c -o animation_lut
+ */
+
+#ifndef ANIMATION_LUT_H
+#define ANIMATION_LUT_H
+
+#include "../key_led_map.h"
+#include <inttypes.h>
+#include <avr/pgmspace.h>
+
+#if MATRIX_ROWS != 6 || MATRIX_COLS != 17
+#error "generated for a 6x17 matrix"
+#endif
+
+// keys with a position
+#define KEY_LAYOUT_KEYS 91
+#define KEY_LAYOUT_NEIGHBORS 6
+#define KEY_LAYOUT_HYPOT_WIDTH 37
+#define KEY_LAYOUT_HYPOT_HEIGHT 12
+
+// quarter key units of the polar distance 255
+#define KEY_LAYOUT_POLAR_CENTER_RANGE 38
+
+// center of a key in quarter key units, NLED if there is no key
+typedef struct
+{
+    uint8_t x;
+    uint8_t y;
+} key_layout_point;
+
+// distance 0..255 (the farthest key is 255), angle 0..255 counterclockwise from the right
+typedef struct
+{
+    uint8_t distance;
+    uint8_t angle;
+} key_layout_polar;
+
+extern const key_layout_point key_layout_position[6][17] PROGMEM;
+extern const key_layout_polar key_layout_polar_center[6][17] PROGMEM;
+// row * MATRIX_COLS + col of the keys by their distance to the center
+extern const uint8_t key_layout_order_polar_center[KEY_LAYOUT_KEYS] PROGMEM;
+// [dy][dx] in half key units, the distance in quarter key units
+extern const uint8_t key_layout_hypot[KEY_LAYOUT_HYPOT_HEIGHT][KEY_LAYOUT_HYPOT_WIDTH] PROGMEM;
+// row * MATRIX_COLS + col of the nearest keys within 1.5 key units, NLED padded
+extern const uint8_t key_layout_neighbors[6][17][KEY_LAYOUT_NEIGHBORS] PROGMEM;
+// row * MATRIX_COLS + col of the keys from left to right and from top to bottom
+extern const uint8_t key_layout_order_x[KEY_LAYOUT_KEYS] PROGMEM;
+extern const uint8_t key_layout_order_y[KEY_LAYOUT_KEYS] PROGMEM;
+
+extern const uint16_t sin_lut[256] PROGMEM;
+extern const uint8_t PlasmaColorSpace[3 * 3 * 256] PROGMEM;
+
+#endif
@@ -1,5 +1,6 @@
 
 #include "animation_utils.h"
+#include "animation_arena.h"
 #include "config.h"
 #include "../sector/sector_control.h"
 #include "../key_led_map.h"
@@ -24,19 +25,95 @@ static uint8_t *lower_pwm;
 static uint8_t *key_pressed_count = 0;
 static bool hardware_was_enabled = false;
 
-void animation_prepare(bool set_all_to_black)
+/*
+ * Key to PWM buffer lookup, built once by animation_init_key_pwm_lookup().
+ *
+ * key_pwm_offset is the offset of the first PWM byte of a key in the buffer of its device (NLED: no LED),
+ * the color bytes follow at the fixed pwm_channel_offset distances. key_on_upper selects the device.
+ * Three pointers per key would need 612 bytes of RAM, this needs 129.
+ */
+static uint8_t key_pwm_offset[MATRIX_ROWS][MATRIX_COLS];
+static matrix_row_t key_on_upper[MATRIX_ROWS];
+static uint8_t pwm_channel_offset[3];
+// last key row with a LED on the lower and on the upper chip
+static uint8_t last_key_row[2];
+
+void animation_init_key_pwm_lookup(void)
 {
-    dprintf("ani: save, %d\n", freeRam());
+    uint8_t row;
+    uint8_t col;
+    uint8_t device_number;
 
-    hardware_was_enabled = is31fl3733_91tkl_is_hardware_enabled(&issi);
+    // both devices use the same color offsets
+    for (uint8_t c = 0; c < 3; ++c)
+        pwm_channel_offset[c] = issi.upper->offsets.color[c] * IS31FL3733_CS;
+
+    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
+    {
+        key_on_upper[key_row] = 0;
+
+        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
+        {
+            key_pwm_offset[key_row][key_col] = NLED;
+
+            if (getLedPosByMatrixKey(key_row, key_col, &device_number, &row, &col))
+            {
+                key_pwm_offset[key_row][key_col] = (row * 3) * IS31FL3733_CS + col;
+                if (device_number)
+                    key_on_upper[key_row] |= ((matrix_row_t)1 << key_col);
+                last_key_row[device_number ? 1 : 0] = key_row;
+            }
+        }
+    }
+}
 
-    upper_leds = (uint8_t *)malloc(IS31FL3733_LED_ENABLE_SIZE * sizeof(uint8_t));
-    upper_pwm = (uint8_t *)malloc(IS31FL3733_LED_PWM_SIZE * sizeof(uint8_t));
+void animation_upload_after_row(uint8_t key_row)
+{
+    // the upload of a finished chip runs while the rows of the other one are drawn
+    if (key_row == last_key_row[1])
+        is31fl3733_91tkl_update_led_pwm_half(&issi, issi.upper);
+    if (key_row == last_key_row[0])
+        is31fl3733_91tkl_update_led_pwm_half(&issi, issi.lower);
+}
 
-    lower_leds = (uint8_t *)malloc(IS31FL3733_LED_ENABLE_SIZE * sizeof(uint8_t));
-    lower_pwm = (uint8_t *)malloc(IS31FL3733_LED_PWM_SIZE * sizeof(uint8_t));
+static inline uint8_t *key_pwm(uint8_t key_row, uint8_t key_col)
+{
+    uint8_t offset = key_pwm_offset[key_row][key_col];
 
-    key_pressed_count = (uint8_t *)calloc(MATRIX_ROWS * MATRIX_COLS, sizeof(uint8_t));
+    if (offset == NLED)
+        return 0;
+
+    IS31FL3733 *device = (key_on_upper[key_row] & ((matrix_row_t)1 << key_col)) ? issi.upper->device : issi.lower->device;
+    return device->pwm + offset;
+}
+
+static inline void set_key_pwm(uint8_t *pwm, RGB color)
+{
+    pwm[pwm_channel_offset[0]] = color.r;
+    pwm[pwm_channel_offset[1]] = color.g;
+    pwm[pwm_channel_offset[2]] = color.b;
+}
+
+bool animation_prepare(bool set_all_to_black)
+{
+    dprintf("ani: save, %d\n", freeRam());
+
+    // released by stop_animation(), one block: the arena either has all of it or none
+    uint8_t *saved = (uint8_t *)animation_arena_alloc(ANIMATION_ARENA_PREPARE_SIZE);
+    if (!saved)
+    {
+        // the leds keep what they show, animation_postpare() has nothing to restore
+        dprintf("ani: no arena for the saved leds\n");
+        return false;
+    }
+
+    upper_leds = saved;
+    upper_pwm = upper_leds + IS31FL3733_LED_ENABLE_SIZE;
+    lower_leds = upper_pwm + IS31FL3733_LED_PWM_SIZE;
+    lower_pwm = lower_leds + IS31FL3733_LED_ENABLE_SIZE;
+    key_pressed_count = lower_pwm + IS31FL3733_LED_PWM_SIZE;
+
+    hardware_was_enabled = is31fl3733_91tkl_is_hardware_enabled(&issi);
 
     memcpy(upper_leds, is31fl3733_led_buffer(issi.upper->device), IS31FL3733_LED_ENABLE_SIZE * sizeof(uint8_t));
     memcpy(upper_pwm, is31fl3733_pwm_buffer(issi.upper->device), IS31FL3733_LED_PWM_SIZE * sizeof(uint8_t));
@@ -58,12 +135,21 @@ void animation_prepare(bool set_all_to_black)
     is31fl3733_91tkl_hardware_shutdown(&issi, false);
 
     dprintf("ani: ram:%d\n", freeRam());
+    return true;
+}
+
+bool animation_is_prepared(void)
+{
+    return upper_leds != 0;
 }
 
 void animation_postpare()
 {
     dprintf("ani: restore, %d\n", freeRam());
 
+    if (!upper_leds)
+        return;
+
     if (!hardware_was_enabled)
         is31fl3733_91tkl_hardware_shutdown(&issi, true);
 
@@ -76,13 +162,8 @@ void animation_postpare()
     is31fl3733_91tkl_update_led_pwm(&issi);
     is31fl3733_91tkl_update_led_enable(&issi);
 
-    free(upper_leds);
-    free(upper_pwm);
-
-    free(lower_leds);
-    free(lower_pwm);
-
-    free(key_pressed_count);
+    // the arena is reset after the stop
+    upper_leds = upper_pwm = lower_leds = lower_pwm = key_pressed_count = 0;
 
     dprintf("ram: %d\n", freeRam());
 }
@@ -104,11 +185,17 @@ void animation_default_animation_stop()
 
 uint8_t key_was_pressed(uint8_t key_row, uint8_t key_col)
 {
+    if (!key_pressed_count)
+        return 0;
+
     return key_pressed_count[key_row * MATRIX_COLS + key_col];
 }
 
 void animation_default_typematrix_row(uint8_t row_number, matrix_row_t row)
 {
+    if (!key_pressed_count)
+        return;
+
     for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
     {
         if ((row & ((matrix_row_t)1 << key_col)))
@@ -118,26 +205,64 @@ void animation_default_typematrix_row(uint8_t row_number, matrix_row_t row)
 
 void draw_keymatrix_rgb_pixel(IS31FL3733_91TKL *device_91tkl, int16_t key_row, int16_t key_col, RGB color)
 {
-    uint8_t row;
-    uint8_t col;
-    uint8_t device_number;
-    IS31FL3733_RGB *device;
-
     if (key_col < 0 || key_col >= MATRIX_COLS)
         return;
     if (key_row < 0 || key_row >= MATRIX_ROWS)
         return;
 
-    if (getLedPosByMatrixKey(key_row, key_col, &device_number, &row, &col))
+    uint8_t *pwm = key_pwm(key_row, key_col);
+    if (pwm)
+        set_key_pwm(pwm, color);
+}
+
+bool read_keymatrix_rgb_pixel(IS31FL3733_91TKL *device_91tkl, int16_t key_row, int16_t key_col, RGB *color)
+{
+    if (key_col < 0 || key_col >= MATRIX_COLS)
+        return false;
+    if (key_row < 0 || key_row >= MATRIX_ROWS)
+        return false;
+
+    uint8_t *pwm = key_pwm(key_row, key_col);
+    if (!pwm)
+        return false;
+
+    color->r = pwm[pwm_channel_offset[0]];
+    color->g = pwm[pwm_channel_offset[1]];
+    color->b = pwm[pwm_channel_offset[2]];
+    return true;
+}
+
+void draw_keymatrix_row(IS31FL3733_91TKL *device_91tkl, uint8_t key_row, RGB const *colors)
+{
+    for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
     {
-        device = DEVICE_BY_NUMBER(issi, device_number);
-        is31fl3733_rgb_set_pwm(device, col, row, color);
+        uint8_t *pwm = key_pwm(key_row, key_col);
+        if (pwm)
+            set_key_pwm(pwm, colors[key_col]);
+    }
+}
+
+void fill_keys_by_mask(IS31FL3733_91TKL *device_91tkl, matrix_row_t const *mask, RGB color)
+{
+    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
+    {
+        matrix_row_t row = mask[key_row];
+
+        for (uint8_t key_col = 0; row; ++key_col, row >>= 1)
+        {
+            if (!(row & 1))
+                continue;
+
+            uint8_t *pwm = key_pwm(key_row, key_col);
+            if (pwm)
+                set_key_pwm(pwm, color);
+        }
     }
 }
 
 void draw_keymatrix_hsv_pixel(IS31FL3733_91TKL *device_91tkl, int16_t key_row, int16_t key_col, HSV color)
 {
-    RGB color_rgb = hsv_to_rgb(color);
+    RGB color_rgb = hsv_to_rgb_rainbow(color);
     draw_keymatrix_rgb_pixel(device_91tkl, key_row, key_col, color_rgb);
 
 #if 0
@@ -159,6 +284,22 @@ void draw_keymatrix_hsv_pixel(IS31FL3733_91TKL *device_91tkl, int16_t key_row, i
 #endif
 }
 
+void draw_keymatrix_hsv_row(IS31FL3733_91TKL *device_91tkl, uint8_t key_row, HSV const *colors)
+{
+    RGB colors_rgb[MATRIX_COLS];
+
+    hsv_to_rgb_rainbow_array(colors, colors_rgb, MATRIX_COLS);
+    draw_keymatrix_row(device_91tkl, key_row, colors_rgb);
+}
+
+void draw_keymatrix_spectrum_row(IS31FL3733_91TKL *device_91tkl, uint8_t key_row, HSV const *colors)
+{
+    RGB colors_rgb[MATRIX_COLS];
+
+    hsv_to_rgb_spectrum_array(colors, colors_rgb, MATRIX_COLS);
+    draw_keymatrix_row(device_91tkl, key_row, colors_rgb);
+}
+
 void draw_direct_keymatrix_rgb_pixel(IS31FL3733_91TKL *device_91tkl, int16_t key_row, int16_t key_col, RGB color)
 {
     uint8_t row;
@@ -181,6 +322,6 @@ void draw_direct_keymatrix_rgb_pixel(IS31FL3733_91TKL *device_91tkl, int16_t key
 
 void draw_direct_keymatrix_hsv_pixel(IS31FL3733_91TKL *device_91tkl, int16_t key_row, int16_t key_col, HSV color)
 {
-    RGB color_rgb = hsv_to_rgb(color);
+    RGB color_rgb = hsv_to_rgb_rainbow(color);
     draw_direct_keymatrix_rgb_pixel(device_91tkl, key_row, key_col, color_rgb);
 }
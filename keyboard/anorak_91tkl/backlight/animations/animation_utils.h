@@ -3,6 +3,7 @@
 
 #include "matrix.h"
 #include "../issi/is31fl3733_91tkl.h"
+#include "led_matrix/led_matrix_event.h"
 #include <inttypes.h>
 #include <stdbool.h>
 
@@ -26,6 +27,12 @@ struct _animation_interface
     uint16_t loop_timer;
     uint32_t duration_timer;
 
+    // set by animate() before animationLoop: the time since the last frame and the number of
+    // delay_in_ms periods it covers, 1 if the frame is on time. Animations advance by frame_steps
+    // so they keep their speed when frames are skipped.
+    uint16_t elapsed_in_ms;
+    uint8_t frame_steps;
+
     bool is_running;
     bool is_suspended;
 
@@ -33,13 +40,21 @@ struct _animation_interface
     void (*animationStop)(void);
     void (*animationLoop)(void);
     void (*animation_typematrix_row)(uint8_t row_number, matrix_row_t row);
+    // optional: one call per key press or release, preferred over animation_typematrix_row
+    void (*animation_key_event)(led_matrix_key_event const *event);
+
+    // optional: draw one key row, the frame is then drawn in slices over several calls of animate(),
+    // animationLoop only prepares the frame
+    void (*animationRow)(uint8_t key_row);
 };
 
 typedef struct _animation_interface animation_interface;
 
 extern animation_interface animation;
 
-void animation_prepare(bool set_all_to_black);
+// saves the leds to the arena, false if the arena is taken: the leds are left alone then
+bool animation_prepare(bool set_all_to_black);
+bool animation_is_prepared(void);
 void animation_postpare(void);
 
 void animation_default_animation_start(void);
@@ -50,8 +65,23 @@ void animation_default_typematrix_row(uint8_t row_number, matrix_row_t row);
 
 uint8_t key_was_pressed(uint8_t key_row, uint8_t key_col);
 
+// build the key to PWM buffer lookup used by all draw_keymatrix functions
+void animation_init_key_pwm_lookup(void);
+// upload the chips whose last key row was just drawn, used by sliced animations
+void animation_upload_after_row(uint8_t key_row);
+
 void draw_keymatrix_rgb_pixel(IS31FL3733_91TKL *device_91tkl, int16_t row, int16_t col, RGB color);
+// read back the color of a key, false if the key has no LED
+bool read_keymatrix_rgb_pixel(IS31FL3733_91TKL *device_91tkl, int16_t row, int16_t col, RGB *color);
+// draw a whole key row, colors holds MATRIX_COLS values
+void draw_keymatrix_row(IS31FL3733_91TKL *device_91tkl, uint8_t row, RGB const *colors);
+// set all keys with a bit set in mask (MATRIX_ROWS rows) to color
+void fill_keys_by_mask(IS31FL3733_91TKL *device_91tkl, matrix_row_t const *mask, RGB color);
 void draw_keymatrix_hsv_pixel(IS31FL3733_91TKL *device_91tkl, int16_t row, int16_t col, HSV color);
+// draw a whole key row, colors holds MATRIX_COLS values
+void draw_keymatrix_hsv_row(IS31FL3733_91TKL *device_91tkl, uint8_t row, HSV const *colors);
+// like draw_keymatrix_hsv_row with the spectrum conversion, the brightness stays the same over all hues
+void draw_keymatrix_spectrum_row(IS31FL3733_91TKL *device_91tkl, uint8_t row, HSV const *colors);
 
 void draw_direct_keymatrix_rgb_pixel(IS31FL3733_91TKL *device_91tkl, int16_t row, int16_t col, RGB color);
 void draw_direct_keymatrix_hsv_pixel(IS31FL3733_91TKL *device_91tkl, int16_t row, int16_t col, HSV color);
@@ -3,6 +3,7 @@
 #include "animation_utils.h"
 #include "config.h"
 #include "matrix.h"
+#include "../issi/is31fl3733_91tkl.h"
 
 #ifdef DEBUG_ANIMATION
 #include "debug.h"
@@ -10,13 +11,18 @@
 #include "nodebug.h"
 #endif
 
-uint8_t animation_frame;
+/*
+ * The breathing is done completely by the auto breath engine (ABM-1) of the
+ * IS31FL3733 chips: the frame is uploaded once on start and the chips fade
+ * it in and out on their own. There is no animation loop, so an idle
+ * breathing keyboard costs neither MCU time nor I2C bandwidth.
+ */
 
 void set_animation_breathing()
 {
 	dprintf("breathing\r\n");
 
-    animation.delay_in_ms = 50;
+    animation.delay_in_ms = 400;
     animation.duration_in_ms = 0;
 
     animation.animationStart = &breathing_animation_start;
@@ -27,33 +33,45 @@ void set_animation_breathing()
 
 void breathing_animation_start()
 {
-    animation_frame = 1;
-
-    animation_prepare(true);
-
-    /*TODO: implement
-    issi.setAutoFramePlayConfig(0, 1, 40);
-    issi.setAutoFramePlayMode(0);
-    issi.setBreathConfig(7, 7, 2);
-    issi.setBreathMode(true);
-    */
-
-    /*
-    issi.enableLed(0, 1, animation_frame);
-    issi.setLedBrightness(14, 255, animation_frame);
-    issi.setAutoFramePlayConfig(0,1,40);
-    issi.setAutoFramePlayMode(animation_frame);
-    issi.setBreathConfig(7, 7, 2);
-    issi.setBreathMode(1);
-    */
+    if (!animation_prepare(true))
+        return;
+
+    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
+    {
+        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
+        {
+            draw_keymatrix_rgb_pixel(&issi, key_row, key_col, animation.rgb);
+        }
+    }
+
+    is31fl3733_91tkl_update_led_pwm(&issi);
+
+    breathing_animation_update_speed();
+}
+
+void breathing_animation_update_speed()
+{
+    // map the animation speed to the fade times: 0.21s .. 26.88s
+    uint8_t fade = animation.delay_in_ms / 128;
+    if (fade > 7)
+        fade = 7;
+
+    IS31FL3733_ABM abm = {
+        .t1 = (IS31FL3733_ABM_T1)(fade << 5),
+        .t2 = IS31FL3733_ABM_T2_210MS,
+        .t3 = (IS31FL3733_ABM_T3)(fade << 5),
+        .t4 = IS31FL3733_ABM_T4_420MS,
+        .loop_begin = IS31FL3733_ABM_LOOP_BEGIN_T1,
+        .loop_end = IS31FL3733_ABM_LOOP_END_T3,
+        .loop_times = IS31FL3733_ABM_LOOP_FOREVER
+    };
+
+    is31fl3733_91tkl_start_auto_breath(&issi, &abm);
 }
 
 void breathing_animation_stop()
 {
-	/*TODO: implement
-    issi.setBreathMode(false);
-    issi.setPictureMode();
-    */
+    is31fl3733_91tkl_stop_auto_breath(&issi);
 
     animation_postpare();
 }
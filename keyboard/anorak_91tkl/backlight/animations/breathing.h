@@ -6,5 +6,7 @@ void set_animation_breathing(void);
 
 void breathing_animation_start(void);
 void breathing_animation_stop(void);
+// restarts the auto breath engines with the timing of animation.delay_in_ms
+void breathing_animation_update_speed(void);
 
 #endif /* KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_ANIMATIONS_BREATHING_H_ */
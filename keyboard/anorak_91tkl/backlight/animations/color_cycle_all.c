@@ -31,7 +31,7 @@ void color_cycle_all_animation_loop(void)
 
     is31fl3733_91tkl_update_led_pwm(&issi);
 
-    offset++;
+    offset += animation.frame_steps;
 }
 
 void set_animation_color_cycle_all()
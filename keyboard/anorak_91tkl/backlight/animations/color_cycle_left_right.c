@@ -18,6 +18,7 @@ static uint8_t offset2;
 void color_cycle_left_right_animation_loop(void)
 {
 	HSV hsv = {.h = 0, .s = animation.hsv.s, .v = animation.hsv.v};
+    HSV row[MATRIX_COLS];
 
     for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
     {
@@ -26,13 +27,15 @@ void color_cycle_left_right_animation_loop(void)
         	offset2 = key_was_pressed(key_row, key_col) << 2;
         	// Relies on hue being 8-bit and wrapping
             hsv.h = key_col + offset + offset2;
-            draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv);
+            row[key_col] = hsv;
         }
+
+        draw_keymatrix_hsv_row(&issi, key_row, row);
     }
 
     is31fl3733_91tkl_update_led_pwm(&issi);
 
-    offset++;
+    offset += animation.frame_steps;
 }
 
 void set_animation_color_cycle_left_right()
@@ -2,7 +2,7 @@
 #include "color_cycle_radial_1.h"
 #include "../key_led_map.h"
 #include "animation_utils.h"
-#include "map_led_to_point_polar.h"
+#include "animation_lut.h"
 #include "timer.h"
 #include "config.h"
 #include <stdlib.h>
@@ -17,25 +17,26 @@ static uint8_t offset;
 
 void color_cycle_radial_1_animation_loop(void)
 {
-	uint8_t row;
-	uint8_t col;
-	HSV hsv = {.h = 0, .s = 255, .v = animation.hsv.v};
+    // the rows of this frame are drawn with the new offset
+    offset += animation.frame_steps;
+}
+
+void color_cycle_radial_1_animation_row(uint8_t key_row)
+{
+	key_layout_polar polar[MATRIX_COLS];
+	HSV hsv[MATRIX_COLS];
 
-    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
+    memcpy_P(polar, key_layout_polar_center[key_row], sizeof(polar));
+
+    for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
     {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-        {
-        	map_led_to_point_polar( key_row * MATRIX_COLS + key_col, &row, &col );
-        	// Relies on hue being 8-bit and wrapping
-            hsv.h = col + offset;
-            hsv.s = row;
-            draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv);
-        }
+    	// Relies on hue being 8-bit and wrapping
+        hsv[key_col].h = polar[key_col].angle + offset;
+        hsv[key_col].s = polar[key_col].distance;
+        hsv[key_col].v = animation.hsv.v;
     }
 
-    is31fl3733_91tkl_update_led_pwm(&issi);
-
-    offset++;
+    draw_keymatrix_hsv_row(&issi, key_row, hsv);
 }
 
 void set_animation_color_cycle_radial_1()
@@ -50,6 +51,7 @@ void set_animation_color_cycle_radial_1()
     animation.animationStart = &animation_default_animation_start_clear;
     animation.animationStop = &animation_default_animation_stop;
     animation.animationLoop = &color_cycle_radial_1_animation_loop;
+    animation.animationRow = &color_cycle_radial_1_animation_row;
     animation.animation_typematrix_row = 0;
 }
 
@@ -18,20 +18,24 @@ static uint8_t offset2;
 void color_cycle_up_down_animation_loop(void)
 {
 	HSV hsv = {.h = 0, .s = 255, .v = animation.hsv.v};
+    HSV row[MATRIX_COLS];
 
     for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
     {
         for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
         {
         	offset2 = key_was_pressed(key_row, key_col) << 2;
+        	// Relies on hue being 8-bit and wrapping
             hsv.h = key_row + offset + offset2;
-            draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv);
+            row[key_col] = hsv;
         }
+
+        draw_keymatrix_hsv_row(&issi, key_row, row);
     }
 
     is31fl3733_91tkl_update_led_pwm(&issi);
 
-    offset++;
+    offset += animation.frame_steps;
 }
 
 void set_animation_color_cycle_up_down()
@@ -16,6 +16,9 @@ static uint8_t offset = 0;
 static int8_t direction = 1;
 static bool updown = true;
 
+static int16_t delta_h_row;
+static int16_t delta_h_col;
+
 void color_wave_animation_loop(void)
 {
     int16_t h1 = animation.hsv.h;
@@ -32,32 +35,33 @@ void color_wave_animation_loop(void)
         deltaH += 256;
     }
 
-    int16_t deltaHr = deltaH / MATRIX_ROWS;
+    delta_h_row = deltaH / MATRIX_ROWS;
 
     // Divide delta by MATRIX_COLS, this gives the delta per col
-    deltaH /= MATRIX_COLS;
-
-    HSV hsv = { .h = animation.hsv.h, .s = 255, .v = animation.hsv.v};
-    //HSV hsv = {animation.hsv.h, 255, animation.hsv.v};
+    delta_h_col = deltaH / MATRIX_COLS;
 
-    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
-    {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-        {
-            // Relies on hue being 8-bit and wrapping
+    // the rows of this frame are drawn with the new offset
+    offset += direction * animation.frame_steps;
+}
 
-            if (updown)
-                hsv.h = animation.hsv.h + (deltaHr * key_row) + offset;
-            else
-                hsv.h = animation.hsv.h + (deltaH * key_col) + offset;
+void color_wave_animation_row(uint8_t key_row)
+{
+    HSV hsv[MATRIX_COLS];
 
-            draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv);
-        }
+    for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
+    {
+        // Relies on hue being 8-bit and wrapping
+        if (updown)
+            hsv[key_col].h = animation.hsv.h + (delta_h_row * key_row) + offset;
+        else
+            hsv[key_col].h = animation.hsv.h + (delta_h_col * key_col) + offset;
+
+        hsv[key_col].s = 255;
+        hsv[key_col].v = animation.hsv.v;
     }
 
-    is31fl3733_91tkl_update_led_pwm(&issi);
-
-    offset += direction;
+    // the wave runs through all hues, the spectrum keeps the brightness of the keys even
+    draw_keymatrix_spectrum_row(&issi, key_row, hsv);
 }
 
 void color_wave_typematrix_row(uint8_t row_number, matrix_row_t row)
@@ -80,5 +84,6 @@ void set_animation_color_wave()
     animation.animationStart = &animation_default_animation_start_clear;
     animation.animationStop = &animation_default_animation_stop;
     animation.animationLoop = &color_wave_animation_loop;
+    animation.animationRow = &color_wave_animation_row;
     animation.animation_typematrix_row = &color_wave_typematrix_row;
 }
@@ -2,6 +2,8 @@
 #include "conway.h"
 #include "../key_led_map.h"
 #include "animation_utils.h"
+#include "animation_arena.h"
+#include "led_matrix/conway_rows.h"
 #include "utils.h"
 #include "config.h"
 #include <stdlib.h>
@@ -15,126 +17,58 @@
 
 #define MCPOS(row, col) (row * MATRIX_COLS + col)
 
-static uint8_t *cells[2] = {0, 0};
+/*
+ * The board is a torus of MATRIX_ROWS x MATRIX_COLS cells, one bit per cell.
+ * generation[0] is the current generation, [1] the next, [2] the one before
+ * the current: a board matching it is in a period 2 cycle (blinkers).
+ */
+static matrix_row_t *generation[3] = {0, 0, 0};
 static uint8_t *cell_colors = 0;
 static uint8_t cycle = 0;
-static uint8_t cells_changed = 0;
-
-void conway_init_cells(void)
-{
-    dprintf("cycle %u", cycle);
-
-    HSV hsv;
-    hsv.h = animation.hsv.h + cycle;
-    hsv.s = animation.hsv.s;
-    hsv.v = animation.hsv.v;
-
-    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
-    {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-        {
-            bool draw = rand() % 7 ? false : true;
-            cells[0][MCPOS(key_row, key_col)] = draw;
-            cells[1][MCPOS(key_row, key_col)] = 0;
-            draw_keymatrix_hsv_pixel(&issi, key_row, key_col, draw ? hsv : hsv_black);
-        }
-    }
-
-    /*
-    cells[0][MCPOS(3, 5)] = 1;
-    cells[0][MCPOS(3, 6)] = 1;
-    cells[0][MCPOS(3, 7)] = 1;
 
-    draw_keymatrix_hsv_pixel(&issi, 3, 5, hsv);
-    draw_keymatrix_hsv_pixel(&issi, 3, 6, hsv);
-    draw_keymatrix_hsv_pixel(&issi, 3, 7, hsv);
-    */
-
-    cycle += 4;
-}
+ANIMATION_ARENA_BUDGET(conway, 3 * MATRIX_ROWS * sizeof(matrix_row_t) + MATRIX_ROWS * MATRIX_COLS * sizeof(uint8_t));
+static uint8_t cells_changed = 0;
 
-void conway_animation_loop(void)
+/*
+ * Compute generation[1] from generation[0] and advance.
+ * Counts the changed cells into cells_changed and returns true while the
+ * board is neither still nor blinking, all in the same pass.
+ */
+static bool conway_step(void)
 {
-    int rm, rp, cm, cp, nsum;
-    bool unchanged = true;
-
-    HSV hsv;
-    hsv.h = animation.hsv.h + cycle;
-    hsv.s = animation.hsv.s;
-    hsv.v = animation.hsv.v;
+    matrix_row_t *current = generation[0];
+    matrix_row_t *next = generation[1];
+    matrix_row_t *before = generation[2];
+    bool period_1 = true;
+    bool period_2 = true;
 
     cells_changed = 0;
 
     for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
     {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-        {
-            rm = (0 == key_row) ? (MATRIX_ROWS - 1) : (key_row - 1);
-            rp = ((MATRIX_ROWS - 1) == key_row) ? 0 : (key_row + 1);
-            cm = (0 == key_col) ? (MATRIX_COLS - 1) : (key_col - 1);
-            cp = ((MATRIX_COLS - 1) == key_col) ? 0 : (key_col + 1);
-
-            nsum = cells[0][MCPOS(rm, cm)] + cells[0][MCPOS(rm, key_col)] + cells[0][MCPOS(rm, cp)] +
-                   cells[0][MCPOS(key_row, cm)] + cells[0][MCPOS(key_row, cp)] + cells[0][MCPOS(rp, cm)] +
-                   cells[0][MCPOS(rp, key_col)] + cells[0][MCPOS(rp, cp)];
-
-            /*
-            dprintf("row %d", key_row);
-            dprintf("col %d", key_col);
-            dprintf("rm %d", rm);
-            dprintf("rp %d", rp);
-            dprintf("cm %d", cm);
-            dprintf("cp %d", cp);
-
-            dprintf("rm cm %d", cells[0][MCPOS(rm, cm)]);
-            dprintf("rm c  %d", cells[0][MCPOS(rm, key_col)]);
-            dprintf("rm cp %d", cells[0][MCPOS(rm, cp)]);
-            dprintf("r  cm %d", cells[0][MCPOS(key_row, cm)]);
-            dprintf("r  cp %d", cells[0][MCPOS(key_row, cp)]);
-            dprintf("rp cm %d", cells[0][MCPOS(rp, cm)]);
-            dprintf("rp c  %d", cells[0][MCPOS(rp, key_col)]);
-            dprintf("rp cp %d", cells[0][MCPOS(rp, cp)]);
-            dprintf("nsum %d", nsum);
-            */
-
-            switch (nsum)
-            {
-
-            case 3:
-                cells[1][MCPOS(key_row, key_col)] = 1;
-                draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv);
-                break;
+        uint8_t rm = (0 == key_row) ? (MATRIX_ROWS - 1) : (key_row - 1);
+        uint8_t rp = ((MATRIX_ROWS - 1) == key_row) ? 0 : (key_row + 1);
 
-            case 2:
-                draw_keymatrix_hsv_pixel(&issi, key_row, key_col,
-                                         (cells[0][MCPOS(key_row, key_col)]) ? hsv : hsv_black);
-
-                cells[1][MCPOS(key_row, key_col)] = cells[0][MCPOS(key_row, key_col)];
-                break;
-
-            default:
-                draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv_black);
-                cells[1][MCPOS(key_row, key_col)] = 0;
-            }
+        next[key_row] = conway_next_row(current[rm], current[key_row], current[rp]);
 
-            cells_changed += abs(cells[1][MCPOS(key_row, key_col)] - cells[0][MCPOS(key_row, key_col)]);
+        matrix_row_t changed = next[key_row] ^ current[key_row];
+        cells_changed += conway_count_bits(changed);
 
-            if (cells[1][MCPOS(key_row, key_col)] != cells[0][MCPOS(key_row, key_col)])
-                unchanged = false;
-        }
+        if (changed)
+            period_1 = false;
+        if (next[key_row] != before[key_row])
+            period_2 = false;
     }
 
-    // dprintf("cells changed %u", cells_changed);
-
-    memcpy(cells[0], cells[1], MATRIX_ROWS * MATRIX_COLS * sizeof(uint8_t));
+    // rotate: the current generation becomes the one before
+    generation[0] = next;
+    generation[1] = before;
+    generation[2] = current;
 
-    if (unchanged)
-        conway_init_cells();
-
-    is31fl3733_91tkl_update_led_pwm(&issi);
+    return !period_1 && !period_2;
 }
 
-void conway_rgb_init_cells(void)
+static void conway_rgb_init_cells(void)
 {
     dprintf("cycle %u", cycle);
 
@@ -142,93 +76,62 @@ void conway_rgb_init_cells(void)
 
     for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
     {
+        matrix_row_t cells = 0;
+
         for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
         {
             bool draw = rand() % 7 ? false : true;
-            cells[0][MCPOS(key_row, key_col)] = draw;
-            cells[1][MCPOS(key_row, key_col)] = 0;
+            if (draw)
+                cells |= ((matrix_row_t)1 << key_col);
             cell_colors[MCPOS(key_row, key_col)] = animation.hsv.h;
             draw_keymatrix_hsv_pixel(&issi, key_row, key_col, draw ? animation.hsv : hsv_black);
         }
+
+        generation[0][key_row] = cells;
+        generation[2][key_row] = 0;
     }
 }
 
 void conway_rgb_animation_loop(void)
 {
     HSV hsv;
-    int rm, rp, cm, cp, nsum;
-    bool unchanged = true;
 
-    cells_changed = 0;
+    if (!conway_step())
+    {
+        conway_rgb_init_cells();
+        is31fl3733_91tkl_update_led_pwm(&issi);
+        return;
+    }
+
+    hsv.s = animation.hsv.s;
+    hsv.v = animation.hsv.v;
 
+    // only cells born or died this generation need to be drawn, survivors keep their color
     for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
     {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-        {
-            rm = (0 == key_row) ? (MATRIX_ROWS - 1) : (key_row - 1);
-            rp = ((MATRIX_ROWS - 1) == key_row) ? 0 : (key_row + 1);
-            cm = (0 == key_col) ? (MATRIX_COLS - 1) : (key_col - 1);
-            cp = ((MATRIX_COLS - 1) == key_col) ? 0 : (key_col + 1);
+        matrix_row_t alive = generation[0][key_row];
+        matrix_row_t changed = alive ^ generation[2][key_row];
 
-            nsum = cells[0][MCPOS(rm, cm)] + cells[0][MCPOS(rm, key_col)] + cells[0][MCPOS(rm, cp)] +
-                   cells[0][MCPOS(key_row, cm)] + cells[0][MCPOS(key_row, cp)] + cells[0][MCPOS(rp, cm)] +
-                   cells[0][MCPOS(rp, key_col)] + cells[0][MCPOS(rp, cp)];
+        for (uint8_t key_col = 0; changed; ++key_col, changed >>= 1, alive >>= 1)
+        {
+            if (!(changed & 1))
+                continue;
 
-            switch (nsum)
+            if (alive & 1)
             {
-
-            case 3:
-                if (cells[0][MCPOS(key_row, key_col)] == 0)
-                {
-                    cell_colors[MCPOS(key_row, key_col)] = animation.hsv.h + cycle;
-                }
-
-                cells[1][MCPOS(key_row, key_col)] = 1;
+                cell_colors[MCPOS(key_row, key_col)] = animation.hsv.h + cycle;
 
                 hsv.h = cell_colors[MCPOS(key_row, key_col)];
-                hsv.s = animation.hsv.s;
-                hsv.v = animation.hsv.v;
-
                 draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv);
-                break;
-
-            case 2:
-                if (cells[0][MCPOS(key_row, key_col)])
-                {
-                    hsv.h = cell_colors[MCPOS(key_row, key_col)];
-                    hsv.s = animation.hsv.s;
-                    hsv.v = animation.hsv.v;
-
-                    draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv);
-                }
-                else
-                {
-                    draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv_black);
-                }
-
-                cells[1][MCPOS(key_row, key_col)] = cells[0][MCPOS(key_row, key_col)];
-                break;
-
-            default:
-                draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv_black);
-                cells[1][MCPOS(key_row, key_col)] = 0;
+            }
+            else
+            {
                 cell_colors[MCPOS(key_row, key_col)] = animation.hsv.h;
+                draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv_black);
             }
-
-            cells_changed += abs(cells[1][MCPOS(key_row, key_col)] - cells[0][MCPOS(key_row, key_col)]);
-
-            if (cells[1][MCPOS(key_row, key_col)] != cells[0][MCPOS(key_row, key_col)])
-                unchanged = false;
         }
     }
 
-    // dprintf("cells changed %u", cells_changed);
-
-    memcpy(cells[0], cells[1], MATRIX_ROWS * MATRIX_COLS * sizeof(uint8_t));
-
-    if (unchanged)
-        conway_rgb_init_cells();
-
     is31fl3733_91tkl_update_led_pwm(&issi);
 
     cycle++;
@@ -237,15 +140,22 @@ void conway_rgb_animation_loop(void)
 void conway_typematrix_row(uint8_t row_number, matrix_row_t row)
 {
     if (cells_changed < 5)
-        conway_init_cells();
+        conway_rgb_init_cells();
 }
 
 void conway_animation_start(void)
 {
-    animation_prepare(true);
-    cells[0] = (uint8_t *)calloc(MATRIX_ROWS * MATRIX_COLS, sizeof(uint8_t));
-    cells[1] = (uint8_t *)calloc(MATRIX_ROWS * MATRIX_COLS, sizeof(uint8_t));
-    cell_colors = (uint8_t *)calloc(MATRIX_ROWS * MATRIX_COLS, sizeof(uint8_t));
+    if (!animation_prepare(true))
+        return;
+    for (uint8_t i = 0; i < 3; ++i)
+        generation[i] = (matrix_row_t *)animation_arena_alloc(MATRIX_ROWS * sizeof(matrix_row_t));
+    cell_colors = (uint8_t *)animation_arena_alloc(MATRIX_ROWS * MATRIX_COLS * sizeof(uint8_t));
+    // the last allocation fails first, start_animation() does not run an animation that is not prepared
+    if (!cell_colors)
+    {
+        animation_postpare();
+        return;
+    }
     cycle = animation.hsv.h;
     conway_rgb_init_cells();
     is31fl3733_91tkl_update_led_pwm(&issi);
@@ -254,9 +164,6 @@ void conway_animation_start(void)
 void conway_animation_stop(void)
 {
     animation_postpare();
-    free(cells[0]);
-    free(cells[1]);
-    free(cell_colors);
 }
 
 void set_animation_conway()
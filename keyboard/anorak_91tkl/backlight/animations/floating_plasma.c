@@ -4,9 +4,9 @@
 #ifdef ANIMATION_ENABLE_FLOATING_PLASMA
 
 #include "animation_utils.h"
+#include "animation_arena.h"
 #include "utils.h"
-#include "sinus_lut.h"
-#include "plasma_color_lut.h"
+#include "animation_lut.h"
 #include "../key_led_map.h"
 #include "config.h"
 #include <stdlib.h>
@@ -20,60 +20,64 @@
 static animation_options plasma_option = animation_option_variant_2;
 static uint16_t plasmacounter = 0;
 
-void floating_plasma_animation_loop(void)
-{
-    uint16_t color;
-    RGB rgb;
+// sin_lut[temp4] of every key, temp4 depends on the position only
+static uint16_t *sin_temp4 = 0;
+
+ANIMATION_ARENA_BUDGET(floating_plasma, MATRIX_ROWS * MATRIX_COLS * sizeof(uint16_t));
 
+static void floating_plasma_init_position_terms(void)
+{
     for (uint8_t y = 0; y < MATRIX_ROWS; ++y)
     {
         for (uint8_t x = 0; x < MATRIX_COLS; ++x)
         {
-            uint8_t temp1 = (x << 4) + plasmacounter;
-            uint8_t temp2 = (y << 5) + plasmacounter;
-            uint8_t temp3 = ((x << 4) + (y << 4)) + (plasmacounter >> 1);
             uint8_t temp4 = (((x * x) << 3) + ((y * y) << 3)) / (x + y + 1);
+            sin_temp4[y * MATRIX_COLS + x] = pgm_read_word(&sin_lut[temp4]);
+        }
+    }
+}
+
+void floating_plasma_animation_loop(void)
+{
+    // the rows of this frame are drawn with the new counter
+    plasmacounter += animation.frame_steps;
+}
+
+void floating_plasma_animation_row(uint8_t y)
+{
+    uint16_t color;
+    RGB rgb[MATRIX_COLS];
 
-            color = pgm_read_word(&sin_lut[temp1]);
-            color += pgm_read_word(&sin_lut[temp2]);
-            color += pgm_read_word(&sin_lut[temp3]);
-            color += pgm_read_word(&sin_lut[temp4]);
-
-            if (plasma_option | animation_option_variant_1)
-            {
-                color = ((color >> 4) + plasmacounter) % (256 * 3);
-
-                /*
-                color = (((pgm_read_word(&sin_lut[temp1]) + pgm_read_word(&sin_lut[temp2]) +
-                           pgm_read_word(&sin_lut[temp3]) + pgm_read_word(&sin_lut[temp4])) >>
-                          4) +
-                         plasmacounter) %
-                        256 * 3;
-                        */
-            }
-            else
-            {
-                color += (plasmacounter << 2);
-                color = (color >> 4) % (256 * 3);
-
-                /*
-                color = (((pgm_read_word(&sin_lut[temp1]) + pgm_read_word(&sin_lut[temp2]) +
-                           pgm_read_word(&sin_lut[temp3]) + pgm_read_word(&sin_lut[temp4]) + (plasmacounter << 2)) >>
-                          4)) %
-                        (256 * 3);
-                                */
-            }
-
-            rgb.r = pgm_read_byte(&PlasmaColorSpace[color * 3]);
-            rgb.g = pgm_read_byte(&PlasmaColorSpace[color * 3 + 1]);
-            rgb.b = pgm_read_byte(&PlasmaColorSpace[color * 3 + 2]);
-
-            draw_keymatrix_rgb_pixel(&issi, y, x, rgb);
+    uint8_t temp2 = (y << 5) + plasmacounter;
+    uint16_t row_color = pgm_read_word(&sin_lut[temp2]);
+    uint16_t const *position_color = sin_temp4 + y * MATRIX_COLS;
+
+    for (uint8_t x = 0; x < MATRIX_COLS; ++x)
+    {
+        uint8_t temp1 = (x << 4) + plasmacounter;
+        uint8_t temp3 = ((x << 4) + (y << 4)) + (plasmacounter >> 1);
+
+        color = pgm_read_word(&sin_lut[temp1]);
+        color += row_color;
+        color += pgm_read_word(&sin_lut[temp3]);
+        color += position_color[x];
+
+        if (plasma_option | animation_option_variant_1)
+        {
+            color = ((color >> 4) + plasmacounter) % (256 * 3);
         }
+        else
+        {
+            color += (plasmacounter << 2);
+            color = (color >> 4) % (256 * 3);
+        }
+
+        rgb[x].r = pgm_read_byte(&PlasmaColorSpace[color * 3]);
+        rgb[x].g = pgm_read_byte(&PlasmaColorSpace[color * 3 + 1]);
+        rgb[x].b = pgm_read_byte(&PlasmaColorSpace[color * 3 + 2]);
     }
 
-    is31fl3733_91tkl_update_led_pwm(&issi);
-    plasmacounter++;
+    draw_keymatrix_row(&issi, y, rgb);
 }
 
 /*
@@ -84,8 +88,18 @@ void floating_plasma_typematrix_row(uint8_t row_number, matrix_row_t row)
 
 void floating_plasma_animation_start(void)
 {
-    animation_prepare(true);
+    if (!animation_prepare(true))
+        return;
     plasmacounter = 0;
+
+    // released by stop_animation()
+    sin_temp4 = (uint16_t *)animation_arena_alloc(MATRIX_ROWS * MATRIX_COLS * sizeof(uint16_t));
+    if (!sin_temp4)
+    {
+        animation_postpare();
+        return;
+    }
+    floating_plasma_init_position_terms();
 }
 
 void floating_plasma_animation_stop(void)
@@ -103,6 +117,7 @@ void set_animation_floating_plasma()
     animation.animationStart = &floating_plasma_animation_start;
     animation.animationStop = &floating_plasma_animation_stop;
     animation.animationLoop = &floating_plasma_animation_loop;
+    animation.animationRow = &floating_plasma_animation_row;
     // animation.animation_typematrix_row = &floating_plasma_typematrix_row;
     animation.animation_typematrix_row = 0;
 }
@@ -31,7 +31,8 @@ void flying_ball_typematrix_row(uint8_t row_number, matrix_row_t row)
 
 void flying_ball_animation_start(void)
 {
-	animation_prepare(true);
+	if (!animation_prepare(true))
+		return;
 
 	hsv.h = animation.hsv.h;
 	hsv.s = animation.hsv.s;
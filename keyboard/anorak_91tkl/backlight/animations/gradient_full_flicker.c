@@ -15,26 +15,26 @@ static uint8_t offset = 0;
 static int8_t leftright = 1;
 
 void gradient_full_flicker_animation_loop(void)
+{
+    // the rows of this frame are drawn with the new offset
+    offset += leftright * animation.frame_steps;
+}
+
+void gradient_full_flicker_animation_row(uint8_t key_row)
 {
     // Divide delta by MATRIX_COLS, this gives the delta per column
     int16_t deltaHc = 256 / MATRIX_COLS;
-    HSV hsv = { .h = 0, .s = 255, .v = animation.hsv.v };
-    //HSV hsv = { 0, 255, animation.hsv.v };
+    HSV hsv[MATRIX_COLS];
 
-    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
+    for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
     {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-        {
-            // Relies on hue being 8-bit and wrapping
-            hsv.h = ( deltaHc * key_col ) + offset;
-            //hsv.s = animation.hsv.s + ( deltaS * key_row );
-            draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv);
-        }
+        // Relies on hue being 8-bit and wrapping
+        hsv[key_col].h = ( deltaHc * key_col ) + offset;
+        hsv[key_col].s = 255;
+        hsv[key_col].v = animation.hsv.v;
     }
 
-    is31fl3733_91tkl_update_led_pwm(&issi);
-
-    offset += leftright;
+    draw_keymatrix_hsv_row(&issi, key_row, hsv);
 }
 
 void gradient_full_flicker_typematrix_row(uint8_t row_number, matrix_row_t row)
@@ -50,11 +50,13 @@ void set_animation_gradient_full_flicker()
 {
     dprintf("gradient_full_flicker\n");
 
-    animation.delay_in_ms = FPS_TO_DELAY(100);
+    // a frame takes about 162000 cycles on the TWI, at 100 fps it would not fit its 10 ms
+    animation.delay_in_ms = FPS_TO_DELAY(50);
     animation.duration_in_ms = 0;
 
     animation.animationStart = &animation_default_animation_start_clear;
     animation.animationStop = &animation_default_animation_stop;
     animation.animationLoop = &gradient_full_flicker_animation_loop;
+    animation.animationRow = &gradient_full_flicker_animation_row;
     animation.animation_typematrix_row = &gradient_full_flicker_typematrix_row;
 }
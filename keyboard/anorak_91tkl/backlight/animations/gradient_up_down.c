@@ -13,6 +13,8 @@
 
 static uint8_t offset = 0;
 
+static int16_t delta_h;
+
 void gradient_up_down_animation_loop(void)
 {
     int16_t h1 = animation.hsv.h;
@@ -29,48 +31,25 @@ void gradient_up_down_animation_loop(void)
         deltaH += 256;
     }
     // Divide delta by MATRIX_ROWS, this gives the delta per row
-    deltaH /= MATRIX_ROWS;
-
-    //int16_t s1 = animation.hsv.s;
-    //int16_t s2 = animation.hsv2.s;
-    //int16_t deltaS = ( s2 - s1 ) / MATRIX_ROWS;
+    delta_h = deltaH / MATRIX_ROWS;
 
-    HSV hsv = { .h = 0, .s = 255, .v = animation.hsv.v };
-    //HSV hsv = { 0, 255, animation.hsv.v };
+    // the rows of this frame are drawn with the new offset
+    offset += animation.frame_steps;
+}
 
-    /*
+void gradient_up_down_animation_row(uint8_t key_row)
+{
+    HSV hsv[MATRIX_COLS];
 
-    Point point;
-    for ( int i=0; i<72; i++ )
+    for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
     {
-        map_led_to_point( i, &point );
-        // The y range will be 0..64, map this to 0..4
-        uint8_t y = (point.y>>4);
         // Relies on hue being 8-bit and wrapping
-        hsv.h = g_config.color_1.h + ( deltaH * y );
-        hsv.s = g_config.color_1.s + ( deltaS * y );
-        rgb = hsv_to_rgb( hsv );
-        backlight_set_color( i, rgb.r, rgb.g, rgb.b );
+        hsv[key_col].h = animation.hsv.h + ( delta_h * key_row ) + offset;
+        hsv[key_col].s = 255;
+        hsv[key_col].v = animation.hsv.v;
     }
 
-    */
-
-    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
-    {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-        {
-            // The y range will be 0..64, map this to 0..4
-            //uint8_t y = ((key_row * key_col) >> 4);
-            // Relies on hue being 8-bit and wrapping
-            hsv.h = animation.hsv.h + ( deltaH * key_row ) + offset;
-            //hsv.s = animation.hsv.s + ( deltaS * key_row );
-            draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv);
-        }
-    }
-
-    is31fl3733_91tkl_update_led_pwm(&issi);
-
-    offset++;
+    draw_keymatrix_hsv_row(&issi, key_row, hsv);
 }
 
 void set_animation_gradient_up_down()
@@ -83,5 +62,6 @@ void set_animation_gradient_up_down()
     animation.animationStart = &animation_default_animation_start_clear;
     animation.animationStop = &animation_default_animation_stop;
     animation.animationLoop = &gradient_up_down_animation_loop;
+    animation.animationRow = &gradient_up_down_animation_row;
     animation.animation_typematrix_row = 0;
 }
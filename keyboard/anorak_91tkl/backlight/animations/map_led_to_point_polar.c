@@ -1,7 +0,0 @@
-
-#include "map_led_to_point_polar.h"
-
-void map_led_to_point_polar(uint8_t index, uint8_t *row, uint8_t *col)
-{
-
-}
@@ -0,0 +1,66 @@
+#include "particle_sys_flame.h"
+#include "animation.h"
+#include "animation_utils.h"
+#include "animation_arena.h"
+#include "../led_surface_91tkl.h"
+#include "led_matrix/led_matrix.h"
+#include "config.h"
+
+#ifdef DEBUG_ANIMATION
+#include "debug.h"
+#else
+#include "nodebug.h"
+#endif
+
+#ifdef ANIMATION_ENABLE_PARTICLE_SYSTEM
+
+// drawn by the board independent flame of tmk_core/common/led_matrix
+
+ANIMATION_ARENA_BUDGET(particle_sys_flame, sizeof(led_matrix_flame_state));
+
+void particle_sys_flame_animation_start(void)
+{
+    if (!animation_prepare(true))
+        return;
+
+    // the memory is released by stop_animation()
+    led_matrix_state = animation_arena_alloc(led_matrix_flame.state_size);
+    if (!led_matrix_state)
+    {
+        animation_postpare();
+        return;
+    }
+    led_matrix_flame.start(led_surface_91tkl());
+}
+
+void particle_sys_flame_animation_stop(void)
+{
+    animation_postpare();
+    led_matrix_state = 0;
+}
+
+void particle_sys_flame_animation_loop(void)
+{
+    led_matrix_flame.loop(led_surface_91tkl());
+}
+
+void particle_sys_flame_key_event(led_matrix_key_event const *event)
+{
+    led_matrix_flame.key_event(led_surface_91tkl(), event);
+}
+
+void set_animation_particle_sys_flame()
+{
+    dprintf("particle_sys_flame\n");
+
+    animation.delay_in_ms = led_matrix_flame.delay_in_ms;
+    animation.duration_in_ms = 0;
+
+    animation.animationStart = &particle_sys_flame_animation_start;
+    animation.animationStop = &particle_sys_flame_animation_stop;
+    animation.animationLoop = &particle_sys_flame_animation_loop;
+    animation.animation_typematrix_row = 0;
+    animation.animation_key_event = &particle_sys_flame_key_event;
+}
+
+#endif
@@ -1,22 +0,0 @@
-
-#include "sinus_lut.h"
-
-#ifdef ANIMATION_ENABLE_FLOATING_PLASMA
-
-const uint16_t sin_lut[256] PROGMEM = {
-    0,    0,    1,    1,    2,    4,    6,    8,    10,   12,   15,   19,   22,   26,   30,   34,   39,   44,   49,
-    55,   60,   66,   73,   79,   86,   93,   101,  108,  116,  124,  132,  141,  150,  159,  168,  177,  187,  197,
-    207,  217,  227,  238,  248,  259,  270,  281,  293,  304,  316,  327,  339,  351,  363,  375,  387,  399,  412,
-    424,  436,  449,  461,  474,  486,  499,  511,  524,  536,  549,  561,  574,  586,  599,  611,  623,  636,  648,
-    660,  672,  684,  695,  707,  719,  730,  741,  753,  764,  774,  785,  796,  806,  816,  826,  836,  846,  855,
-    864,  873,  882,  891,  899,  907,  915,  923,  930,  937,  944,  951,  957,  963,  969,  974,  980,  985,  989,
-    994,  998,  1002, 1005, 1008, 1011, 1014, 1016, 1018, 1020, 1021, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1022,
-    1020, 1019, 1017, 1014, 1012, 1009, 1006, 1002, 999,  995,  990,  986,  981,  976,  970,  964,  958,  952,  945,
-    939,  932,  924,  917,  909,  901,  893,  884,  875,  866,  857,  848,  838,  828,  818,  808,  798,  788,  777,
-    766,  755,  744,  733,  721,  710,  698,  686,  675,  663,  651,  638,  626,  614,  602,  589,  577,  564,  552,
-    539,  527,  514,  502,  489,  477,  464,  452,  439,  427,  414,  402,  390,  378,  366,  354,  342,  330,  318,
-    307,  295,  284,  273,  262,  251,  240,  230,  219,  209,  199,  189,  179,  170,  161,  152,  143,  134,  126,
-    118,  110,  102,  95,   88,   81,   74,   68,   62,   56,   50,   45,   40,   35,   31,   27,   23,   19,   16,
-    13,   10,   8,    6,    4,    3,    2,    1,    0};
-
-#endif
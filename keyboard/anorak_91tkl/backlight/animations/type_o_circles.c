@@ -2,9 +2,12 @@
 #include "type_o_circles.h"
 #include "../key_led_map.h"
 #include "animation_utils.h"
+#include "animation_arena.h"
+#include "animation_lut.h"
 #include "utils.h"
 #include "config.h"
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef DEBUG_ANIMATION
 #include "debug.h"
@@ -13,49 +16,84 @@
 #endif
 
 #define RADIUS_COUNT (MATRIX_COLS)
-static uint8_t *pressed_keys = 0;
+#define TYPE_O_CIRCLES_EFFECTS 16
 
-void draw_circle_outline(IS31FL3733_91TKL *device, int16_t x0, int16_t y0, int16_t r, RGB color)
+// pressed keys with a growing circle, value: remaining radius steps
+static led_matrix_effect_list circles;
+// the last frame had circles, the next one clears them
+static bool circles_drawn;
+
+ANIMATION_ARENA_BUDGET(type_o_circles, TYPE_O_CIRCLES_EFFECTS * sizeof(led_matrix_effect));
+
+// key is row * MATRIX_COLS + col, as in the order tables
+static inline uint8_t center_distance(uint8_t key)
+{
+    return pgm_read_byte(&(&key_layout_polar_center[0][0])[key].distance);
+}
+
+/*
+ * Rings around the key in whole key units of the physical layout, rings[0] is the first ring.
+ *
+ * A key on the rings is no farther from the center of the layout than the key plus the radius,
+ * and no nearer than the key minus the radius. Only that band of key_layout_order_polar_center
+ * is looked at, not every key of the matrix.
+ */
+static void draw_rings(uint8_t key_row, uint8_t key_col, uint8_t ring_count, RGB const *rings)
 {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    draw_keymatrix_rgb_pixel(device, x0, y0 + r, color);
-    draw_keymatrix_rgb_pixel(device, x0, y0 - r, color);
-    draw_keymatrix_rgb_pixel(device, x0 + r, y0, color);
-    draw_keymatrix_rgb_pixel(device, x0 - r, y0, color);
-
-    while (x < y)
+    key_layout_point center;
+    key_layout_point position;
+
+    memcpy_P(&center, &key_layout_position[key_row][key_col], sizeof(center));
+
+    // radius in polar units: the outer ring ends 1 quarter key out, the half key steps of the hypot table
+    // may hide 3 more, and the polar distances are rounded
+    uint8_t distance = center_distance(key_row * MATRIX_COLS + key_col);
+    uint16_t reach = ((uint16_t)ring_count * 4 + 4) * 255 / KEY_LAYOUT_POLAR_CENTER_RANGE + 1;
+    uint8_t nearest = distance > reach ? distance - reach : 0;
+    uint16_t farthest = distance + reach;
+
+    // first key of the band
+    uint8_t first = 0;
+    uint8_t end = KEY_LAYOUT_KEYS;
+    while (first < end)
     {
-        if (f >= 0)
-        {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
+        uint8_t middle = (first + end) >> 1;
+        if (center_distance(pgm_read_byte(&key_layout_order_polar_center[middle])) < nearest)
+            first = middle + 1;
+        else
+            end = middle;
+    }
+
+    for (uint8_t i = first; i < KEY_LAYOUT_KEYS; ++i)
+    {
+        uint8_t key = pgm_read_byte(&key_layout_order_polar_center[i]);
+        if (center_distance(key) > farthest)
+            break;
+
+        memcpy_P(&position, &(&key_layout_position[0][0])[key], sizeof(position));
 
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        draw_keymatrix_rgb_pixel(device, x0 + x, y0 + y, color);
-        draw_keymatrix_rgb_pixel(device, x0 - x, y0 + y, color);
-        draw_keymatrix_rgb_pixel(device, x0 + x, y0 - y, color);
-        draw_keymatrix_rgb_pixel(device, x0 - x, y0 - y, color);
-        draw_keymatrix_rgb_pixel(device, x0 + y, y0 + x, color);
-        draw_keymatrix_rgb_pixel(device, x0 - y, y0 + x, color);
-        draw_keymatrix_rgb_pixel(device, x0 + y, y0 - x, color);
-        draw_keymatrix_rgb_pixel(device, x0 - y, y0 - x, color);
+        uint8_t dx = (position.x > center.x ? position.x - center.x : center.x - position.x) >> 1;
+        uint8_t dy = (position.y > center.y ? position.y - center.y : center.y - position.y) >> 1;
+        // quarter key units, rounded to the ring
+        uint8_t ring = (pgm_read_byte(&key_layout_hypot[dy][dx]) + 2) >> 2;
+
+        if (ring > 0 && ring <= ring_count)
+            draw_keymatrix_rgb_pixel(&issi, key / MATRIX_COLS, key % MATRIX_COLS, rings[ring - 1]);
     }
 }
 
 void type_o_circles_animation_start(void)
 {
-    animation_prepare(true);
-    pressed_keys = (uint8_t *)calloc(MATRIX_ROWS * MATRIX_COLS, sizeof(uint8_t));
+    if (!animation_prepare(true))
+        return;
+    led_matrix_effect *items = (led_matrix_effect *)animation_arena_alloc(TYPE_O_CIRCLES_EFFECTS * sizeof(led_matrix_effect));
+    if (!items)
+    {
+        animation_postpare();
+        return;
+    }
+    led_matrix_effect_init(&circles, items, TYPE_O_CIRCLES_EFFECTS);
+    circles_drawn = false;
 
     dprintf("ram: %d\n", freeRam());
 }
@@ -63,55 +101,62 @@ void type_o_circles_animation_start(void)
 void type_o_circles_animation_stop(void)
 {
     animation_postpare();
-    free(pressed_keys);
 }
 
 void type_o_circles_animation_loop(void)
 {
+    if (circles.count == 0 && !circles_drawn)
+        return;
+    circles_drawn = circles.count > 0;
+
     is31fl3733_fill(issi.upper->device, 0);
     is31fl3733_fill(issi.lower->device, 0);
 
     uint8_t d = animation.hsv.v / RADIUS_COUNT;
 
-    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
+    for (uint8_t i = 0; i < circles.count;)
     {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
+        led_matrix_effect *circle = &circles.items[i];
+        uint8_t key_row = circle->row;
+        uint8_t key_col = circle->col;
+        HSV hsv = {.h = animation.hsv.h, .s = animation.hsv.s, .v = animation.hsv.v};
+        uint8_t endr = RADIUS_COUNT - circle->value;
+        RGB rings[RADIUS_COUNT];
+
+        // the outer ring is the brightest
+        for (uint8_t r = endr; r > 0; r--)
         {
-            if (pressed_keys[key_row * MATRIX_COLS + key_col] > 0)
-            {
-                uint8_t keyr = pressed_keys[key_row * MATRIX_COLS + key_col];
-                HSV hsv = {.h = animation.hsv.h, .s = animation.hsv.s, .v = animation.hsv.v};
-                // HSV hsv = {animation.hsv.h, animation.hsv.s, animation.hsv.v};
-                uint8_t endr = RADIUS_COUNT - keyr;
-
-                for (uint8_t r = endr; r > 0; r--)
-                {
-                    RGB rgb = hsv_to_rgb(hsv);
-                    draw_circle_outline(&issi, key_row, key_col, r, rgb);
-                    hsv.v -= d;
-                }
-
-                uint8_t sat = (uint8_t)((animation.hsv2.s / RADIUS_COUNT) * endr);
-                HSV hsv2 = { .h = animation.hsv2.h, .s = sat, .v = animation.hsv2.v};
-                // HSV hsv2 = {animation.hsv2.h, sat, animation.hsv2.v};
-                draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv2);
-
-                pressed_keys[key_row * MATRIX_COLS + key_col]--;
-            }
+            rings[r - 1] = hsv_to_rgb(hsv);
+            hsv.v -= d;
         }
+        draw_rings(key_row, key_col, endr, rings);
+
+        uint8_t sat = (uint8_t)((animation.hsv2.s / RADIUS_COUNT) * endr);
+        HSV hsv2 = { .h = animation.hsv2.h, .s = sat, .v = animation.hsv2.v};
+        draw_keymatrix_hsv_pixel(&issi, key_row, key_col, hsv2);
+
+        if (circle->value <= animation.frame_steps)
+            circle->value = 0;
+        else
+            circle->value -= animation.frame_steps;
+
+        if (circle->value == 0)
+            led_matrix_effect_remove(&circles, circle);
+        else
+            i++;
     }
 
     is31fl3733_91tkl_update_led_pwm(&issi);
 }
 
-void type_o_circles_typematrix_row(uint8_t row_number, matrix_row_t row)
+void type_o_circles_key_event(led_matrix_key_event const *event)
 {
-    for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-    {
-        if (pressed_keys[row_number * MATRIX_COLS + key_col] == 0 &&
-            (row & ((matrix_row_t)1 << key_col)) /*matrix_is_on(key_row, key_col)*/)
-            pressed_keys[row_number * MATRIX_COLS + key_col] = RADIUS_COUNT - 1;
-    }
+    if (!(event->flags & LED_MATRIX_EVENT_PRESSED))
+        return;
+
+    // a running circle is not restarted, keys beyond TYPE_O_CIRCLES_EFFECTS get none
+    if (!led_matrix_effect_find(&circles, event->row, event->col))
+        led_matrix_effect_add(&circles, event->row, event->col, RADIUS_COUNT - 1);
 }
 
 void set_animation_type_o_circles()
@@ -124,5 +169,6 @@ void set_animation_type_o_circles()
     animation.animationStart = &type_o_circles_animation_start;
     animation.animationStop = &type_o_circles_animation_stop;
     animation.animationLoop = &type_o_circles_animation_loop;
-    animation.animation_typematrix_row = &type_o_circles_typematrix_row;
+    animation.animation_typematrix_row = 0;
+    animation.animation_key_event = &type_o_circles_key_event;
 }
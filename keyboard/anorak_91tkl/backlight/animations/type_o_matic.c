@@ -1,8 +1,8 @@
-
 #include "type_o_matic.h"
-#include "../key_led_map.h"
-#include "../../utils.h"
 #include "animation_utils.h"
+#include "animation_arena.h"
+#include "../led_surface_91tkl.h"
+#include "led_matrix/led_matrix.h"
 #include "config.h"
 
 #ifdef DEBUG_ANIMATION
@@ -11,95 +11,61 @@
 #include "nodebug.h"
 #endif
 
-void type_o_matic_typematrix_row(uint8_t row_number, matrix_row_t row_columns)
-{
-    uint8_t row;
-    uint8_t col;
-    uint8_t device_number;
-    IS31FL3733_RGB *device;
-    bool changed = false;
+// drawn by the board independent type_o_matic of tmk_core/common/led_matrix
 
-    for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-    {
-    	if (row_columns & ((matrix_row_t)1 << key_col))
-        {
-            if (getLedPosByMatrixKey(row_number, key_col, &device_number, &row, &col))
-            {
-                device = DEVICE_BY_NUMBER(issi, device_number);
-                is31fl3733_rgb_set_pwm(device, col, row, animation.rgb);
-                changed = true;
-            }
-        }
-    }
+ANIMATION_ARENA_BUDGET(type_o_matic, sizeof(led_matrix_type_o_matic_state));
 
-    if (changed)
-    	is31fl3733_91tkl_update_led_pwm(&issi);
+static void sync_color(void)
+{
+    led_matrix_color.r = animation.rgb.r;
+    led_matrix_color.g = animation.rgb.g;
+    led_matrix_color.b = animation.rgb.b;
 }
 
-void type_o_matic_animation_loop(void)
+void type_o_matic_animation_start(void)
 {
-    // HSV hsv;
-    uint8_t row;
-    uint8_t col;
-    uint8_t device_number;
-    IS31FL3733_RGB *device;
-    bool changed = false;
+    animation_default_animation_start_clear();
+    if (!animation_is_prepared())
+        return;
 
-    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
+    // the memory is released by stop_animation()
+    led_matrix_state = animation_arena_alloc(led_matrix_type_o_matic.state_size);
+    if (!led_matrix_state)
     {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
-        {
-            if (!getLedPosByMatrixKey(key_row, key_col, &device_number, &row, &col))
-                continue;
-
-            device = DEVICE_BY_NUMBER(issi, device_number);
-
-            if (matrix_is_on(key_row, key_col))
-            {
-                RGB rgb = is31fl3733_rgb_get_pwm(device, col, row);
-
-                if (rgb.r && rgb.g && rgb.b)
-                    continue;
-
-                is31fl3733_rgb_set_pwm(device, col, row, animation.rgb);
-                changed = true;
-            }
-            else
-            {
-                RGB color = is31fl3733_rgb_get_pwm(device, col, row);
-
-                if (color.r == 0 && color.g == 0 && color.b == 0)
-                	continue;
-
-                color.r = decrement(color.r, 3, 0, 255);
-                color.g = decrement(color.g, 3, 0, 255);
-                color.b = decrement(color.b, 3, 0, 255);
+        animation_default_animation_stop();
+        return;
+    }
+    led_matrix_type_o_matic.start(led_surface_91tkl());
+}
 
-                /*
-                hsv = rgb_to_hsv(color);
-                dprintf("v=%u", hsv.v);
-                hsv.v = decrement(hsv.v, 1, 0, 255);
-                */
+void type_o_matic_animation_stop(void)
+{
+    animation_default_animation_stop();
+    led_matrix_state = 0;
+}
 
-                is31fl3733_rgb_set_pwm(device, col, row, color);
-                changed = true;
-            }
-        }
-    }
+void type_o_matic_key_event(led_matrix_key_event const *event)
+{
+    sync_color();
+    led_matrix_type_o_matic.key_event(led_surface_91tkl(), event);
+}
 
-    if (changed)
-    	is31fl3733_91tkl_update_led_pwm(&issi);
+void type_o_matic_animation_loop(void)
+{
+    sync_color();
+    led_matrix_type_o_matic.loop(led_surface_91tkl());
 }
 
 void set_animation_type_o_matic(void)
 {
     dprintf("type_o_matic\n");
 
-    animation.delay_in_ms = FPS_TO_DELAY(6);
+    animation.delay_in_ms = led_matrix_type_o_matic.delay_in_ms;
     animation.duration_in_ms = 0;
 
-    animation.animationStart = &animation_default_animation_start_clear;
-    animation.animationStop = &animation_default_animation_stop;
+    animation.animationStart = &type_o_matic_animation_start;
+    animation.animationStop = &type_o_matic_animation_stop;
     animation.animationLoop = &type_o_matic_animation_loop;
-    animation.animation_typematrix_row = &type_o_matic_typematrix_row;
+    animation.animation_typematrix_row = 0;
+    animation.animation_key_event = &type_o_matic_key_event;
 }
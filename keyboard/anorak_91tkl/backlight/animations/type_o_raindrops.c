@@ -2,6 +2,7 @@
 #include "type_o_raindrops.h"
 #include "../key_led_map.h"
 #include "animation_utils.h"
+#include "animation_arena.h"
 #include "config.h"
 #include "../../utils.h"
 #include <stdlib.h>
@@ -12,97 +13,87 @@
 #include "nodebug.h"
 #endif
 
-void type_o_raindrops_typematrix_row(uint8_t row_number, matrix_row_t row_columns)
+#define TYPE_O_RAINDROPS_EFFECTS 24
+
+#define DROP_FADING 0
+#define DROP_HELD   1
+
+// held and fading drops, a frame only visits these
+static led_matrix_effect_list drops;
+
+ANIMATION_ARENA_BUDGET(type_o_raindrops, TYPE_O_RAINDROPS_EFFECTS * sizeof(led_matrix_effect));
+
+void type_o_raindrops_animation_start(void)
 {
-    HSV hsv;
-    uint8_t row;
-    uint8_t col;
-    uint8_t device_number;
-    IS31FL3733_RGB *device;
-    bool changed = false;
+    animation_default_animation_start_clear();
+    if (!animation_is_prepared())
+        return;
+    led_matrix_effect *items = (led_matrix_effect *)animation_arena_alloc(TYPE_O_RAINDROPS_EFFECTS * sizeof(led_matrix_effect));
+    if (!items)
+    {
+        animation_default_animation_stop();
+        return;
+    }
+    led_matrix_effect_init(&drops, items, TYPE_O_RAINDROPS_EFFECTS);
+}
 
-    for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
+void type_o_raindrops_key_event(led_matrix_key_event const *event)
+{
+    if (!(event->flags & LED_MATRIX_EVENT_PRESSED))
     {
-        // if (matrix_is_on(row_number, key_col))
-        if (row_columns & ((matrix_row_t)1 << key_col))
-        {
-            if (getLedPosByMatrixKey(row_number, key_col, &device_number, &row, &col))
-            {
-                device = DEVICE_BY_NUMBER(issi, device_number);
-                RGB rgb = is31fl3733_rgb_get_pwm(device, col, row);
-
-                if (rgb.r && rgb.g && rgb.b)
-                    continue;
-
-                hsv.h = rand() & 0xff;
-                hsv.s = rand() & 0xff;
-                // Override brightness with global brightness control
-                hsv.v = animation.hsv.v;
-
-                is31fl3733_hsv_set_pwm(device, col, row, hsv);
-                changed = true;
-            }
-        }
+        led_matrix_effect *drop = led_matrix_effect_find(&drops, event->row, event->col);
+        if (drop)
+            drop->value = DROP_FADING;
+        return;
     }
 
-    if (changed)
-    	is31fl3733_91tkl_update_led_pwm(&issi);
+    // keys beyond TYPE_O_RAINDROPS_EFFECTS stay dark
+    if (!led_matrix_effect_add(&drops, event->row, event->col, DROP_HELD))
+        return;
+
+    HSV hsv;
+    hsv.h = rand() & 0xff;
+    hsv.s = rand() & 0xff;
+    // Override brightness with global brightness control
+    hsv.v = animation.hsv.v;
+
+    draw_keymatrix_hsv_pixel(&issi, event->row, event->col, hsv);
+    is31fl3733_91tkl_update_led_pwm(&issi);
 }
 
 void type_o_raindrops_animation_loop()
 {
-    uint8_t row;
-    uint8_t col;
-    uint8_t device_number;
     bool changed = false;
+    RGB color;
 
-    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
+    for (uint8_t i = 0; i < drops.count;)
     {
-        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
+        led_matrix_effect *drop = &drops.items[i];
+
+        if (drop->value == DROP_HELD)
         {
-            if (!getLedPosByMatrixKey(key_row, key_col, &device_number, &row, &col))
-                continue;
-
-            IS31FL3733_RGB *device;
-            device = DEVICE_BY_NUMBER(issi, device_number);
-
-            if (matrix_is_on(key_row, key_col))
-            {
-                RGB rgb = is31fl3733_rgb_get_pwm(device, col, row);
-
-                if (rgb.r && rgb.g && rgb.b)
-                    continue;
-
-                HSV hsv;
-                hsv.h = rand() & 0xff;
-                hsv.s = rand() & 0xff;
-                // Override brightness with global brightness control
-                hsv.v = animation.hsv.v;
-
-                is31fl3733_hsv_set_pwm(device, col, row, hsv);
-                changed = true;
-            }
-            else
-            {
-                RGB color = is31fl3733_rgb_get_pwm(device, col, row);
-
-                if (color.r == 0 && color.g == 0 && color.b == 0)
-                    continue;
-
-                color.r = decrement(color.r, 3, 0, 255);
-                color.g = decrement(color.g, 3, 0, 255);
-                color.b = decrement(color.b, 3, 0, 255);
-
-                /*
-                HSV hsv = rgb_to_hsv(color);
-                hsv.v = decrement(hsv.v, 1, 0, 255);
-                */
-
-                // is31fl3733_hsv_set_pwm(device, col, row, hsv);
-                is31fl3733_rgb_set_pwm(device, col, row, color);
-                changed = true;
-            }
+            i++;
+            continue;
         }
+
+        if (!read_keymatrix_rgb_pixel(&issi, drop->row, drop->col, &color))
+        {
+            led_matrix_effect_remove(&drops, drop);
+            continue;
+        }
+
+        uint8_t fade = 3 * animation.frame_steps;
+        color.r = decrement(color.r, fade, 0, 255);
+        color.g = decrement(color.g, fade, 0, 255);
+        color.b = decrement(color.b, fade, 0, 255);
+
+        draw_keymatrix_rgb_pixel(&issi, drop->row, drop->col, color);
+        changed = true;
+
+        if (color.r == 0 && color.g == 0 && color.b == 0)
+            led_matrix_effect_remove(&drops, drop);
+        else
+            i++;
     }
 
     if (changed)
@@ -116,8 +107,9 @@ void set_animation_type_o_raindrops(void)
     animation.delay_in_ms = FPS_TO_DELAY(6);
     animation.duration_in_ms = 0;
 
-    animation.animationStart = &animation_default_animation_start_clear;
+    animation.animationStart = &type_o_raindrops_animation_start;
     animation.animationStop = &animation_default_animation_stop;
     animation.animationLoop = &type_o_raindrops_animation_loop;
-    animation.animation_typematrix_row = &type_o_raindrops_typematrix_row;
+    animation.animation_typematrix_row = 0;
+    animation.animation_key_event = &type_o_raindrops_key_event;
 }
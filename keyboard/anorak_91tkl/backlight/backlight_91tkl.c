@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "issi/is31fl3733_91tkl.h"
 #include "sector/sector_control.h"
 #include "animations/animation.h"
+#include "led_health.h"
 
 #ifdef DEBUG_BACKLIGHT
 #include "debug.h"
@@ -56,6 +57,10 @@ void fix_backlight_level()
     {
         eeconfig_backlight_init();
     }
+    else if (eeconfig_backlight_has_raw_pwm_maps())
+    {
+        sector_migrate_raw_pwm_maps();
+    }
 
     backlight_config_t backlight_config;
     backlight_config.raw = eeconfig_read_backlight();
@@ -78,6 +83,7 @@ void backlight_setup()
 #ifdef BACKLIGHT_ENABLE
     is31fl3733_91tkl_init(&issi);
     is31fl3733_91tkl_power_target(&issi, 500);
+    led_health_init();
 
     sector_control_init();
     fix_backlight_level();
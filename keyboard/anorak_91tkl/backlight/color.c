@@ -80,13 +80,156 @@ RGB hsv_to_rgb(HSV hsv)
         break;
     }
 
-    rgb.r = pgm_read_byte(&g_cie_curve[rgb.r]);
-    rgb.g = pgm_read_byte(&g_cie_curve[rgb.g]);
-    rgb.b = pgm_read_byte(&g_cie_curve[rgb.b]);
+    // no lightness correction here, the CIE curve is applied by the PWM output stage on upload
+    return rgb;
+}
+
+uint8_t cie_inverse(uint8_t pwm)
+{
+    // the curve never falls: binary search for the first value that reaches pwm
+    uint8_t low = 0;
+    uint8_t high = 255;
+
+    while (low < high)
+    {
+        uint8_t middle = low + ((high - low) >> 1);
+        if (pgm_read_byte(&g_cie_curve[middle]) < pwm)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low;
+}
+
+RGB rgb_from_pwm(RGB pwm)
+{
+    RGB rgb;
+
+    for (uint8_t c = 0; c < 3; c++)
+        rgb.rgb[c] = cie_inverse(pwm.rgb[c]);
+
+    return rgb;
+}
+
+RGB rgb_to_pwm(RGB color)
+{
+    RGB pwm;
+
+    for (uint8_t c = 0; c < 3; c++)
+        pwm.rgb[c] = pgm_read_byte(&g_cie_curve[color.rgb[c]]);
+
+    return pwm;
+}
+
+RGB hsv_to_rgb_rainbow(HSV hsv)
+{
+    RGB rgb;
+    uint8_t region, remainder, p, q, t;
+
+    if (hsv.s == 0)
+    {
+        rgb.r = hsv.v;
+        rgb.g = hsv.v;
+        rgb.b = hsv.v;
+        return rgb;
+    }
+
+    // h * 6 is a 8.8 fixed point value: the high byte is the sector, the low byte the position within
+    uint16_t h6 = hsv.h * 6;
+    region = h6 >> 8;
+    remainder = h6 & 0xFF;
+
+    p = ((uint16_t)hsv.v * (uint8_t)(255 - hsv.s)) >> 8;
+    q = ((uint16_t)hsv.v * (uint8_t)(255 - (((uint16_t)hsv.s * remainder) >> 8))) >> 8;
+    t = ((uint16_t)hsv.v * (uint8_t)(255 - (((uint16_t)hsv.s * (uint8_t)(255 - remainder)) >> 8))) >> 8;
+
+    switch (region)
+    {
+    case 0:
+        rgb.r = hsv.v;
+        rgb.g = t;
+        rgb.b = p;
+        break;
+    case 1:
+        rgb.r = q;
+        rgb.g = hsv.v;
+        rgb.b = p;
+        break;
+    case 2:
+        rgb.r = p;
+        rgb.g = hsv.v;
+        rgb.b = t;
+        break;
+    case 3:
+        rgb.r = p;
+        rgb.g = q;
+        rgb.b = hsv.v;
+        break;
+    case 4:
+        rgb.r = t;
+        rgb.g = p;
+        rgb.b = hsv.v;
+        break;
+    default:
+        rgb.r = hsv.v;
+        rgb.g = p;
+        rgb.b = q;
+        break;
+    }
 
     return rgb;
 }
 
+RGB hsv_to_rgb_spectrum(HSV hsv)
+{
+    RGB rgb;
+
+    // h * 3 is a 8.8 fixed point value: the high byte is the section, the low byte the ramp
+    uint16_t h3 = hsv.h * 3;
+    uint8_t section = h3 >> 8;
+    uint8_t ramp = h3 & 0xFF;
+
+    // the desaturated part is the same for all colors, only the rest is ramped
+    uint8_t floor = ((uint16_t)hsv.v * (uint8_t)(255 - hsv.s)) >> 8;
+    uint8_t amplitude = hsv.v - floor;
+    uint8_t up = floor + (((uint16_t)amplitude * ramp) >> 8);
+    uint8_t down = floor + (((uint16_t)amplitude * (uint8_t)(255 - ramp)) >> 8);
+
+    switch (section)
+    {
+    case 0:
+        rgb.r = down;
+        rgb.g = up;
+        rgb.b = floor;
+        break;
+    case 1:
+        rgb.r = floor;
+        rgb.g = down;
+        rgb.b = up;
+        break;
+    default:
+        rgb.r = up;
+        rgb.g = floor;
+        rgb.b = down;
+        break;
+    }
+
+    return rgb;
+}
+
+void hsv_to_rgb_rainbow_array(HSV const *hsv, RGB *rgb, uint8_t count)
+{
+    while (count--)
+        *rgb++ = hsv_to_rgb_rainbow(*hsv++);
+}
+
+void hsv_to_rgb_spectrum_array(HSV const *hsv, RGB *rgb, uint8_t count)
+{
+    while (count--)
+        *rgb++ = hsv_to_rgb_spectrum(*hsv++);
+}
+
 /*
  *
  * hsv library by Julien Vanier <jvanier@gmail.com>
@@ -73,6 +73,27 @@ extern HSV const hsv_black;
 RGB hsv_to_rgb(HSV hsv);
 HSV rgb_to_hsv(RGB rgb);
 
+/*
+ * The PWM output stage applies g_cie_curve on upload. RGB values that are PWM values already
+ * (the raw maps of older firmware, '.map set' and the map_rgb frames) are stored as the
+ * smallest color the curve brings to that PWM value, rgb_to_pwm() gives it back.
+ */
+uint8_t cie_inverse(uint8_t pwm);
+RGB rgb_from_pwm(RGB pwm);
+RGB rgb_to_pwm(RGB color);
+
+/*
+ * Fast conversions for the animation loops: 8 bit fixed point, no divisions, no tables.
+ *
+ * rainbow  : six hue sectors like hsv_to_rgb, sector borders differ by at most one hue step
+ * spectrum : three hue sections with linear ramps, constant brightness over the whole hue circle
+ */
+RGB hsv_to_rgb_rainbow(HSV hsv);
+RGB hsv_to_rgb_spectrum(HSV hsv);
+
+void hsv_to_rgb_rainbow_array(HSV const *hsv, RGB *rgb, uint8_t count);
+void hsv_to_rgb_spectrum_array(HSV const *hsv, RGB *rgb, uint8_t count);
+
 #ifdef __cplusplus
 }
 #endif
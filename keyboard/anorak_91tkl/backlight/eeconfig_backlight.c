@@ -1,23 +1,131 @@
 #include "eeconfig_backlight.h"
-#include <avr/eeprom.h>
+#include "eeconfig.h"
+#include "eeprom_cache.h"
+#include "pwm_map_codec.h"
 #include <stdbool.h>
 #include <stdint.h>
 
+#ifdef BACKLIGHT_ENABLE
+enum journal_values { journal_animation = 0, journal_active_map, journal_backlight, journal_sequence };
+
+// the newest slot, read once
+static uint8_t journal[EECONFIG_BACKLIGHT_JOURNAL_SLOT_SIZE];
+static uint8_t journal_slot;
+static bool journal_loaded = false;
+
+static uint8_t *journal_address(uint8_t slot)
+{
+    return EECONFIG_BACKLIGHT_JOURNAL + slot * EECONFIG_BACKLIGHT_JOURNAL_SLOT_SIZE;
+}
+
+static uint8_t journal_next_sequence(uint8_t sequence)
+{
+    // 0xFF marks an empty slot
+    return (sequence >= 0xFE) ? 0 : sequence + 1;
+}
+
+static void journal_load(void)
+{
+    if (journal_loaded)
+        return;
+
+    journal_loaded = true;
+    journal_slot = 0;
+
+    uint8_t sequence = eeprom_cache_read_byte(journal_address(0) + journal_sequence);
+
+    if (sequence == 0xFF)
+    {
+        // empty journal: the values of the firmware before the journal
+        journal[journal_animation] = eeprom_cache_read_byte(EECONFIG_BACKLIGHT_ANIMATION);
+        journal[journal_active_map] = eeprom_cache_read_byte(EECONFIG_BACKLIGHT_PWM_ACTIVE_MAP);
+        journal[journal_backlight] = eeprom_cache_read_byte(EECONFIG_BACKLIGHT);
+        journal[journal_sequence] = 0xFF;
+        journal_slot = EECONFIG_BACKLIGHT_JOURNAL_SLOTS - 1;
+        return;
+    }
+
+    // follow the sequence to its break
+    while (journal_slot < EECONFIG_BACKLIGHT_JOURNAL_SLOTS - 1)
+    {
+        uint8_t next = eeprom_cache_read_byte(journal_address(journal_slot + 1) + journal_sequence);
+        if (next != journal_next_sequence(sequence))
+            break;
+        sequence = next;
+        journal_slot++;
+    }
+
+    eeprom_cache_read_block(journal, journal_address(journal_slot), EECONFIG_BACKLIGHT_JOURNAL_SLOT_SIZE);
+}
+
+static void journal_write(uint8_t value, uint8_t data)
+{
+    journal_load();
+
+    if (journal[value] == data && journal[journal_sequence] != 0xFF)
+        return;
+
+    journal[value] = data;
+    journal[journal_sequence] = journal_next_sequence(journal[journal_sequence]);
+
+    if (++journal_slot == EECONFIG_BACKLIGHT_JOURNAL_SLOTS)
+        journal_slot = 0;
+
+    // the cache writes dirty bytes by rising address, the sequence byte is the last of the slot
+    eeprom_cache_update_block(journal, journal_address(journal_slot), EECONFIG_BACKLIGHT_JOURNAL_SLOT_SIZE);
+}
+
+static uint8_t journal_read(uint8_t value)
+{
+    journal_load();
+    return journal[value];
+}
+#endif
+
 void eeconfig_backlight_enable(void)
 {
 #ifdef BACKLIGHT_ENABLE
-    eeprom_write_word(EECONFIG_BACKLIGHT_MAGIC, EECONFIG_BACKLIGHT_MAGIC_NUMBER);
+    eeprom_cache_update_word(EECONFIG_BACKLIGHT_MAGIC, EECONFIG_BACKLIGHT_MAGIC_NUMBER);
 #endif
 }
 
 void eeconfig_backlight_disable(void)
 {
-    eeprom_write_word(EECONFIG_BACKLIGHT_MAGIC, 0xFFFF);
+    eeprom_cache_update_word(EECONFIG_BACKLIGHT_MAGIC, 0xFFFF);
 }
 
 bool eeconfig_backlight_is_enabled(void)
 {
-    return (eeprom_read_word(EECONFIG_BACKLIGHT_MAGIC) == EECONFIG_BACKLIGHT_MAGIC_NUMBER);
+    uint16_t magic = eeprom_cache_read_word(EECONFIG_BACKLIGHT_MAGIC);
+    return (magic == EECONFIG_BACKLIGHT_MAGIC_NUMBER || eeconfig_backlight_has_raw_pwm_maps());
+}
+
+bool eeconfig_backlight_has_raw_pwm_maps(void)
+{
+    uint16_t magic = eeprom_cache_read_word(EECONFIG_BACKLIGHT_MAGIC);
+    return (magic == EECONFIG_BACKLIGHT_MAGIC_NUMBER_RAW_MAPS ||
+            (magic >= EECONFIG_BACKLIGHT_MAGIC_NUMBER_MIGRATING(0) &&
+             magic < EECONFIG_BACKLIGHT_MAGIC_NUMBER_MIGRATING(EECONFIG_BACKLIGHT_PWM_MAP_COUNT)) ||
+            (magic >= EECONFIG_BACKLIGHT_MAGIC_NUMBER_MIGRATING_WRITE(0) &&
+             magic < EECONFIG_BACKLIGHT_MAGIC_NUMBER_MIGRATING_WRITE(EECONFIG_BACKLIGHT_PWM_MAP_COUNT)));
+}
+
+uint8_t eeconfig_backlight_read_raw_pwm_map_progress(bool *writing)
+{
+    uint16_t magic = eeprom_cache_read_word(EECONFIG_BACKLIGHT_MAGIC);
+
+    *writing = false;
+    if (magic == EECONFIG_BACKLIGHT_MAGIC_NUMBER_RAW_MAPS)
+        return 0;
+
+    *writing = (magic >= EECONFIG_BACKLIGHT_MAGIC_NUMBER_MIGRATING_WRITE(0));
+    return magic & 0x0f;
+}
+
+void eeconfig_backlight_write_raw_pwm_map_progress(uint8_t map, bool writing)
+{
+    eeprom_cache_update_word(EECONFIG_BACKLIGHT_MAGIC, writing ? EECONFIG_BACKLIGHT_MAGIC_NUMBER_MIGRATING_WRITE(map)
+                                                               : EECONFIG_BACKLIGHT_MAGIC_NUMBER_MIGRATING(map));
 }
 
 void eeconfig_backlight_init(void)
@@ -33,26 +141,28 @@ void eeconfig_backlight_init(void)
     eeconfig_write_animation_current(0);
     eeconfig_write_animation_hsv_values(0, 255, 250, 192);
     eeconfig_write_animation_hsv_values(1, 130, 70, 194);
+
+    eeconfig_write_backlight_led_faults_valid(false);
 #endif
 }
 
 #ifdef BACKLIGHT_ENABLE
 uint8_t eeconfig_read_backlight_sectors_state(void)
 {
-    return eeprom_read_byte(EECONFIG_BACKLIGHT_SECTORS);
+    return eeprom_cache_read_byte(EECONFIG_BACKLIGHT_SECTORS);
 }
 
 void eeconfig_write_backlight_sectors_state(uint8_t val)
 {
     //eeprom_write_byte(EECONFIG_BACKLIGHT_SECTORS, val);
-    eeprom_update_byte(EECONFIG_BACKLIGHT_SECTORS, val);
+    eeprom_cache_update_byte(EECONFIG_BACKLIGHT_SECTORS, val);
 }
 
 void eeconfig_read_backlight_sector_values(uint8_t sector, uint8_t *v1, uint8_t *v2, uint8_t *v3)
 {
-    *v1 = eeprom_read_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3));
-    *v2 = eeprom_read_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 1);
-    *v3 = eeprom_read_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 2);
+    *v1 = eeprom_cache_read_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3));
+    *v2 = eeprom_cache_read_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 1);
+    *v3 = eeprom_cache_read_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 2);
 }
 
 void eeconfig_write_backlight_sector_values(uint8_t sector, uint8_t v1, uint8_t v2, uint8_t v3)
@@ -61,60 +171,105 @@ void eeconfig_write_backlight_sector_values(uint8_t sector, uint8_t v1, uint8_t
     //eeprom_write_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 1, green);
     //eeprom_write_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 2, blue);
 
-    eeprom_update_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3), v1);
-    eeprom_update_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 1, v2);
-    eeprom_update_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 2, v3);
+    eeprom_cache_update_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3), v1);
+    eeprom_cache_update_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 1, v2);
+    eeprom_cache_update_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (sector * 3) + 2, v3);
 }
 
 uint8_t eeconfig_read_animation_current(void)
 {
-    return eeprom_read_byte(EECONFIG_BACKLIGHT_ANIMATION);
+    return journal_read(journal_animation);
 }
 
 void eeconfig_write_animation_current(uint8_t current)
 {
-	eeprom_update_byte(EECONFIG_BACKLIGHT_ANIMATION, current);
+    journal_write(journal_animation, current);
 }
 
 void eeconfig_read_animation_hsv_values(uint8_t hsv, uint8_t *v1, uint8_t *v2, uint8_t *v3)
 {
-    *v1 = eeprom_read_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3));
-    *v2 = eeprom_read_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3) + 1);
-    *v3 = eeprom_read_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3) + 2);
+    *v1 = eeprom_cache_read_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3));
+    *v2 = eeprom_cache_read_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3) + 1);
+    *v3 = eeprom_cache_read_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3) + 2);
 }
 
 void eeconfig_write_animation_hsv_values(uint8_t hsv, uint8_t v1, uint8_t v2, uint8_t v3)
 {
-    eeprom_update_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3), v1);
-    eeprom_update_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3) + 1, v2);
-    eeprom_update_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3) + 2, v3);
+    eeprom_cache_update_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3), v1);
+    eeprom_cache_update_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3) + 1, v2);
+    eeprom_cache_update_byte(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + (hsv * 3) + 2, v3);
 }
 
 uint8_t eeconfig_read_backlight_pwm_active_map()
 {
-    return eeprom_read_byte(EECONFIG_BACKLIGHT_PWM_ACTIVE_MAP);
+    return journal_read(journal_active_map);
 }
 
 void eeconfig_write_backlight_pwm_active_map(uint8_t map)
 {
-    //eeprom_write_byte(EECONFIG_BACKLIGHT_PWM_ACTIVE_MAP, map);
-    eeprom_update_byte(EECONFIG_BACKLIGHT_PWM_ACTIVE_MAP, map);
+    journal_write(journal_active_map, map);
+}
+
+uint16_t eeconfig_read_backlight_pwm_map(uint8_t map, uint8_t *buffer)
+{
+    uint8_t *address = EECONFIG_BACKLIGHT_PWM_MAP + (map * EECONFIG_BACKLIGHT_PWM_MAP_SIZE);
+
+    // the header of an encoded map gives its size, only the used part of the slot is read
+    eeprom_cache_read_block(buffer, address, 2);
+    uint16_t size = pwm_map_size(buffer);
+    if (size <= 2 || size > EECONFIG_BACKLIGHT_PWM_MAP_SIZE)
+        return 0;
+
+    eeprom_cache_read_block(buffer + 2, address + 2, size - 2);
+    return size;
+}
+
+bool eeconfig_write_backlight_pwm_map(uint8_t map, uint8_t const *buffer, uint16_t size)
+{
+    if (size > EECONFIG_BACKLIGHT_PWM_MAP_SIZE)
+        return false;
+    return eeprom_cache_update_range(buffer, EECONFIG_BACKLIGHT_PWM_MAP + (map * EECONFIG_BACKLIGHT_PWM_MAP_SIZE), size);
+}
+
+void eeconfig_read_backlight_pwm_raw_map(uint8_t map, uint8_t *buffer, bool read_lower)
+{
+    uint16_t offset = (map * EECONFIG_BACKLIGHT_PWM_RAW_MAP_SIZE);
+    if (read_lower)
+        offset += EECONFIG_BACKLIGHT_PWM_RAW_MAP_SIZE_HALF;
+    eeprom_cache_read_block(buffer, EECONFIG_BACKLIGHT_PWM_MAP + offset, EECONFIG_BACKLIGHT_PWM_RAW_MAP_SIZE_HALF);
+}
+
+// the tmk backlight config (level and enable) goes into the journal, replaces the weak eeconfig.c functions
+uint8_t eeconfig_read_backlight(void)
+{
+    return journal_read(journal_backlight);
 }
 
-void eeconfig_read_backlight_pwm_map(uint8_t map, uint8_t *buffer, bool read_lower)
+void eeconfig_write_backlight(uint8_t val)
 {
-	uint16_t offset = (map*EECONFIG_BACKLIGHT_PWM_MAP_SIZE);
+    journal_write(journal_backlight, val);
+}
+
+bool eeconfig_read_backlight_led_faults(uint8_t *buffer, bool read_lower)
+{
+	if (eeprom_cache_read_byte(EECONFIG_BACKLIGHT_LED_FAULTS_MAGIC) != EECONFIG_BACKLIGHT_LED_FAULTS_MAGIC_NUMBER)
+		return false;
+
+	uint8_t offset = 0;
 	if (read_lower)
-		offset += EECONFIG_BACKLIGHT_PWM_MAP_SIZE_HALF;
-	eeprom_read_block(buffer, EECONFIG_BACKLIGHT_PWM_MAP + offset, EECONFIG_BACKLIGHT_PWM_MAP_SIZE_HALF);
+		offset += EECONFIG_BACKLIGHT_LED_FAULTS_SIZE_HALF;
+	eeprom_cache_read_block(buffer, EECONFIG_BACKLIGHT_LED_FAULTS + offset, EECONFIG_BACKLIGHT_LED_FAULTS_SIZE_HALF);
+	return true;
+}
+
+void eeconfig_write_backlight_led_faults_valid(bool valid)
+{
+	eeprom_cache_update_byte(EECONFIG_BACKLIGHT_LED_FAULTS_MAGIC, valid ? EECONFIG_BACKLIGHT_LED_FAULTS_MAGIC_NUMBER : 0xFF);
 }
 
-void eeconfig_write_backlight_pwm_map(uint8_t map, uint8_t *buffer, bool write_lower)
+void eeconfig_write_backlight_led_fault(uint8_t offset, uint8_t val)
 {
-	uint16_t offset = (map*EECONFIG_BACKLIGHT_PWM_MAP_SIZE);
-	if (write_lower)
-		offset += EECONFIG_BACKLIGHT_PWM_MAP_SIZE_HALF;
-	eeprom_write_block(buffer, EECONFIG_BACKLIGHT_PWM_MAP + offset, EECONFIG_BACKLIGHT_PWM_MAP_SIZE_HALF);
+	eeprom_cache_update_byte(EECONFIG_BACKLIGHT_LED_FAULTS + offset, val);
 }
 
 #endif
@@ -26,14 +26,21 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 extern "C" {
 #endif
 
-#define EECONFIG_BACKLIGHT_MAGIC_NUMBER (uint16_t)0xAFFE
+#define EECONFIG_BACKLIGHT_MAGIC_NUMBER (uint16_t)0xAFFD
+// the same settings with the raw maps of before the encoded ones, see sector_migrate_raw_pwm_maps()
+#define EECONFIG_BACKLIGHT_MAGIC_NUMBER_RAW_MAPS (uint16_t)0xAFFE
+// during the migration: the maps below map are encoded, the slot of map is untouched or being written
+#define EECONFIG_BACKLIGHT_MAGIC_NUMBER_MIGRATING(map) (uint16_t)(0xAFE0 | (map))
+#define EECONFIG_BACKLIGHT_MAGIC_NUMBER_MIGRATING_WRITE(map) (uint16_t)(0xAFF0 | (map))
 
 /* eeprom parameteter address */
 /* size for sectors is: 8*3 = 24 bytes
- * size for pwm maps: 192*2 = 384 bytes
- *   5 pwm maps: 1920 bytes
+ * size for led faults: 24*2 = 48 bytes
+ * size for pwm maps: encoded (pwm_map_codec.h), at most 3+3*102 = 309 bytes (literal), slots of 320 bytes
+ *   6 pwm maps: 1920 bytes, before the encoding 5 raw maps of 192*2 = 384 bytes
  * eeprom size: 2048
  *      size left: 2048-1920 = 128
+ * journal of the hot settings: 8*4 = 32 bytes, 95..126, ends right before the active map
  *
  */
 
@@ -42,9 +49,17 @@ extern "C" {
 #define EECONFIG_BACKLIGHT_SECTOR_COUNT 8
 #define EECONFIG_BACKLIGHT_SECTOR_PWM_SIZE (EECONFIG_BACKLIGHT_SECTOR_COUNT * 3)
 
-#define EECONFIG_BACKLIGHT_PWM_MAP_COUNT 5
-#define EECONFIG_BACKLIGHT_PWM_MAP_SIZE_HALF 192
-#define EECONFIG_BACKLIGHT_PWM_MAP_SIZE (EECONFIG_BACKLIGHT_PWM_MAP_SIZE_HALF * 2)
+#define EECONFIG_BACKLIGHT_PWM_MAP_COUNT 6
+#define EECONFIG_BACKLIGHT_PWM_MAP_SIZE 320
+
+// the raw maps were the PWM buffers of both chips
+#define EECONFIG_BACKLIGHT_PWM_RAW_MAP_COUNT 5
+#define EECONFIG_BACKLIGHT_PWM_RAW_MAP_SIZE_HALF 192
+#define EECONFIG_BACKLIGHT_PWM_RAW_MAP_SIZE (EECONFIG_BACKLIGHT_PWM_RAW_MAP_SIZE_HALF * 2)
+
+#define EECONFIG_BACKLIGHT_LED_FAULTS_SIZE_HALF 24
+#define EECONFIG_BACKLIGHT_LED_FAULTS_SIZE (EECONFIG_BACKLIGHT_LED_FAULTS_SIZE_HALF * 2)
+#define EECONFIG_BACKLIGHT_LED_FAULTS_MAGIC_NUMBER 0x5A
 
 // positions, EECONFIG_BACKLIGHT == 6
 //            EECONFIG_STATUSLED_NUMLOCK == 11
@@ -59,11 +74,32 @@ extern "C" {
 #define EECONFIG_BACKLIGHT_ANIMATION_HSV_1 (uint8_t *)(EECONFIG_BACKLIGHT_ANIMATION + 1)
 #define EECONFIG_BACKLIGHT_ANIMATION_HSV_2 (uint8_t *)(EECONFIG_BACKLIGHT_ANIMATION_HSV_1 + 3)
 
+#define EECONFIG_BACKLIGHT_LED_FAULTS_MAGIC (uint8_t *)(EECONFIG_BACKLIGHT_ANIMATION_HSV_2 + 3)
+#define EECONFIG_BACKLIGHT_LED_FAULTS (uint8_t *)(EECONFIG_BACKLIGHT_LED_FAULTS_MAGIC + 1)
+
+/* current animation, active map and tmk backlight config change with every key press that
+ * touches them. They are written round robin into the slots of a journal, the slot with the
+ * sequence break is the newest: each EEPROM byte sees 1/8 of the writes.
+ * slot: animation, active map, backlight config, sequence (never 0xFF, written last)
+ * The single bytes EECONFIG_BACKLIGHT_ANIMATION, EECONFIG_BACKLIGHT_PWM_ACTIVE_MAP and
+ * EECONFIG_BACKLIGHT are only read while the journal is empty.
+ */
+#define EECONFIG_BACKLIGHT_JOURNAL (uint8_t *)(EECONFIG_BACKLIGHT_LED_FAULTS + EECONFIG_BACKLIGHT_LED_FAULTS_SIZE)
+#define EECONFIG_BACKLIGHT_JOURNAL_SLOTS 8
+#define EECONFIG_BACKLIGHT_JOURNAL_SLOT_SIZE 4
+
 #define EECONFIG_BACKLIGHT_PWM_ACTIVE_MAP (uint8_t *)127
 #define EECONFIG_BACKLIGHT_PWM_MAP (uint8_t *)128
 
 bool eeconfig_backlight_is_enabled(void);
 void eeconfig_backlight_init(void);
+void eeconfig_backlight_enable(void);
+void eeconfig_backlight_disable(void);
+// true while the maps are still raw, eeconfig_backlight_enable() marks them encoded
+bool eeconfig_backlight_has_raw_pwm_maps(void);
+// the first map that is not encoded yet, writing is set if its slot may be partly written
+uint8_t eeconfig_backlight_read_raw_pwm_map_progress(bool *writing);
+void eeconfig_backlight_write_raw_pwm_map_progress(uint8_t map, bool writing);
 
 #ifdef BACKLIGHT_ENABLE
 uint8_t eeconfig_read_backlight_sectors_state(void);
@@ -81,8 +117,17 @@ void eeconfig_write_animation_hsv_values(uint8_t hsv, uint8_t v1, uint8_t v2, ui
 uint8_t eeconfig_read_backlight_pwm_active_map(void);
 void eeconfig_write_backlight_pwm_active_map(uint8_t map);
 
-void eeconfig_read_backlight_pwm_map(uint8_t map, uint8_t *buffer, bool read_lower);
-void eeconfig_write_backlight_pwm_map(uint8_t map, uint8_t *buffer, bool write_lower);
+// reads the encoded map into buffer (EECONFIG_BACKLIGHT_PWM_MAP_SIZE bytes), returns its size, 0 for an empty slot
+uint16_t eeconfig_read_backlight_pwm_map(uint8_t map, uint8_t *buffer);
+// buffer is written behind the main loop and has to keep the map until eeprom_cache_pending() is 0
+bool eeconfig_write_backlight_pwm_map(uint8_t map, uint8_t const *buffer, uint16_t size);
+// reads one half of a raw map (EECONFIG_BACKLIGHT_PWM_RAW_MAP_SIZE_HALF bytes)
+void eeconfig_read_backlight_pwm_raw_map(uint8_t map, uint8_t *buffer, bool read_lower);
+
+bool eeconfig_read_backlight_led_faults(uint8_t *buffer, bool read_lower);
+void eeconfig_write_backlight_led_faults_valid(bool valid);
+// write one byte of the led faults, offset is 0..EECONFIG_BACKLIGHT_LED_FAULTS_SIZE-1
+void eeconfig_write_backlight_led_fault(uint8_t offset, uint8_t val);
 #endif
 
 #ifdef __cplusplus
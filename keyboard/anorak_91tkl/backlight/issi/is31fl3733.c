@@ -1,5 +1,6 @@
 #include "is31fl3733.h"
 #include "is31fl3733_twi.h"
+#include "perf.h"
 #include <util/delay.h>
 #include <string.h>
 
@@ -14,6 +15,47 @@
 //#define ISSI_DECTECT_DEVICE
 
 
+static inline uint8_t is31fl3733_output_pwm(IS31FL3733_OUTPUT const *output, uint8_t balance, uint8_t pwm)
+{
+    uint8_t value = output->lut[pwm];
+
+    if (balance != 0xFF)
+        value = ((uint16_t)value * (balance + 1)) >> 8;
+
+    return value;
+}
+
+static void is31fl3733_output_line(IS31FL3733_OUTPUT const *output, uint8_t sw, uint8_t const *pwm, uint8_t *line)
+{
+    uint8_t balance = output->white_balance[sw % 3];
+
+    for (uint8_t cs = 0; cs < IS31FL3733_CS; ++cs)
+        line[cs] = is31fl3733_output_pwm(output, balance, pwm[cs]);
+}
+
+static uint16_t is31fl3733_mask_line(uint16_t faults, uint8_t const *pwm, uint8_t *line)
+{
+    uint16_t sum = 0;
+
+    for (uint8_t cs = 0; cs < IS31FL3733_CS; ++cs)
+    {
+        line[cs] = (faults & (1 << cs)) ? 0 : pwm[cs];
+        sum += line[cs];
+    }
+
+    return sum;
+}
+
+static uint16_t is31fl3733_sum_line(uint8_t const *pwm)
+{
+    uint16_t sum = 0;
+
+    for (uint8_t cs = 0; cs < IS31FL3733_CS; ++cs)
+        sum += pwm[cs];
+
+    return sum;
+}
+
 void is31fl3733_write_common_reg(IS31FL3733 *device, uint8_t reg_addr, uint8_t reg_value)
 {
     // Write value to register.
@@ -118,6 +160,8 @@ void is31fl3733_init(IS31FL3733 *device)
     // Set global current control register.
     //dprintf("gcc\n");
     is31fl3733_write_paged_reg(device, IS31FL3733_GCC, device->gcc);
+    device->gcc_applied = device->gcc;
+    device->pwm_sum = 0;
 
     //dprintf("res\n");
     is31fl3733_set_resistor_values(device, IS31FL3733_RESISTOR_32K, IS31FL3733_RESISTOR_32K);
@@ -140,7 +184,14 @@ void is31fl3733_init(IS31FL3733 *device)
 void is31fl3733_update_global_current_control(IS31FL3733 *device)
 {
     // Set global current control register.
-    is31fl3733_write_paged_reg(device, IS31FL3733_GCC, device->gcc);
+    is31fl3733_apply_global_current_control(device, device->gcc);
+}
+
+void is31fl3733_apply_global_current_control(IS31FL3733 *device, uint8_t gcc)
+{
+    // Set global current control register.
+    is31fl3733_write_paged_reg(device, IS31FL3733_GCC, gcc);
+    device->gcc_applied = gcc;
 }
 
 void is31fl3733_set_resistor_values(IS31FL3733 *device, IS31FL3733_RESISTOR swpur, IS31FL3733_RESISTOR cspdr)
@@ -165,6 +216,50 @@ void is31fl3733_auto_breath_mode(IS31FL3733 *device, bool enable)
     is31fl3733_write_paged_reg(device, IS31FL3733_CR, device->cr);
 }
 
+void is31fl3733_config_abm(IS31FL3733 *device, uint16_t abm_reg, IS31FL3733_ABM const *config)
+{
+    // Set fade in and hold on times.
+    is31fl3733_write_paged_reg(device, abm_reg, config->t1 | config->t2);
+    // Set fade out and hold off times.
+    is31fl3733_write_paged_reg(device, abm_reg + 1, config->t3 | config->t4);
+    // Set loop begin/end and high part of loop times.
+    is31fl3733_write_paged_reg(device, abm_reg + 2,
+                               config->loop_end | config->loop_begin | ((config->loop_times >> 8) & 0x0F));
+    // Set low part of loop times.
+    is31fl3733_write_paged_reg(device, abm_reg + 3, config->loop_times & 0xFF);
+}
+
+void is31fl3733_update_led_mode(IS31FL3733 *device, uint8_t mode)
+{
+    uint8_t modes[IS31FL3733_CS];
+
+    // Select IS31FL3733_LEDABM register page.
+    is31fl3733_select_page(device, IS31FL3733_GET_PAGE(IS31FL3733_LEDABM));
+
+    // Write LED modes, one SW line at a time.
+    for (uint8_t sw = 0; sw < IS31FL3733_SW; ++sw)
+    {
+        for (uint8_t cs = 0; cs < IS31FL3733_CS; ++cs)
+        {
+            bool enabled = device->leds[(sw << 1) + (cs / 8)] & (0x01 << (cs % 8));
+            modes[cs] = enabled ? mode : IS31FL3733_LEDABM_PWM;
+        }
+
+        device->pfn_i2c_write_reg(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDABM) + sw * IS31FL3733_CS,
+                                  modes, IS31FL3733_CS);
+    }
+}
+
+void is31fl3733_start_abm(IS31FL3733 *device)
+{
+    // Restart the engine: the ABM timing starts over when BEN goes from 0 to 1.
+    is31fl3733_auto_breath_mode(device, false);
+    is31fl3733_auto_breath_mode(device, true);
+
+    // Write 0x00 to Time Update Register to latch the ABM configuration.
+    is31fl3733_write_paged_reg(device, IS31FL3733_TUR, 0x00);
+}
+
 void is31fl3733_software_shutdown(IS31FL3733 *device, bool enable)
 {
     if (enable)
@@ -210,11 +305,16 @@ void is31fl3733_update_led_enable(IS31FL3733 *device)
     // Select IS31FL3733_LEDONOFF register page.
     is31fl3733_select_page(device, IS31FL3733_GET_PAGE(IS31FL3733_LEDONOFF));
 
-    // Write LED states.
+    uint8_t leds[IS31FL3733_LED_ENABLE_SIZE / 2];
+
+    // Write LED states, faulty LEDs stay off.
     for (uint8_t offset = 0; offset < IS31FL3733_LED_ENABLE_SIZE; offset += IS31FL3733_LED_ENABLE_SIZE / 2)
     {
-        device->pfn_i2c_write_reg(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDONOFF) + offset,
-                                  device->leds + offset, IS31FL3733_LED_ENABLE_SIZE / 2);
+        for (uint8_t i = 0; i < IS31FL3733_LED_ENABLE_SIZE / 2; ++i)
+            leds[i] = device->leds[offset + i] & ~device->faults[offset + i];
+
+        device->pfn_i2c_write_reg(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDONOFF) + offset, leds,
+                                  IS31FL3733_LED_ENABLE_SIZE / 2);
     }
 }
 
@@ -222,15 +322,47 @@ void is31fl3733_update_led_pwm(IS31FL3733 *device)
 {
 	//dprintf("issi: up pwm %X\n", device->address);
 
+    uint8_t line[IS31FL3733_CS];
+    uint8_t *data;
+    uint16_t sum = 0;
+
+    PERF_START(upload);
+
     // Select IS31FL3733_LEDPWM register page.
     is31fl3733_select_page(device, IS31FL3733_GET_PAGE(IS31FL3733_LEDPWM));
 
-    // Write PWM values.
-    for (uint8_t offset = 0; offset < IS31FL3733_LED_PWM_USED_SIZE; offset += IS31FL3733_CS)
+    // Write PWM values, one SW line at a time.
+    for (uint8_t sw = 0; sw < IS31FL3733_LED_PWM_USED_SIZE / IS31FL3733_CS; ++sw)
     {
-        device->pfn_i2c_write_reg(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDPWM) + offset,
-                                  device->pwm + offset, IS31FL3733_CS);
+        uint8_t offset = sw * IS31FL3733_CS;
+        data = device->pwm + offset;
+
+        uint16_t faults = device->faults[sw << 1] | (device->faults[(sw << 1) + 1] << 8);
+
+        if (device->output)
+        {
+            is31fl3733_output_line(device->output, sw, data, line);
+            data = line;
+        }
+
+        if (faults)
+        {
+            // Faulty LEDs get no PWM value and are left out of the power estimation.
+            sum += is31fl3733_mask_line(faults, data, line);
+            data = line;
+        }
+        else
+        {
+            sum += is31fl3733_sum_line(data);
+        }
+
+        device->pfn_i2c_write_reg(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDPWM) + offset, data,
+                                  IS31FL3733_CS);
     }
+
+    device->pwm_sum = sum;
+
+    PERF_STOP(upload, perfI2CUpload);
 }
 
 #ifdef ISSI_ENABLE_DIRECT_WRITE
@@ -243,12 +375,40 @@ void is31fl3733_update_led_pwm_fast(IS31FL3733 *device)
     // Select requested page in Command Register.
     queued_twi_write_byte_to_register(device->address, IS31FL3733_PSR, IS31FL3733_GET_PAGE(IS31FL3733_LEDPWM));
 
+    uint8_t line[IS31FL3733_CS];
+    uint8_t *data;
+    uint16_t sum = 0;
+
     // Write PWM values.
-    for (uint8_t offset = 0; offset < IS31FL3733_LED_PWM_USED_SIZE; offset += IS31FL3733_CS)
+    for (uint8_t sw = 0; sw < IS31FL3733_LED_PWM_USED_SIZE / IS31FL3733_CS; ++sw)
     {
-        queued_twi_write_data_to_register(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDPWM) + offset,
-                                          device->pwm + offset, IS31FL3733_CS);
+        uint8_t offset = sw * IS31FL3733_CS;
+        data = device->pwm + offset;
+
+        uint16_t faults = device->faults[sw << 1] | (device->faults[(sw << 1) + 1] << 8);
+
+        if (device->output)
+        {
+            is31fl3733_output_line(device->output, sw, data, line);
+            data = line;
+        }
+
+        if (faults)
+        {
+            // Faulty LEDs get no PWM value and are left out of the power estimation.
+            sum += is31fl3733_mask_line(faults, data, line);
+            data = line;
+        }
+        else
+        {
+            sum += is31fl3733_sum_line(data);
+        }
+
+        queued_twi_write_data_to_register(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDPWM) + offset, data,
+                                          IS31FL3733_CS);
     }
+
+    device->pwm_sum = sum;
 }
 #endif
 
@@ -351,6 +511,9 @@ void is31fl3733_direct_set_pwm(IS31FL3733 *device, uint8_t cs, uint8_t sw, uint8
     // Set brightness level of selected LED.
     device->pwm[offset] = brightness;
 
+    if (device->output)
+        brightness = is31fl3733_output_pwm(device->output, device->output->white_balance[sw % 3], brightness);
+
     // Select IS31FL3733_LEDPWM register page.
     is31fl3733_select_page(device, IS31FL3733_GET_PAGE(IS31FL3733_LEDPWM));
     // Set brightness level of selected LED.
@@ -510,6 +673,75 @@ void is31fl3733_read_led_short_states(IS31FL3733 *device)
 #endif
 }
 
+void is31fl3733_start_led_fault_detection(IS31FL3733 *device)
+{
+    uint8_t all_on[IS31FL3733_CS];
+    memset(all_on, 0xFF, sizeof(all_on));
+
+    is31fl3733_write_paged_reg(device, IS31FL3733_GCC, 0x01);
+
+    // Enable all LEDs at full PWM, written directly to keep the buffers.
+    is31fl3733_select_page(device, IS31FL3733_GET_PAGE(IS31FL3733_LEDONOFF));
+    for (uint8_t offset = 0; offset < IS31FL3733_LED_ENABLE_SIZE; offset += IS31FL3733_LED_ENABLE_SIZE / 2)
+    {
+        device->pfn_i2c_write_reg(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDONOFF) + offset, all_on,
+                                  IS31FL3733_LED_ENABLE_SIZE / 2);
+    }
+
+    is31fl3733_select_page(device, IS31FL3733_GET_PAGE(IS31FL3733_LEDPWM));
+    for (uint8_t offset = 0; offset < IS31FL3733_LED_PWM_USED_SIZE; offset += IS31FL3733_CS)
+    {
+        device->pfn_i2c_write_reg(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDPWM) + offset, all_on,
+                                  IS31FL3733_CS);
+    }
+
+    // A rising edge of OSD starts the detection. The breath engine is off meanwhile, in its
+    // hold off time the LEDs would read as open.
+    is31fl3733_write_paged_reg(device, IS31FL3733_CR, device->cr & ~(IS31FL3733_CR_OSD | IS31FL3733_CR_BEN));
+    is31fl3733_write_paged_reg(device, IS31FL3733_CR, (device->cr | IS31FL3733_CR_OSD) & ~IS31FL3733_CR_BEN);
+}
+
+void is31fl3733_read_led_faults_part(IS31FL3733 *device, uint8_t *faults, uint8_t part)
+{
+    uint8_t shorts[IS31FL3733_LED_ENABLE_SIZE / 2];
+    uint8_t offset = (part >> 1) * (IS31FL3733_LED_ENABLE_SIZE / 2);
+
+    // Select IS31FL3733_LEDOPEN register page, IS31FL3733_LEDSHORT is on the same page.
+    // Other writes may have changed the page since the last part.
+    is31fl3733_select_page(device, IS31FL3733_GET_PAGE(IS31FL3733_LEDOPEN));
+
+    if (!(part & 0x01))
+    {
+        // Read LED open states of this half.
+        device->pfn_i2c_read_reg(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDOPEN) + offset,
+                                 faults + offset, IS31FL3733_LED_ENABLE_SIZE / 2);
+        return;
+    }
+
+    // Read LED short states of this half, added to the open states.
+    device->pfn_i2c_read_reg(device->address, IS31FL3733_GET_ADDR(IS31FL3733_LEDSHORT) + offset, shorts,
+                             IS31FL3733_LED_ENABLE_SIZE / 2);
+
+    for (uint8_t i = 0; i < IS31FL3733_LED_ENABLE_SIZE / 2; ++i)
+        faults[offset + i] |= shorts[i];
+}
+
+void is31fl3733_read_led_faults(IS31FL3733 *device, uint8_t *faults)
+{
+    for (uint8_t part = 0; part < IS31FL3733_FAULT_READ_PARTS; ++part)
+        is31fl3733_read_led_faults_part(device, faults, part);
+}
+
+void is31fl3733_end_led_fault_detection(IS31FL3733 *device)
+{
+    is31fl3733_write_paged_reg(device, IS31FL3733_CR, device->cr);
+    // BEN went from 0 to 1 again, latch the ABM configuration as is31fl3733_start_abm() does.
+    if (device->cr & IS31FL3733_CR_BEN)
+        is31fl3733_write_paged_reg(device, IS31FL3733_TUR, 0x00);
+    is31fl3733_write_paged_reg(device, IS31FL3733_GCC, device->gcc_applied);
+    is31fl3733_update(device);
+}
+
 #if 0
 void is31fl3733_dump_led_buffer(IS31FL3733 *device)
 {
@@ -112,6 +112,87 @@ extern "C" {
 #define IS31FL3733_CR_BEN (0x02)          /// Auto breath mode enable bit.
 #define IS31FL3733_CR_SSD (0x01)          /// Software shutdown bit.
 
+/// ABM T1 (fade in) time.
+typedef enum {
+    IS31FL3733_ABM_T1_210MS   = 0x00,  ///< 0.21 s.
+    IS31FL3733_ABM_T1_420MS   = 0x20,  ///< 0.42 s.
+    IS31FL3733_ABM_T1_840MS   = 0x40,  ///< 0.84 s.
+    IS31FL3733_ABM_T1_1680MS  = 0x60,  ///< 1.68 s.
+    IS31FL3733_ABM_T1_3360MS  = 0x80,  ///< 3.36 s.
+    IS31FL3733_ABM_T1_6720MS  = 0xA0,  ///< 6.72 s.
+    IS31FL3733_ABM_T1_13440MS = 0xC0,  ///< 13.44 s.
+    IS31FL3733_ABM_T1_26880MS = 0xE0   ///< 26.88 s.
+} IS31FL3733_ABM_T1;
+
+/// ABM T2 (hold on) time.
+typedef enum {
+    IS31FL3733_ABM_T2_0MS     = 0x00,  ///< 0 s.
+    IS31FL3733_ABM_T2_210MS   = 0x02,  ///< 0.21 s.
+    IS31FL3733_ABM_T2_420MS   = 0x04,  ///< 0.42 s.
+    IS31FL3733_ABM_T2_840MS   = 0x06,  ///< 0.84 s.
+    IS31FL3733_ABM_T2_1680MS  = 0x08,  ///< 1.68 s.
+    IS31FL3733_ABM_T2_3360MS  = 0x0A,  ///< 3.36 s.
+    IS31FL3733_ABM_T2_6720MS  = 0x0C,  ///< 6.72 s.
+    IS31FL3733_ABM_T2_13440MS = 0x0E,  ///< 13.44 s.
+    IS31FL3733_ABM_T2_26880MS = 0x10   ///< 26.88 s.
+} IS31FL3733_ABM_T2;
+
+/// ABM T3 (fade out) time.
+typedef enum {
+    IS31FL3733_ABM_T3_210MS   = 0x00,  ///< 0.21 s.
+    IS31FL3733_ABM_T3_420MS   = 0x20,  ///< 0.42 s.
+    IS31FL3733_ABM_T3_840MS   = 0x40,  ///< 0.84 s.
+    IS31FL3733_ABM_T3_1680MS  = 0x60,  ///< 1.68 s.
+    IS31FL3733_ABM_T3_3360MS  = 0x80,  ///< 3.36 s.
+    IS31FL3733_ABM_T3_6720MS  = 0xA0,  ///< 6.72 s.
+    IS31FL3733_ABM_T3_13440MS = 0xC0,  ///< 13.44 s.
+    IS31FL3733_ABM_T3_26880MS = 0xE0   ///< 26.88 s.
+} IS31FL3733_ABM_T3;
+
+/// ABM T4 (hold off) time.
+typedef enum {
+    IS31FL3733_ABM_T4_0MS      = 0x00,  ///< 0 s.
+    IS31FL3733_ABM_T4_210MS    = 0x02,  ///< 0.21 s.
+    IS31FL3733_ABM_T4_420MS    = 0x04,  ///< 0.42 s.
+    IS31FL3733_ABM_T4_840MS    = 0x06,  ///< 0.84 s.
+    IS31FL3733_ABM_T4_1680MS   = 0x08,  ///< 1.68 s.
+    IS31FL3733_ABM_T4_3360MS   = 0x0A,  ///< 3.36 s.
+    IS31FL3733_ABM_T4_6720MS   = 0x0C,  ///< 6.72 s.
+    IS31FL3733_ABM_T4_13440MS  = 0x0E,  ///< 13.44 s.
+    IS31FL3733_ABM_T4_26880MS  = 0x10,  ///< 26.88 s.
+    IS31FL3733_ABM_T4_53760MS  = 0x12,  ///< 53.76 s.
+    IS31FL3733_ABM_T4_107520MS = 0x14   ///< 107.52 s.
+} IS31FL3733_ABM_T4;
+
+/// ABM loop beginning time.
+typedef enum {
+    IS31FL3733_ABM_LOOP_BEGIN_T1 = 0x00,  ///< Loop begins with T1.
+    IS31FL3733_ABM_LOOP_BEGIN_T2 = 0x10,  ///< Loop begins with T2.
+    IS31FL3733_ABM_LOOP_BEGIN_T3 = 0x20,  ///< Loop begins with T3.
+    IS31FL3733_ABM_LOOP_BEGIN_T4 = 0x30   ///< Loop begins with T4.
+} IS31FL3733_ABM_LOOP_BEGIN;
+
+/// ABM loop end time.
+typedef enum {
+    IS31FL3733_ABM_LOOP_END_T3 = 0x00,  ///< Loop ends at the end of T3 (LED off).
+    IS31FL3733_ABM_LOOP_END_T1 = 0x40   ///< Loop ends at the end of T1 (LED on).
+} IS31FL3733_ABM_LOOP_END;
+
+/// Endless ABM loop.
+#define IS31FL3733_ABM_LOOP_FOREVER (0x0000)
+
+/// Auto breath mode configuration.
+typedef struct {
+    IS31FL3733_ABM_T1 t1;
+    IS31FL3733_ABM_T2 t2;
+    IS31FL3733_ABM_T3 t3;
+    IS31FL3733_ABM_T4 t4;
+    IS31FL3733_ABM_LOOP_BEGIN loop_begin;
+    IS31FL3733_ABM_LOOP_END loop_end;
+    /// Loop count 1..4095 or IS31FL3733_ABM_LOOP_FOREVER.
+    uint16_t loop_times;
+} IS31FL3733_ABM;
+
 /// LED state enumeration.
 typedef enum {
     IS31FL3733_LED_STATE_OFF = 0x00,  ///< LED is off.
@@ -138,6 +219,18 @@ typedef enum {
     IS31FL3733_RESISTOR_32K = 0x07   ///< 32 kOhm pull-up resistor.
 } IS31FL3733_RESISTOR;
 
+/** IS31FL3733 PWM output stage.
+ *  Applied to the PWM buffer values while they are uploaded, the buffer itself keeps the uncorrected values.
+ */
+struct IS31FL3733OutputStage {
+    /// Lightness correction and global brightness scale, one lookup per PWM value.
+    uint8_t lut[256];
+    /// White balance scale per color line (SW % 3). 0xFF leaves the color unscaled.
+    uint8_t white_balance[3];
+};
+
+typedef struct IS31FL3733OutputStage IS31FL3733_OUTPUT;
+
 typedef enum { IS31FL3733_SINGLE, IS31FL3733_MASTER, IS31FL3733_SLAVE } IS31FL3733_DEVICE_TYPE;
 
 /** IS31FL3733 structure.
@@ -149,6 +242,10 @@ struct IS31FL3733Device {
     uint8_t cr;
     /// Global Current Control value. Iout = (840 / Rext) * (GCC / 256). Rext = 20 kOhm, typically.
     uint8_t gcc;
+    /// Global Current Control value currently set in the device, may be lower than gcc to keep the power budget.
+    uint8_t gcc_applied;
+    /// Sum of the PWM values sent with the last full PWM upload.
+    uint16_t pwm_sum;
     /// This device is the master
     IS31FL3733_DEVICE_TYPE devicetype;
     /// device is enabled (hardware shutdown disabled)
@@ -159,6 +256,10 @@ struct IS31FL3733Device {
     uint8_t pwm[IS31FL3733_LED_PWM_USED_SIZE];
     /// LED matrix mask.
     uint8_t mask[IS31FL3733_LED_ENABLE_SIZE];
+    /// LEDs found open or short, these are never enabled and get no PWM value.
+    uint8_t faults[IS31FL3733_LED_ENABLE_SIZE];
+    /// PWM output stage, PWM values are uploaded unchanged if not set.
+    IS31FL3733_OUTPUT *output;
     /// Pointer to I2C write data to register function.
     uint8_t (*pfn_i2c_write_reg)(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *buffer, uint8_t count);
     /// Pointer to I2C read data from register function.
@@ -179,6 +280,8 @@ typedef struct IS31FL3733Device IS31FL3733;
 void is31fl3733_init(IS31FL3733 *device);
 
 void is31fl3733_update_global_current_control(IS31FL3733 *device);
+/// Set Global Current Control register to gcc, the configured device->gcc value is kept.
+void is31fl3733_apply_global_current_control(IS31FL3733 *device, uint8_t gcc);
 void is31fl3733_set_resistor_values(IS31FL3733 *device, IS31FL3733_RESISTOR swpur, IS31FL3733_RESISTOR cspdr);
 
 void    is31fl3733_write_interrupt_mask_register(IS31FL3733 *device, uint8_t imr);
@@ -190,6 +293,13 @@ bool is31fl3733_is_hardware_enabled(IS31FL3733 *device);
 
 void is31fl3733_auto_breath_mode(IS31FL3733 *device, bool enable);
 
+/// Configure ABM-1, ABM-2 or ABM-3 (IS31FL3733_ABM1 .. IS31FL3733_ABM3).
+void is31fl3733_config_abm(IS31FL3733 *device, uint16_t abm_reg, IS31FL3733_ABM const *config);
+/// Set the mode (IS31FL3733_LEDABM_*) of all enabled LEDs, disabled LEDs are set to PWM mode.
+void is31fl3733_update_led_mode(IS31FL3733 *device, uint8_t mode);
+/// (Re)start the auto breath engine with the current ABM configuration.
+void is31fl3733_start_abm(IS31FL3733 *device);
+
 /// Update LED matrix with internal buffer values.
 void is31fl3733_update(IS31FL3733 *device);
 /// Update LED matrix LED enable/disable states with internal buffer values.
@@ -211,6 +321,18 @@ void is31fl3733_read_led_open_states(IS31FL3733 *device);
 // Read LED short states and store them into the led buffer
 void is31fl3733_read_led_short_states(IS31FL3733 *device);
 
+// Non-blocking open/short detection, the led and pwm buffers are not changed:
+// start the detection, wait at least IS31FL3733_DETECT_TIME_MS, read the faults, then end the detection
+#define IS31FL3733_DETECT_TIME_MS 4
+void is31fl3733_start_led_fault_detection(IS31FL3733 *device);
+// Read LED open and short states into faults (IS31FL3733_LED_ENABLE_SIZE bytes)
+void is31fl3733_read_led_faults(IS31FL3733 *device, uint8_t *faults);
+// The same in IS31FL3733_FAULT_READ_PARTS blocking reads of half a register each, read the parts in order
+#define IS31FL3733_FAULT_READ_PARTS 4
+void is31fl3733_read_led_faults_part(IS31FL3733 *device, uint8_t *faults, uint8_t part);
+// Restore global current control, configuration and led/pwm registers from the buffers
+void is31fl3733_end_led_fault_detection(IS31FL3733 *device);
+
 void is31fl3733_led_disable_all(IS31FL3733 *device);
 void is31fl3733_led_enable_all(IS31FL3733 *device);
 void is31fl3733_enable_leds_by_mask(IS31FL3733 *device, uint8_t *mask);
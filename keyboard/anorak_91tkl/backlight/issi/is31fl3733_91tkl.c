@@ -3,6 +3,7 @@
 #include "is31fl3733_sdb.h"
 #include "is31fl3733_iicrst.h"
 #include "is31fl3733_twi.h"
+#include <avr/pgmspace.h>
 
 #ifdef DEBUG_ISSI
 #include "debug.h"
@@ -20,6 +21,24 @@ static IS31FL3733 device_lower;
 
 static bool is_initialized = false;
 
+// uploads deferred while the chips are held, see is31fl3733_91tkl_hold()
+#define PENDING_UPDATE 0x01
+#define PENDING_GCC 0x02
+
+static bool is_held = false;
+static uint8_t pending = 0;
+
+// shared by both devices: same LEDs on both halves
+static IS31FL3733_OUTPUT output_stage;
+static uint8_t output_brightness = 0xFF;
+
+static void build_output_lut(void)
+{
+	// CIE lightness correction and global brightness scale folded into one table
+	for (uint16_t i = 0; i < 256; ++i)
+		output_stage.lut[i] = ((uint16_t)pgm_read_byte(&g_cie_curve[i]) * (output_brightness + 1)) >> 8;
+}
+
 uint32_t compute_power_target(uint16_t milliampere)
 {
 	/*
@@ -50,8 +69,14 @@ void is31fl3733_91tkl_init(IS31FL3733_91TKL *device)
 	device->global_power_target_milliampere = 90;
 	uint8_t gcc = compute_power_target(90) / 2;
 
+    build_output_lut();
+    output_stage.white_balance[0] = 0xFF;
+    output_stage.white_balance[1] = 0xFF;
+    output_stage.white_balance[2] = 0xFF;
+
     device->upper = &device_rgb_upper;
     device_rgb_upper.device = &device_upper;
+    device_upper.output = &output_stage;
 
     device_upper.gcc = gcc;
     device_upper.devicetype = IS31FL3733_MASTER;
@@ -63,6 +88,7 @@ void is31fl3733_91tkl_init(IS31FL3733_91TKL *device)
 
     device->lower = &device_rgb_lower;
     device_rgb_lower.device = &device_lower;
+    device_lower.output = &output_stage;
 
     device_lower.gcc = gcc;
     device_upper.devicetype = IS31FL3733_SLAVE;
@@ -101,6 +127,54 @@ void is31fl3733_91tkl_fill_hsv_masked(IS31FL3733_91TKL *device, HSV color)
 	is31fl3733_fill_hsv_masked(device->lower, color);
 }
 
+void is31fl3733_91tkl_start_auto_breath(IS31FL3733_91TKL *device, IS31FL3733_ABM const *config)
+{
+	is31fl3733_config_abm(device->upper->device, IS31FL3733_ABM1, config);
+	is31fl3733_config_abm(device->lower->device, IS31FL3733_ABM1, config);
+
+	is31fl3733_update_led_mode(device->upper->device, IS31FL3733_LEDABM_ABM1);
+	is31fl3733_update_led_mode(device->lower->device, IS31FL3733_LEDABM_ABM1);
+
+	// start both engines back to back to keep the halves in phase
+	is31fl3733_start_abm(device->upper->device);
+	is31fl3733_start_abm(device->lower->device);
+}
+
+void is31fl3733_91tkl_stop_auto_breath(IS31FL3733_91TKL *device)
+{
+	is31fl3733_auto_breath_mode(device->upper->device, false);
+	is31fl3733_auto_breath_mode(device->lower->device, false);
+
+	is31fl3733_update_led_mode(device->upper->device, IS31FL3733_LEDABM_PWM);
+	is31fl3733_update_led_mode(device->lower->device, IS31FL3733_LEDABM_PWM);
+}
+
+void is31fl3733_91tkl_set_brightness(IS31FL3733_91TKL *device, uint8_t brightness)
+{
+	output_brightness = brightness;
+	build_output_lut();
+}
+
+uint8_t is31fl3733_91tkl_get_brightness(IS31FL3733_91TKL *device)
+{
+	return output_brightness;
+}
+
+void is31fl3733_91tkl_set_white_balance(IS31FL3733_91TKL *device, RGB balance)
+{
+	// white balance is indexed by color line, the offsets are the same for both devices
+	for (uint8_t c = 0; c < 3; ++c)
+		output_stage.white_balance[device->upper->offsets.color[c]] = balance.rgb[c];
+}
+
+RGB is31fl3733_91tkl_get_white_balance(IS31FL3733_91TKL *device)
+{
+	RGB balance;
+	for (uint8_t c = 0; c < 3; ++c)
+		balance.rgb[c] = output_stage.white_balance[device->upper->offsets.color[c]];
+	return balance;
+}
+
 void is31fl3733_91tkl_power_target(IS31FL3733_91TKL *device, uint16_t milliampere)
 {
 	device->global_power_target_milliampere = milliampere;
@@ -110,29 +184,140 @@ void is31fl3733_91tkl_power_target(IS31FL3733_91TKL *device, uint16_t milliamper
     device->upper->device->gcc = gcc2;
     device->lower->device->gcc = gcc2;
 
+    if (is_held)
+    {
+        pending |= PENDING_GCC;
+        return;
+    }
+
     is31fl3733_update_global_current_control(device->upper->device);
     is31fl3733_update_global_current_control(device->lower->device);
 }
 
+/*
+ * Current estimate, see compute_power_target():
+ *
+ * I = sum(PWM)/256 * 840/R_ext * GCC/256 * DUTY
+ *   = sum(PWM) * GCC / POWER_ESTIMATE_DIVISOR [mA]
+ *
+ * R_ext = 20kOhm, DUTY = 1 / 12.75
+ */
+#define POWER_ESTIMATE_DIVISOR 19895UL
+
+// do not raise the current for every small change of the frame content
+#define POWER_LIMIT_HYSTERESIS 4
+
+static uint16_t estimate_milliampere(IS31FL3733 *device)
+{
+	return ((uint32_t)device->pwm_sum * device->gcc_applied) / POWER_ESTIMATE_DIVISOR;
+}
+
+uint16_t is31fl3733_91tkl_current_power_usage(IS31FL3733_91TKL *device)
+{
+	return estimate_milliampere(device->upper->device) + estimate_milliampere(device->lower->device);
+}
+
+static void limit_device_power(IS31FL3733 *device, uint8_t gcc_allowed)
+{
+	uint8_t gcc = (device->gcc < gcc_allowed) ? device->gcc : gcc_allowed;
+
+	if (gcc < device->gcc_applied || gcc >= device->gcc_applied + POWER_LIMIT_HYSTERESIS ||
+		(gcc == device->gcc && gcc != device->gcc_applied))
+	{
+		is31fl3733_apply_global_current_control(device, gcc);
+	}
+}
+
+static void limit_power(IS31FL3733_91TKL *device)
+{
+	// sums of the frame that was just uploaded
+	uint32_t pwm_sum = (uint32_t)device->upper->device->pwm_sum + device->lower->device->pwm_sum;
+	uint8_t gcc_allowed = 0xFF;
+
+	if (pwm_sum)
+	{
+		uint32_t gcc = (device->global_power_target_milliampere * POWER_ESTIMATE_DIVISOR) / pwm_sum;
+		if (gcc < 0xFF)
+			gcc_allowed = gcc;
+	}
+
+	limit_device_power(device->upper->device, gcc_allowed);
+	limit_device_power(device->lower->device, gcc_allowed);
+}
+
 bool is31fl3733_91tkl_initialized(void)
 {
     return is_initialized;
 }
 
+void is31fl3733_91tkl_hold(IS31FL3733_91TKL *device, bool hold)
+{
+	is_held = hold;
+	if (hold || !pending)
+		return;
+
+	// the buffers kept every change, upload them once
+	if (pending & PENDING_GCC)
+	{
+		is31fl3733_update_global_current_control(device->upper->device);
+		is31fl3733_update_global_current_control(device->lower->device);
+	}
+	pending = 0;
+	is31fl3733_91tkl_update(device);
+}
+
+bool is31fl3733_91tkl_is_held(void)
+{
+	return is_held;
+}
+
 void is31fl3733_91tkl_update(IS31FL3733_91TKL *device)
 {
+	if (is_held)
+	{
+		pending |= PENDING_UPDATE;
+		return;
+	}
+
 	is31fl3733_update(device->upper->device);
 	is31fl3733_update(device->lower->device);
+	limit_power(device);
 }
 
 void is31fl3733_91tkl_update_led_enable(IS31FL3733_91TKL *device)
 {
+	if (is_held)
+	{
+		pending |= PENDING_UPDATE;
+		return;
+	}
+
 	is31fl3733_update_led_enable(device->upper->device);
 	is31fl3733_update_led_enable(device->lower->device);
 }
 
 void is31fl3733_91tkl_update_led_pwm(IS31FL3733_91TKL *device)
 {
+	if (is_held)
+	{
+		pending |= PENDING_UPDATE;
+		return;
+	}
+
 	is31fl3733_update_led_pwm(device->upper->device);
 	is31fl3733_update_led_pwm(device->lower->device);
+	limit_power(device);
+}
+
+void is31fl3733_91tkl_update_led_pwm_half(IS31FL3733_91TKL *device, IS31FL3733_RGB *half)
+{
+	if (is_held)
+	{
+		pending |= PENDING_UPDATE;
+		return;
+	}
+
+	is31fl3733_update_led_pwm(half->device);
+	// uses the sum of the other chip from its last upload
+	limit_power(device);
 }
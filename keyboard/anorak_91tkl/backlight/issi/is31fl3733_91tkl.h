@@ -35,18 +35,41 @@ void is31fl3733_91tkl_fill_rgb_masked(IS31FL3733_91TKL *device, RGB color);
 /// Set brightness level for one color all enabled LEDs.
 void is31fl3733_91tkl_fill_hsv_masked(IS31FL3733_91TKL *device, HSV color);
 
+/// Let both chips play the ABM-1 breathing cycle on all enabled LEDs.
+/// The current PWM buffers are used as the peak brightness of each LED.
+void is31fl3733_91tkl_start_auto_breath(IS31FL3733_91TKL *device, IS31FL3733_ABM const *config);
+/// Stop auto breath mode and return all LEDs to PWM control.
+void is31fl3733_91tkl_stop_auto_breath(IS31FL3733_91TKL *device);
+
+/// Set the global brightness scale (0..255) of the PWM output stage.
+void is31fl3733_91tkl_set_brightness(IS31FL3733_91TKL *device, uint8_t brightness);
+uint8_t is31fl3733_91tkl_get_brightness(IS31FL3733_91TKL *device);
+/// Set the white balance scale (0..255 per color) of the PWM output stage.
+void is31fl3733_91tkl_set_white_balance(IS31FL3733_91TKL *device, RGB balance);
+RGB is31fl3733_91tkl_get_white_balance(IS31FL3733_91TKL *device);
+
 // power target in milliampere
+// every PWM upload estimates the current of the frame and lowers the global current control to keep the target
 void is31fl3733_91tkl_power_target(IS31FL3733_91TKL *device, uint16_t milliampere);
+// estimated current of the last uploaded frame in milliampere
 uint16_t is31fl3733_91tkl_current_power_usage(IS31FL3733_91TKL *device);
 
 bool is31fl3733_91tkl_initialized(void);
 
+/// Hold the chips for a direct access such as the LED fault detection.
+/// While held, PWM, enable and global current changes only go to the buffers and are
+/// uploaded once when the hold is released.
+void is31fl3733_91tkl_hold(IS31FL3733_91TKL *device, bool hold);
+bool is31fl3733_91tkl_is_held(void);
+
 /// Update LED matrix with internal buffer values.
 void is31fl3733_91tkl_update(IS31FL3733_91TKL *device);
 /// Update LED matrix LED enable/disable states with internal buffer values.
 void is31fl3733_91tkl_update_led_enable(IS31FL3733_91TKL *device);
 /// Update LED matrix LED brightness values with internal buffer values.
 void is31fl3733_91tkl_update_led_pwm(IS31FL3733_91TKL *device);
+/// Update the LED brightness values of one chip (device->upper or device->lower) only.
+void is31fl3733_91tkl_update_led_pwm_half(IS31FL3733_91TKL *device, IS31FL3733_RGB *half);
 
 #ifdef __cplusplus
 }
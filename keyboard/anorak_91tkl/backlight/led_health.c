@@ -0,0 +1,193 @@
+
+#include "led_health.h"
+#include "config.h"
+#include "timer.h"
+#include "eeconfig_backlight.h"
+#include "key_led_map.h"
+#include "issi/is31fl3733_91tkl.h"
+#include "../twi/twi_config.h"
+#include "../twi/avr315/twi_transmit_queue.h"
+#include <avr/eeprom.h>
+
+#ifdef DEBUG_BACKLIGHT
+#include "debug.h"
+#else
+#include "nodebug.h"
+#endif
+
+// time without key activity before a check starts
+#define LED_HEALTH_IDLE_TIMEOUT 30000UL
+// time between two checks
+#define LED_HEALTH_SCAN_INTERVAL 3600000UL
+
+typedef enum
+{
+    led_health_idle,
+    led_health_detect,
+    led_health_wait,
+    led_health_read,
+    led_health_save
+} led_health_state;
+
+static led_health_state state = led_health_idle;
+static uint8_t chip;
+static uint8_t read_part;
+static uint8_t save_offset;
+static uint16_t detect_timer;
+static uint32_t last_activity;
+static uint32_t last_scan;
+static bool scanned = false;
+
+static IS31FL3733 *chip_device(uint8_t number)
+{
+    return number ? issi.upper->device : issi.lower->device;
+}
+
+static bool twi_idle(void)
+{
+    return tx_queue_is_empty() && !TWI_Transceiver_Busy();
+}
+
+void led_health_init(void)
+{
+    // eeprom layout: upper faults, then lower faults
+    if (!eeconfig_read_backlight_led_faults(issi.upper->device->faults, false) ||
+        !eeconfig_read_backlight_led_faults(issi.lower->device->faults, true))
+    {
+        dprintf("led health: no saved faults\n");
+    }
+
+    last_activity = timer_read32();
+}
+
+void led_health_key_activity(void)
+{
+    last_activity = timer_read32();
+}
+
+bool led_health_is_scanning(void)
+{
+    return state != led_health_idle && state != led_health_save;
+}
+
+void led_health_request_scan(void)
+{
+    scanned = false;
+}
+
+void led_health_task(void)
+{
+    IS31FL3733 *device;
+
+    switch (state)
+    {
+    case led_health_idle:
+        if (!is31fl3733_91tkl_initialized() || !is31fl3733_91tkl_is_hardware_enabled(&issi))
+            return;
+        if (timer_elapsed32(last_activity) < LED_HEALTH_IDLE_TIMEOUT)
+            return;
+        if (scanned && timer_elapsed32(last_scan) < LED_HEALTH_SCAN_INTERVAL)
+            return;
+
+        // uploads and current changes wait until both chips are read
+        is31fl3733_91tkl_hold(&issi, true);
+        chip = 0;
+        state = led_health_detect;
+        break;
+
+    case led_health_detect:
+        if (!twi_idle())
+            return;
+
+        is31fl3733_start_led_fault_detection(chip_device(chip));
+        state = led_health_wait;
+        break;
+
+    case led_health_wait:
+        // the detection starts when the queued writes have been sent
+        if (!twi_idle())
+            return;
+
+        detect_timer = timer_read();
+        read_part = 0;
+        state = led_health_read;
+        break;
+
+    case led_health_read:
+        if (timer_elapsed(detect_timer) < IS31FL3733_DETECT_TIME_MS || !twi_idle())
+            return;
+
+        // one blocking read of 12 bytes per pass keeps the scan short
+        device = chip_device(chip);
+        is31fl3733_read_led_faults_part(device, device->faults, read_part);
+        if (++read_part < IS31FL3733_FAULT_READ_PARTS)
+            return;
+
+        is31fl3733_end_led_fault_detection(device);
+
+        if (++chip < 2)
+        {
+            state = led_health_detect;
+        }
+        else
+        {
+            is31fl3733_91tkl_hold(&issi, false);
+            save_offset = 0;
+            state = led_health_save;
+        }
+        break;
+
+    case led_health_save:
+        // one byte per pass, never wait for the eeprom
+        if (!eeprom_is_ready())
+            return;
+
+        if (save_offset < EECONFIG_BACKLIGHT_LED_FAULTS_SIZE)
+        {
+            device = (save_offset < EECONFIG_BACKLIGHT_LED_FAULTS_SIZE_HALF) ? issi.upper->device : issi.lower->device;
+            eeconfig_write_backlight_led_fault(save_offset,
+                                               device->faults[save_offset % EECONFIG_BACKLIGHT_LED_FAULTS_SIZE_HALF]);
+            save_offset++;
+            return;
+        }
+
+        eeconfig_write_backlight_led_faults_valid(true);
+        dprintf("led health: %u faulty keys\n", led_health_faulty_key_count());
+
+        scanned = true;
+        last_scan = timer_read32();
+        state = led_health_idle;
+        break;
+    }
+}
+
+uint8_t led_health_faulty_key_count(void)
+{
+    uint8_t count = 0;
+    uint8_t device_number;
+    uint8_t row;
+    uint8_t col;
+
+    for (uint8_t key_row = 0; key_row < MATRIX_ROWS; ++key_row)
+    {
+        for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col)
+        {
+            if (!getLedPosByMatrixKey(key_row, key_col, &device_number, &row, &col))
+                continue;
+
+            IS31FL3733_RGB *device = device_number ? issi.upper : issi.lower;
+
+            for (uint8_t c = 0; c < 3; ++c)
+            {
+                uint8_t sw = row * 3 + device->offsets.color[c];
+                if (device->device->faults[(sw << 1) + (col / 8)] & (0x01 << (col % 8)))
+                {
+                    count++;
+                    break;
+                }
+            }
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,37 @@
+#ifndef KEYBOARD_ANORAK_91TKL_BACKLIGHT_LED_HEALTH_H_
+#define KEYBOARD_ANORAK_91TKL_BACKLIGHT_LED_HEALTH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Background LED open/short detection.
+ *
+ * When the keyboard is idle the chips are checked one after the other,
+ * each step of the check runs in its own pass of the main loop. Faulty LEDs
+ * are kept in IS31FL3733.faults, which is masked out of every upload and of
+ * the power estimation, and saved to the eeprom.
+ */
+
+// load saved faults, call after is31fl3733_91tkl_init()
+void led_health_init(void);
+// run one step of the check, call once per matrix scan
+void led_health_task(void);
+// a key changed state, delays the next check
+void led_health_key_activity(void);
+// a check is in progress: the chips do not show the buffers right now
+bool led_health_is_scanning(void);
+// check again on the next idle window
+void led_health_request_scan(void);
+// number of keys with at least one faulty LED
+uint8_t led_health_faulty_key_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KEYBOARD_ANORAK_91TKL_BACKLIGHT_LED_HEALTH_H_ */
@@ -0,0 +1,45 @@
+
+#include "led_surface_91tkl.h"
+#include "animations/animation_utils.h"
+#include "issi/is31fl3733_91tkl.h"
+#include "matrix.h"
+
+static void surface_set(led_surface *surface, uint8_t row, uint8_t col, led_pixel pixel)
+{
+    RGB color = { .r = pixel.r, .g = pixel.g, .b = pixel.b };
+    draw_keymatrix_rgb_pixel(&issi, row, col, color);
+}
+
+static bool surface_get(led_surface *surface, uint8_t row, uint8_t col, led_pixel *pixel)
+{
+    RGB color;
+
+    if (!read_keymatrix_rgb_pixel(&issi, row, col, &color))
+        return false;
+
+    pixel->r = color.r;
+    pixel->g = color.g;
+    pixel->b = color.b;
+    return true;
+}
+
+static void surface_commit(led_surface *surface)
+{
+    is31fl3733_91tkl_update_led_pwm(&issi);
+}
+
+static led_surface surface_91tkl =
+{
+    .rows = MATRIX_ROWS,
+    .cols = MATRIX_COLS,
+    .flags = LED_SURFACE_RGB,
+    .context = 0,
+    .set = &surface_set,
+    .get = &surface_get,
+    .commit = &surface_commit
+};
+
+led_surface *led_surface_91tkl(void)
+{
+    return &surface_91tkl;
+}
@@ -0,0 +1,21 @@
+#ifndef KEYBOARD_ANORAK_91TKL_BACKLIGHT_LED_SURFACE_91TKL_H_
+#define KEYBOARD_ANORAK_91TKL_BACKLIGHT_LED_SURFACE_91TKL_H_
+
+#include "led_matrix/led_surface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The keys of both IS31FL3733 chips as one RGB led_surface,
+ * drawn through the key to PWM buffer lookup of animation_utils.
+ */
+
+led_surface *led_surface_91tkl(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KEYBOARD_ANORAK_91TKL_BACKLIGHT_LED_SURFACE_91TKL_H_ */
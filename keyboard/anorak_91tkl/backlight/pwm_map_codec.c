@@ -0,0 +1,199 @@
+
+#include "pwm_map_codec.h"
+#include "../crc8.h"
+
+#define PWM_MAP_CODEC_HEADER_SIZE 2
+
+static uint16_t color_distance(RGB a, RGB b)
+{
+    uint16_t distance = 0;
+
+    for (uint8_t i = 0; i < 3; i++)
+        distance += (a.rgb[i] > b.rgb[i]) ? a.rgb[i] - b.rgb[i] : b.rgb[i] - a.rgb[i];
+
+    return distance;
+}
+
+static uint8_t palette_nearest(RGB const *palette, uint8_t colors, RGB color, uint16_t *distance)
+{
+    uint8_t nearest = 0;
+
+    *distance = 0xffff;
+
+    for (uint8_t i = 0; i < colors; i++)
+    {
+        uint16_t d = color_distance(palette[i], color);
+        if (d < *distance)
+        {
+            *distance = d;
+            nearest = i;
+            if (d == 0)
+                break;
+        }
+    }
+
+    return nearest;
+}
+
+static uint8_t *put_run(uint8_t *out, uint8_t index, uint16_t length)
+{
+    while (length)
+    {
+        uint8_t n = (length > PWM_MAP_CODEC_RUN_MAX) ? PWM_MAP_CODEC_RUN_MAX : length;
+        *out++ = (index << 4) | (n - 1);
+        length -= n;
+    }
+
+    return out;
+}
+
+static uint16_t encode_literal(pwm_map_keys const *keys, uint8_t *out)
+{
+    RGB *colors = (RGB *)(out + PWM_MAP_CODEC_HEADER_SIZE);
+
+    for (uint8_t key = 0; key < keys->keys; key++)
+    {
+        if (!keys->get(key, &colors[key]))
+            colors[key].r = colors[key].g = colors[key].b = 0;
+    }
+
+    uint16_t size = PWM_MAP_CODEC_LITERAL_SIZE(keys->keys);
+
+    out[0] = PWM_MAP_CODEC_MAGIC_LITERAL;
+    out[1] = keys->keys;
+    out[size - 1] = crc8_calc(out, PWM_MAP_CODEC_CRC_START, size - 1);
+
+    return size;
+}
+
+uint16_t pwm_map_encode(pwm_map_keys const *keys, uint8_t *out)
+{
+    RGB *palette = (RGB *)(out + PWM_MAP_CODEC_HEADER_SIZE);
+    uint8_t colors = 0;
+    uint16_t distance;
+    RGB color;
+
+    for (uint8_t key = 0; key < keys->keys; key++)
+    {
+        if (!keys->get(key, &color))
+            continue;
+
+        palette_nearest(palette, colors, color, &distance);
+        if (!distance)
+            continue;
+
+        if (colors == PWM_MAP_CODEC_PALETTE_MAX)
+            return encode_literal(keys, out);
+
+        palette[colors++] = color;
+    }
+
+    if (!colors)
+    {
+        color.r = color.g = color.b = 0;
+        palette[colors++] = color;
+    }
+
+    uint8_t *run = out + PWM_MAP_CODEC_HEADER_SIZE + 3 * colors;
+    uint8_t index = 0xff;
+    uint16_t length = 0;
+
+    for (uint8_t key = 0; key < keys->keys; key++)
+    {
+        // keys without a LED extend the current run, the leading ones the first run
+        if (!keys->get(key, &color))
+        {
+            length++;
+            continue;
+        }
+
+        uint8_t nearest = palette_nearest(palette, colors, color, &distance);
+
+        if (index != 0xff && nearest != index)
+        {
+            run = put_run(run, index, length);
+            length = 0;
+        }
+
+        index = nearest;
+        length++;
+    }
+
+    run = put_run(run, (index == 0xff) ? 0 : index, length);
+
+    uint8_t size = (run - out) + 1;
+
+    out[0] = PWM_MAP_CODEC_MAGIC | (colors - 1);
+    out[1] = size;
+    out[size - 1] = crc8_calc(out, PWM_MAP_CODEC_CRC_START, size - 1);
+
+    return size;
+}
+
+uint16_t pwm_map_size(uint8_t const *header)
+{
+    if (header[0] == PWM_MAP_CODEC_MAGIC_LITERAL)
+        return PWM_MAP_CODEC_LITERAL_SIZE(header[1]);
+
+    if ((header[0] & 0xf0) != PWM_MAP_CODEC_MAGIC || header[1] <= PWM_MAP_CODEC_HEADER_SIZE)
+        return 0;
+
+    return header[1];
+}
+
+static bool decode_literal(pwm_map_keys const *keys, uint8_t const *in, uint16_t size)
+{
+    if (in[1] != keys->keys || size != PWM_MAP_CODEC_LITERAL_SIZE(keys->keys))
+        return false;
+
+    RGB const *colors = (RGB const *)(in + PWM_MAP_CODEC_HEADER_SIZE);
+
+    for (uint8_t key = 0; key < keys->keys; key++)
+        keys->set(key, colors[key]);
+
+    return true;
+}
+
+bool pwm_map_decode(pwm_map_keys const *keys, uint8_t const *in, uint16_t size)
+{
+    if (size <= PWM_MAP_CODEC_HEADER_SIZE || pwm_map_size(in) != size)
+        return false;
+
+    if (crc8_calc(in, PWM_MAP_CODEC_CRC_START, size - 1) != in[size - 1])
+        return false;
+
+    if (in[0] == PWM_MAP_CODEC_MAGIC_LITERAL)
+        return decode_literal(keys, in, size);
+
+    uint8_t colors = (in[0] & 0x0f) + 1;
+    RGB const *palette = (RGB const *)(in + PWM_MAP_CODEC_HEADER_SIZE);
+    uint8_t const *runs = in + PWM_MAP_CODEC_HEADER_SIZE + 3 * colors;
+    uint8_t const *end = in + size - 1;
+    uint16_t covered = 0;
+
+    if (runs > end)
+        return false;
+
+    // check all runs before the first key is set
+    for (uint8_t const *run = runs; run < end; run++)
+    {
+        if ((*run >> 4) >= colors)
+            return false;
+        covered += (*run & 0x0f) + 1;
+    }
+
+    if (covered != keys->keys)
+        return false;
+
+    uint8_t key = 0;
+
+    for (uint8_t const *run = runs; run < end; run++)
+    {
+        RGB color = palette[*run >> 4];
+
+        for (uint8_t n = (*run & 0x0f) + 1; n; n--)
+            keys->set(key++, color);
+    }
+
+    return true;
+}
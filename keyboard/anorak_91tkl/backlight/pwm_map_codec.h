@@ -0,0 +1,62 @@
+#ifndef KEYBOARD_ANORAK_91TKL_BACKLIGHT_PWM_MAP_CODEC_H_
+#define KEYBOARD_ANORAK_91TKL_BACKLIGHT_PWM_MAP_CODEC_H_
+
+#include "color.h"
+#include <inttypes.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Custom PWM maps as stored in EEPROM: the key colors in matrix order
+ * (row * MATRIX_COLS + col) as palette indices, run length encoded.
+ *
+ *   MAGIC | colors - 1 , size , palette[colors] (r g b) , runs , crc8
+ *
+ * size counts all bytes including the crc8 (crc8_calc, start PWM_MAP_CODEC_CRC_START).
+ * A run byte is index << 4 | (length - 1). Keys without a LED don't matter and join
+ * the run next to them. A map with more than PWM_MAP_CODEC_PALETTE_MAX colors is
+ * stored literally instead, keys without a LED as black:
+ *
+ *   MAGIC_LITERAL , keys , colors[keys] (r g b) , crc8
+ *
+ * This file has no AVR dependencies, the host tools use it as well.
+ */
+
+#define PWM_MAP_CODEC_MAGIC 0xA0
+#define PWM_MAP_CODEC_MAGIC_LITERAL 0xB0
+#define PWM_MAP_CODEC_CRC_START 0x5C
+#define PWM_MAP_CODEC_PALETTE_MAX 16
+#define PWM_MAP_CODEC_RUN_MAX 16
+
+// one run per key, the literal form is larger from 24 keys on
+#define PWM_MAP_CODEC_PALETTE_SIZE_MAX(keys) (3 + 3 * PWM_MAP_CODEC_PALETTE_MAX + (keys))
+#define PWM_MAP_CODEC_LITERAL_SIZE(keys) (3 + 3 * (keys))
+#define PWM_MAP_CODEC_SIZE_MAX(keys)                                              \
+    ((PWM_MAP_CODEC_LITERAL_SIZE(keys) > PWM_MAP_CODEC_PALETTE_SIZE_MAX(keys)) ?  \
+         PWM_MAP_CODEC_LITERAL_SIZE(keys) :                                       \
+         PWM_MAP_CODEC_PALETTE_SIZE_MAX(keys))
+
+struct pwm_map_keys_t {
+    uint8_t keys;
+    // false for a key without a LED
+    bool (*get)(uint8_t key, RGB *color);
+    void (*set)(uint8_t key, RGB color);
+};
+
+typedef struct pwm_map_keys_t pwm_map_keys;
+
+// writes the encoded map into out (PWM_MAP_CODEC_SIZE_MAX bytes), returns its size
+uint16_t pwm_map_encode(pwm_map_keys const *keys, uint8_t *out);
+// size of the map from its first two bytes, 0 if they are no map header
+uint16_t pwm_map_size(uint8_t const *header);
+// sets all keys, false (and no key set) if in is no valid map
+bool pwm_map_decode(pwm_map_keys const *keys, uint8_t const *in, uint16_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KEYBOARD_ANORAK_91TKL_BACKLIGHT_PWM_MAP_CODEC_H_ */
@@ -4,7 +4,10 @@
 #include "../../utils.h"
 #include "config.h"
 #include "eeconfig.h"
+#include "eeprom_cache.h"
 #include "../eeconfig_backlight.h"
+#include "../key_led_map.h"
+#include "../pwm_map_codec.h"
 #include "sector_led_masks.h"
 
 #include <avr/interrupt.h>
@@ -298,33 +301,170 @@ void sector_save_state()
 #endif
 }
 
+#ifdef BACKLIGHT_ENABLE
+#if PWM_MAP_CODEC_SIZE_MAX(MATRIX_ROWS * MATRIX_COLS) > EECONFIG_BACKLIGHT_PWM_MAP_SIZE
+#error The encoded custom PWM map does not fit into its EEPROM slot
+#endif
+#if EECONFIG_BACKLIGHT_PWM_MAP_SIZE > EECONFIG_BACKLIGHT_PWM_RAW_MAP_SIZE
+#error A slot would reach into the next raw map during sector_migrate_raw_pwm_maps()
+#endif
+
+static IS31FL3733_RGB *pwm_map_led(uint8_t key, uint8_t *row, uint8_t *col)
+{
+    uint8_t device_number;
+
+    if (!getLedPosByMatrixKey(key / MATRIX_COLS, key % MATRIX_COLS, &device_number, row, col))
+        return 0;
+
+    return device_number ? issi.upper : issi.lower;
+}
+
+static bool pwm_map_get_key(uint8_t key, RGB *color)
+{
+    uint8_t row, col;
+    IS31FL3733_RGB *device = pwm_map_led(key, &row, &col);
+
+    if (!device)
+        return false;
+
+    *color = is31fl3733_rgb_get_pwm(device, col, row);
+    return true;
+}
+
+static void pwm_map_set_key(uint8_t key, RGB color)
+{
+    uint8_t row, col;
+    IS31FL3733_RGB *device = pwm_map_led(key, &row, &col);
+
+    if (device)
+        is31fl3733_rgb_set_pwm(device, col, row, color);
+}
+
+static const pwm_map_keys pwm_map_91tkl = {
+    .keys = MATRIX_ROWS * MATRIX_COLS,
+    .get = pwm_map_get_key,
+    .set = pwm_map_set_key,
+};
+
+// the saved map, the EEPROM cache writes it from here behind the main loop
+static uint8_t saved_map[EECONFIG_BACKLIGHT_PWM_MAP_SIZE];
+static uint8_t saved_map_slot = 0xff;
+#endif
+
 void sector_load_custom_pwm_map(void)
 {
 #ifdef BACKLIGHT_ENABLE
     dprintf("sector_load_custom_pwm_map: %u\n", custom_pwm_map);
 
-    uint8_t *buffer;
-    buffer = is31fl3733_pwm_buffer(issi.upper->device);
-    eeconfig_read_backlight_pwm_map(custom_pwm_map, buffer, false);
-    buffer = is31fl3733_pwm_buffer(issi.lower->device);
-    eeconfig_read_backlight_pwm_map(custom_pwm_map, buffer, true);
+    uint8_t buffer[EECONFIG_BACKLIGHT_PWM_MAP_SIZE];
+    uint16_t size = eeconfig_read_backlight_pwm_map(custom_pwm_map, buffer);
+
+    // LEDs between the keys stay dark, an empty slot leaves all keys dark
+    memset(is31fl3733_pwm_buffer(issi.upper->device), 0, IS31FL3733_LED_PWM_SIZE);
+    memset(is31fl3733_pwm_buffer(issi.lower->device), 0, IS31FL3733_LED_PWM_SIZE);
+
+    if (!pwm_map_decode(&pwm_map_91tkl, buffer, size))
+        dprintf("sector_load_custom_pwm_map: no map in slot %u\n", custom_pwm_map);
 
     sector_enable_all_leds();
 #endif
 }
 
-void sector_save_custom_pwm_map(void)
+bool sector_save_custom_pwm_map(void)
 {
 #ifdef BACKLIGHT_ENABLE
     dprintf("sector_save_custom_pwm_map: %u\n", custom_pwm_map);
 
-    uint8_t *buffer;
-    buffer = is31fl3733_pwm_buffer(issi.upper->device);
-    eeconfig_write_backlight_pwm_map(custom_pwm_map, buffer, false);
-    buffer = is31fl3733_pwm_buffer(issi.lower->device);
-    eeconfig_write_backlight_pwm_map(custom_pwm_map, buffer, true);
+    if (custom_pwm_map >= EECONFIG_BACKLIGHT_PWM_MAP_COUNT)
+        return false;
+
+    // the map of another slot is still written from the buffer, the same slot starts over with the new map
+    if (saved_map_slot != custom_pwm_map && eeprom_cache_range_pending(saved_map))
+        return false;
 
+    uint16_t size = pwm_map_encode(&pwm_map_91tkl, saved_map);
+    dprintf("sector_save_custom_pwm_map: %u bytes\n", size);
+
+    if (!eeconfig_write_backlight_pwm_map(custom_pwm_map, saved_map, size))
+        return false;
+    saved_map_slot = custom_pwm_map;
     eeconfig_write_backlight_pwm_active_map(custom_pwm_map);
+#endif
+    return true;
+}
+
+void sector_migrate_raw_pwm_maps(void)
+{
+#ifdef BACKLIGHT_ENABLE
+    static const uint8_t empty_map[2] = {0xff, 0xff};
+    uint8_t *upper = is31fl3733_pwm_buffer(issi.upper->device);
+    uint8_t *lower = is31fl3733_pwm_buffer(issi.lower->device);
+    bool writing;
+
+    /* The slot of a map starts in the raw map before it and ends in its own raw map, no slot
+     * reaches a raw map that is not encoded yet. The progress in the magic word tells a
+     * restart which map was next and whether its slot was being written: that raw map may
+     * be partly overwritten, the map stays empty unless its slot was written completely.
+     */
+    for (uint8_t map = eeconfig_backlight_read_raw_pwm_map_progress(&writing); map < EECONFIG_BACKLIGHT_PWM_MAP_COUNT;
+         map++, writing = false)
+    {
+        uint16_t size = 0;
+
+        if (writing)
+        {
+            size = eeconfig_read_backlight_pwm_map(map, saved_map);
+            if (size && pwm_map_decode(&pwm_map_91tkl, saved_map, size))
+            {
+                dprintf("sector_migrate_raw_pwm_maps: %u: written before\n", map);
+                eeconfig_backlight_write_raw_pwm_map_progress(map + 1, false);
+                eeprom_cache_flush();
+                continue;
+            }
+            size = 0;
+        }
+        else if (map < EECONFIG_BACKLIGHT_PWM_RAW_MAP_COUNT)
+        {
+            eeconfig_read_backlight_pwm_raw_map(map, upper, false);
+            eeconfig_read_backlight_pwm_raw_map(map, lower, true);
+
+            // an erased raw map stays empty instead of becoming a white one
+            uint16_t erased = 0;
+            for (uint16_t i = 0; i < IS31FL3733_LED_PWM_SIZE; i++)
+                erased += (upper[i] == 0xff) + (lower[i] == 0xff);
+
+            if (erased != 2 * IS31FL3733_LED_PWM_SIZE)
+            {
+                // the raw maps hold the PWM values, the output stage applies the CIE curve now
+                for (uint16_t i = 0; i < IS31FL3733_LED_PWM_SIZE; i++)
+                {
+                    upper[i] = cie_inverse(upper[i]);
+                    lower[i] = cie_inverse(lower[i]);
+                }
+                size = pwm_map_encode(&pwm_map_91tkl, saved_map);
+            }
+        }
+
+        dprintf("sector_migrate_raw_pwm_maps: %u: %u bytes\n", map, size);
+
+        eeconfig_backlight_write_raw_pwm_map_progress(map, true);
+        eeprom_cache_flush();
+
+        if (size)
+            eeconfig_write_backlight_pwm_map(map, saved_map, size);
+        else
+            eeconfig_write_backlight_pwm_map(map, empty_map, sizeof(empty_map));
+        eeprom_cache_flush();
+
+        eeconfig_backlight_write_raw_pwm_map_progress(map + 1, false);
+        eeprom_cache_flush();
+    }
+
+    memset(upper, 0, IS31FL3733_LED_PWM_SIZE);
+    memset(lower, 0, IS31FL3733_LED_PWM_SIZE);
+
+    eeconfig_backlight_enable();
+    eeprom_cache_flush();
 #endif
 }
 
@@ -38,7 +38,10 @@ uint8_t sector_get_custom_map(void);
 
 void sector_next_custom_map(void);
 
-void sector_save_custom_pwm_map(void);
+bool sector_save_custom_pwm_map(void);
+// converts the raw maps of an older firmware into encoded ones on the first start, an interrupted
+// migration goes on at the next start
+void sector_migrate_raw_pwm_maps(void);
 
 void sector_dump_state(void);
 void sector_dump_mask(uint8_t *mask);
@@ -1,6 +1,7 @@
 #ifndef CRC8_H_
 #define CRC8_H_
 
+unsigned char crc8_calc_byte(unsigned char crc, unsigned char data);
 unsigned char crc8_calc(unsigned char const *data, unsigned char crc_start, unsigned int len);
 
 #endif /* CRC8_H_ */
@@ -2,23 +2,23 @@
 
 #ifdef STATUS_LED_PWM_ENABLE
 
-#include <avr/eeprom.h>
+#include "eeprom_cache.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 void eeconfig_statusled_enable(void)
 {
-    eeprom_update_word(EECONFIG_STATUSLED_MAGIC, EECONFIG_STATUSLED_MAGIC_NUMBER);
+    eeprom_cache_update_word(EECONFIG_STATUSLED_MAGIC, EECONFIG_STATUSLED_MAGIC_NUMBER);
 }
 
 void eeconfig_statusled_disable(void)
 {
-    eeprom_update_word(EECONFIG_STATUSLED_MAGIC, 0xFFFF);
+    eeprom_cache_update_word(EECONFIG_STATUSLED_MAGIC, 0xFFFF);
 }
 
 bool eeconfig_statusled_brightness_is_enabled(void)
 {
-    return (eeprom_read_word(EECONFIG_STATUSLED_MAGIC) == EECONFIG_STATUSLED_MAGIC_NUMBER);
+    return (eeprom_cache_read_word(EECONFIG_STATUSLED_MAGIC) == EECONFIG_STATUSLED_MAGIC_NUMBER);
 }
 
 void eeconfig_statusled_brightness_init(void)
@@ -32,32 +32,32 @@ void eeconfig_statusled_brightness_init(void)
 
 uint8_t eeconfig_read_scrolllock_led_brightness(void)
 {
-    return eeprom_read_byte(EECONFIG_STATUSLED_SCROLLLOCK);
+    return eeprom_cache_read_byte(EECONFIG_STATUSLED_SCROLLLOCK);
 }
 
 void eeconfig_write_scrolllock_led_brightness(uint8_t val)
 {
-    eeprom_update_byte(EECONFIG_STATUSLED_SCROLLLOCK, val);
+    eeprom_cache_update_byte(EECONFIG_STATUSLED_SCROLLLOCK, val);
 }
 
 uint8_t eeconfig_read_capslock_led_brightness(void)
 {
-    return eeprom_read_byte(EECONFIG_STATUSLED_CAPSLOCK);
+    return eeprom_cache_read_byte(EECONFIG_STATUSLED_CAPSLOCK);
 }
 
 void eeconfig_write_capslock_led_brightness(uint8_t val)
 {
-    eeprom_update_byte(EECONFIG_STATUSLED_CAPSLOCK, val);
+    eeprom_cache_update_byte(EECONFIG_STATUSLED_CAPSLOCK, val);
 }
 
 uint8_t eeconfig_read_numlock_led_brightness(void)
 {
-    return eeprom_read_byte(EECONFIG_STATUSLED_NUMLOCK);
+    return eeprom_cache_read_byte(EECONFIG_STATUSLED_NUMLOCK);
 }
 
 void eeconfig_write_numlock_led_brightness(uint8_t val)
 {
-    eeprom_update_byte(EECONFIG_STATUSLED_NUMLOCK, val);
+    eeprom_cache_update_byte(EECONFIG_STATUSLED_NUMLOCK, val);
 }
 
 #endif
@@ -12,6 +12,7 @@
 #include "backlight/backlight_91tkl.h"
 #include "backlight/issi/is31fl3733_91tkl.h"
 #include "utils.h"
+#include "eeprom_cache.h"
 
 #if defined(LUFA_DEBUG_UART) || defined(DEBUG_ISSI_PERFORMANCE) || defined(DEBUG_OUTPUT_ENABLE)
 #include "uart/uart.h"
@@ -93,6 +94,9 @@ void hook_usb_suspend_entry(void)
     matrix_clear();
     clear_keyboard();
 
+    // the main loop stops, the host may cut the power while suspended
+    eeprom_cache_flush();
+
 #ifdef BACKLIGHT_ENABLE
     suspend_animation();
     is31fl3733_91tkl_hardware_shutdown(&issi, true);
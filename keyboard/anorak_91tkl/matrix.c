@@ -32,6 +32,8 @@
 #include <util/delay.h>
 #include "backlight/animations/animation.h"
 #include "backlight/backlight_91tkl.h"
+#include "backlight/led_health.h"
+#include "virt_ser_stream.h"
 #include "uart/uart.h"
 
 #ifndef DEBOUNCE_TIME
@@ -130,6 +132,7 @@ uint8_t matrix_scan(void)
 				debouncing[row] = false;
 
 				animation_typematrix_row(row, matrix[row]);
+				led_health_key_activity();
 			}
 		}
 		else
@@ -138,7 +141,9 @@ uint8_t matrix_scan(void)
 		}
 	}
 
+	led_health_task();
 	animate();
+	virtser_stream_task();
 
 	return 1;
 }
@@ -0,0 +1,198 @@
+/*
+ * Round trip and size check of the encoded custom PWM maps (backlight/pwm_map_codec.c)
+ * on the 91tkl key layout.
+ *
+ * Every map is encoded, decoded into a cleared key array and compared key by key, all
+ * maps have to come back unchanged. Maps with up to PWM_MAP_CODEC_PALETTE_MAX colors have
+ * to use the palette, the others the literal form. The EEPROM bytes read on a map switch
+ * are compared with the raw map of both chips (2 * 192 bytes) that was stored before, the
+ * decode time is measured on the host.
+ *
+ *   make pwm_map_bench
+ *   ./pwm_map_bench -n 100000
+ */
+
+#include "../backlight/pwm_map_codec.h"
+#include "../backlight/key_led_map.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ROWS 6
+#define COLS 17
+#define KEYS (ROWS * COLS)
+#define RAW_MAP_SIZE (2 * 192)
+// EEPROM slot of a map, EECONFIG_BACKLIGHT_PWM_MAP_SIZE
+#define SLOT_SIZE 320
+
+// clang-format off
+static const uint8_t key_led[ROWS][COLS] = KEY_TO_LED_MAP_91TKL(
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,    1, 1, 1,
+    1, 1, 1, 1,                1, 1, 1, 1,    1, 1, 1
+);
+// clang-format on
+
+static RGB source[KEYS];
+static RGB decoded[KEYS];
+
+static bool has_led(uint8_t key) { return key_led[key / COLS][key % COLS] != NLED; }
+
+static bool source_get(uint8_t key, RGB *color) {
+    if (!has_led(key)) return false;
+    *color = source[key];
+    return true;
+}
+
+static void decoded_set(uint8_t key, RGB color) {
+    if (has_led(key)) decoded[key] = color;
+}
+
+static const pwm_map_keys keys = {.keys = KEYS, .get = source_get, .set = decoded_set};
+
+static RGB rgb(uint8_t r, uint8_t g, uint8_t b) {
+    RGB color = {.r = r, .g = g, .b = b};
+    return color;
+}
+
+/*
+ * maps
+ */
+
+static void map_single(void) {
+    for (int key = 0; key < KEYS; ++key) source[key] = rgb(255, 255, 255);
+}
+
+static void map_rows(void) {
+    static const RGB row_colors[ROWS] = {{{255, 0, 0}}, {{255, 128, 0}}, {{255, 255, 0}}, {{0, 255, 0}}, {{0, 0, 255}}, {{128, 0, 255}}};
+    for (int key = 0; key < KEYS; ++key) source[key] = row_colors[key / COLS];
+}
+
+static void map_wasd(void) {
+    // row 3: tab q w e r, row 2: caps a s d, arrows
+    static const uint8_t highlight[] = {3 * COLS + 2, 2 * COLS + 1, 2 * COLS + 2, 2 * COLS + 3, 0 * COLS + 14, 0 * COLS + 15, 0 * COLS + 16, 1 * COLS + 15};
+    for (int key = 0; key < KEYS; ++key) source[key] = rgb(0, 32, 64);
+    for (unsigned i = 0; i < sizeof(highlight); ++i) source[highlight[i]] = rgb(255, 0, 0);
+}
+
+static void map_columns(void) {
+    // 17 colors, one more than the palette
+    for (int key = 0; key < KEYS; ++key) source[key] = rgb((key % COLS) * 15, 255 - (key % COLS) * 15, 64);
+}
+
+static void map_random_16(void) {
+    RGB palette[PWM_MAP_CODEC_PALETTE_MAX];
+    for (int i = 0; i < PWM_MAP_CODEC_PALETTE_MAX; ++i) palette[i] = rgb(rand(), rand(), rand());
+    for (int key = 0; key < KEYS; ++key) source[key] = palette[rand() % PWM_MAP_CODEC_PALETTE_MAX];
+}
+
+static void map_random(void) {
+    for (int key = 0; key < KEYS; ++key) source[key] = rgb(rand(), rand(), rand());
+}
+
+struct map_t {
+    char const *name;
+    void (*fill)(void);
+    bool palette;
+};
+
+static const struct map_t maps[] = {
+    {"single color", map_single, true},
+    {"row colors", map_rows, true},
+    {"wasd and arrows", map_wasd, true},
+    {"random, 16 colors", map_random_16, true},
+    {"17 columns", map_columns, false},
+    {"random, 91 colors", map_random, false},
+};
+
+static int max_error(void) {
+    int error = 0;
+
+    for (int key = 0; key < KEYS; ++key) {
+        if (!has_led(key)) continue;
+        for (int c = 0; c < 3; ++c) {
+            int d = abs(source[key].rgb[c] - decoded[key].rgb[c]);
+            if (d > error) error = d;
+        }
+    }
+
+    return error;
+}
+
+static double decode_ns(uint8_t const *encoded, uint16_t size, int rounds) {
+    struct timespec start, end;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < rounds; ++i) pwm_map_decode(&keys, encoded, size);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / rounds;
+}
+
+static bool check_corrupt(uint8_t const *encoded, uint16_t size) {
+    uint8_t corrupt[SLOT_SIZE];
+
+    // every single flipped byte has to be rejected without touching a key
+    for (uint16_t i = 0; i < size; ++i) {
+        memcpy(corrupt, encoded, size);
+        corrupt[i] ^= 0x21;
+        memset(decoded, 0, sizeof(decoded));
+        if (pwm_map_decode(&keys, corrupt, size)) return false;
+        for (int key = 0; key < KEYS; ++key)
+            if (decoded[key].r || decoded[key].g || decoded[key].b) return false;
+    }
+
+    // and the erased slot
+    memset(corrupt, 0xFF, sizeof(corrupt));
+    return !pwm_map_decode(&keys, corrupt, 0) && !pwm_map_decode(&keys, corrupt, SLOT_SIZE);
+}
+
+int main(int argc, char **argv) {
+    int rounds = 10000;
+    int failed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                rounds = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n decode_rounds]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    srand(91);
+
+    printf("slot %u bytes, worst case %u bytes, raw map %u bytes\n\n", SLOT_SIZE, PWM_MAP_CODEC_SIZE_MAX(KEYS), RAW_MAP_SIZE);
+    printf("%-20s %8s %6s %10s %10s %8s\n", "map", "form", "bytes", "read raw", "decode ns", "result");
+
+    for (unsigned m = 0; m < sizeof(maps) / sizeof(maps[0]); ++m) {
+        uint8_t encoded[PWM_MAP_CODEC_SIZE_MAX(KEYS)];
+
+        maps[m].fill();
+        uint16_t size = pwm_map_encode(&keys, encoded);
+        bool ok = (encoded[0] != PWM_MAP_CODEC_MAGIC_LITERAL) == maps[m].palette;
+
+        memset(decoded, 0, sizeof(decoded));
+        ok &= pwm_map_decode(&keys, encoded, size) && size == pwm_map_size(encoded) && size <= SLOT_SIZE;
+        if (max_error()) ok = false;
+        if (!check_corrupt(encoded, size)) ok = false;
+
+        double ns = decode_ns(encoded, size, rounds);
+
+        printf("%-20s %8s %6u %9.0f%% %10.0f %8s\n", maps[m].name, (encoded[0] == PWM_MAP_CODEC_MAGIC_LITERAL) ? "literal" : "palette", size,
+               100.0 * size / RAW_MAP_SIZE, ns, ok ? "ok" : "FAILED");
+        if (!ok) failed++;
+    }
+
+    printf("\n%u maps in the EEPROM area of %u raw maps\n", 1920 / SLOT_SIZE, 1920 / RAW_MAP_SIZE);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * Throughput of a full PWM map upload, binary frames against the '.map set' text command.
+ *
+ * The keyboard is replaced by a loopback stand-in that runs the firmware frame
+ * decoder (../virt_ser_frame.c) and answers like frame_command() in virt_ser_rpc.c.
+ * Reported per upload:
+ *
+ *  - bytes on the wire and request/reply round trips
+ *  - 64 byte CDC OUT packets, the firmware drains one packet per virtser_task()
+ *  - host frames per second through encoder, decoder and reply
+ *
+ *   make && ./virtser_bench -n 10000
+ */
+
+#include "virtser_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CDC_EPSIZE 64
+
+struct loopback_t {
+    virtser_frame_decoder decoder;
+    uint8_t               buffer[VIRTSER_FRAME_LENGTH_MAX];
+    uint8_t               map[VIRTSER_KEYS][3];
+    uint8_t               reply[VIRTSER_FRAME_SIZE_MAX];
+    size_t                reply_length;
+    unsigned long         packets;
+};
+
+static void loopback_command(struct loopback_t *device, uint8_t opcode, uint8_t const *payload, uint8_t length) {
+    uint8_t reply[VIRTSER_FRAME_LENGTH_MAX];
+    uint8_t reply_length = 1;
+
+    reply[0] = virtser_frame_ok;
+
+    switch (opcode) {
+        case virtser_frame_ping:
+            memcpy(reply + 1, payload, length);
+            reply_length += length;
+            break;
+
+        case virtser_frame_map_rgb:
+        case virtser_frame_map_hsv:
+            if (length < 2 || (length - 2) % 3 || payload[1] + (length - 2) / 3 > VIRTSER_KEYS) {
+                reply[0] = virtser_frame_bad_length;
+                break;
+            }
+            memcpy(device->map[payload[1]], payload + 2, length - 2);
+            break;
+
+        case virtser_frame_map_update:
+            break;
+
+        default:
+            reply[0] = virtser_frame_unknown_opcode;
+            break;
+    }
+
+    device->reply_length = virtser_frame_encode(device->reply, opcode | VIRTSER_FRAME_REPLY, reply, reply_length);
+}
+
+static int loopback_write(void *context, uint8_t const *data, size_t length) {
+    struct loopback_t *device = context;
+
+    device->packets += (length + CDC_EPSIZE - 1) / CDC_EPSIZE;
+
+    for (size_t i = 0; i < length; ++i) {
+        switch (virtser_frame_decode(&device->decoder, data[i])) {
+            case virtser_frame_complete:
+                loopback_command(device, device->buffer[0], device->buffer + 1, virtser_frame_payload_length(&device->decoder));
+                break;
+            case virtser_frame_corrupt:
+            case virtser_frame_too_long: {
+                uint8_t status       = virtser_frame_crc_error;
+                device->reply_length = virtser_frame_encode(device->reply, device->buffer[0] | VIRTSER_FRAME_REPLY, &status, 1);
+            } break;
+            case virtser_frame_incomplete:
+                break;
+        }
+    }
+
+    return length;
+}
+
+static int loopback_read(void *context, uint8_t *data, size_t length) {
+    struct loopback_t *device = context;
+
+    if (length > device->reply_length) length = device->reply_length;
+
+    memcpy(data, device->reply, length);
+    device->reply_length -= length;
+    memmove(device->reply, device->reply + length, device->reply_length);
+
+    return length;
+}
+
+// the text shell gets one '.map set' command per matrix row and answers each of them
+static void text_upload(uint8_t const colors[VIRTSER_KEYS][3], unsigned long *bytes, unsigned long *packets, unsigned long *round_trips) {
+    char command[512];
+
+    for (int row = 0; row < VIRTSER_KEYS / VIRTSER_COLS; ++row) {
+        int n = sprintf(command, "!map set {\"map\":0,\"row\":%d,\"cols\":[", row);
+
+        for (int col = 0; col < VIRTSER_COLS; ++col) {
+            uint8_t const *c = colors[row * VIRTSER_COLS + col];
+            n += sprintf(command + n, "%s[%d,\"%02X%02X%02X\"]", col ? "," : "", col, c[0], c[1], c[2]);
+        }
+
+        n += sprintf(command + n, "]}\n");
+
+        // ".map set #\n>OK\n"
+        int reply = strlen(".map set 0\n>OK\n");
+
+        *bytes += n + reply;
+        *packets += (n + CDC_EPSIZE - 1) / CDC_EPSIZE;
+        *round_trips += 1;
+    }
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    int iterations = 10000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n iterations]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    static struct loopback_t device;
+    static uint8_t           colors[VIRTSER_KEYS][3];
+    virtser_client           client;
+
+    virtser_frame_decoder_init(&device.decoder, device.buffer);
+    virtser_transport transport = {&device, loopback_write, loopback_read};
+    virtser_client_init(&client, transport);
+
+    srand(91);
+    for (int key = 0; key < VIRTSER_KEYS; ++key)
+        for (int c = 0; c < 3; ++c) colors[key][c] = rand();
+
+    // one upload for the wire statistics and to check that the map arrived
+    if (virtser_client_upload_map(&client, 0, 0, colors) != virtser_frame_ok || memcmp(device.map, colors, sizeof(colors)) != 0) {
+        fprintf(stderr, "loopback upload failed\n");
+        return 1;
+    }
+
+    unsigned long text_bytes = 0, text_packets = 0, text_round_trips = 0;
+    text_upload(colors, &text_bytes, &text_packets, &text_round_trips);
+
+    printf("full map, %d keys          bytes  packets  round trips\n", VIRTSER_KEYS);
+    printf("  binary frames       %8lu %8lu %12lu\n", client.tx_bytes + client.rx_bytes, device.packets, client.frames);
+    printf("  text '.map set'     %8lu %8lu %12lu\n", text_bytes, text_packets, text_round_trips);
+
+    unsigned long frames = client.frames;
+    double        start  = now();
+
+    for (int i = 0; i < iterations; ++i) virtser_client_upload_map(&client, 0, i & 1, colors);
+
+    double elapsed = now() - start;
+    frames         = client.frames - frames;
+
+    printf("\nhost loopback: %d uploads in %.3f s, %.0f frames/s, %.1f MB/s\n", iterations, elapsed, frames / elapsed, (client.tx_bytes + client.rx_bytes) / elapsed / 1e6);
+
+    return 0;
+}
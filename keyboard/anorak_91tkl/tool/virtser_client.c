@@ -0,0 +1,190 @@
+/*
+ * Host client for the binary frames of virt_ser_rpc, see virtser_client.h.
+ */
+
+#include "virtser_client.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+struct tty_context_t {
+    int fd;
+    int timeout_ms;
+};
+
+static struct tty_context_t tty;
+
+static int tty_write(void *context, uint8_t const *data, size_t length) {
+    struct tty_context_t *t       = context;
+    size_t                written = 0;
+
+    while (written < length) {
+        ssize_t n = write(t->fd, data + written, length - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        written += n;
+    }
+
+    return written;
+}
+
+static int tty_read(void *context, uint8_t *data, size_t length) {
+    struct tty_context_t *t   = context;
+    struct pollfd         pfd = {.fd = t->fd, .events = POLLIN};
+
+    int ready = poll(&pfd, 1, t->timeout_ms);
+    if (ready <= 0) return ready;
+
+    return read(t->fd, data, length);
+}
+
+void virtser_client_init(virtser_client *client, virtser_transport transport) {
+    memset(client, 0, sizeof(*client));
+    client->transport = transport;
+    virtser_frame_decoder_init(&client->decoder, client->buffer);
+}
+
+int virtser_client_open_tty(virtser_client *client, char const *path, int timeout_ms) {
+    struct termios options;
+
+    tty.fd = open(path, O_RDWR | O_NOCTTY);
+    if (tty.fd < 0) return -1;
+
+    tty.timeout_ms = timeout_ms;
+
+    tcgetattr(tty.fd, &options);
+    cfmakeraw(&options);
+    cfsetispeed(&options, B115200);
+    cfsetospeed(&options, B115200);
+    tcsetattr(tty.fd, TCSANOW, &options);
+    tcflush(tty.fd, TCIOFLUSH);
+
+    virtser_transport transport = {&tty, tty_write, tty_read};
+    virtser_client_init(client, transport);
+
+    return 0;
+}
+
+void virtser_client_close_tty(virtser_client *client) {
+    (void)client;
+    if (tty.fd >= 0) close(tty.fd);
+    tty.fd = -1;
+}
+
+static int receive_reply(virtser_client *client, uint8_t opcode, virtser_reply *reply) {
+    uint8_t data[64];
+
+    virtser_frame_decoder_reset(&client->decoder);
+
+    for (;;) {
+        int n = client->transport.read(client->transport.context, data, sizeof(data));
+        if (n <= 0) return -1;
+
+        client->rx_bytes += n;
+
+        // text output of the shell may be interleaved, the decoder skips it until the sync byte
+        for (int i = 0; i < n; ++i) {
+            enum virtser_frame_result result = virtser_frame_decode(&client->decoder, data[i]);
+            if (result != virtser_frame_complete) continue;
+
+            uint8_t length = virtser_frame_payload_length(&client->decoder);
+            if (client->buffer[0] != (opcode | VIRTSER_FRAME_REPLY) || length == 0) continue;
+
+            reply->opcode = client->buffer[0] & ~VIRTSER_FRAME_REPLY;
+            reply->status = client->buffer[1];
+            reply->length = length - 1;
+            memcpy(reply->data, client->buffer + 2, reply->length);
+
+            return reply->status;
+        }
+    }
+}
+
+int virtser_client_request(virtser_client *client, uint8_t opcode, uint8_t const *payload, uint8_t length, virtser_reply *reply) {
+    uint8_t       frame[VIRTSER_FRAME_SIZE_MAX];
+    virtser_reply ignored;
+
+    uint8_t size = virtser_frame_encode(frame, opcode, payload, length);
+
+    if (client->transport.write(client->transport.context, frame, size) != size) return -1;
+
+    client->tx_bytes += size;
+    client->frames++;
+
+    return receive_reply(client, opcode, reply ? reply : &ignored);
+}
+
+int virtser_client_upload_map(virtser_client *client, uint8_t map, int is_hsv, uint8_t const colors[VIRTSER_KEYS][3]) {
+    // map, first key and as many keys as fit into one frame
+    enum { keys_per_frame = (VIRTSER_FRAME_LENGTH_MAX - 1 - 2) / 3 };
+
+    uint8_t payload[VIRTSER_FRAME_LENGTH_MAX];
+    uint8_t opcode = is_hsv ? virtser_frame_map_hsv : virtser_frame_map_rgb;
+
+    for (int key = 0; key < VIRTSER_KEYS; key += keys_per_frame) {
+        int count = VIRTSER_KEYS - key;
+        if (count > keys_per_frame) count = keys_per_frame;
+
+        payload[0] = map;
+        payload[1] = key;
+        memcpy(payload + 2, colors[key], count * 3);
+
+        int status = virtser_client_request(client, opcode, payload, 2 + count * 3, 0);
+        if (status != virtser_frame_ok) return status;
+    }
+
+    return virtser_client_request(client, virtser_frame_map_update, 0, 0, 0);
+}
+
+int virtser_client_stream_start(virtser_client *client, uint16_t frames) {
+    uint8_t       payload[2] = {frames & 0xff, frames >> 8};
+    virtser_reply reply;
+
+    int status = virtser_client_request(client, virtser_frame_stream_start, payload, sizeof(payload), &reply);
+    if (status != virtser_frame_ok || reply.length != 2) return -1;
+
+    return reply.data[0] | (reply.data[1] << 8);
+}
+
+int virtser_client_stream_frame(virtser_client *client, uint8_t const *frame, size_t size) {
+    if (client->transport.write(client->transport.context, frame, size) != (int)size) return -1;
+
+    client->tx_bytes += size;
+    client->frames++;
+
+    return 0;
+}
+
+int virtser_client_stream_end(virtser_client *client, uint16_t *uploaded) {
+    virtser_reply reply;
+    int           status = -1;
+
+    // an endless stream ends after the timeout of the keyboard, longer than the read timeout
+    for (int attempt = 0; attempt < 8 && status < 0; ++attempt) status = receive_reply(client, virtser_frame_stream_end, &reply);
+
+    if (status >= 0 && uploaded) *uploaded = reply.length == 2 ? reply.data[0] | (reply.data[1] << 8) : 0;
+
+    return status;
+}
+
+char const *virtser_client_status_name(int status) {
+    switch (status) {
+        case virtser_frame_ok:
+            return "ok";
+        case virtser_frame_error:
+            return "error";
+        case virtser_frame_crc_error:
+            return "crc error";
+        case virtser_frame_unknown_opcode:
+            return "unknown opcode";
+        case virtser_frame_bad_length:
+            return "bad length";
+        default:
+            return "no reply";
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef KEYBOARD_ANORAK_91TKL_TOOL_VIRTSER_CLIENT_H_
+#define KEYBOARD_ANORAK_91TKL_TOOL_VIRTSER_CLIENT_H_
+
+#include "../virt_ser_frame.h"
+#include <stddef.h>
+
+/*
+ * Host side of the binary frames on the 91tkl virtual serial port.
+ *
+ * The transport is a pair of callbacks, virtser_client_open_tty() fills it for a
+ * cdc_acm device, the benchmark plugs in a loopback that runs the firmware decoder.
+ */
+
+#define VIRTSER_KEYS (6 * 17)
+#define VIRTSER_COLS 17
+
+struct virtser_transport_t {
+    void *context;
+    // both return the number of bytes transferred or -1, read may return 0 on timeout
+    int (*write)(void *context, uint8_t const *data, size_t length);
+    int (*read)(void *context, uint8_t *data, size_t length);
+};
+
+typedef struct virtser_transport_t virtser_transport;
+
+struct virtser_reply_t {
+    uint8_t opcode;
+    uint8_t status;
+    uint8_t length;
+    uint8_t data[VIRTSER_FRAME_LENGTH_MAX];
+};
+
+typedef struct virtser_reply_t virtser_reply;
+
+struct virtser_client_t {
+    virtser_transport transport;
+    virtser_frame_decoder decoder;
+    uint8_t buffer[VIRTSER_FRAME_LENGTH_MAX];
+    // bytes and frames sent, for the benchmark
+    unsigned long tx_bytes;
+    unsigned long rx_bytes;
+    unsigned long frames;
+};
+
+typedef struct virtser_client_t virtser_client;
+
+void virtser_client_init(virtser_client *client, virtser_transport transport);
+
+// raw mode, 115200 (ignored by cdc_acm), reads time out after timeout_ms
+int virtser_client_open_tty(virtser_client *client, char const *path, int timeout_ms);
+void virtser_client_close_tty(virtser_client *client);
+
+// sends a frame and waits for its reply, returns the reply status or -1 on a transport error
+int virtser_client_request(virtser_client *client, uint8_t opcode, uint8_t const *payload, uint8_t length, virtser_reply *reply);
+
+// uploads r g b (or h s v) for all keys, key = row * VIRTSER_COLS + col, and updates the LEDs
+int virtser_client_upload_map(virtser_client *client, uint8_t map, int is_hsv, uint8_t const colors[VIRTSER_KEYS][3]);
+
+// asks for a stream of raw PWM frames (0 frames: until the keyboard times out), returns the frame size or -1
+int virtser_client_stream_start(virtser_client *client, uint16_t frames);
+// sends one frame of the size returned by virtser_client_stream_start, blocks while the keyboard uploads
+int virtser_client_stream_frame(virtser_client *client, uint8_t const *frame, size_t size);
+// waits for the end of the stream, returns its status, uploaded receives the frames shown by the keyboard
+int virtser_client_stream_end(virtser_client *client, uint16_t *uploaded);
+
+char const *virtser_client_status_name(int status);
+
+#endif /* KEYBOARD_ANORAK_91TKL_TOOL_VIRTSER_CLIENT_H_ */
@@ -0,0 +1,246 @@
+/*
+ * Fuzz and throughput check of the '.map set' JSON push reader (virt_ser_json.c).
+ *
+ * Generated rows with random whitespace, key order and length have to come back pair by pair.
+ * Mutated rows (flipped, inserted, deleted bytes, cut lines) and random bytes must never make
+ * the reader touch memory it does not own, build with -fsanitize to check that. The throughput
+ * is compared with jsmn on the same rows, the tokenizer the text shell used before.
+ *
+ *   make virtser_json_bench
+ *   ./virtser_json_bench -n 100000
+ */
+
+#include "../virt_ser_json.h"
+#include "../jsonparser/jsmn.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PAIRS_MAX 200
+#define LINE_MAX_SIZE 8192
+// the token array and the line buffer of the shell before the push reader, in AVR sizes
+#define JSMN_TOKENS 70
+#define JSMN_TOKEN_SIZE_AVR 8
+#define RECV_BUFFER_SIZE 300
+// virtser_json_map on AVR: 2 callbacks, 3 state bytes, number, row, col, color, has_row, map, 2 counters
+#define READER_SIZE_AVR (2 * 2 + 3 + 2 + 2 + 3 + 1 + 1 + 2 * 2)
+
+struct pair_t {
+    uint8_t col;
+    RGB color;
+};
+
+static struct pair_t expected[PAIRS_MAX];
+static int expected_count;
+static int expected_row;
+
+static struct pair_t received[PAIRS_MAX];
+static int received_count;
+static int received_row;
+static int selected_map;
+
+static void on_map(uint8_t map) { selected_map = map; }
+
+static bool on_key(uint8_t row, uint8_t col, RGB color) {
+    received_row = row;
+    if (received_count < PAIRS_MAX) {
+        received[received_count].col = col;
+        received[received_count].color = color;
+    }
+    received_count++;
+    return true;
+}
+
+static virtser_json_map reader = {.map = on_map, .key = on_key};
+
+static void reset(void) {
+    virtser_json_map_init(&reader);
+    received_count = 0;
+    received_row = -1;
+    selected_map = -1;
+}
+
+static bool push_line(char const *line, size_t length) {
+    reset();
+    for (size_t i = 0; i < length; ++i) virtser_json_map_push(&reader, line[i]);
+    return virtser_json_map_complete(&reader);
+}
+
+static int space(char *out, bool allowed) {
+    static const char spaces[] = " \t\r";
+    int n = 0;
+    if (allowed)
+        while (rand() % 4 == 0) out[n++] = spaces[rand() % 3];
+    return n;
+}
+
+// a valid row, pretty or compact
+static int generate(char *out, int pairs, bool pretty) {
+    int n = 0;
+
+    expected_count = pairs;
+    expected_row = rand() % 6;
+
+    n += space(out + n, pretty);
+    out[n++] = '{';
+    n += space(out + n, pretty);
+
+    if (rand() & 1)
+        n += sprintf(out + n, "\"map\":%d,\"row\":%d,", 3, expected_row);
+    else
+        n += sprintf(out + n, "\"row\":%d,\"map\":%d,", expected_row, 3);
+
+    n += sprintf(out + n, "\"cols\"");
+    n += space(out + n, pretty);
+    out[n++] = ':';
+    n += space(out + n, pretty);
+    out[n++] = '[';
+
+    for (int i = 0; i < pairs; ++i) {
+        struct pair_t *p = &expected[i];
+        p->col = rand() % 17;
+        for (int c = 0; c < 3; ++c) p->color.rgb[c] = rand();
+
+        if (i) out[n++] = ',';
+        n += space(out + n, pretty);
+        out[n++] = '[';
+        n += space(out + n, pretty);
+        n += snprintf(out + n, LINE_MAX_SIZE - n, "%u", p->col);
+        n += space(out + n, pretty);
+        out[n++] = ',';
+        n += space(out + n, pretty);
+        n += sprintf(out + n, (rand() & 1) ? "\"%02X%02X%02X\"" : "\"%02x%02x%02x\"", p->color.r, p->color.g, p->color.b);
+        n += space(out + n, pretty);
+        out[n++] = ']';
+    }
+
+    n += space(out + n, pretty);
+    out[n++] = ']';
+    n += space(out + n, pretty);
+    out[n++] = '}';
+    n += space(out + n, pretty);
+    out[n] = '\0';
+
+    return n;
+}
+
+static bool matches(void) {
+    if (received_count != expected_count || selected_map != 3) return false;
+    if (expected_count && received_row != expected_row) return false;
+
+    for (int i = 0; i < expected_count; ++i) {
+        if (received[i].col != expected[i].col) return false;
+        if (memcmp(received[i].color.rgb, expected[i].color.rgb, 3)) return false;
+    }
+
+    return true;
+}
+
+static int mutate(char *line, int length) {
+    switch (rand() % 4) {
+        case 0:
+            line[rand() % length] ^= 1 << (rand() % 8);
+            break;
+        case 1: {
+            int at = rand() % length;
+            memmove(line + at + 1, line + at, length - at);
+            line[at] = "{}[],:\"0aF \\"[rand() % 12];
+            length++;
+            break;
+        }
+        case 2: {
+            int at = rand() % length;
+            memmove(line + at, line + at + 1, length - at - 1);
+            length--;
+            break;
+        }
+        default:
+            length = rand() % length;
+            break;
+    }
+
+    return length;
+}
+
+static double seconds(struct timespec const *start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static double jsmn_throughput(char const *line, int length, int rounds) {
+    jsmntok_t tokens[JSMN_TOKENS];
+    jsmn_parser parser;
+    struct timespec start;
+    volatile int r = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < rounds; ++i) {
+        jsmn_init(&parser);
+        r += jsmn_parse(&parser, line, length, tokens, JSMN_TOKENS);
+    }
+
+    return (double)length * rounds / seconds(&start) / 1e6;
+}
+
+static double reader_throughput(char const *line, int length, int rounds) {
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < rounds; ++i) push_line(line, length);
+
+    return (double)length * rounds / seconds(&start) / 1e6;
+}
+
+int main(int argc, char **argv) {
+    static char line[LINE_MAX_SIZE];
+    int rounds = 20000;
+    int failed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                rounds = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n rounds]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    srand(91);
+
+    // valid rows, up to PAIRS_MAX pairs, far longer than the old 300 byte line
+    for (int i = 0; i < rounds; ++i) {
+        int length = generate(line, rand() % (PAIRS_MAX + 1), i & 1);
+        if (!push_line(line, length) || !matches()) {
+            if (failed++ < 5) printf("valid row rejected: %s\n", line);
+        }
+    }
+    printf("valid rows: %d, %d failed\n", rounds, failed);
+
+    // mutated rows and noise, the reader has to stay inside its state
+    int accepted = 0;
+    for (int i = 0; i < rounds; ++i) {
+        int length = generate(line, rand() % 40, i & 1);
+        for (int m = rand() % 4; m >= 0 && length > 0; --m) length = mutate(line, length);
+        if (push_line(line, length)) accepted++;
+    }
+    for (int i = 0; i < rounds; ++i) {
+        int length = rand() % 256;
+        for (int c = 0; c < length; ++c) line[c] = rand();
+        if (push_line(line, length)) accepted++;
+    }
+    printf("mutated rows and noise: %d, %d still valid JSON maps\n", 2 * rounds, accepted);
+
+    // a row of the 91tkl as the host tools send it
+    int length = generate(line, 17, false);
+    printf("\n%-24s %10s %12s\n", "17 key row", "MB/s host", "RAM bytes");
+    printf("%-24s %10.1f %12u\n", "jsmn, buffered line", jsmn_throughput(line, length, rounds), JSMN_TOKENS * JSMN_TOKEN_SIZE_AVR + RECV_BUFFER_SIZE);
+    printf("%-24s %10.1f %12u\n", "push reader", reader_throughput(line, length, rounds), READER_SIZE_AVR);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+/*
+ * Streams raw PWM frames to the 91tkl, see virt_ser_stream.h for the frame layout.
+ *
+ *   visualizer | ./virtser_stream -d /dev/ttyACM0 -i -      frames from stdin
+ *   ./virtser_stream -d /dev/ttyACM0 -n 300 -r 30            test pattern at 30 fps
+ *   ./virtser_stream -l -n 1000                              pty loopback, as fast as possible
+ *
+ * The loopback replaces the keyboard by a thread on the master side of a pty: it runs the
+ * firmware frame decoder, reads the raw frames and spends -u microseconds per frame on the
+ * "upload" without reading, the default is the I2C time of both chips at 400 kHz. The pty
+ * buffer fills up like the CDC endpoint and the streamer is throttled the same way.
+ */
+
+#include "virtser_client.h"
+#include <poll.h>
+#include <pthread.h>
+#include <pty.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// 2 chips, 12 SW lines of start, address, register and 16 PWM bytes, 9 bits each
+#define UPLOAD_US (2 * 12 * 19 * 9 * 1000000L / 400000)
+
+struct loopback_t {
+    int fd;
+    long upload_us;
+    uint16_t uploaded;
+    double elapsed;
+};
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void loopback_reply(struct loopback_t *device, uint8_t opcode, uint8_t status, uint8_t const *data, uint8_t length) {
+    uint8_t payload[VIRTSER_FRAME_LENGTH_MAX];
+    uint8_t frame[VIRTSER_FRAME_SIZE_MAX];
+
+    payload[0] = status;
+    memcpy(payload + 1, data, length);
+
+    uint8_t size = virtser_frame_encode(frame, opcode | VIRTSER_FRAME_REPLY, payload, length + 1);
+    if (write(device->fd, frame, size) != size) perror("loopback");
+}
+
+static int loopback_read(int fd, uint8_t *data, size_t length, int timeout_ms) {
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+
+    if (poll(&pfd, 1, timeout_ms) <= 0) return 0;
+
+    return read(fd, data, length);
+}
+
+// the keyboard side of virt_ser_rpc.c and virt_ser_stream.c for one stream
+static void *loopback_keyboard(void *context) {
+    struct loopback_t    *device = context;
+    virtser_frame_decoder decoder;
+    uint8_t               buffer[VIRTSER_FRAME_LENGTH_MAX];
+    uint8_t               data[512];
+    uint16_t              frames = 0;
+    int                   n      = 0;
+    int                   i      = 0;
+
+    virtser_frame_decoder_init(&decoder, buffer);
+
+    // wait for virtser_frame_stream_start
+    for (;;) {
+        n = loopback_read(device->fd, data, sizeof(data), 5000);
+        if (n <= 0) return 0;
+
+        for (i = 0; i < n; ++i) {
+            if (virtser_frame_decode(&decoder, data[i]) == virtser_frame_complete && buffer[0] == virtser_frame_stream_start) break;
+        }
+
+        if (i < n) break;
+    }
+
+    frames              = buffer[1] | (buffer[2] << 8);
+    uint8_t frame_size[2] = {(2 * 192) & 0xff, (2 * 192) >> 8};
+    loopback_reply(device, virtser_frame_stream_start, virtser_frame_ok, frame_size, 2);
+
+    double   start = now();
+    uint16_t pos   = 0;
+
+    // raw frame data following the start frame in the same read
+    n -= i + 1;
+    memmove(data, data + i + 1, n);
+
+    for (;;) {
+        for (i = 0; i < n; ++i) {
+            if (++pos < 2 * 192) continue;
+
+            // the upload, nothing is read meanwhile
+            pos = 0;
+            usleep(device->upload_us);
+            device->uploaded++;
+        }
+
+        if (frames && device->uploaded >= frames) break;
+
+        n = loopback_read(device->fd, data, sizeof(data), 1000);
+        if (n <= 0) break;
+    }
+
+    device->elapsed = now() - start;
+
+    uint8_t status = (frames && device->uploaded != frames) ? virtser_frame_error : virtser_frame_ok;
+    loopback_reply(device, virtser_frame_stream_end, status, (uint8_t const *)&device->uploaded, 2);
+
+    return 0;
+}
+
+static void test_pattern(uint8_t *frame, int size, int number) {
+    for (int i = 0; i < size; ++i) frame[i] = (uint8_t)((i % 192) + number * 4);
+}
+
+static void usage(char const *name) { fprintf(stderr, "usage: %s [-d device | -l] [-i file|-] [-n frames] [-r fps] [-u upload_us]\n", name); }
+
+int main(int argc, char **argv) {
+    char const *device    = "/dev/ttyACM0";
+    char const *input     = 0;
+    int         loopback  = 0;
+    int         frames    = 300;
+    int         fps       = 0;
+    long        upload_us = UPLOAD_US;
+    int         opt;
+
+    while ((opt = getopt(argc, argv, "d:li:n:r:u:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                device = optarg;
+                break;
+            case 'l':
+                loopback = 1;
+                break;
+            case 'i':
+                input = optarg;
+                break;
+            case 'n':
+                frames = atoi(optarg);
+                break;
+            case 'r':
+                fps = atoi(optarg);
+                break;
+            case 'u':
+                upload_us = atol(optarg);
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    struct loopback_t keyboard = {.upload_us = upload_us};
+    pthread_t         thread;
+    char              slave[64];
+    int               slave_fd = -1;
+
+    if (loopback) {
+        if (openpty(&keyboard.fd, &slave_fd, slave, 0, 0) < 0) {
+            perror("openpty");
+            return 1;
+        }
+
+        device = slave;
+        pthread_create(&thread, 0, loopback_keyboard, &keyboard);
+    }
+
+    FILE *in = 0;
+    if (input) {
+        in = strcmp(input, "-") == 0 ? stdin : fopen(input, "rb");
+        if (!in) {
+            perror(input);
+            return 1;
+        }
+    }
+
+    virtser_client client;
+    if (virtser_client_open_tty(&client, device, 2000) < 0) {
+        perror(device);
+        return 1;
+    }
+
+    // the pty stays open through the client from here on
+    if (slave_fd >= 0) close(slave_fd);
+
+    // 0 frames when reading a file, the stream ends with its last frame and the timeout
+    int size = virtser_client_stream_start(&client, in ? 0 : frames);
+    if (size <= 0) {
+        fprintf(stderr, "%s: no stream\n", device);
+        return 1;
+    }
+
+    uint8_t *frame = malloc(size);
+    double   start = now();
+    int      sent  = 0;
+
+    for (; in || sent < frames; ++sent) {
+        if (in) {
+            if (fread(frame, size, 1, in) != 1) break;
+        } else {
+            test_pattern(frame, size, sent);
+        }
+
+        if (fps) {
+            double due = start + (double)sent / fps;
+            double t   = now();
+            if (due > t) usleep((due - t) * 1e6);
+        }
+
+        if (virtser_client_stream_frame(&client, frame, size) < 0) {
+            perror(device);
+            break;
+        }
+    }
+
+    double   elapsed  = now() - start;
+    uint16_t uploaded = 0;
+    int      status   = virtser_client_stream_end(&client, &uploaded);
+
+    printf("sent %d frames of %d bytes in %.2f s, %.1f fps, %.1f kB/s\n", sent, size, elapsed, sent / elapsed, sent * size / elapsed / 1000);
+    printf("stream end: %s, %u frames uploaded\n", virtser_client_status_name(status), uploaded);
+
+    if (loopback) {
+        pthread_join(thread, 0);
+        printf("loopback: %u frames in %.2f s, %.1f fps with %ld us per upload\n", keyboard.uploaded, keyboard.elapsed, keyboard.uploaded / keyboard.elapsed, upload_us);
+    }
+
+    virtser_client_close_tty(&client);
+    free(frame);
+    if (in && in != stdin) fclose(in);
+
+    return status == virtser_frame_ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+/*
+ * Command line client for the binary frames of the 91tkl virtual serial port.
+ *
+ *   ./virtser_tool -d /dev/ttyACM0 ping
+ *   ./virtser_tool -d /dev/ttyACM0 map 0 FF0000          all keys of map 0 red
+ *   ./virtser_tool -d /dev/ttyACM0 sector 2 1 55 FF FF
+ *   ./virtser_tool -d /dev/ttyACM0 animation 3 1
+ *   ./virtser_tool -d /dev/ttyACM0 fps 30
+ *   ./virtser_tool -d /dev/ttyACM0 save
+ *
+ * Numbers after the command are hex, like the text shell prints them.
+ */
+
+#include "virtser_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void usage(char const *name) {
+    fprintf(stderr, "usage: %s [-d device] [-t timeout_ms] command [args]\n", name);
+    fprintf(stderr, "  ping | map # rrggbb | sector # 0|1 h s v | animation # 0|1 | color 0|1 h s v | fps # | update | save\n");
+}
+
+static uint8_t hex(char const *s) { return strtoul(s, 0, 16); }
+
+static int print_reply(char const *command, int status, virtser_reply const *reply) {
+    printf("%s: %s", command, virtser_client_status_name(status));
+    for (int i = 0; status >= 0 && i < reply->length; ++i) printf(" %02X", reply->data[i]);
+    printf("\n");
+
+    return status == virtser_frame_ok ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    char const *device     = "/dev/ttyACM0";
+    int         timeout_ms = 500;
+    int         opt;
+
+    while ((opt = getopt(argc, argv, "d:t:h")) != -1) {
+        switch (opt) {
+            case 'd':
+                device = optarg;
+                break;
+            case 't':
+                timeout_ms = atoi(optarg);
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    char const *command = argv[optind];
+    char      **args    = argv + optind + 1;
+    int         nargs   = argc - optind - 1;
+
+    virtser_client client;
+    virtser_reply  reply;
+    uint8_t        payload[5];
+    int            status;
+
+    if (virtser_client_open_tty(&client, device, timeout_ms) < 0) {
+        perror(device);
+        return 1;
+    }
+
+    if (strcmp(command, "ping") == 0) {
+        status = virtser_client_request(&client, virtser_frame_ping, (uint8_t const *)"91tkl", 5, &reply);
+    } else if (strcmp(command, "map") == 0 && nargs == 2) {
+        static uint8_t colors[VIRTSER_KEYS][3];
+        uint32_t       rgb = strtoul(args[1], 0, 16);
+
+        for (int key = 0; key < VIRTSER_KEYS; ++key) {
+            colors[key][0] = rgb >> 16;
+            colors[key][1] = rgb >> 8;
+            colors[key][2] = rgb;
+        }
+
+        status       = virtser_client_upload_map(&client, hex(args[0]), 0, colors);
+        reply.length = 0;
+    } else if (strcmp(command, "sector") == 0 && nargs == 5) {
+        for (int i = 0; i < 5; ++i) payload[i] = hex(args[i]);
+        status = virtser_client_request(&client, virtser_frame_sector_set, payload, 5, &reply);
+    } else if (strcmp(command, "animation") == 0 && nargs == 2) {
+        for (int i = 0; i < 2; ++i) payload[i] = hex(args[i]);
+        status = virtser_client_request(&client, virtser_frame_animation_run, payload, 2, &reply);
+    } else if (strcmp(command, "color") == 0 && nargs == 4) {
+        for (int i = 0; i < 4; ++i) payload[i] = hex(args[i]);
+        status = virtser_client_request(&client, virtser_frame_animation_hsv, payload, 4, &reply);
+    } else if (strcmp(command, "fps") == 0 && nargs == 1) {
+        payload[0] = strtoul(args[0], 0, 10);
+        status     = virtser_client_request(&client, virtser_frame_animation_fps, payload, 1, &reply);
+    } else if (strcmp(command, "update") == 0) {
+        status = virtser_client_request(&client, virtser_frame_map_update, 0, 0, &reply);
+    } else if (strcmp(command, "save") == 0) {
+        status = virtser_client_request(&client, virtser_frame_map_save, 0, 0, &reply);
+    } else {
+        usage(argv[0]);
+        virtser_client_close_tty(&client);
+        return 2;
+    }
+
+    virtser_client_close_tty(&client);
+
+    return print_reply(command, status, &reply);
+}
@@ -47,6 +47,7 @@
 #include "TWI_Master.h"
 #include "../../nfo_led.h"
 #include "twi_transmit_queue.h"
+#include "trace.h"
 #include <avr/interrupt.h>
 #include <avr/io.h>
 #include <util/delay.h>
@@ -431,6 +432,18 @@ void queued_twi_start_transceiver(void)
            (0 << TWWC);                                //
 }
 
+// the main loop stalls here until the TWI interrupt sends a queued transfer
+static void wait_for_free_buffer(unsigned char slave_address)
+{
+    if (!tx_queue_is_full())
+        return;
+
+    TRACE_BEGIN(traceTwiWait, slave_address);
+    while (tx_queue_is_full())
+        ; // Wait until there is a free buffer in the queue
+    TRACE_END(traceTwiWait, 0);
+}
+
 void queued_twi_write_byte(unsigned char slave_address, unsigned char data_byte)
 {
     // dprintf("queued_twi_write_byte 0x%X\n", data_byte);
@@ -439,8 +452,7 @@ void queued_twi_write_byte(unsigned char slave_address, unsigned char data_byte)
     if ((slave_address & (TRUE << TWI_READ_BIT))) // If it is a read operation, then do nothing
         return;
 
-    while (tx_queue_is_full())
-        ; // Wait until there is a free buffer in the queue
+    wait_for_free_buffer(slave_address);
 
     tx_queue_get_empty_tail(&tail);
 
@@ -473,8 +485,7 @@ void queued_twi_write_byte_to_register(unsigned char slave_address, unsigned cha
     }
 #endif
 
-    while (tx_queue_is_full())
-        ; // Wait until there is a free buffer in the queue
+    wait_for_free_buffer(slave_address);
 
     tx_queue_get_empty_tail(&tail);
 
@@ -510,8 +521,7 @@ void queued_twi_write_data_to_register(unsigned char slave_address, unsigned cha
     }
 #endif
 
-    while (tx_queue_is_full())
-        ; // Wait until there is a free buffer in the queue
+    wait_for_free_buffer(slave_address);
 
     if (!tx_queue_get_empty_tail(&tail))
     {
@@ -0,0 +1,66 @@
+
+#include "virt_ser_frame.h"
+#include "crc8.h"
+#include <string.h>
+
+enum decoder_state { decoderIdle = 0, decoderLength, decoderData, decoderCrc };
+
+void virtser_frame_decoder_init(virtser_frame_decoder *decoder, uint8_t *buffer) {
+    decoder->buffer = buffer;
+    virtser_frame_decoder_reset(decoder);
+}
+
+void virtser_frame_decoder_reset(virtser_frame_decoder *decoder) {
+    decoder->state  = decoderIdle;
+    decoder->length = 0;
+    decoder->pos    = 0;
+}
+
+bool virtser_frame_decoding(virtser_frame_decoder const *decoder) { return decoder->state != decoderIdle; }
+
+enum virtser_frame_result virtser_frame_decode(virtser_frame_decoder *decoder, uint8_t data) {
+    switch (decoder->state) {
+        case decoderIdle:
+            if (data == VIRTSER_FRAME_SYNC) {
+                decoder->state = decoderLength;
+                decoder->crc   = VIRTSER_FRAME_CRC_START;
+            }
+            break;
+
+        case decoderLength:
+            if (data == 0 || data > VIRTSER_FRAME_LENGTH_MAX) {
+                virtser_frame_decoder_reset(decoder);
+                return virtser_frame_too_long;
+            }
+            decoder->length = data;
+            decoder->pos    = 0;
+            decoder->crc    = crc8_calc_byte(decoder->crc, data);
+            decoder->state  = decoderData;
+            break;
+
+        case decoderData:
+            decoder->buffer[decoder->pos++] = data;
+            decoder->crc                    = crc8_calc_byte(decoder->crc, data);
+            if (decoder->pos == decoder->length) decoder->state = decoderCrc;
+            break;
+
+        case decoderCrc:
+            decoder->state = decoderIdle;
+            return (data == decoder->crc) ? virtser_frame_complete : virtser_frame_corrupt;
+    }
+
+    return virtser_frame_incomplete;
+}
+
+uint8_t virtser_frame_encode(uint8_t *out, uint8_t opcode, uint8_t const *payload, uint8_t length) {
+    if (length >= VIRTSER_FRAME_LENGTH_MAX) length = VIRTSER_FRAME_LENGTH_MAX - 1;
+
+    out[0] = VIRTSER_FRAME_SYNC;
+    out[1] = length + 1;
+    out[2] = opcode;
+    if (length) memcpy(out + 3, payload, length);
+
+    out[3 + length] = crc8_calc(out + 1, VIRTSER_FRAME_CRC_START, length + 2);
+
+    return length + 4;
+}
@@ -0,0 +1,101 @@
+#ifndef KEYBOARD_ANORAK_91TKL_VIRT_SER_FRAME_H_
+#define KEYBOARD_ANORAK_91TKL_VIRT_SER_FRAME_H_
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Binary command frames on the virtual serial port, next to the '!' text shell.
+ *
+ *   SYNC | length | opcode | payload[length - 1] | crc8
+ *
+ * length counts the opcode and the payload, the crc8 (crc8_calc, start VIRTSER_FRAME_CRC_START)
+ * covers length, opcode and payload. A reply has the opcode of the request with VIRTSER_FRAME_REPLY
+ * set, its first payload byte is a virtser_frame_status.
+ *
+ * This file has no AVR dependencies, the host client uses it as well.
+ */
+
+#define VIRTSER_FRAME_SYNC 0xA5
+#define VIRTSER_FRAME_CRC_START 0x2D
+#define VIRTSER_FRAME_REPLY 0x80
+
+// opcode and payload
+#define VIRTSER_FRAME_LENGTH_MAX 250
+// sync, length and crc
+#define VIRTSER_FRAME_OVERHEAD 3
+#define VIRTSER_FRAME_SIZE_MAX (VIRTSER_FRAME_LENGTH_MAX + VIRTSER_FRAME_OVERHEAD)
+
+enum virtser_frame_opcode {
+    // the payload is sent back
+    virtser_frame_ping = 0x01,
+    // map, first key (row * MATRIX_COLS + col), r g b of the following keys as PWM values (after the CIE curve)
+    virtser_frame_map_rgb = 0x10,
+    // map, first key, h s v of the following keys
+    virtser_frame_map_hsv = 0x11,
+    // upload the PWM buffers set by map_rgb and map_hsv
+    virtser_frame_map_update = 0x12,
+    virtser_frame_map_save = 0x13,
+    // sector, enabled, h s v
+    virtser_frame_sector_set = 0x20,
+    // animation, run
+    virtser_frame_animation_run = 0x30,
+    // color 0|1, h s v
+    virtser_frame_animation_hsv = 0x31,
+    // fps
+    virtser_frame_animation_fps = 0x32,
+    // frames (uint16_t, little endian, 0 until the stream times out), raw frames follow the reply, see virt_ser_stream.h
+    virtser_frame_stream_start = 0x40,
+    // sent by the keyboard only, uploaded frames (uint16_t)
+    virtser_frame_stream_end = 0x41,
+};
+
+enum virtser_frame_status {
+    virtser_frame_ok = 0,
+    virtser_frame_error = 1,
+    virtser_frame_crc_error = 2,
+    virtser_frame_unknown_opcode = 3,
+    virtser_frame_bad_length = 4,
+};
+
+enum virtser_frame_result {
+    // more bytes needed
+    virtser_frame_incomplete = 0,
+    virtser_frame_complete,
+    virtser_frame_corrupt,
+    virtser_frame_too_long,
+};
+
+struct virtser_frame_decoder_t {
+    uint8_t *buffer;
+    uint8_t state;
+    uint8_t length;
+    uint8_t pos;
+    uint8_t crc;
+};
+
+typedef struct virtser_frame_decoder_t virtser_frame_decoder;
+
+// buffer holds VIRTSER_FRAME_LENGTH_MAX bytes, a complete frame leaves opcode and payload in it
+void virtser_frame_decoder_init(virtser_frame_decoder *decoder, uint8_t *buffer);
+// call with the sync byte and all bytes up to the crc
+enum virtser_frame_result virtser_frame_decode(virtser_frame_decoder *decoder, uint8_t data);
+// true between the sync byte and the crc
+bool virtser_frame_decoding(virtser_frame_decoder const *decoder);
+void virtser_frame_decoder_reset(virtser_frame_decoder *decoder);
+
+// the payload length of the decoded frame
+static inline uint8_t virtser_frame_payload_length(virtser_frame_decoder const *decoder) { return decoder->length - 1; }
+
+// writes a frame into out (VIRTSER_FRAME_SIZE_MAX bytes), returns its size
+uint8_t virtser_frame_encode(uint8_t *out, uint8_t opcode, uint8_t const *payload, uint8_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KEYBOARD_ANORAK_91TKL_VIRT_SER_FRAME_H_ */
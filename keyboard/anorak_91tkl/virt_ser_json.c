@@ -0,0 +1,252 @@
+
+#include "virt_ser_json.h"
+
+#ifdef __AVR__
+#    include <avr/pgmspace.h>
+#else
+#    define PROGMEM
+#    define pgm_read_byte(p) (*(p))
+#endif
+
+enum json_state {
+    jsonObject = 0,
+    jsonFirstKey,
+    jsonKey,
+    jsonName,
+    jsonColon,
+    jsonValue,
+    jsonNumber,
+    jsonNextKey,
+    jsonColsFirst,
+    jsonPair,
+    jsonPairComma,
+    jsonColorStart,
+    jsonColor,
+    jsonColorEnd,
+    jsonPairEnd,
+    jsonColsNext,
+    jsonDone,
+    jsonError
+};
+
+enum json_name { nameMap = 0, nameRow, nameCols, nameCount, nameCol = nameCount };
+
+// 0 terminated, NAME_SIZE apart
+#define NAME_SIZE 5
+static const char names[nameCount][NAME_SIZE] PROGMEM = {"map", "row", "cols"};
+
+#define NAMES_ALL ((1 << nameCount) - 1)
+
+static bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static int8_t hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static bool fail(virtser_json_map *reader) {
+    reader->state = jsonError;
+    return false;
+}
+
+static void number_start(virtser_json_map *reader, uint8_t name) {
+    reader->name   = name;
+    reader->number = 0;
+    reader->pos    = 0;
+    reader->state  = jsonNumber;
+}
+
+// the name bits are the names still matching the characters read so far
+static void name_char(virtser_json_map *reader, char c) {
+    for (uint8_t n = 0; n < nameCount; n++) {
+        if (reader->pos >= NAME_SIZE - 1 || pgm_read_byte(&names[n][reader->pos]) != c) reader->name &= ~(1 << n);
+    }
+    reader->pos++;
+}
+
+static bool name_end(virtser_json_map *reader) {
+    for (uint8_t n = 0; n < nameCount; n++) {
+        if ((reader->name & (1 << n)) && pgm_read_byte(&names[n][reader->pos]) == '\0') {
+            reader->name  = n;
+            reader->state = jsonColon;
+            return true;
+        }
+    }
+
+    return fail(reader);
+}
+
+static bool number_end(virtser_json_map *reader) {
+    if (reader->pos == 0) return fail(reader);
+
+    switch (reader->name) {
+        case nameMap:
+            reader->map_selected = reader->number;
+            if (reader->map) reader->map(reader->map_selected);
+            reader->state = jsonNextKey;
+            break;
+
+        case nameRow:
+            reader->row     = reader->number;
+            reader->has_row = true;
+            reader->state   = jsonNextKey;
+            break;
+
+        case nameCol:
+            reader->col   = reader->number;
+            reader->state = jsonPairComma;
+            break;
+
+        default:
+            return fail(reader);
+    }
+
+    return true;
+}
+
+void virtser_json_map_init(virtser_json_map *reader) {
+    reader->state        = jsonObject;
+    reader->has_row      = false;
+    reader->map_selected = 0xff;
+    reader->keys_set     = 0;
+    reader->keys_missing = 0;
+}
+
+bool virtser_json_map_push(virtser_json_map *reader, char c) {
+    if (reader->state == jsonError) return false;
+
+    if (reader->state == jsonNumber) {
+        if (c >= '0' && c <= '9') {
+            reader->number = reader->number * 10 + (c - '0');
+            reader->pos++;
+            return (reader->number <= 0xff) || fail(reader);
+        }
+
+        if (reader->pos == 0 && is_space(c)) return true;
+
+        // the character after the number is read again in the next state
+        return number_end(reader) && virtser_json_map_push(reader, c);
+    }
+
+    if (reader->state == jsonName) {
+        if (c == '"') return name_end(reader);
+        name_char(reader, c);
+        return true;
+    }
+
+    if (reader->state == jsonColor) {
+        int8_t value = hex_value(c);
+        if (value < 0) return fail(reader);
+
+        uint8_t *channel = &reader->color.rgb[reader->pos / 2];
+        *channel         = (reader->pos & 1) ? (*channel | value) : (value << 4);
+
+        if (++reader->pos == 6) reader->state = jsonColorEnd;
+        return true;
+    }
+
+    if (reader->state == jsonColorEnd) {
+        if (c != '"') return fail(reader);
+        reader->state = jsonPairEnd;
+        return true;
+    }
+
+    if (is_space(c)) return true;
+
+    switch (reader->state) {
+        case jsonObject:
+            if (c != '{') return fail(reader);
+            reader->state = jsonFirstKey;
+            break;
+
+        case jsonFirstKey:
+            if (c == '}') {
+                reader->state = jsonDone;
+                break;
+            }
+            // fall through
+        case jsonKey:
+            if (c != '"') return fail(reader);
+            reader->name  = NAMES_ALL;
+            reader->pos   = 0;
+            reader->state = jsonName;
+            break;
+
+        case jsonColon:
+            if (c != ':') return fail(reader);
+            reader->state = jsonValue;
+            break;
+
+        case jsonValue:
+            if (reader->name == nameCols) {
+                // the pairs are applied as they arrive, they need the row
+                if (c != '[' || !reader->has_row) return fail(reader);
+                reader->state = jsonColsFirst;
+                break;
+            }
+            if (c < '0' || c > '9') return fail(reader);
+            number_start(reader, reader->name);
+            return virtser_json_map_push(reader, c);
+
+        case jsonNextKey:
+            if (c == ',')
+                reader->state = jsonKey;
+            else if (c == '}')
+                reader->state = jsonDone;
+            else
+                return fail(reader);
+            break;
+
+        case jsonColsFirst:
+            if (c == ']') {
+                reader->state = jsonNextKey;
+                break;
+            }
+            // fall through
+        case jsonPair:
+            if (c != '[') return fail(reader);
+            number_start(reader, nameCol);
+            break;
+
+        case jsonPairComma:
+            if (c != ',') return fail(reader);
+            reader->state = jsonColorStart;
+            break;
+
+        case jsonColorStart:
+            if (c != '"') return fail(reader);
+            reader->pos   = 0;
+            reader->state = jsonColor;
+            break;
+
+        case jsonPairEnd:
+            if (c != ']') return fail(reader);
+
+            if (reader->key && reader->key(reader->row, reader->col, reader->color))
+                reader->keys_set++;
+            else
+                reader->keys_missing++;
+
+            reader->state = jsonColsNext;
+            break;
+
+        case jsonColsNext:
+            if (c == ',')
+                reader->state = jsonPair;
+            else if (c == ']')
+                reader->state = jsonNextKey;
+            else
+                return fail(reader);
+            break;
+
+        default:
+            // nothing but whitespace after the object
+            return fail(reader);
+    }
+
+    return true;
+}
+
+bool virtser_json_map_complete(virtser_json_map const *reader) { return reader->state == jsonDone; }
@@ -0,0 +1,58 @@
+#ifndef KEYBOARD_ANORAK_91TKL_VIRT_SER_JSON_H_
+#define KEYBOARD_ANORAK_91TKL_VIRT_SER_JSON_H_
+
+#include "backlight/color.h"
+#include <inttypes.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Push reader for the JSON of the '.map set' text command, fed byte by byte as it is received:
+ *
+ *   {"map":0,"row":1,"cols":[[0,"FFFFFF"],[1,"00FF00"], ...]}
+ *
+ * Nothing is buffered, every [col,"RRGGBB"] pair goes to the key callback as soon as its closing
+ * bracket arrives, so a row may have any number of pairs. "map" and "row" have to come before
+ * "cols", other keys are errors. Whitespace outside of strings is skipped.
+ *
+ * This file has no AVR dependencies, the host tools use it as well.
+ */
+
+struct virtser_json_map_t {
+    // selects the custom map
+    void (*map)(uint8_t map);
+    // false if there is no LED at the key
+    bool (*key)(uint8_t row, uint8_t col, RGB color);
+
+    uint8_t  state;
+    uint8_t  name;
+    uint8_t  pos;
+    uint16_t number;
+    uint8_t  row;
+    uint8_t  col;
+    RGB      color;
+    bool     has_row;
+
+    // 0xff until "map" is read
+    uint8_t  map_selected;
+    uint16_t keys_set;
+    uint16_t keys_missing;
+};
+
+typedef struct virtser_json_map_t virtser_json_map;
+
+// resets the reader, the callbacks stay
+void virtser_json_map_init(virtser_json_map *reader);
+// false once the input is no valid map, the following bytes are ignored
+bool virtser_json_map_push(virtser_json_map *reader, char c);
+// true if the object is closed
+bool virtser_json_map_complete(virtser_json_map const *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KEYBOARD_ANORAK_91TKL_VIRT_SER_JSON_H_ */
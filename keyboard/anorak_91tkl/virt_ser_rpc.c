@@ -5,10 +5,11 @@
 #include "backlight/sector/sector_control.h"
 #include "backlight/animations/animation.h"
 #include "backlight/animations/animation_utils.h"
+#include "backlight/animations/animation_arena.h"
 #include "backlight/key_led_map.h"
 #include "backlight/backlight_91tkl.h"
+#include "backlight/led_health.h"
 #include "twi/avr315/TWI_Master.h"
-#include "jsonparser/jsmn.h"
 #include "keymap.h"
 #include "action_layer.h"
 #include "bootloader.h"
@@ -21,9 +22,16 @@
 #include "timer.h"
 #include "host.h"
 #include "virt_ser_rpc.h"
+#include "shell_dispatch.h"
+#include "virt_ser_frame.h"
+#include "virt_ser_json.h"
+#include "virt_ser_stream.h"
 #include "eeconfig.h"
+#include "eeprom_cache.h"
 #include "keyboard.h"
 #include "keycode.h"
+#include "perf.h"
+#include "trace.h"
 #include "keymap.h"
 #include "backlight.h"
 #include "backlight/eeconfig_backlight.h"
@@ -52,6 +60,19 @@
 #define DATAGRAM_USER_START '!'
 #define DATAGRAM_USER_STOP '\n'
 
+// a binary frame that stalls this long is dropped
+#define VIRTSER_FRAME_TIMEOUT_MS 50
+
+// the time a reply may wait for a host that takes nothing when the TX queue is full, a text
+// command is typed by someone waiting for its output, the main loop gets only VIRTSER_TX_BUDGET_US
+// otherwise. A reply that lost bytes anyway ends with '.truncated <bytes>'.
+#define VIRTSER_SHELL_TX_BUDGET_US 20000
+#define VIRTSER_FRAME_TX_BUDGET_US 5000
+
+// the JSON of '.map set' is read as it arrives, see virt_ser_json.h
+#define JSON_MAP_PREFIX "map set "
+#define JSON_MAP_PREFIX_LENGTH (sizeof(JSON_MAP_PREFIX) - 1)
+
 //.map set {"map":0,"row":1,"cols":[[0,"FFFFFF"],[1,"FFFFFF"],[2,"FFFFFF"],[3,"FFFFFF"],[4,"FFFFFF"],[5,"FFFFFF"],[6,"FFFFFF"],[7,"FFFFFF"],[8,"FFFFFF"],[9,"FFFFFF"],[10,"FFFFFF"],[11,"FFFFFF"],[12,"FFFFFF"],[13,"FFFFFF"],[14,"FFFFFF"],[15,"FFFFFF"],[16,"FFFFFF"]]}
 #define MAX_MSG_LENGTH 300
 
@@ -81,22 +102,19 @@ uint8_t recv_buffer[MAX_MSG_LENGTH];
 
 extern backlight_config_t backlight_config;
 
-enum recvStatus { recvStatusIdle = 0, recvStatusFoundUserStart = 2, recvStatusFindStop = 4 };
+enum recvStatus { recvStatusIdle = 0, recvStatusFoundUserStart = 2, recvStatusFindStop = 4, recvStatusJsonMap = 6 };
 
 enum recvStatus recv_status = recvStatusIdle;
 
-struct user_command_t {
-    char *cmd;
-    bool (*pfn_command)(uint8_t argc, char **argv);
-    char *help_args;
-    char *help_msg;
-};
-
-typedef struct user_command_t user_command;
+// binary frames are decoded into recv_buffer, they never overlap a text command
+static virtser_frame_decoder frame_decoder = {.buffer = recv_buffer};
+static uint16_t              frame_timer;
 
 bool cmd_user_help(uint8_t argc, char **argv);
 bool cmd_user_info(uint8_t argc, char **argv);
 bool cmd_user_ram(uint8_t argc, char **argv);
+bool cmd_user_perf(uint8_t argc, char **argv);
+bool cmd_user_trace(uint8_t argc, char **argv);
 bool cmd_user_dump_eeprom(uint8_t argc, char **argv);
 bool cmd_user_led(uint8_t argc, char **argv);
 bool cmd_user_pwm(uint8_t argc, char **argv);
@@ -119,41 +137,53 @@ bool cmd_user_status_leds_pwm(uint8_t argc, char **argv);
 bool cmd_user_test_sleep_led(uint8_t argc, char **argv);
 bool cmd_user_test_issi(uint8_t argc, char **argv);
 
-const user_command user_command_table[] PROGMEM = {{"?", &cmd_user_help, 0, "help"},
-                                                   {"info", &cmd_user_info, 0, "tmk"},
-                                                   {"ram", &cmd_user_ram, 0, "free"},
-                                                   {"ee", &cmd_user_dump_eeprom, 0, "dump ee"},
-                                                   {"fee", &cmd_user_eeprom_clear, 0, "clear ee"},
-                                                   {"bee", &cmd_user_backlight_eeprom_clear, 0, "clear bl ee"},
-                                                   {"bl", &cmd_user_backlight, 0, "bl"},
-                                                   {"sector", &cmd_user_sector, "save | # [0|1] | # h s v", "control"},
-                                                   {"animation", &cmd_user_animation, "list | # save | # [0|1] | # fps [#] | # c 0|1 [h s v]", "control"},
-                                                   {"map", &cmd_user_map, "save | # | # r", "control"},
-                                                   {"issi", &cmd_user_issi, "pt [#] | ptc | cl d | gcc d [#]", "control"},
-                                                   {"debug", &cmd_user_debug_config, 0, "config"},
-                                                   {"keymap", &cmd_user_keymap_config, 0, "config"},
-                                                   {"layer", &cmd_user_default_layer, 0, "default"},
-                                                   {"boot", &cmd_user_bootloader_jump, 0, "jump to bootloader"},
-
+// sorted by name, see shell_dispatch.h
+static const shell_command_t user_command_list[] PROGMEM = {
+    SHELL_COMMAND("?", &cmd_user_help, 0, "help"),
+    SHELL_COMMAND("animation", &cmd_user_animation, "list | stats | # save | # [0|1] | # fps [#] | # c 0|1 [h s v]", "control"),
+    SHELL_COMMAND("bee", &cmd_user_backlight_eeprom_clear, 0, "clear bl ee"),
+    SHELL_COMMAND("bl", &cmd_user_backlight, 0, "bl"),
+    SHELL_COMMAND("boot", &cmd_user_bootloader_jump, 0, "jump to bootloader"),
+    SHELL_COMMAND("debug", &cmd_user_debug_config, 0, "config"),
+    SHELL_COMMAND("ee", &cmd_user_dump_eeprom, 0, "dump ee"),
+    SHELL_COMMAND("fee", &cmd_user_eeprom_clear, 0, "clear ee"),
+#ifdef DEBUG_ISSI
+    SHELL_COMMAND("hsv", &cmd_user_key_hsv, "row col h s v", "set hsv"),
+#endif
+    SHELL_COMMAND("info", &cmd_user_info, 0, "tmk"),
+    SHELL_COMMAND("issi", &cmd_user_issi, "pt [#] | ptc | cl d | gcc d [#] | br [#] | wb [r g b] | health [scan]", "control"),
+    SHELL_COMMAND("keymap", &cmd_user_keymap_config, 0, "config"),
+    SHELL_COMMAND("layer", &cmd_user_default_layer, 0, "default"),
+    SHELL_COMMAND("map", &cmd_user_map, "save | # | # r | set {json}", "control"),
+#ifdef PERF_ENABLE
+    SHELL_COMMAND("perf", &cmd_user_perf, "reset | bin", "counters"),
+#endif
+    SHELL_COMMAND("ram", &cmd_user_ram, 0, "free"),
+    SHELL_COMMAND("sector", &cmd_user_sector, "save | # [0|1] | # h s v", "control"),
 #ifdef STATUS_LED_PWM_ENABLE
-                                                   {"stabri", &cmd_user_status_leds_pwm, 0, "bstatus leds"},
-                                                   {"see", &cmd_user_statusled_eeprom_clear, 0, "clear leds eeprom"},
+    SHELL_COMMAND("see", &cmd_user_statusled_eeprom_clear, 0, "clear leds eeprom"),
 #endif
-
 #ifdef SLEEP_LED_ENABLE
-                                                   {"sleepled", &cmd_user_test_sleep_led, 0, "test sleepled"},
+    SHELL_COMMAND("sleepled", &cmd_user_test_sleep_led, 0, "test sleepled"),
+#endif
+#ifdef STATUS_LED_PWM_ENABLE
+    SHELL_COMMAND("stabri", &cmd_user_status_leds_pwm, 0, "bstatus leds"),
 #endif
-
 #ifdef DEBUG_ISSI
-                                                   {"ti", &cmd_user_test_issi, 0, "test issi"},
-                                                   {"tpwm", &cmd_user_pwm, "dev cs sw bri", "set pwm"},
-                                                   {"trgb", &cmd_user_rgb, "dev row col r g b", "set rgb"},
-                                                   {"thsv", &cmd_user_hsv, "dev row col h s v", "set hsv"},
-                                                   {"tled", &cmd_user_led, "dev cs sw on", "enable/disable led"},
-                                                   {"hsv", &cmd_user_key_hsv, "row col h s v", "set hsv"},
+    SHELL_COMMAND("thsv", &cmd_user_hsv, "dev row col h s v", "set hsv"),
+    SHELL_COMMAND("ti", &cmd_user_test_issi, 0, "test issi"),
+    SHELL_COMMAND("tled", &cmd_user_led, "dev cs sw on", "enable/disable led"),
+    SHELL_COMMAND("tpwm", &cmd_user_pwm, "dev cs sw bri", "set pwm"),
+#endif
+#ifdef TRACE_ENABLE
+    SHELL_COMMAND("trace", &cmd_user_trace, "freeze | arm us | mask hex", "timeline"),
 #endif
+#ifdef DEBUG_ISSI
+    SHELL_COMMAND("trgb", &cmd_user_rgb, "dev row col r g b", "set rgb"),
+#endif
+};
 
-                                                   {0, 0, 0, 0}};
+static shell_table_t user_commands = SHELL_TABLE(user_command_list);
 
 void dump_led_buffer(IS31FL3733 *device) {
     uint8_t *led = is31fl3733_led_buffer(device);
@@ -200,18 +230,15 @@ void dump_args(uint8_t argc, char **argv) {
 }
 
 bool cmd_user_help(uint8_t argc, char **argv) {
-    uint8_t      pos = 0;
-    user_command cmd;
+    shell_command_t cmd;
 
-    memcpy_P(&cmd, (const void *)&user_command_table[pos++], sizeof(struct user_command_t));
+    for (uint8_t pos = 0; pos < user_commands.count; pos++) {
+        shell_command_get(&user_commands, pos, &cmd);
 
-    while (cmd.pfn_command) {
         if (cmd.help_args)
-            vserprintfln("%s [%s]: %s", cmd.cmd, cmd.help_args, cmd.help_msg);
+            vserprintfln("%s [%s]: %s", cmd.name, cmd.help_args, cmd.help_msg);
         else
-            vserprintfln("%s: %s", cmd.cmd, cmd.help_msg);
-
-        memcpy_P(&cmd, (const void *)&user_command_table[pos++], sizeof(struct user_command_t));
+            vserprintfln("%s: %s", cmd.name, cmd.help_msg);
     }
 
     vserprintf("\n");
@@ -301,6 +328,9 @@ bool cmd_user_status_leds_pwm(uint8_t argc, char **argv) {
 bool cmd_user_test_issi(uint8_t argc, char **argv) {
     bool found = false;
 
+    // the LED health check drives the chips directly, see is31fl3733_91tkl_hold()
+    if (is31fl3733_91tkl_is_held()) return false;
+
     if (argc == 1 && strcmp_P(argv[0], PSTR("detect")) == 0) {
         unsigned char slave_address;
         unsigned char device_present;
@@ -470,7 +500,7 @@ bool cmd_user_test_issi(uint8_t argc, char **argv) {
 #endif
 
 bool cmd_user_issi(uint8_t argc, char **argv) {
-    // pt [#] | ptc | cl d | gcc d [#]
+    // pt [#] | ptc | cl d | gcc d [#] | br [#] | wb [r g b] | health [scan]
 
     if (argc == 1 && strcmp_P(argv[0], PSTR("save")) == 0) {
         // TODO: save current gcc value...
@@ -483,7 +513,7 @@ bool cmd_user_issi(uint8_t argc, char **argv) {
     }
 
     if (argc == 1 && strcmp_P(argv[0], PSTR("ptc")) == 0) {
-        vserprintfln(".ptc %u", issi.global_power_target_milliampere);
+        vserprintfln(".ptc %u", is31fl3733_91tkl_current_power_usage(&issi));
         return true;
     }
 
@@ -493,6 +523,28 @@ bool cmd_user_issi(uint8_t argc, char **argv) {
         return true;
     }
 
+    if (argc == 1 && strcmp_P(argv[0], PSTR("health")) == 0) {
+        vserprintfln(".health %u", led_health_faulty_key_count());
+        return true;
+    }
+
+    if (argc == 2 && strcmp_P(argv[0], PSTR("health")) == 0 && strcmp_P(argv[1], PSTR("scan")) == 0) {
+        led_health_request_scan();
+        vserprintfln(".health scan");
+        return true;
+    }
+
+    if (argc == 1 && strcmp_P(argv[0], PSTR("br")) == 0) {
+        vserprintfln(".br %u", is31fl3733_91tkl_get_brightness(&issi));
+        return true;
+    }
+
+    if (argc == 1 && strcmp_P(argv[0], PSTR("wb")) == 0) {
+        RGB balance = is31fl3733_91tkl_get_white_balance(&issi);
+        vserprintfln(".wb %u %u %u", balance.r, balance.g, balance.b);
+        return true;
+    }
+
     /*
     if (argc == 2 && (strcmp_P(argv[0], PSTR("cl")) == 0)
     {
@@ -527,6 +579,7 @@ bool cmd_user_issi(uint8_t argc, char **argv) {
     }
 
     if (argc == 2 && strcmp_P(argv[0], PSTR("gbr")) == 0) {
+        if (is31fl3733_91tkl_is_held()) return false;
         uint8_t gcc             = atoi(argv[1]);
         issi.lower->device->gcc = gcc;
         issi.upper->device->gcc = gcc;
@@ -536,7 +589,23 @@ bool cmd_user_issi(uint8_t argc, char **argv) {
         return true;
     }
 
+    if (argc == 2 && strcmp_P(argv[0], PSTR("br")) == 0) {
+        is31fl3733_91tkl_set_brightness(&issi, atoi(argv[1]));
+        is31fl3733_91tkl_update_led_pwm(&issi);
+        vserprintfln(".br %u", is31fl3733_91tkl_get_brightness(&issi));
+        return true;
+    }
+
+    if (argc == 4 && strcmp_P(argv[0], PSTR("wb")) == 0) {
+        RGB balance = {.r = atoi(argv[1]), .g = atoi(argv[2]), .b = atoi(argv[3])};
+        is31fl3733_91tkl_set_white_balance(&issi, balance);
+        is31fl3733_91tkl_update_led_pwm(&issi);
+        vserprintfln(".wb %u %u %u", balance.r, balance.g, balance.b);
+        return true;
+    }
+
     if (argc == 3 && strcmp_P(argv[0], PSTR("gcc")) == 0) {
+        if (is31fl3733_91tkl_is_held()) return false;
         IS31FL3733 *device = ((atoi(argv[1]) == 0) ? issi.lower->device : issi.upper->device);
         device->gcc        = atoi(argv[2]);
         is31fl3733_update_global_current_control(device);
@@ -549,6 +618,7 @@ bool cmd_user_issi(uint8_t argc, char **argv) {
 
 bool cmd_user_led(uint8_t argc, char **argv) {
     if (argc != 4) return false;
+    if (is31fl3733_91tkl_is_held()) return false;
 
     uint8_t dev = atoi(argv[0]);
     uint8_t cs  = atoi(argv[1]);
@@ -565,6 +635,7 @@ bool cmd_user_led(uint8_t argc, char **argv) {
 
 bool cmd_user_pwm(uint8_t argc, char **argv) {
     if (argc != 4) return false;
+    if (is31fl3733_91tkl_is_held()) return false;
 
     uint8_t dev = atoi(argv[0]);
     uint8_t cs  = atoi(argv[1]);
@@ -581,6 +652,7 @@ bool cmd_user_pwm(uint8_t argc, char **argv) {
 
 bool cmd_user_rgb(uint8_t argc, char **argv) {
     if (argc != 6) return false;
+    if (is31fl3733_91tkl_is_held()) return false;
 
     RGB rgb;
 
@@ -603,6 +675,7 @@ bool cmd_user_rgb(uint8_t argc, char **argv) {
 
 bool cmd_user_hsv(uint8_t argc, char **argv) {
     if (argc != 6) return false;
+    if (is31fl3733_91tkl_is_held()) return false;
 
     HSV hsv;
 
@@ -698,15 +771,17 @@ bool cmd_user_key_hsv(uint8_t argc, char **argv) {
 }
 
 bool cmd_user_animation(uint8_t argc, char **argv) {
-    // list | # save | # [0|1] | # fps [#] | # c 0|1 [h s v]
+    // list | stats | # save | # [0|1] | # fps [#] | # c 0|1 [h s v]
 
     if (argc == 0) {
         char *namebuffer = animation_name(animation_current());
+        animation_stats stats = animation_get_stats(animation_current());
 
         vserprintfln(".animation %u", animation_current());
         vserprintfln(".name %s", namebuffer);
         vserprintfln(".running %u", animation_is_running());
         vserprintfln(".fps %u", DELAY_TO_FPS(animation.delay_in_ms));
+        vserprintfln(".rate %u %u", stats.fps, stats.dropped);
         vserprintfln(".duration %u", animation.duration_in_ms);
         vserprintfln(".hsv1 %X %X %X", animation.hsv.h, animation.hsv.s, animation.hsv.v);
         vserprintfln(".hsv2 %X %X %X", animation.hsv2.h, animation.hsv2.s, animation.hsv2.v);
@@ -727,6 +802,15 @@ bool cmd_user_animation(uint8_t argc, char **argv) {
         return true;
     }
 
+    if (argc == 1 && strcmp_P(argv[0], PSTR("stats")) == 0) {
+        // effective frames per second and dropped frames
+        for (uint8_t i = 0; i < animation_LAST; i++) {
+            animation_stats stats = animation_get_stats(i);
+            vserprintfln(".rate %u %u %u", i, stats.fps, stats.dropped);
+        }
+        return true;
+    }
+
     if (argc == 1) {
         uint8_t selected_animation = atoi(argv[0]);
         vserprintfln(".animation %u %u", selected_animation, (selected_animation == animation_current() ? animation_is_running() : 0));
@@ -900,11 +984,40 @@ bool cmd_user_sector(uint8_t argc, char **argv) {
     return false;
 }
 
-static int jsoneq(const char *json, jsmntok_t *tok, const char *s) {
-    if (tok->type == JSMN_STRING && (int)strlen(s) == tok->end - tok->start && strncmp(json + tok->start, s, tok->end - tok->start) == 0) {
-        return 0;
+static void json_map_select(uint8_t map) {
+    if (sector_get_custom_map() != map) sector_set_custom_map(map);
+}
+
+static bool json_map_key(uint8_t key_row, uint8_t key_col, RGB color) {
+    uint8_t row;
+    uint8_t col;
+    uint8_t dev;
+
+    if (key_row >= MATRIX_ROWS || key_col >= MATRIX_COLS) return false;
+    if (!getLedPosByMatrixKey(key_row, key_col, &dev, &row, &col)) return false;
+
+    // RRGGBB is the PWM value, the output stage applies the CIE curve on upload
+    is31fl3733_rgb_set_pwm(DEVICE_BY_NUMBER(issi, dev), col, row, rgb_from_pwm(color));
+    return true;
+}
+
+static virtser_json_map json_map = {.map = json_map_select, .key = json_map_key};
+
+// end of the '.map set' line
+static void json_map_done(void) {
+    if (!virtser_json_map_complete(&json_map)) {
+        vserprintfln("parse fail");
+        vserprintfln(">ERR");
+        return;
     }
-    return -1;
+
+    if (json_map.keys_missing) vserprintfln("no mx key: %u", json_map.keys_missing);
+
+    // TODO: add a "update" command for this
+    is31fl3733_91tkl_update_led_pwm(&issi);
+
+    vserprintfln(".map set %u", json_map.map_selected);
+    vserprintfln(">OK");
 }
 
 bool cmd_user_map(uint8_t argc, char **argv) {
@@ -914,9 +1027,9 @@ bool cmd_user_map(uint8_t argc, char **argv) {
     }
 
     if (argc == 1 && strcmp_P(argv[0], PSTR("save")) == 0) {
-        vserprintfln(".saved");
         sector_save_state();
-        sector_save_custom_pwm_map();
+        if (!sector_save_custom_pwm_map()) return false;
+        vserprintfln(".saved");
         return true;
     }
 
@@ -927,139 +1040,6 @@ bool cmd_user_map(uint8_t argc, char **argv) {
         return true;
     }
 
-    if (argc == 2 && strcmp_P(argv[0], PSTR("set")) == 0) {
-        // map set {...}
-        char const *jsonstring = argv[1];
-
-        jsmn_parser parser;
-        jsmntok_t   tokens[70];
-
-        jsmn_init(&parser);
-
-        // js - pointer to JSON string
-        // tokens - an array of tokens available
-        // 10 - number of tokens available
-        int r = jsmn_parse(&parser, jsonstring, strlen(jsonstring), tokens, 60);
-        vserprintfln("tokens: %d", r);
-
-        if (r < 0) {
-            vserprintfln("parse fail: %d", r);
-            return false;
-        }
-
-        /* Assume the top-level element is an object */
-        if (r < 1 || tokens[0].type != JSMN_OBJECT) {
-            vserprintfln("obj expected");
-            return false;
-        }
-
-        uint8_t key_column   = 0;
-        uint8_t key_row      = 0;
-        uint8_t selected_map = 0;
-        char    hexcolor[3];
-        char    buf[10];
-
-        for (int i = 1; i < r; i++) {
-            if (jsoneq(jsonstring, &tokens[i], "map") == 0) {
-                // char *mapidstr = strndup(jsonstring + tokens[i + 1].start, tokens[i + 1].end - tokens[i + 1].start);
-                memset(buf, '\0', 10);
-                strncpy(buf, jsonstring + tokens[i + 1].start, tokens[i + 1].end - tokens[i + 1].start);
-                selected_map = atoi(buf);
-                // vserprintfln("map: %s %d", buf, selected_map);
-                // free(mapidstr);
-
-                if (sector_get_custom_map() != selected_map) sector_set_custom_map(selected_map);
-
-                i++;
-            } else if (jsoneq(jsonstring, &tokens[i], "row") == 0) {
-                // char *rowidstr = strndup(jsonstring + tokens[i + 1].start, tokens[i + 1].end - tokens[i + 1].start);
-                memset(buf, '\0', 10);
-                strncpy(buf, jsonstring + tokens[i + 1].start, tokens[i + 1].end - tokens[i + 1].start);
-                key_row = atoi(buf);
-                // vserprintfln("row: %s %d", buf, key_row);
-                // free(rowidstr);
-
-                i++;
-            }
-        }
-
-        jsmn_init(&parser);
-        jsmn_parse(&parser, jsonstring, strlen(jsonstring), tokens, 60);
-
-        for (int i = 1; i < r; i++) {
-            if (jsoneq(jsonstring, &tokens[i], "cols") == 0) {
-                if (tokens[i + 1].type != JSMN_ARRAY) {
-                    vserprintfln("not array of arrays");
-                    return false;
-                }
-
-                RGB rgb;
-                int arraysize = tokens[i + 1].size;
-
-                // vserprintfln("cols: %d", arraysize);
-
-                for (int j = 0; j < arraysize; j++) {
-                    jsmntok_t *g = &tokens[i + j + 2];
-                    // vserprintfln(" %d: %.*s", j, g->end - g->start, jsonstring + g->start);
-
-                    if (g->type != JSMN_ARRAY) {
-                        vserprintfln("not array");
-                        return false;
-                    }
-
-                    // char *colidstr = strndup(jsonstring + tokens[i + j + 1 + 2].start, tokens[i + j + 1 + 2].end - tokens[i + j + 1 + 2].start);
-                    memset(buf, '\0', 10);
-                    strncpy(buf, jsonstring + tokens[i + j + 1 + 2].start, tokens[i + j + 1 + 2].end - tokens[i + j + 1 + 2].start);
-                    key_column = atoi(buf);
-                    // vserprintfln("col: %s %d", buf, column);
-                    // free(colidstr);
-
-                    // char *colorstr = strndup(jsonstring + tokens[i + j + 2 + 2].start, tokens[i + j + 2 + 2].end - tokens[i + j + 2 + 2].start);
-                    memset(buf, '\0', 10);
-                    strncpy(buf, jsonstring + tokens[i + j + 2 + 2].start, tokens[i + j + 2 + 2].end - tokens[i + j + 2 + 2].start);
-                    // vserprintfln("color: %s", buf);
-
-                    if (strlen(buf) != 6) {
-                        vserprintfln("not color");
-                        return false;
-                    }
-
-                    for (int c = 0; c < 3; ++c) {
-                        strncpy(hexcolor, buf + (c * 2), 2);
-                        hexcolor[2] = '\0';
-                        rgb.rgb[c]  = strtol(hexcolor, 0, 16);
-                        // vserprintfln("color %d: '%s' %d %X", c, hexcolor, rgb.rgb[c], rgb.rgb[c]);
-                    }
-
-                    i += g->size;
-
-                    // set the color
-
-                    uint8_t row;
-                    uint8_t col;
-                    uint8_t dev;
-
-                    if (getLedPosByMatrixKey(key_row, key_column, &dev, &row, &col)) {
-                        // vserprintfln("set at r%u c%u d%u r%u c%u", key_row, key_column, dev, row, col);
-                        IS31FL3733_RGB *device = DEVICE_BY_NUMBER(issi, dev);
-                        is31fl3733_rgb_set_pwm(device, col, row, rgb);
-                    } else {
-                        vserprintfln("no mx key");
-                    }
-                }
-
-                i += arraysize + 1;
-            }
-        }
-
-        // TODO: add a "update" command for this
-        is31fl3733_91tkl_update_led_pwm(&issi);
-
-        vserprintfln(".map set %u", selected_map);
-
-        return true;
-    }
-
     if (argc == 2) {
         uint8_t selected_map     = atoi(argv[0]);
         uint8_t selected_map_row = atoi(argv[1]);
@@ -1076,7 +1056,7 @@ bool cmd_user_map(uint8_t argc, char **argv) {
         for (uint8_t key_col = 0; key_col < MATRIX_COLS; ++key_col) {
             if (getLedPosByMatrixKey(selected_map_row, key_col, &dev, &row, &col)) {
                 IS31FL3733_RGB *device = DEVICE_BY_NUMBER(issi, dev);
-                RGB             rgb    = is31fl3733_rgb_get_pwm(device, col, row);
+                RGB             rgb    = rgb_to_pwm(is31fl3733_rgb_get_pwm(device, col, row));
 
                 if (printedToken) {
                     vserprint(",");
@@ -1105,14 +1085,97 @@ bool cmd_user_info(uint8_t argc, char **argv) {
     vserprintf(".product: " STR(PRODUCT) "\n");
     vserprintf(".version: " STR(DEVICE_VER) "\n");
     vserprintf(".build: " STR(VERSION) " (" __TIME__ " " __DATE__ ")\n");
+
+    virtser_tx_stats_t tx = virtser_tx_stats();
+    vserprintfln(".virtser tx %u %u %u %u", tx.packets, tx.stalls, tx.dropped, tx.diagnostic_dropped);
     return true;
 }
 
 bool cmd_user_ram(uint8_t argc, char **argv) {
     vserprintf(".free %d\n", freeRam());
+    vserprintfln(".arena %u %u %u", animation_arena_used(), animation_arena_peak(), ANIMATION_ARENA_SIZE);
     return true;
 }
 
+#ifdef PERF_ENABLE
+// name, samples, min, avg and max in us, then the histogram, see perf.h
+// 'bin' sends the count of counters, their size and the us of 1000 ticks, then the raw counters
+bool cmd_user_perf(uint8_t argc, char **argv) {
+    perf_counter_t counter;
+
+    if (argc == 1 && strcmp_P(argv[0], PSTR("reset")) == 0) {
+        perf_reset();
+        vserprintfln(".perf reset");
+        return true;
+    }
+
+    if (argc == 1 && strcmp_P(argv[0], PSTR("bin")) == 0) {
+        vserprintfln(".perf bin %u %u %u", PERF_COUNTERS, sizeof(perf_counter_t), perf_us(1000));
+        for (uint8_t i = 0; i < PERF_COUNTERS; i++) {
+            perf_get(i, &counter);
+            virtser_send_data((uint8_t const *)&counter, sizeof(counter));
+        }
+        return true;
+    }
+
+    if (argc != 0) return false;
+
+    for (uint8_t i = 0; i < PERF_COUNTERS; i++) {
+        if (!perf_get(i, &counter)) continue;
+
+        vserprint(".perf ");
+        virtser_print_P(perf_name_P(i));
+        vserprintf(" %u %u", counter.count, perf_us(counter.min));
+        vserprintf(" %u %u", perf_us(counter.sum / counter.count), perf_us(counter.max));
+        for (uint8_t b = 0; b < PERF_BUCKETS; b++) vserprintf(" %u", counter.buckets[b]);
+        vserprintln("");
+    }
+
+    return true;
+}
+#endif
+
+#ifdef TRACE_ENABLE
+// freezes the trace and sends it, recording starts again after the dump, see tmk_core/tool/trace_json
+bool cmd_user_trace(uint8_t argc, char **argv) {
+    trace_record_t record;
+
+    if (argc == 1 && strcmp_P(argv[0], PSTR("freeze")) == 0) {
+        trace_freeze();
+        vserprintfln(".trace frozen");
+        return true;
+    }
+
+    if (argc == 2 && strcmp_P(argv[0], PSTR("arm")) == 0) {
+        trace_arm(atoi(argv[1]));
+        vserprintfln(".trace armed %u", atoi(argv[1]));
+        return true;
+    }
+
+    // a bit per event of trace.h, animate (0x8) is off by default
+    if (argc == 2 && strcmp_P(argv[0], PSTR("mask")) == 0) {
+        trace_set_mask(strtoul(argv[1], 0, 16));
+        vserprintfln(".trace mask %X", trace_mask());
+        return true;
+    }
+
+    if (argc != 0) return false;
+
+    trace_freeze();
+    trace_stats_t stats = trace_stats();
+
+    vserprintfln(".trace %u %u %u %u", stats.count, stats.overwritten, stats.tick_ns, stats.record_ns);
+    for (uint8_t i = 0; trace_get(i, &record); i++) {
+        vserprintf(".t %u %u %c ", (uint16_t)(record.stamp >> 16), (uint16_t)record.stamp, trace_phase(record.event));
+        virtser_print_P(trace_name_P(record.event));
+        vserprintfln(" %u", record.arg);
+    }
+
+    trace_resume();
+    return true;
+}
+#endif
+
 bool cmd_user_bootloader_jump(uint8_t argc, char **argv) {
     bootloader_jump();
     return true;
@@ -1268,6 +1331,12 @@ bool cmd_user_dump_eeprom(uint8_t argc, char **argv) {
     cmd_user_debug_config(0, 0);
     cmd_user_backlight(0, 0);
 
+#ifdef EEPROM_CACHE_ENABLE
+    // dirty bytes, bytes written, unchanged bytes skipped, refused updates
+    eeprom_cache_stats_t stats = eeprom_cache_stats();
+    vserprintfln(".eeprom %u %u %u %u", eeprom_cache_pending(), stats.written, stats.skipped, stats.refused);
+#endif
+
     return true;
 }
 
@@ -1351,14 +1420,13 @@ int virtser_print_P(const char *progmem_s) {
     return ret;
 }
 
-void shell_command(uint8_t *buffer, uint8_t length) {
-    uint8_t               pos = 0;
-    char *                str = (char *)buffer;
-    char *                token;
-    char *                command;
-    uint8_t               argc = 0;
-    char *                argv[10];
-    struct user_command_t user_command;
+void shell_command(uint8_t *buffer, uint16_t length) {
+    char *          str = (char *)buffer;
+    char *          token;
+    char *          command;
+    uint8_t         argc = 0;
+    char *          argv[10];
+    shell_command_t user_command;
 
     // dprintf("buffer: <%s> l:%u\n", buffer, length);
     command = strsep(&str, " ");
@@ -1368,34 +1436,26 @@ void shell_command(uint8_t *buffer, uint8_t length) {
         argc++;
     }
 
-    memcpy_P(&user_command, &user_command_table[pos++], sizeof(struct user_command_t));
-
-    // dprintf("uc: [%s] [%s]\n", user_command.cmd, user_command.help_msg);
-
-    while (user_command.pfn_command) {
-        if (strcmp(user_command.cmd, command) == 0) {
-            dprintf("exec: %s\n", command);
-            dump_args(argc, argv);
-
-            bool success = user_command.pfn_command(argc, argv);
-
-            if (success) {
-                vserprintfln(">OK");
-            } else {
-                vserprintfln(">ERR");
-            }
+    if (!shell_command_find(&user_commands, command, &user_command)) {
+        vserprintfln(">NC '!?' for help");
+        vserprintfln(">NC");
+        return;
+    }
 
-            break;
-        }
+    dprintf("exec: %s\n", command);
+    dump_args(argc, argv);
 
-        memcpy_P(&user_command, &user_command_table[pos++], sizeof(struct user_command_t));
+    virtser_send_budget(VIRTSER_SHELL_TX_BUDGET_US);
+    uint16_t dropped = virtser_tx_stats().dropped;
+    bool     success = user_command.fn(argc, argv);
 
-        // dprintf("uc: [%s] [%s]\n", user_command.cmd, user_command.help_msg);
-    }
+    dropped = virtser_tx_stats().dropped - dropped;
+    if (dropped) vserprintfln(".truncated %u", dropped);
 
-    if (!user_command.pfn_command) {
-        vserprintfln(">NC '!?' for help");
-        vserprintfln(">NC");
+    if (success) {
+        vserprintfln(">OK");
+    } else {
+        vserprintfln(">ERR");
     }
 }
 
@@ -1422,8 +1482,192 @@ bool datagram_is_valid(uint8_t buffer_pos, uint8_t expected_length) { return (bu
 
 bool datagram_is_userdata_start(uint8_t ucData) { return (ucData == DATAGRAM_USER_START && recv_status == recvStatusIdle); }
 
+void frame_reply(uint8_t opcode, uint8_t status, uint8_t const *data, uint8_t length) {
+    // sent in pieces, a reply never needs its own frame buffer
+    uint8_t header[4] = {VIRTSER_FRAME_SYNC, length + 2, opcode | VIRTSER_FRAME_REPLY, status};
+
+    uint8_t crc = crc8_calc(header + 1, VIRTSER_FRAME_CRC_START, sizeof(header) - 1);
+    crc         = crc8_calc(data, crc, length);
+
+    virtser_send_data(header, sizeof(header));
+    virtser_send_data(data, length);
+    virtser_send_data(&crc, 1);
+}
+
+uint8_t frame_map(bool is_hsv, uint8_t const *payload, uint8_t length) {
+    // map, first key, 3 bytes per key
+    if (length < 2 || (length - 2) % 3) return virtser_frame_bad_length;
+
+    uint8_t selected_map = payload[0];
+    uint8_t key          = payload[1];
+
+    if (key + (length - 2) / 3 > MATRIX_ROWS * MATRIX_COLS) return virtser_frame_error;
+
+    if (sector_get_custom_map() != selected_map) sector_set_custom_map(selected_map);
+
+    uint8_t row;
+    uint8_t col;
+    uint8_t dev;
+
+    for (uint8_t i = 2; i < length; i += 3, ++key) {
+        if (!getLedPosByMatrixKey(key / MATRIX_COLS, key % MATRIX_COLS, &dev, &row, &col)) continue;
+
+        IS31FL3733_RGB *device = DEVICE_BY_NUMBER(issi, dev);
+
+        if (is_hsv) {
+            HSV hsv = {.h = payload[i], .s = payload[i + 1], .v = payload[i + 2]};
+            is31fl3733_hsv_set_pwm(device, col, row, hsv);
+        } else {
+            RGB rgb = {.r = payload[i], .g = payload[i + 1], .b = payload[i + 2]};
+            is31fl3733_rgb_set_pwm(device, col, row, rgb_from_pwm(rgb));
+        }
+    }
+
+    return virtser_frame_ok;
+}
+
+void frame_command(uint8_t opcode, uint8_t const *payload, uint8_t length) {
+    uint8_t status = virtser_frame_ok;
+    uint8_t reply[2];
+    uint8_t reply_length = 0;
+
+    virtser_send_budget(VIRTSER_FRAME_TX_BUDGET_US);
+
+    switch (opcode) {
+        case virtser_frame_ping:
+            // the reply carries the status byte in addition
+            if (length > VIRTSER_FRAME_LENGTH_MAX - 2) length = VIRTSER_FRAME_LENGTH_MAX - 2;
+            frame_reply(opcode, virtser_frame_ok, payload, length);
+            return;
+
+        case virtser_frame_map_rgb:
+        case virtser_frame_map_hsv:
+            status = frame_map(opcode == virtser_frame_map_hsv, payload, length);
+            break;
+
+        case virtser_frame_map_update:
+            is31fl3733_91tkl_update_led_pwm(&issi);
+            break;
+
+        case virtser_frame_map_save:
+            sector_save_state();
+            if (!sector_save_custom_pwm_map()) status = virtser_frame_error;
+            break;
+
+        case virtser_frame_sector_set:
+            // sector, enabled, h s v
+            if (length != 5) {
+                status = virtser_frame_bad_length;
+            } else if (payload[0] >= SECTOR_MAX) {
+                status = virtser_frame_error;
+            } else {
+                HSV hsv = {.h = payload[2], .s = payload[3], .v = payload[4]};
+                sector_select(payload[0]);
+                sector_set_selected(payload[1]);
+                sector_set_hsv_color(payload[0], hsv);
+                is31fl3733_91tkl_update_led_pwm(&issi);
+            }
+            break;
+
+        case virtser_frame_animation_run:
+            // animation, run
+            if (length != 2) {
+                status = virtser_frame_bad_length;
+            } else if (payload[0] >= animation_LAST) {
+                status = virtser_frame_error;
+            } else {
+                if (payload[1])
+                    set_and_start_animation(payload[0]);
+                else
+                    stop_animation();
+
+                reply[reply_length++] = animation_current();
+                reply[reply_length++] = animation_is_running();
+            }
+            break;
+
+        case virtser_frame_animation_hsv:
+            // color 0|1, h s v
+            if (length != 4) {
+                status = virtser_frame_bad_length;
+            } else if (payload[0] == 0) {
+                animation.hsv.h = payload[1];
+                animation.hsv.s = payload[2];
+                animation.hsv.v = payload[3];
+                animation.rgb   = hsv_to_rgb(animation.hsv);
+            } else {
+                animation.hsv2.h = payload[1];
+                animation.hsv2.s = payload[2];
+                animation.hsv2.v = payload[3];
+            }
+            break;
+
+        case virtser_frame_stream_start:
+            // frames, the reply tells the frame size
+            if (length != 2) {
+                status = virtser_frame_bad_length;
+            } else if (!virtser_stream_start(payload[0] | (payload[1] << 8))) {
+                status = virtser_frame_error;
+            } else {
+                reply[reply_length++] = VIRTSER_STREAM_FRAME_SIZE & 0xff;
+                reply[reply_length++] = VIRTSER_STREAM_FRAME_SIZE >> 8;
+            }
+            break;
+
+        case virtser_frame_animation_fps:
+            if (length != 1) {
+                status = virtser_frame_bad_length;
+            } else {
+                animation_set_speed(FPS_TO_DELAY(payload[0]));
+                reply[reply_length++] = DELAY_TO_FPS(animation.delay_in_ms);
+            }
+            break;
+
+        default:
+            status = virtser_frame_unknown_opcode;
+            break;
+    }
+
+    frame_reply(opcode, status, reply, reply_length);
+}
+
+void frame_recv(uint8_t ucData) {
+    if (virtser_frame_decoding(&frame_decoder) && timer_elapsed(frame_timer) > VIRTSER_FRAME_TIMEOUT_MS) {
+        dprintf("frame timeout\n");
+        virtser_frame_decoder_reset(&frame_decoder);
+    }
+
+    frame_timer = timer_read();
+
+    switch (virtser_frame_decode(&frame_decoder, ucData)) {
+        case virtser_frame_complete:
+            frame_command(recv_buffer[0], recv_buffer + 1, virtser_frame_payload_length(&frame_decoder));
+            break;
+
+        case virtser_frame_corrupt:
+            dprintf("frame crc error\n");
+            frame_reply(recv_buffer[0], virtser_frame_crc_error, 0, 0);
+            break;
+
+        case virtser_frame_too_long:
+            frame_reply(0, virtser_frame_bad_length, 0, 0);
+            break;
+
+        case virtser_frame_incomplete:
+            break;
+    }
+}
+
+bool virtser_recv_ready(void) { return virtser_stream_ready(); }
+
 void virtser_recv(uint8_t ucData) {
-    static uint8_t buffer_pos = 0;
+    static uint16_t buffer_pos = 0;
+
+    // raw frame data, not even echoed
+    if (virtser_stream_is_active()) {
+        virtser_stream_recv(ucData);
+        return;
+    }
 
     LedInfo2_On();
 
@@ -1431,6 +1675,12 @@ void virtser_recv(uint8_t ucData) {
     virtser_send(ucData);
 #endif
 
+    if (recv_status == recvStatusIdle && (ucData == VIRTSER_FRAME_SYNC || virtser_frame_decoding(&frame_decoder))) {
+        frame_recv(ucData);
+        LedInfo2_Off();
+        return;
+    }
+
     // dprintf("recv: [%02X] <%c> s:%u\n", ucData, (char)ucData, recv_status);
 
     if (datagram_is_userdata_start(ucData)) {
@@ -1461,6 +1711,19 @@ void virtser_recv(uint8_t ucData) {
         else {
             recv_buffer[buffer_pos] = ucData;
             buffer_pos++;
+
+            if (buffer_pos == JSON_MAP_PREFIX_LENGTH && strncmp_P((char const *)recv_buffer, PSTR(JSON_MAP_PREFIX), buffer_pos) == 0) {
+                virtser_json_map_init(&json_map);
+                recv_status = recvStatusJsonMap;
+            }
+        }
+    } else if (recv_status == recvStatusJsonMap) {
+        if (ucData == DATAGRAM_USER_STOP) {
+            json_map_done();
+            buffer_pos  = 0;
+            recv_status = recvStatusIdle;
+        } else {
+            virtser_json_map_push(&json_map, ucData);
         }
     }
 
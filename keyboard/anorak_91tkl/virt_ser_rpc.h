@@ -1,5 +1,11 @@
 #ifndef KEYBOARD_ANORAK_91TKL_VIRT_SER_RPC_H_
 #define KEYBOARD_ANORAK_91TKL_VIRT_SER_RPC_H_
 
+#include <inttypes.h>
+
+void virtser_send_data(uint8_t const *data, uint8_t length);
+
+// sends a reply frame, see virt_ser_frame.h
+void frame_reply(uint8_t opcode, uint8_t status, uint8_t const *data, uint8_t length);
 
 #endif /* KEYBOARD_ANORAK_91TKL_VIRT_SER_RPC_H_ */
@@ -0,0 +1,109 @@
+
+#include "virt_ser_stream.h"
+#include "virt_ser_frame.h"
+#include "virt_ser_rpc.h"
+#include "backlight/issi/is31fl3733_91tkl.h"
+#include "backlight/sector/sector_control.h"
+#include "backlight/animations/animation.h"
+#include "backlight/animations/animation_arena.h"
+#include "backlight/led_health.h"
+#include "timer.h"
+#include <string.h>
+
+#ifdef DEBUG_VIRTSER
+#    include "debug.h"
+#else
+#    include "nodebug.h"
+#endif
+
+// the back buffer takes the whole arena, the animation is stopped and animation_prepare() is not used
+typedef char virtser_stream_arena_budget[(VIRTSER_STREAM_FRAME_SIZE <= ANIMATION_ARENA_SIZE) ? 1 : -1];
+
+enum stream_state { streamIdle = 0, streamReceiving, streamFrameReady };
+
+static uint8_t *stream_buffer;
+static uint8_t  stream_state = streamIdle;
+static uint16_t stream_pos;
+static uint16_t stream_frames;
+static uint16_t stream_uploaded;
+static uint16_t stream_timer;
+static bool     stream_restart_animation;
+
+static void stream_end(uint8_t status) {
+    dprintf("stream end: %u %u\n", stream_uploaded, status);
+
+    stream_state  = streamIdle;
+    stream_buffer = 0;
+
+    frame_reply(virtser_frame_stream_end, status, (uint8_t const *)&stream_uploaded, sizeof(stream_uploaded));
+
+    animation_arena_reset();
+    sector_set_custom_map(sector_get_custom_map());
+
+    if (stream_restart_animation) start_animation();
+}
+
+bool virtser_stream_start(uint16_t frames) {
+    if (stream_state != streamIdle) return false;
+
+    stream_restart_animation = animation_is_running();
+    stop_animation();
+    animation_arena_reset();
+
+    stream_buffer = animation_arena_alloc(VIRTSER_STREAM_FRAME_SIZE);
+    if (!stream_buffer) return false;
+
+    sector_enable_all_leds();
+    is31fl3733_91tkl_update_led_enable(&issi);
+
+    stream_state    = streamReceiving;
+    stream_pos      = 0;
+    stream_frames   = frames;
+    stream_uploaded = 0;
+    stream_timer    = timer_read();
+
+    return true;
+}
+
+void virtser_stream_stop(void) {
+    if (stream_state == streamIdle) return;
+
+    // the caller starts the animation itself
+    stream_restart_animation = false;
+    stream_end(virtser_frame_error);
+}
+
+bool virtser_stream_is_active(void) { return stream_state != streamIdle; }
+
+bool virtser_stream_ready(void) { return stream_state != streamFrameReady; }
+
+void virtser_stream_recv(uint8_t data) {
+    stream_buffer[stream_pos++] = data;
+    stream_timer                = timer_read();
+
+    if (stream_pos == VIRTSER_STREAM_FRAME_SIZE) stream_state = streamFrameReady;
+}
+
+void virtser_stream_task(void) {
+    if (stream_state == streamIdle) return;
+
+    if (stream_state == streamReceiving) {
+        if (timer_elapsed(stream_timer) > VIRTSER_STREAM_TIMEOUT_MS) stream_end(stream_frames ? virtser_frame_error : virtser_frame_ok);
+        return;
+    }
+
+    if (led_health_is_scanning()) return;
+
+    // swap: the driver buffers are the front buffer, the back buffer is free for the next frame as soon as it is copied
+    memcpy(is31fl3733_pwm_buffer(issi.upper->device), stream_buffer, IS31FL3733_LED_PWM_SIZE);
+    memcpy(is31fl3733_pwm_buffer(issi.lower->device), stream_buffer + IS31FL3733_LED_PWM_SIZE, IS31FL3733_LED_PWM_SIZE);
+
+    stream_pos   = 0;
+    stream_state = streamReceiving;
+    stream_timer = timer_read();
+
+    is31fl3733_91tkl_update_led_pwm(&issi);
+    stream_uploaded++;
+
+    if (stream_frames && stream_uploaded == stream_frames) stream_end(virtser_frame_ok);
+}
@@ -0,0 +1,44 @@
+#ifndef KEYBOARD_ANORAK_91TKL_VIRT_SER_STREAM_H_
+#define KEYBOARD_ANORAK_91TKL_VIRT_SER_STREAM_H_
+
+#include "backlight/issi/is31fl3733.h"
+#include <inttypes.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Raw PWM frames from the host, started with the virtser_frame_stream_start frame.
+ *
+ * A frame is the PWM buffer of the upper chip followed by the one of the lower chip, in the
+ * register layout of the IS31FL3733 (sw * IS31FL3733_CS + cs). The frame is received into a
+ * back buffer in the animation arena, the PWM buffers of the driver are the front buffer.
+ * While a received frame waits for its upload the endpoint is not read, the host is held
+ * back by USB flow control.
+ *
+ * The stream ends after the requested number of frames, after VIRTSER_STREAM_TIMEOUT_MS
+ * without data or when an animation is started, it is answered with a
+ * virtser_frame_stream_end frame with the number of uploaded frames.
+ */
+
+#define VIRTSER_STREAM_FRAME_SIZE (2 * IS31FL3733_LED_PWM_SIZE)
+#define VIRTSER_STREAM_TIMEOUT_MS 1000
+
+// frames 0 streams until the timeout, returns false if there is no buffer for the stream
+bool virtser_stream_start(uint16_t frames);
+// ends the stream and releases the arena, called by start_animation()
+void virtser_stream_stop(void);
+bool virtser_stream_is_active(void);
+// false while a received frame waits for its upload
+bool virtser_stream_ready(void);
+void virtser_stream_recv(uint8_t data);
+// uploads a received frame and ends the stream, called from the main loop
+void virtser_stream_task(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KEYBOARD_ANORAK_91TKL_VIRT_SER_STREAM_H_ */
@@ -1,6 +1,7 @@
 
 #include "animation.h"
 #include "animation_utils.h"
+#include "led_matrix/led_matrix.h"
 #include "breathing.h"
 #include "sweep.h"
 #include "timer.h"
@@ -21,7 +22,7 @@ void set_animation_sweep()
 	dprintf("sweep\r\n");
 
     animation.brightness = 255;
-    animation.delay_in_ms = 150;
+    animation.delay_in_ms = led_matrix_sweep.delay_in_ms;
     animation.duration_in_ms = 0;
 
 #ifdef DEBUG_ISSI_PERFORMANCE
@@ -32,6 +33,7 @@ void set_animation_sweep()
     animation.animationStop = &sweep_animation_stop;
     animation.animationLoop = &sweep_animation_loop;
     animation.animation_typematrix_row = 0;
+    animation.animation_key_event = &sweep_key_event;
 }
 #endif
 
@@ -40,13 +42,14 @@ void set_animation_type_o_matic()
 	dprintf("type_o_matic\r\n");
 
     animation.brightness = 255;
-    animation.delay_in_ms = 250;
+    animation.delay_in_ms = led_matrix_type_o_matic.delay_in_ms;
     animation.duration_in_ms = 0;
 
     animation.animationStart = &type_o_matic_animation_start;
     animation.animationStop = &type_o_matic_animation_stop;
     animation.animationLoop = &type_o_matic_animation_loop;
-    animation.animation_typematrix_row = &type_o_matic_typematrix_row;
+    animation.animation_typematrix_row = 0;
+    animation.animation_key_event = &type_o_matic_key_event;
 }
 
 void set_animation_type_o_circles()
@@ -61,6 +64,7 @@ void set_animation_type_o_circles()
     animation.animationStop = &type_o_circles_animation_stop;
     animation.animationLoop = &type_o_circles_animation_loop;
     animation.animation_typematrix_row = &type_o_circles_typematrix_row;
+    animation.animation_key_event = 0;
 }
 
 void set_animation_breathing()
@@ -75,6 +79,7 @@ void set_animation_breathing()
     animation.animationStop = &breathing_animation_stop;
     animation.animationLoop = 0;
     animation.animation_typematrix_row = 0;
+    animation.animation_key_event = 0;
 }
 
 void set_animation(uint8_t animation_number)
@@ -185,6 +190,9 @@ void start_animation()
 
     animation.loop_timer = timer_read();
     animation.duration_timer = timer_read32();
+
+    // keys pressed before the start are not news to the animation
+    led_matrix_event_clear();
 }
 
 void stop_animation()
@@ -198,6 +206,18 @@ void stop_animation()
     animation.animationStop = 0;
     animation.animationLoop = 0;
     animation.animation_typematrix_row = 0;
+    animation.animation_key_event = 0;
+}
+
+static void dispatch_key_events(void)
+{
+    led_matrix_key_event event;
+
+    while (led_matrix_event_pop(&event))
+    {
+        if (animation.animation_key_event)
+            animation.animation_key_event(&event);
+    }
 }
 
 void animate()
@@ -205,6 +225,8 @@ void animate()
     if (animation.animationLoop == 0)
         return;
 
+    dispatch_key_events();
+
     if (timer_elapsed(animation.loop_timer) < animation.delay_in_ms)
         return;
 
@@ -220,6 +242,9 @@ void animate()
 
 void animation_typematrix_row(uint8_t row_number, matrix_row_t row)
 {
+	// keeps track of the row state even if no animation is running
+	led_matrix_event_row(LED_MATRIX_EVENT_SOURCE_LOCAL, row_number, row, timer_read());
+
 	if (animation.animation_typematrix_row)
 	{
 		animation.loop_timer = timer_read();
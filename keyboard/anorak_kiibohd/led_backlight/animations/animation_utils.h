@@ -2,6 +2,7 @@
 #define KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_ANIMATIONS_ANIMATION_UTILS_H_
 
 #include "matrix.h"
+#include "led_matrix/led_matrix_event.h"
 #include <inttypes.h>
 
 struct _animation_interface
@@ -14,6 +15,8 @@ struct _animation_interface
     void (*animationStop)(void);
     void (*animationLoop)(void);
     void (*animation_typematrix_row)(uint8_t row_number, matrix_row_t row);
+    // optional: one call per key press or release, preferred over animation_typematrix_row
+    void (*animation_key_event)(led_matrix_key_event const *event);
 
     uint16_t loop_timer;
     uint32_t duration_timer;
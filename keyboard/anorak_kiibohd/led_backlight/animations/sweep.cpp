@@ -1,7 +1,10 @@
 
+#include "sweep.h"
 #include "../avr315/twi_transmit_queue.h"
 #include "../control.h"
+#include "../led_surface_kiibohd.h"
 #include "animation_utils.h"
+#include "led_matrix/led_matrix.h"
 #include "matrix.h"
 
 #if defined(DEBUG_ANIMATION) || defined(DEBUG_ISSI_PERFORMANCE)
@@ -10,24 +13,24 @@
 #include "nodebug.h"
 #endif
 
-// The lookup table to make the brightness changes be more visible
-// uint8_t const sweep[] PROGMEM = {1, 2, 3, 4, 6, 8, 10, 15, 20, 30, 40, 60, 60, 40, 30, 20, 15, 10, 8, 6, 4, 3, 2, 1};
-uint8_t const sweep[] PROGMEM = {1,   3,  6,  10, 20, 30, 40, 50, 60, 70, 80, 100,
-                                 100, 80, 70, 60, 50, 40, 30, 20, 10, 6,  3,  1};
-static uint8_t animation_frame;
-static uint8_t incr;
+// drawn by the board independent sweep of tmk_core/common/led_matrix
 
 void sweep_animation_start()
 {
-    incr = 0;
-    animation_frame = 1;
+    animation_prepare(LED_SURFACE_KIIBOHD_FRAME);
 
-    animation_prepare(animation_frame);
+    led_matrix_color.r = led_matrix_color.g = led_matrix_color.b = animation.brightness;
+    led_matrix_sweep.start(led_surface_kiibohd());
 }
 
 void sweep_animation_stop()
 {
-    animation_postpare(animation_frame);
+    animation_postpare(LED_SURFACE_KIIBOHD_FRAME);
+}
+
+void sweep_key_event(led_matrix_key_event const *event)
+{
+    led_matrix_sweep.key_event(led_surface_kiibohd(), event);
 }
 
 #ifdef DEBUG_ISSI_PERFORMANCE
@@ -55,15 +58,7 @@ void sweep_animation_loop()
     */
 #endif
 
-    incr++;
-    if (incr >= 24)
-        incr = 0;
-
-    for (uint8_t x = 0; x < 16; x++)
-        for (uint8_t y = 0; y < 9; y++)
-            issi.drawPixel(x, y, pgm_read_byte(&sweep[(x + y + incr) % 24]));
-
-    issi.blitToFrame(1);
+    led_matrix_sweep.loop(led_surface_kiibohd());
 
 #ifdef DEBUG_ISSI_PERFORMANCE
     uint8_t queue_size = tx_queue_size();
@@ -2,8 +2,11 @@
 #ifndef KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_ANIMATIONS_SWEEP_H_
 #define KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_ANIMATIONS_SWEEP_H_
 
+#include "led_matrix/led_matrix_event.h"
+
 void sweep_animation_start(void);
 void sweep_animation_loop(void);
 void sweep_animation_stop(void);
+void sweep_key_event(led_matrix_key_event const *event);
 
 #endif /* KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_ANIMATIONS_SWEEP_H_ */
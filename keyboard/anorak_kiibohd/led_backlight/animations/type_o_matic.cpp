@@ -1,58 +1,43 @@
 
 #include "type_o_matic.h"
-#include "../control.h"
-#include "../key_led_map.h"
+#include "../led_surface_kiibohd.h"
 #include "animation_utils.h"
+#include "led_matrix/led_matrix.h"
 #include "config.h"
+#include <string.h>
 
-static uint8_t animation_frame = 1;
+// drawn by the board independent type_o_matic of tmk_core/common/led_matrix
 
-void type_o_matic_typematrix_row(uint8_t row_number, matrix_row_t row)
+static led_matrix_type_o_matic_state type_o_matic_state;
+
+static void sync_color(void)
 {
-    type_o_matic_animation_loop();
+    led_matrix_color.r = led_matrix_color.g = led_matrix_color.b = animation.brightness;
 }
 
 void type_o_matic_animation_start()
 {
-    animation_frame = 1;
+    animation_prepare(LED_SURFACE_KIIBOHD_FRAME);
 
-    animation_prepare(animation_frame);
+    memset(&type_o_matic_state, 0, sizeof(type_o_matic_state));
+    led_matrix_state = &type_o_matic_state;
+    led_matrix_type_o_matic.start(led_surface_kiibohd());
 }
 
 void type_o_matic_animation_stop()
 {
-    animation_postpare(animation_frame);
+    animation_postpare(LED_SURFACE_KIIBOHD_FRAME);
+    led_matrix_state = 0;
 }
 
 void type_o_matic_animation_loop()
 {
-    uint8_t led_row;
-    uint8_t led_col;
-
-    for (uint8_t row = 0; row < MATRIX_ROWS; ++row)
-    {
-        for (uint8_t col = 0; col < MATRIX_COLS; ++col)
-        {
-            uint8_t color;
-            getLedPosByMatrixKey(row, col, &led_row, &led_col);
-
-            if (matrix_is_on(row, col))
-            {
-                issi.drawPixel(led_col, led_row, animation.brightness);
-            }
-            else
-            {
-                color = issi.getPixel(led_col, led_row);
-
-                if (color >= 5)
-                    color -= 5;
-                else
-                    color = 0;
-
-                issi.drawPixel(led_col, led_row, color);
-            }
-        }
-    }
-
-    issi.blitToFrame(animation_frame);
+    sync_color();
+    led_matrix_type_o_matic.loop(led_surface_kiibohd());
+}
+
+void type_o_matic_key_event(led_matrix_key_event const *event)
+{
+    sync_color();
+    led_matrix_type_o_matic.key_event(led_surface_kiibohd(), event);
 }
@@ -1,12 +1,12 @@
-
 #ifndef KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_ANIMATIONS_TYPE_O_MATIC_H_
 #define KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_ANIMATIONS_TYPE_O_MATIC_H_
 
 #include "matrix.h"
+#include "led_matrix/led_matrix_event.h"
 
 void type_o_matic_animation_start(void);
 void type_o_matic_animation_loop(void);
 void type_o_matic_animation_stop(void);
-void type_o_matic_typematrix_row(uint8_t row_number, matrix_row_t row);
+void type_o_matic_key_event(led_matrix_key_event const *event);
 
 #endif /* KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_ANIMATIONS_TYPE_O_MATIC_H_ */
@@ -17,7 +17,7 @@ const uint8_t PROGMEM keyledmap[MATRIX_ROWS][MATRIX_COLS] =
 			35, 34, 33, 32, 31, 30,
 			45, 44, 43, 42, 41, 40, 50);
 
-void getLedPosByMatrixKey(uint8_t row, uint8_t col, uint8_t *led_row, uint8_t *led_col)
+bool getLedPosByMatrixKey(uint8_t row, uint8_t col, uint8_t *led_row, uint8_t *led_col)
 {
     uint8_t pos = pgm_read_byte(&keyledmap[row][col]);
 
@@ -25,4 +25,6 @@ void getLedPosByMatrixKey(uint8_t row, uint8_t col, uint8_t *led_row, uint8_t *l
     *led_col = (pos & 0x0F);
 
     dprintf("r:%u, c:%u 0x%X -> %u %u\n", row, col, pos, *led_row, *led_col);
+
+    return pos != 0xFF;
 }
@@ -0,0 +1,47 @@
+
+#include "led_surface_kiibohd.h"
+#include "control.h"
+#include "key_led_map.h"
+#include "matrix.h"
+
+static void surface_set(led_surface *surface, uint8_t row, uint8_t col, led_pixel pixel)
+{
+    uint8_t led_row;
+    uint8_t led_col;
+
+    if (getLedPosByMatrixKey(row, col, &led_row, &led_col))
+        issi.drawPixel(led_col, led_row, led_pixel_level(pixel));
+}
+
+static bool surface_get(led_surface *surface, uint8_t row, uint8_t col, led_pixel *pixel)
+{
+    uint8_t led_row;
+    uint8_t led_col;
+
+    if (!getLedPosByMatrixKey(row, col, &led_row, &led_col))
+        return false;
+
+    pixel->r = pixel->g = pixel->b = issi.getPixel(led_col, led_row);
+    return true;
+}
+
+static void surface_commit(led_surface *surface)
+{
+    issi.blitToFrame(LED_SURFACE_KIIBOHD_FRAME);
+}
+
+static led_surface surface_kiibohd =
+{
+    MATRIX_ROWS,
+    MATRIX_COLS,
+    0,
+    0,
+    &surface_set,
+    &surface_get,
+    &surface_commit
+};
+
+led_surface *led_surface_kiibohd(void)
+{
+    return &surface_kiibohd;
+}
@@ -0,0 +1,23 @@
+#ifndef KEYBOARD_ANORAK_KIIBOHD_LED_BACKLIGHT_LED_SURFACE_KIIBOHD_H_
+#define KEYBOARD_ANORAK_KIIBOHD_LED_BACKLIGHT_LED_SURFACE_KIIBOHD_H_
+
+#include "led_matrix/led_surface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The keys as a mono led_surface on the pixel buffer of the IS31FL3731,
+ * committed to the animation frame.
+ */
+
+#define LED_SURFACE_KIIBOHD_FRAME 1
+
+led_surface *led_surface_kiibohd(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KEYBOARD_ANORAK_KIIBOHD_LED_BACKLIGHT_LED_SURFACE_KIIBOHD_H_ */
@@ -2,6 +2,7 @@
 #include "IS31FL3731.h"
 #include "../../twi/twi_config.h"
 #include "IS31FL3731_debug.h"
+#include "perf.h"
 #include <util/delay.h>
 
 #define ISSI_PICTUREMODE 0x00
@@ -286,6 +287,7 @@ void IS31FL3731::setLedBrightness(uint8_t lednum, uint8_t pwm, uint8_t bank)
 
 void IS31FL3731::setLedsBrightness(uint8_t const pwm[ISSI_TOTAL_CHANNELS], uint8_t bank)
 {
+    PERF_START(upload);
     selectBank(bank);
 
 #if TWILIB == AVR315 || TWILIB == AVR315_SYNC
@@ -325,6 +327,8 @@ void IS31FL3731::setLedsBrightness(uint8_t const pwm[ISSI_TOTAL_CHANNELS], uint8
     i2c_stop();
 
 #endif
+
+    PERF_STOP(upload, perfI2CUpload);
 }
 
 /*************/
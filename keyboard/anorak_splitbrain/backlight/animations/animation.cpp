@@ -5,6 +5,8 @@
 #include "../eeconfig_backlight.h"
 #include "animation_utils.h"
 #include "breathing.h"
+#include "perf.h"
+#include "trace.h"
 #include "sweep.h"
 #include "timer.h"
 #include "type_o_circles.h"
@@ -35,16 +37,6 @@ animation_names current_animation = animation_type_o_matic;
 static uint32_t last_key_pressed_timestamp = 0;
 static bool suspend_animation_on_idle = true;
 
-#ifdef DEBUG_ANIMATION
-//#define DEBUG_ANIMATION_SPEED
-#endif
-
-#ifdef DEBUG_ANIMATION_SPEED
-static uint32_t duration_ms = 0;
-static uint32_t elapsed_ms = 0;
-static uint8_t loop_count = 10;
-#endif
-
 void initialize_animation(void)
 {
     memset(&animation, 0, sizeof(struct _animation_interface));
@@ -121,6 +113,7 @@ animation_names animation_current(void)
 void set_animation(animation_names animation_by_name)
 {
     current_animation = animation_by_name;
+    animation.animation_key_event = 0;
 
     if (current_animation >= animation_LAST)
     {
@@ -238,6 +231,9 @@ void start_animation()
     animation.duration_timer = timer_read32();
     last_key_pressed_timestamp = timer_read32();
 
+    // keys pressed before the start are not news to the animation
+    led_matrix_event_clear();
+
     show_animaiton_info(current_animation);
 }
 
@@ -264,6 +260,7 @@ void stop_animation()
     animation.animationStop = 0;
     animation.animationLoop = 0;
     animation.animation_typematrix_row = 0;
+    animation.animation_key_event = 0;
 
     show_animaiton_info(current_animation);
 }
@@ -290,6 +287,9 @@ void resume_animation()
     animation.is_suspended = false;
 
     last_key_pressed_timestamp = timer_read32();
+
+    // keys pressed while suspended are not news to the animation
+    led_matrix_event_clear();
 }
 
 void resume_animation_in_idle_state()
@@ -303,6 +303,19 @@ void resume_animation_in_idle_state()
     animation.is_suspended = false;
 
     last_key_pressed_timestamp -= ANIMATION_SUSPEND_TIMEOUT;
+
+    led_matrix_event_clear();
+}
+
+static void dispatch_key_events(void)
+{
+    led_matrix_key_event event;
+
+    while (led_matrix_event_pop(&event))
+    {
+        if (animation.animation_key_event)
+            animation.animation_key_event(&event);
+    }
 }
 
 void animate()
@@ -310,6 +323,8 @@ void animate()
     if (!animation.is_running || animation.animationLoop == 0)
         return;
 
+    dispatch_key_events();
+
     if (timer_elapsed(animation.loop_timer) < animation.delay_in_ms)
         return;
 
@@ -324,32 +339,15 @@ void animate()
 	}
 	*/
 
-#ifdef DEBUG_ANIMATION_SPEED
-    if (loop_count)
-    {
-        loop_count--;
-        elapsed_ms = timer_read32();
-    }
-    else
-    {
-        loop_count = 10;
-        duration_ms /= 10;
-        dprintf("avg: %lu\n", duration_ms);
-        duration_ms = 0;
-        elapsed_ms = timer_read32();
-    }
-#endif
-
+    PERF_START(animate);
+    TRACE_BEGIN(traceAnimate, current_animation);
     animation.loop_timer = timer_read();
     animation.animationLoop();
-
-#ifdef DEBUG_ANIMATION_SPEED
-    duration_ms += timer_elapsed32(elapsed_ms);
-    // dprintf("el: %u\n", duration_ms);
-#endif
+    TRACE_END(traceAnimate, 0);
+    PERF_STOP(animate, perfAnimate);
 }
 
-void animation_typematrix_row(uint8_t row_number, matrix_row_t row)
+static void typematrix_row(uint8_t row_number, matrix_row_t row)
 {
     last_key_pressed_timestamp = timer_read32();
 
@@ -364,3 +362,16 @@ void animation_typematrix_row(uint8_t row_number, matrix_row_t row)
         animation.animation_typematrix_row(row_number, row);
     }
 }
+
+void animation_typematrix_row(uint8_t row_number, matrix_row_t row)
+{
+    // keeps track of the row state even if no animation is running
+    led_matrix_event_row(LED_MATRIX_EVENT_SOURCE_LOCAL, row_number, row, timer_read());
+    typematrix_row(row_number, row);
+}
+
+void animation_remote_typematrix_row(uint8_t row_number, matrix_row_t row)
+{
+    led_matrix_event_row(LED_MATRIX_EVENT_SOURCE_REMOTE, row_number, row, timer_read());
+    typematrix_row(row_number, row);
+}
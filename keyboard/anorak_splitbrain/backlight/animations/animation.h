@@ -43,6 +43,8 @@ animation_names animation_current(void);
 
 void animate(void);
 void animation_typematrix_row(uint8_t row_number, matrix_row_t row);
+// a row of the other half, received by splitbrain.c
+void animation_remote_typematrix_row(uint8_t row_number, matrix_row_t row);
 
 #ifdef __cplusplus
 }
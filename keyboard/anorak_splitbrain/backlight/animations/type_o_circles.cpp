@@ -1,4 +1,3 @@
-
 #include "type_o_circles.h"
 #include "../../splitbrain.h"
 #include "../control.h"
@@ -14,21 +13,26 @@
 
 #define RADIUS_COUNT 15
 
-static uint8_t *pressed_keys = 0;
+#define TYPE_O_CIRCLES_EFFECTS 8
+
 static uint8_t animation_frame = 1;
 
+// growing circles of this side, the value counts down the radii left
+static led_matrix_effect circles_items[TYPE_O_CIRCLES_EFFECTS];
+static led_matrix_effect_list circles;
+static bool circles_drawn = false;
 
 void type_o_circles_animation_start(void)
 {
     animation_frame = 1;
-    pressed_keys = (uint8_t *)calloc(MATRIX_ROWS * MATRIX_COLS, sizeof(uint8_t));
     animation_prepare(animation_frame);
+    led_matrix_effect_init(&circles, circles_items, TYPE_O_CIRCLES_EFFECTS);
+    circles_drawn = false;
 }
 
 void type_o_circles_animation_stop(void)
 {
     animation_postpare(animation_frame);
-    free(pressed_keys);
 }
 
 void type_o_circles_animation_loop(void)
@@ -37,34 +41,49 @@ void type_o_circles_animation_loop(void)
     uint8_t led_row;
     uint8_t led_col;
 
+    // the last frame with circles is cleared once, then there is nothing to draw
+    if (circles.count == 0 && !circles_drawn)
+        return;
+
     issi.clear();
+    circles_drawn = circles.count > 0;
 
-    for (uint8_t row = 0; row < MATRIX_ROWS; ++row)
+    for (uint8_t i = 0; i < circles.count;)
     {
-        for (uint8_t col = 0; col < MATRIX_COLS; ++col)
-        {
-            if (pressed_keys[row * MATRIX_ROWS + col] == 0 && matrix_is_on(row, col))
-                pressed_keys[row * MATRIX_ROWS + col] = RADIUS_COUNT;
-
-            if (pressed_keys[row * MATRIX_ROWS + col] > 0)
-            {
-                getLedPosByMatrixKey(row, col, &led_row, &led_col, &is_left_side);
-
-                if (is_left_side != is_left_side_of_keyboard())
-                    continue;
-
-                uint8_t r = RADIUS_COUNT - pressed_keys[row * MATRIX_ROWS + col];
-                issi.drawCircle(led_col, led_row, r, 128);
-                pressed_keys[row * MATRIX_ROWS + col]--;
-            }
-        }
+        led_matrix_effect *circle = &circles.items[i];
+
+        getLedPosByMatrixKey(circle->row, circle->col, &led_row, &led_col, &is_left_side);
+        issi.drawCircle(led_col, led_row, RADIUS_COUNT - circle->value, 128);
+
+        if (--circle->value == 0)
+            led_matrix_effect_remove(&circles, circle);
+        else
+            i++;
     }
 
     issi.blitToFrame(animation_frame);
 }
 
-void type_o_circles_typematrix_row(uint8_t row_number, matrix_row_t row)
+void type_o_circles_key_event(led_matrix_key_event const *event)
 {
+    uint8_t led_row;
+    uint8_t led_col;
+    bool is_left_side;
+
+    if (!(event->flags & LED_MATRIX_EVENT_PRESSED))
+        return;
+
+    getLedPosByMatrixKey(event->row, event->col, &led_row, &led_col, &is_left_side);
+
+    // the LED of the key is driven by the other half
+    if (is_left_side != is_left_side_of_keyboard())
+        return;
+
+    // a key grows one circle at a time, keys beyond TYPE_O_CIRCLES_EFFECTS get none
+    if (led_matrix_effect_find(&circles, event->row, event->col) ||
+        !led_matrix_effect_add(&circles, event->row, event->col, RADIUS_COUNT))
+        return;
+
     type_o_circles_animation_loop();
 }
 
@@ -79,5 +98,6 @@ void set_animation_type_o_circles()
     animation.animationStart = &type_o_circles_animation_start;
     animation.animationStop = &type_o_circles_animation_stop;
     animation.animationLoop = &type_o_circles_animation_loop;
-    animation.animation_typematrix_row = &type_o_circles_typematrix_row;
+    animation.animation_typematrix_row = 0;
+    animation.animation_key_event = &type_o_circles_key_event;
 }
@@ -1,4 +1,3 @@
-
 #include "type_o_drops.h"
 #include "../../splitbrain.h"
 #include "../control.h"
@@ -17,20 +16,26 @@ extern uint8_t gamma_correction_table[GAMMA_STEPS];
 
 #define RADIUS_COUNT 5
 
-static uint8_t *pressed_keys = 0;
+#define TYPE_O_DROPS_EFFECTS 8
+
 static uint8_t animation_frame = 1;
 
+// drops of this side, the value is the number of rings left
+static led_matrix_effect drops_items[TYPE_O_DROPS_EFFECTS];
+static led_matrix_effect_list drops;
+static bool drops_drawn = false;
+
 void type_o_drops_animation_start(void)
 {
     animation_frame = 1;
-    pressed_keys = (uint8_t *)calloc(MATRIX_ROWS * MATRIX_COLS, sizeof(uint8_t));
     animation_prepare(animation_frame);
+    led_matrix_effect_init(&drops, drops_items, TYPE_O_DROPS_EFFECTS);
+    drops_drawn = false;
 }
 
 void type_o_drops_animation_stop(void)
 {
     animation_postpare(animation_frame);
-    free(pressed_keys);
 }
 
 void type_o_drops_animation_loop(void)
@@ -39,37 +44,53 @@ void type_o_drops_animation_loop(void)
     uint8_t led_row;
     uint8_t led_col;
 
+    // the last frame with drops is cleared once, then there is nothing to draw
+    if (drops.count == 0 && !drops_drawn)
+        return;
+
     issi.clear();
+    drops_drawn = drops.count > 0;
 
-    for (uint8_t row = 0; row < MATRIX_ROWS; ++row)
+    for (uint8_t i = 0; i < drops.count;)
     {
-        for (uint8_t col = 0; col < MATRIX_COLS; ++col)
-        {
-            if (pressed_keys[row * MATRIX_ROWS + col] == 0 && matrix_is_on(row, col))
-                pressed_keys[row * MATRIX_ROWS + col] = RADIUS_COUNT;
+        led_matrix_effect *drop = &drops.items[i];
 
-            if (pressed_keys[row * MATRIX_ROWS + col] > 0)
-            {
-                getLedPosByMatrixKey(row, col, &led_row, &led_col, &is_left_side);
+        getLedPosByMatrixKey(drop->row, drop->col, &led_row, &led_col, &is_left_side);
 
-                if (is_left_side != is_left_side_of_keyboard())
-                    continue;
-
-                for (uint8_t r = 0; r < pressed_keys[row * MATRIX_ROWS + col]; ++r)
-                {
-                    issi.drawCircle(led_col, led_row, r, gamma_correction_table[r]);
-                }
-
-                pressed_keys[row * MATRIX_ROWS + col]--;
-            }
+        for (uint8_t r = 0; r < drop->value; ++r)
+        {
+            issi.drawCircle(led_col, led_row, r, gamma_correction_table[r]);
         }
+
+        if (--drop->value == 0)
+            led_matrix_effect_remove(&drops, drop);
+        else
+            i++;
     }
 
     issi.blitToFrame(animation_frame);
 }
 
-void type_o_drops_typematrix_row(uint8_t row_number, matrix_row_t row)
+void type_o_drops_key_event(led_matrix_key_event const *event)
 {
+    uint8_t led_row;
+    uint8_t led_col;
+    bool is_left_side;
+
+    if (!(event->flags & LED_MATRIX_EVENT_PRESSED))
+        return;
+
+    getLedPosByMatrixKey(event->row, event->col, &led_row, &led_col, &is_left_side);
+
+    // the LED of the key is driven by the other half
+    if (is_left_side != is_left_side_of_keyboard())
+        return;
+
+    // a key has one drop at a time, keys beyond TYPE_O_DROPS_EFFECTS get none
+    if (led_matrix_effect_find(&drops, event->row, event->col) ||
+        !led_matrix_effect_add(&drops, event->row, event->col, RADIUS_COUNT))
+        return;
+
     type_o_drops_animation_loop();
 }
 
@@ -84,5 +105,6 @@ void set_animation_type_o_drops()
     animation.animationStart = &type_o_drops_animation_start;
     animation.animationStop = &type_o_drops_animation_stop;
     animation.animationLoop = &type_o_drops_animation_loop;
-    animation.animation_typematrix_row = &type_o_drops_typematrix_row;
+    animation.animation_typematrix_row = 0;
+    animation.animation_key_event = &type_o_drops_key_event;
 }
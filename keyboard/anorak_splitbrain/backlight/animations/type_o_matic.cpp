@@ -1,10 +1,9 @@
-
 #include "type_o_matic.h"
-#include "../../splitbrain.h"
-#include "../control.h"
-#include "../key_led_map.h"
+#include "../led_surface_splitbrain.h"
 #include "animation_utils.h"
+#include "led_matrix/led_matrix.h"
 #include "config.h"
+#include <string.h>
 
 #ifdef DEBUG_ANIMATION
 #include "debug.h"
@@ -12,60 +11,40 @@
 #include "nodebug.h"
 #endif
 
-static uint8_t animation_frame = 1;
+// drawn by the board independent type_o_matic of tmk_core/common/led_matrix
+
+static led_matrix_type_o_matic_state type_o_matic_state;
+
+static void sync_color(void)
+{
+    led_matrix_color.r = led_matrix_color.g = led_matrix_color.b = animation.brightness;
+}
 
 void type_o_matic_animation_start(void)
 {
-    animation_frame = 1;
+    animation_prepare(LED_SURFACE_SPLITBRAIN_FRAME);
 
-    animation_prepare(animation_frame);
+    memset(&type_o_matic_state, 0, sizeof(type_o_matic_state));
+    led_matrix_state = &type_o_matic_state;
+    led_matrix_type_o_matic.start(led_surface_splitbrain());
 }
 
 void type_o_matic_animation_stop(void)
 {
-    animation_postpare(animation_frame);
+    animation_postpare(LED_SURFACE_SPLITBRAIN_FRAME);
+    led_matrix_state = 0;
 }
 
 void type_o_matic_animation_loop(void)
 {
-    uint8_t led_row;
-    uint8_t led_col;
-    bool is_left_side;
-
-    for (uint8_t row = 0; row < MATRIX_ROWS; ++row)
-    {
-        for (uint8_t col = 0; col < MATRIX_COLS; ++col)
-        {
-            uint8_t color;
-            getLedPosByMatrixKey(row, col, &led_row, &led_col, &is_left_side);
-
-            if (is_left_side != is_left_side_of_keyboard())
-                continue;
-
-            if (matrix_is_on(row, col))
-            {
-                issi.drawPixel(led_col, led_row, animation.brightness);
-            }
-            else
-            {
-                color = issi.getPixel(led_col, led_row);
-
-                if (color >= 5)
-                    color -= 5;
-                else
-                    color = 0;
-
-                issi.drawPixel(led_col, led_row, color);
-            }
-        }
-    }
-
-    issi.blitToFrame(animation_frame);
+    sync_color();
+    led_matrix_type_o_matic.loop(led_surface_splitbrain());
 }
 
-void type_o_matic_typematrix_row(uint8_t row_number, matrix_row_t row)
+void type_o_matic_key_event(led_matrix_key_event const *event)
 {
-    type_o_matic_animation_loop();
+    sync_color();
+    led_matrix_type_o_matic.key_event(led_surface_splitbrain(), event);
 }
 
 void set_animation_type_o_matic()
@@ -73,11 +52,12 @@ void set_animation_type_o_matic()
     dprintf("type_o_matic\n");
 
     animation.brightness = 255;
-    animation.delay_in_ms = FPS_TO_DELAY(4);
+    animation.delay_in_ms = led_matrix_type_o_matic.delay_in_ms;
     animation.duration_in_ms = 0;
 
     animation.animationStart = &type_o_matic_animation_start;
     animation.animationStop = &type_o_matic_animation_stop;
     animation.animationLoop = &type_o_matic_animation_loop;
-    animation.animation_typematrix_row = &type_o_matic_typematrix_row;
+    animation.animation_typematrix_row = 0;
+    animation.animation_key_event = &type_o_matic_key_event;
 }
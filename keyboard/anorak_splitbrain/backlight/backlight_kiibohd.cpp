@@ -497,6 +497,32 @@ void backlight_load_region_states()
 #endif
 }
 
+// applies synced region states, only the regions that changed and only while the backlight is on
+void backlight_apply_regions(uint8_t new_regions)
+{
+    uint8_t all = regions & backlight_region_ALL;
+    uint8_t changed = (regions ^ new_regions) & ~backlight_region_ALL;
+
+    regions = (new_regions & ~backlight_region_ALL) | all;
+
+    if (!all)
+        return;
+
+    for (uint8_t pos = 0; pos < BACKLIGHT_MAX_REGIONS; pos++)
+    {
+        uint8_t region = (1 << pos);
+
+        if (changed & region)
+            set_region_mode(region, (regions & region) ? LedControlMode_enable_mask : LedControlMode_disable_mask);
+    }
+}
+
+void backlight_apply_region_brightness(uint8_t pos, uint8_t brightness)
+{
+    if (pos < BACKLIGHT_MAX_REGIONS && region_brightness[pos] != brightness)
+        set_and_save_brightness_for_region((1 << pos), pos, brightness);
+}
+
 void backlight_set_regions_from_saved_state(void)
 {
     set_region_mode(backlight_region_ALL, LedControlMode_disable_mask);
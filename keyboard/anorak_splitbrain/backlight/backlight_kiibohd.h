@@ -2,6 +2,7 @@
 #define _BACKLIGHT_KIIBOHD_
 
 #include <inttypes.h>
+#include <stdbool.h>
 
 #define BACKLIGHT_WASD 0
 #define BACKLIGHT_CONTROLS 1
@@ -53,6 +54,8 @@ void backlight_decrease_brightness_selected_region(void);
 
 void backlight_save_region_states(void);
 void backlight_load_region_states(void);
+void backlight_apply_regions(uint8_t regions);
+void backlight_apply_region_brightness(uint8_t pos, uint8_t brightness);
 
 void backlight_enableShutdown(bool enabled);
 
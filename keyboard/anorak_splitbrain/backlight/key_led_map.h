@@ -25,6 +25,7 @@
   { LS(0x##K0A), LS(0x##K0B), LS(0x##K0C), LS(0x##K0D), LS(0x##K0E),      NO_LED,      NO_LED,      NO_LED, RS(0x##K0I), RS(0x##K0J), RS(0x##K0K), RS(0x##K0L), RS(0x##K0M), RS(0x##K0N),      NO_LED, RS(0x##K0P), RS(0x##K0Q), RS(0x##K0R) }  \
 }
 
-void getLedPosByMatrixKey(uint8_t row, uint8_t col, uint8_t *led_row, uint8_t *led_col, bool* is_left_side);
+// false for keys without LED (NO_LED)
+bool getLedPosByMatrixKey(uint8_t row, uint8_t col, uint8_t *led_row, uint8_t *led_col, bool* is_left_side);
 
 #endif /* KEYBOARD_ANORAK_KIIBOHD_LED_BACKLIGHT_KEY_LED_MAP_H_ */
@@ -0,0 +1,59 @@
+
+#include "led_surface_splitbrain.h"
+#include "../splitbrain.h"
+#include "control.h"
+#include "key_led_map.h"
+#include "matrix.h"
+
+static bool led_position(uint8_t row, uint8_t col, uint8_t *led_row, uint8_t *led_col)
+{
+    bool is_left_side;
+
+    if (!getLedPosByMatrixKey(row, col, led_row, led_col, &is_left_side))
+        return false;
+
+    // the LED of the key is driven by the other half
+    return is_left_side == is_left_side_of_keyboard();
+}
+
+static void surface_set(led_surface *surface, uint8_t row, uint8_t col, led_pixel pixel)
+{
+    uint8_t led_row;
+    uint8_t led_col;
+
+    if (led_position(row, col, &led_row, &led_col))
+        issi.drawPixel(led_col, led_row, led_pixel_level(pixel));
+}
+
+static bool surface_get(led_surface *surface, uint8_t row, uint8_t col, led_pixel *pixel)
+{
+    uint8_t led_row;
+    uint8_t led_col;
+
+    if (!led_position(row, col, &led_row, &led_col))
+        return false;
+
+    pixel->r = pixel->g = pixel->b = issi.getPixel(led_col, led_row);
+    return true;
+}
+
+static void surface_commit(led_surface *surface)
+{
+    issi.blitToFrame(LED_SURFACE_SPLITBRAIN_FRAME);
+}
+
+static led_surface surface_splitbrain =
+{
+    MATRIX_ROWS,
+    MATRIX_COLS,
+    0,
+    0,
+    &surface_set,
+    &surface_get,
+    &surface_commit
+};
+
+led_surface *led_surface_splitbrain(void)
+{
+    return &surface_splitbrain;
+}
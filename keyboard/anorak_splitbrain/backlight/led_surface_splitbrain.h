@@ -0,0 +1,24 @@
+#ifndef KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_LED_SURFACE_SPLITBRAIN_H_
+#define KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_LED_SURFACE_SPLITBRAIN_H_
+
+#include "led_matrix/led_surface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The keys of this half as a mono led_surface on the pixel buffer of the
+ * IS31FL3731, committed to the animation frame. Keys of the other half
+ * have no LED here.
+ */
+
+#define LED_SURFACE_SPLITBRAIN_FRAME 1
+
+led_surface *led_surface_splitbrain(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KEYBOARD_ANORAK_SPLITBRAIN_BACKLIGHT_LED_SURFACE_SPLITBRAIN_H_ */
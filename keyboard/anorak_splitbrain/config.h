@@ -32,6 +32,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define BACKLIGHT_LEVELS 8
 
+/* key events of this half and of the other half */
+#define LED_MATRIX_EVENT_SOURCES 2
+
 /* key combination for command */
 #define IS_COMMAND() (keyboard_report->mods == (MOD_BIT(KC_LGUI) | MOD_BIT(KC_LCTRL)) || keyboard_report->mods == (MOD_BIT(KC_RGUI) | MOD_BIT(KC_RCTRL)))
 
@@ -11,6 +11,7 @@
 #include "matrixdisplay/infodisplay.h"
 #include "nfo_led.h"
 #include "splitbrain.h"
+#include "eeprom_cache.h"
 #include "twi/twi_config.h"
 #include <util/delay.h>
 
@@ -111,6 +112,9 @@ void hook_usb_suspend_entry(void)
     matrix_clear();
     clear_keyboard();
 
+    // the main loop stops, the host may cut the power while suspended
+    eeprom_cache_flush();
+
     send_sleep_to_other_side(true);
     mcpu_hardware_shutdown(true);
 
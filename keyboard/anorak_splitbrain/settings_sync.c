@@ -0,0 +1,232 @@
+#include "settings_sync.h"
+#include "backlight.h"
+#include "backlight/eeconfig_backlight.h"
+#include "crc8.h"
+#include "eeconfig.h"
+#include "timer.h"
+#include <string.h>
+
+#ifdef DEBUG_SPLITBRAIN
+#include "debug.h"
+#else
+#include "nodebug.h"
+#endif
+
+#define SETTINGS_POLL_INTERVAL 100
+#define SETTINGS_ACK_TIMEOUT 100
+#define SETTINGS_CRC_START 0x2D
+
+#ifdef BACKLIGHT_ENABLE
+extern backlight_config_t backlight_config;
+#endif
+
+// the dirty mask shares its byte with SETTINGS_SYNC_CONNECT
+typedef char settings_sync_mask_fits[(syncFieldCount <= 7) ? 1 : -1];
+
+static uint8_t settings[syncFieldCount];
+
+static uint8_t generation = 0;
+static uint8_t sent_generation = 0;
+static uint8_t dirty = 0;
+static bool connect_pending = false;
+static bool ack_pending = false;
+
+static uint16_t last_poll_ts = 0;
+static uint16_t last_sync_ts = 0;
+
+static uint8_t read_field(uint8_t field)
+{
+    switch (field)
+    {
+    case syncFieldDebug:
+        return eeconfig_read_debug();
+#ifdef BACKLIGHT_ENABLE
+    case syncFieldBacklight:
+        return eeconfig_read_backlight();
+    case syncFieldRegions:
+        return eeconfig_read_backlight_regions();
+    default:
+        return eeconfig_read_backlight_region_brightness(field - syncFieldRegionBrightness);
+#else
+    default:
+        return 0;
+#endif
+    }
+}
+
+static void read_settings(void)
+{
+    for (uint8_t field = 0; field < syncFieldCount; field++)
+        settings[field] = read_field(field);
+}
+
+// writes the field through the EEPROM cache and applies it without a backlight init
+static void apply_field(uint8_t field, uint8_t value)
+{
+    dprintf("sync: field %u %u -> %u\n", field, settings[field], value);
+
+    switch (field)
+    {
+    case syncFieldDebug:
+        debug_config.raw = value;
+        eeconfig_write_debug(value);
+        break;
+#ifdef BACKLIGHT_ENABLE
+    case syncFieldBacklight:
+        // applied after the regions, backlight_set() shows them
+        eeconfig_write_backlight(value);
+        break;
+    case syncFieldRegions:
+        eeconfig_write_backlight_regions(value);
+        backlight_apply_regions(value);
+        break;
+    default:
+        eeconfig_write_backlight_region_brightness(field - syncFieldRegionBrightness, value);
+        backlight_apply_region_brightness(field - syncFieldRegionBrightness, value);
+        break;
+#endif
+    }
+}
+
+void settings_sync_init(void)
+{
+    // the persisted values are no change, the first poll only finds what changed after the start
+    read_settings();
+    generation = 0;
+    last_poll_ts = timer_read();
+    settings_sync_reset();
+}
+
+void settings_sync_reset(void)
+{
+    connect_pending = true;
+    ack_pending = false;
+    dirty = 0;
+}
+
+bool settings_sync_poll(void)
+{
+    if (timer_elapsed(last_poll_ts) >= SETTINGS_POLL_INTERVAL)
+    {
+        uint8_t changed = 0;
+
+        for (uint8_t field = 0; field < syncFieldCount; field++)
+        {
+            uint8_t value = read_field(field);
+            if (value != settings[field])
+            {
+                settings[field] = value;
+                changed |= (1 << field);
+            }
+        }
+
+        if (changed)
+        {
+            dirty |= changed;
+            generation++;
+        }
+
+        last_poll_ts = timer_read();
+    }
+
+    if (ack_pending)
+    {
+        if (timer_elapsed(last_sync_ts) < SETTINGS_ACK_TIMEOUT)
+            return false;
+
+        // the sync or its answer is lost, the other side may have applied it or not
+        dprintf("sync: no ack %u\n", sent_generation);
+        ack_pending = false;
+        dirty = SETTINGS_SYNC_ALL;
+    }
+
+    return (connect_pending || dirty);
+}
+
+uint8_t settings_sync_fill(uint8_t *payload)
+{
+    uint8_t pos = 0;
+
+    payload[pos++] = generation;
+    payload[pos++] = dirty | (connect_pending ? SETTINGS_SYNC_CONNECT : 0);
+
+    for (uint8_t field = 0; field < syncFieldCount; field++)
+    {
+        if (dirty & (1 << field))
+            payload[pos++] = settings[field];
+    }
+
+    payload[pos++] = crc8_calc(settings, SETTINGS_CRC_START, syncFieldCount);
+
+    dprintf("sync: send gen %u mask 0x%X\n", generation, payload[1]);
+
+    sent_generation = generation;
+    connect_pending = false;
+    ack_pending = true;
+    dirty = 0;
+    last_sync_ts = timer_read();
+
+    return pos;
+}
+
+void settings_sync_acked(uint8_t acked_generation, bool in_sync)
+{
+    if (!ack_pending || acked_generation != sent_generation)
+        return;
+
+    ack_pending = false;
+
+    if (!in_sync)
+    {
+        dprintf("sync: gen %u out of sync\n", acked_generation);
+        dirty = SETTINGS_SYNC_ALL;
+    }
+}
+
+bool settings_sync_accept(uint8_t const *payload, uint8_t length)
+{
+    uint8_t block[syncFieldCount];
+    uint8_t mask;
+    uint8_t pos = 2;
+
+    if (length < 3)
+        return false;
+
+    // the EEPROM of this side may have changed since the last sync, e.g. by its first setup
+    read_settings();
+    memcpy(block, settings, sizeof(block));
+
+    mask = payload[1];
+    for (uint8_t field = 0; field < syncFieldCount; field++)
+    {
+        if (mask & (1 << field))
+        {
+            if (pos >= length - 1)
+                return false;
+            block[field] = payload[pos++];
+        }
+    }
+
+    if (pos != length - 1 || crc8_calc(block, SETTINGS_CRC_START, syncFieldCount) != payload[pos])
+    {
+        dprintf("sync: gen %u does not match\n", payload[0]);
+        return false;
+    }
+
+    for (uint8_t field = 0; field < syncFieldCount; field++)
+    {
+        if (block[field] != settings[field])
+            apply_field(field, block[field]);
+    }
+
+#ifdef BACKLIGHT_ENABLE
+    if (block[syncFieldBacklight] != settings[syncFieldBacklight])
+    {
+        backlight_config.raw = block[syncFieldBacklight];
+        backlight_set(backlight_config.enable ? backlight_config.level : 0);
+    }
+#endif
+
+    memcpy(settings, block, sizeof(block));
+    return true;
+}
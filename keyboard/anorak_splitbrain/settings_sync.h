@@ -0,0 +1,60 @@
+#pragma once
+
+#include "backlight/backlight_kiibohd.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Settings block shared by both halves
+ *
+ * The side connected to USB owns the settings. It keeps a copy of the
+ * persisted values and polls for changes: a changed field sets its dirty
+ * bit and increments the generation. A sync carries the generation, the
+ * dirty fields and the crc8 of the whole block:
+ *
+ *   <generation> <mask> <value of each field in mask> <crc>
+ *
+ * The other side applies the fields only if its block then has the same
+ * crc8, and answers with the generation and 'A'. A block that does not
+ * match is left as it is and answered with 'N', the owner then sends all
+ * fields. After a reconnect the owner sends no fields at all, halves that
+ * are already in sync are done with one datagram each way.
+ */
+
+enum settings_sync_field
+{
+    syncFieldDebug = 0,
+#ifdef BACKLIGHT_ENABLE
+    syncFieldBacklight,
+    syncFieldRegions,
+    syncFieldRegionBrightness,
+    syncFieldCount = syncFieldRegionBrightness + BACKLIGHT_MAX_REGIONS
+#else
+    syncFieldCount
+#endif
+};
+
+#define SETTINGS_SYNC_ALL ((1 << syncFieldCount) - 1)
+// first sync of a connection
+#define SETTINGS_SYNC_CONNECT 0x80
+#define SETTINGS_SYNC_PAYLOAD_MAX (syncFieldCount + 3)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void settings_sync_init(void);
+// the peer state is unknown, the next sync is a connect sync
+void settings_sync_reset(void);
+// owner: reads the persisted settings, true if a sync is due
+bool settings_sync_poll(void);
+// owner: fills the sync payload, returns its length
+uint8_t settings_sync_fill(uint8_t *payload);
+// owner: the peer answered generation, in_sync is false for 'N'
+void settings_sync_acked(uint8_t generation, bool in_sync);
+// other side: applies a sync payload, false if the block does not match
+bool settings_sync_accept(uint8_t const *payload, uint8_t length);
+
+#ifdef __cplusplus
+}
+#endif
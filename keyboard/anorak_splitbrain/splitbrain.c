@@ -36,7 +36,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * 	    byte 1: 0: slave -> not connected to usb, 1: master -> connected to usb
  *
  *
- * 0x04 sync
+ * 0x53 sync
+ *      settings of the side connected to usb, see settings_sync.h
+ *      payload length: 3..10 bytes
+ *      byte 1: <generation>
+ *      byte 2: <field mask>
+ *      byte 3..: <value of each field in mask> <crc8 of all fields>
+ *
+ * 0x55 sync ack
+ *      payload length: 2 bytes
+ *      byte 1: <generation>
+ *      byte 2: 'A' applied, 'N' settings do not match
  *
  */
 
@@ -54,6 +64,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "matrixdisplay/infodisplay.h"
 #include "nfo_led.h"
+#include "perf.h"
+#include "trace.h"
+#include "settings_sync.h"
 #include "timer.h"
 #include "uart/uart.h"
 #include <avr/io.h>
@@ -82,7 +95,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define LOW_BYTE(x) (x & 0xff)         // 16Bit 	--> 8Bit
 #define HIGH_BYTE(x) ((x >> 8) & 0xff) // 16Bit 	--> 8Bit
 
-#define PROTOCOL_VERSION 2
+#define PROTOCOL_VERSION 3
 
 //#define DATAGRAM_START 0x41
 //#define DATAGRAM_STOP 0x45
@@ -97,6 +110,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define DATAGRAM_CMD_ROW_ACK 0x51
 #define DATAGRAM_CMD_SYNC 0x53
 #define DATAGRAM_CMD_SLEEP 0x54
+#define DATAGRAM_CMD_SYNC_ACK 0x55
 #define DATAGRAM_CMD_CMD 0x60
 
 #define MAX_SPLIT_MSG_LENGTH 16
@@ -122,6 +136,7 @@ bool _waiting_for_row_ack = false;
 bool _is_other_side_connected_to_usb = false;
 bool _is_other_side_sleeping = false;
 bool _was_ever_connected_to_usb = false;
+bool _is_settings_owner = false;
 
 uint16_t last_receive_ts = 0;
 uint16_t last_send_ts = 0;
@@ -168,6 +183,7 @@ void send_row_ack_to_other_side(bool ack);
 void resend_row_to_other_side(void);
 void reset_connection_on_timeout(void);
 void reset_other_sides_rows(void);
+void send_sync_ack_to_other_side(uint8_t generation, bool in_sync);
 
 void splitbrain_init()
 {
@@ -177,6 +193,7 @@ void splitbrain_init()
     _waiting_for_row_ack = false;
     _is_other_side_connected_to_usb = false;
     _is_other_side_sleeping = false;
+    _is_settings_owner = false;
 
     last_receive_ts = 0;
     last_send_ts = 0;
@@ -192,6 +209,7 @@ void splitbrain_init()
 
     reset_other_sides_rows();
     splitbrain_get_my_side();
+    settings_sync_init();
 
     recv_status = recvStatusIdle;
     last_init_send_ts = timer_read() - INIT_TIMEOUT;
@@ -279,50 +297,6 @@ bool accept_connection_request(uint8_t usb, uint8_t other_side, uint8_t protocol
     return (side_matches && connect_matches && protocol_matches);
 }
 
-bool accept_sync_request(uint8_t const *buffer, uint8_t length)
-{
-	bool changed = false;
-
-    uint8_t dbg = buffer[0];
-    if (dbg != eeconfig_read_debug())
-    {
-        debug_config.raw = dbg;
-        eeconfig_write_debug(debug_config.raw);
-        changed = true;
-    }
-
-#ifdef BACKLIGHT_ENABLE
-    uint8_t backlight = buffer[1];
-    if (backlight != eeconfig_read_backlight())
-    {
-        dprintf("sync: fix backlight %u %u\n", backlight, eeconfig_read_backlight());
-        eeconfig_write_backlight(backlight);
-        changed = true;
-    }
-
-    uint8_t regions = buffer[2];
-    if (regions != eeconfig_read_backlight_regions())
-    {
-        dprintf("sync: fix regions %u %u\n", regions, eeconfig_read_backlight_regions());
-        eeconfig_write_backlight_regions(regions);
-        changed = true;
-    }
-
-    for (uint8_t i = 0; i < BACKLIGHT_MAX_REGIONS; i++)
-    {
-        uint8_t region_brightness = buffer[i + 3];
-        if (region_brightness != eeconfig_read_backlight_region_brightness(i))
-        {
-            dprintf("sync: fix brightness %u %u\n", region_brightness, eeconfig_read_backlight_region_brightness(i));
-            eeconfig_write_backlight_region_brightness(i, region_brightness);
-            changed = true;
-        }
-    }
-#endif
-
-    return changed;
-}
-
 void reset_other_sides_rows()
 {
     for (uint8_t r = 0; r < MATRIX_ROWS; ++r)
@@ -367,7 +341,9 @@ void interpret_command(uint8_t const *buffer, uint8_t length)
 
         _is_connected_to_other_side = true;
         _is_other_side_connected_to_usb = false;
+        _is_settings_owner = true;
 
+        settings_sync_reset();
         send_sync_to_other_side();
 
         dprintf("connect ACKed! rtt %u\n", rtt);
@@ -381,7 +357,7 @@ void interpret_command(uint8_t const *buffer, uint8_t length)
         send_row_ack_to_other_side(rd->row_number < MATRIX_ROWS);
 
         mcpu_send_typematrix_row(rd->row_number, other_sides_rows[rd->row_number]);
-        animation_typematrix_row(rd->row_number, other_sides_rows[rd->row_number]);
+        animation_remote_typematrix_row(rd->row_number, other_sides_rows[rd->row_number]);
     }
     else if (cmd == DATAGRAM_CMD_ROW_ACK)
     {
@@ -406,18 +382,21 @@ void interpret_command(uint8_t const *buffer, uint8_t length)
     else if (cmd == DATAGRAM_CMD_SYNC)
     {
         dprintf("recv sync\n");
-        bool changed = accept_sync_request(buffer + 3, length - 3);
+        bool in_sync = settings_sync_accept(buffer + 3, buffer[1]);
+        send_sync_ack_to_other_side(buffer[3], in_sync);
         _is_other_side_connected_to_usb = true;
 
-        if (changed)
+        if (buffer[4] & SETTINGS_SYNC_CONNECT)
         {
-        	backlight_load_region_states();
-        	backlight_init();
+            //TODO: set current animation
+            mcpu_send_animation_stop();
+            stop_animation();
         }
-
-        //TODO: set current animation
-        mcpu_send_animation_stop();
-        stop_animation();
+    }
+    else if (cmd == DATAGRAM_CMD_SYNC_ACK)
+    {
+        dprintf("recv sync ack %u %c\n", buffer[3], buffer[4]);
+        settings_sync_acked(buffer[3], buffer[4] == 'A');
     }
     else if (cmd == DATAGRAM_CMD_SLEEP)
     {
@@ -490,6 +469,9 @@ void receive_data_from_other_side()
     static uint8_t expected_length = 0;
     uint8_t ucData;
     unsigned int rd;
+    bool received = false;
+
+    PERF_START(receive);
 
     do
     {
@@ -504,6 +486,7 @@ void receive_data_from_other_side()
         {
             LedInfo2_On();
             ucData = LOW_BYTE(rd);
+            received = true;
             // dprintf("recv: [%02X] s:%u\n", ucData, recv_status);
 
             if (ucData == DATAGRAM_START && recv_status == recvStatusIdle)
@@ -558,7 +541,9 @@ void receive_data_from_other_side()
                 {
                     // dprintf("recv: ");
                     // dump_buffer(recv_buffer, buffer_pos);
+                    TRACE_BEGIN(traceSplitReceive, (get_datagram_cmd(recv_buffer) << 8) | buffer_pos);
                     interpret_command(recv_buffer, buffer_pos);
+                    TRACE_END(traceSplitReceive, 0);
                 }
                 else
                 {
@@ -597,6 +582,12 @@ void receive_data_from_other_side()
         //#endif
     } while (HIGH_BYTE(rd) == 0);
     //#endif
+
+    // polls without data are left out, they would hide the receive times
+    if (received)
+    {
+        PERF_STOP(receive, perfSplitReceive);
+    }
 }
 
 void uart_send(uint8_t const *data, uint8_t length)
@@ -627,7 +618,9 @@ uint8_t fill_message_footer(uint8_t pos)
 void send_message_to_other_side(uint8_t length)
 {
     LedInfo1_On();
+    TRACE_BEGIN(traceSplitSend, (get_datagram_cmd(send_buffer) << 8) | length);
     uart_send(send_buffer, length);
+    TRACE_END(traceSplitSend, 0);
     last_send_ts = timer_read();
     LedInfo1_Off();
 }
@@ -686,26 +679,23 @@ void send_sync_to_other_side()
     if (!_is_connected_to_other_side)
         return;
 
-    dprintf("send sync\n");
+    uint8_t payload[SETTINGS_SYNC_PAYLOAD_MAX];
+    uint8_t length = settings_sync_fill(payload);
 
-#ifdef BACKLIGHT_ENABLE
-    uint8_t pos = fill_message_header(DATAGRAM_CMD_SYNC, 1 + 1 + BACKLIGHT_MAX_REGIONS + 1);
-    dprintf("sync: bl:%u\n", eeconfig_read_backlight());
-    send_buffer[pos++] = eeconfig_read_debug();
-    send_buffer[pos++] = eeconfig_read_backlight();
-    send_buffer[pos++] = eeconfig_read_backlight_regions();
-    dprintf("sync: rg:%u\n", eeconfig_read_backlight_regions());
-    for (uint8_t i = 0; i < BACKLIGHT_MAX_REGIONS; i++)
-    {
-        dprintf("sync: rg%u:%u\n", i, eeconfig_read_backlight_region_brightness(i));
-        send_buffer[pos++] = eeconfig_read_backlight_region_brightness(i);
-    }
-    //send_buffer[pos++] = current_animation();
-#else
-    uint8_t pos = fill_message_header(DATAGRAM_CMD_SYNC, 1);
-    send_buffer[pos++] = eeconfig_read_debug();
-#endif
+    dprintf("send sync %u\n", length);
+
+    uint8_t pos = fill_message_header(DATAGRAM_CMD_SYNC, length);
+    memcpy(send_buffer + pos, payload, length);
+    pos = fill_message_footer(pos + length);
+    send_message_to_other_side(pos);
+}
 
+void send_sync_ack_to_other_side(uint8_t generation, bool in_sync)
+{
+    dprintf("send sync ack %u %c\n", generation, (in_sync ? 'A' : 'N'));
+    uint8_t pos = fill_message_header(DATAGRAM_CMD_SYNC_ACK, 2);
+    send_buffer[pos++] = generation;
+    send_buffer[pos++] = in_sync ? 'A' : 'N';
     pos = fill_message_footer(pos);
     send_message_to_other_side(pos);
 }
@@ -790,6 +780,7 @@ void reset_connection_on_timeout()
     dprintf("connection broken!\n");
     _is_connected_to_other_side = false;
     _is_other_side_connected_to_usb = false;
+    _is_settings_owner = false;
     _waiting_for_row_ack = false;
     reset_other_sides_rows();
     last_receive_ts = timer_read();
@@ -822,6 +813,11 @@ void communication_watchdog()
         {
             resend_row_to_other_side();
         }
+
+        if (_is_settings_owner && settings_sync_poll())
+        {
+            send_sync_to_other_side();
+        }
     }
     else
     {
@@ -17,9 +17,12 @@
 #include "timer.h"
 #include "host.h"
 #include "virt_ser_rpc.h"
+#include "shell_dispatch.h"
 #include "eeconfig.h"
 #include "keyboard.h"
 #include "keycode.h"
+#include "perf.h"
+#include "trace.h"
 #include "keymap.h"
 #include "backlight.h"
 #include "backlight/eeconfig_backlight.h"
@@ -61,6 +64,7 @@
 
 int virtser_printf_P(const char *fmt, ...);
 int virtser_print_P(const char *s);
+void virtser_send_data(uint8_t const *data, uint8_t length);
 
 #if 0
 #define vserprint(s) xfprintf(&virtser_send, s)
@@ -97,19 +101,11 @@ enum virtserRecvStatus
 
 enum virtserRecvStatus virtser_recv_status = recvStatusIdle;
 
-struct user_command_t
-{
-    char *cmd;
-    bool (*pfn_command)(uint8_t argc, char **argv);
-    char *help_args;
-    char *help_msg;
-};
-
-typedef struct user_command_t user_command;
-
 bool cmd_user_help(uint8_t argc, char **argv);
 bool cmd_user_info(uint8_t argc, char **argv);
 bool cmd_user_ram(uint8_t argc, char **argv);
+bool cmd_user_perf(uint8_t argc, char **argv);
+bool cmd_user_trace(uint8_t argc, char **argv);
 bool cmd_user_dump_eeprom(uint8_t argc, char **argv);
 bool cmd_user_sector(uint8_t argc, char **argv);
 bool cmd_user_animation(uint8_t argc, char **argv);
@@ -122,23 +118,31 @@ bool cmd_user_backlight_eeprom_clear(uint8_t argc, char **argv);
 bool cmd_user_default_layer(uint8_t argc, char **argv);
 bool cmd_user_infodisplay(uint8_t argc, char **argv);
 
-const user_command user_command_table[] PROGMEM = {
-    {"?", &cmd_user_help, 0, "show help"},
-    {"info", &cmd_user_info, 0, "show info"},
-    {"ram", &cmd_user_ram, 0, "show free ram"},
-    {"ee", &cmd_user_dump_eeprom, 0, "dump eeprom"},
-    {"fee", &cmd_user_eeprom_clear, 0, "clear eeprom"},
-    {"bee", &cmd_user_backlight_eeprom_clear, 0, "clear backlight eeprom"},
-	{"bl", &cmd_user_backlight, 0, "enable backlight"},
-    {"sector", &cmd_user_sector, "save | map # | # 0|1 | # h s v", "set sector"},
-    {"animation", &cmd_user_animation, "save | delay ms | # 0|1 | c h s v", "set animation"},
-    {"debug", &cmd_user_debug_config, 0, "debug configuration"},
-	{"keymap", &cmd_user_keymap_config, 0, "keymap configuration"},
-    {"layer", &cmd_user_default_layer, 0, "default layer"},
-    {"boot", &cmd_user_bootloader_jump, 0, "jump to bootloader"},
-	{"mx", &cmd_user_infodisplay, 0, "infodisplay" },
-
-    {0, 0, 0, 0}};
+// sorted by name, see shell_dispatch.h
+static const shell_command_t user_command_list[] PROGMEM = {
+    SHELL_COMMAND("?", &cmd_user_help, 0, "show help"),
+    SHELL_COMMAND("animation", &cmd_user_animation, "save | delay ms | # 0|1 | c h s v", "set animation"),
+    SHELL_COMMAND("bee", &cmd_user_backlight_eeprom_clear, 0, "clear backlight eeprom"),
+    SHELL_COMMAND("bl", &cmd_user_backlight, 0, "enable backlight"),
+    SHELL_COMMAND("boot", &cmd_user_bootloader_jump, 0, "jump to bootloader"),
+    SHELL_COMMAND("debug", &cmd_user_debug_config, 0, "debug configuration"),
+    SHELL_COMMAND("ee", &cmd_user_dump_eeprom, 0, "dump eeprom"),
+    SHELL_COMMAND("fee", &cmd_user_eeprom_clear, 0, "clear eeprom"),
+    SHELL_COMMAND("info", &cmd_user_info, 0, "show info"),
+    SHELL_COMMAND("keymap", &cmd_user_keymap_config, 0, "keymap configuration"),
+    SHELL_COMMAND("layer", &cmd_user_default_layer, 0, "default layer"),
+    SHELL_COMMAND("mx", &cmd_user_infodisplay, 0, "infodisplay"),
+#ifdef PERF_ENABLE
+    SHELL_COMMAND("perf", &cmd_user_perf, "reset | bin", "performance counters"),
+#endif
+    SHELL_COMMAND("ram", &cmd_user_ram, 0, "show free ram"),
+    SHELL_COMMAND("sector", &cmd_user_sector, "save | map # | # 0|1 | # h s v", "set sector"),
+#ifdef TRACE_ENABLE
+    SHELL_COMMAND("trace", &cmd_user_trace, "freeze | arm us | mask hex", "timeline trace"),
+#endif
+};
+
+static shell_table_t user_commands = SHELL_TABLE(user_command_list);
 
 void dump_args(uint8_t argc, char **argv)
 {
@@ -150,19 +154,16 @@ void dump_args(uint8_t argc, char **argv)
 
 bool cmd_user_help(uint8_t argc, char **argv)
 {
-    uint8_t pos = 0;
-    user_command cmd;
-
-    memcpy_P(&cmd, (const void *)&user_command_table[pos++], sizeof(struct user_command_t));
+    shell_command_t cmd;
 
-    while (cmd.pfn_command)
+    for (uint8_t pos = 0; pos < user_commands.count; pos++)
     {
+        shell_command_get(&user_commands, pos, &cmd);
+
         if (cmd.help_args)
-            vserprintfln("%s [%s]: %s", cmd.cmd, cmd.help_args, cmd.help_msg);
+            vserprintfln("%s [%s]: %s", cmd.name, cmd.help_args, cmd.help_msg);
         else
-            vserprintfln("%s: %s", cmd.cmd, cmd.help_msg);
-
-        memcpy_P(&cmd, (const void *)&user_command_table[pos++], sizeof(struct user_command_t));
+            vserprintfln("%s: %s", cmd.name, cmd.help_msg);
     }
 
     vserprintf("\n");
@@ -500,6 +501,99 @@ bool cmd_user_ram(uint8_t argc, char **argv)
     return true;
 }
 
+#ifdef PERF_ENABLE
+// name, samples, min, avg and max in us, then the histogram, see perf.h
+// 'bin' sends the count of counters, their size and the us of 1000 ticks, then the raw counters
+bool cmd_user_perf(uint8_t argc, char **argv)
+{
+    perf_counter_t counter;
+
+    if (argc == 1 && strcmp_P(argv[0], PSTR("reset")) == 0)
+    {
+        perf_reset();
+        vserprintfln(".perf reset");
+        return true;
+    }
+
+    if (argc == 1 && strcmp_P(argv[0], PSTR("bin")) == 0)
+    {
+        vserprintfln(".perf bin %u %u %u", PERF_COUNTERS, sizeof(perf_counter_t), perf_us(1000));
+        for (uint8_t i = 0; i < PERF_COUNTERS; i++)
+        {
+            perf_get(i, &counter);
+            virtser_send_data((uint8_t const *)&counter, sizeof(counter));
+        }
+        return true;
+    }
+
+    if (argc != 0)
+        return false;
+
+    for (uint8_t i = 0; i < PERF_COUNTERS; i++)
+    {
+        if (!perf_get(i, &counter))
+            continue;
+
+        vserprint(".perf ");
+        virtser_print_P(perf_name_P(i));
+        vserprintf(" %u %u", counter.count, perf_us(counter.min));
+        vserprintf(" %u %u", perf_us(counter.sum / counter.count), perf_us(counter.max));
+        for (uint8_t b = 0; b < PERF_BUCKETS; b++)
+            vserprintf(" %u", counter.buckets[b]);
+        vserprintln("");
+    }
+
+    return true;
+}
+#endif
+
+#ifdef TRACE_ENABLE
+// freezes the trace and sends it, recording starts again after the dump, see tmk_core/tool/trace_json
+bool cmd_user_trace(uint8_t argc, char **argv)
+{
+    trace_record_t record;
+
+    if (argc == 1 && strcmp_P(argv[0], PSTR("freeze")) == 0)
+    {
+        trace_freeze();
+        vserprintfln(".trace frozen");
+        return true;
+    }
+
+    if (argc == 2 && strcmp_P(argv[0], PSTR("arm")) == 0)
+    {
+        trace_arm(atoi(argv[1]));
+        vserprintfln(".trace armed %u", atoi(argv[1]));
+        return true;
+    }
+
+    // a bit per event of trace.h, animate (0x8) is off by default
+    if (argc == 2 && strcmp_P(argv[0], PSTR("mask")) == 0)
+    {
+        trace_set_mask(strtoul(argv[1], 0, 16));
+        vserprintfln(".trace mask %X", trace_mask());
+        return true;
+    }
+
+    if (argc != 0)
+        return false;
+
+    trace_freeze();
+    trace_stats_t stats = trace_stats();
+
+    vserprintfln(".trace %u %u %u %u", stats.count, stats.overwritten, stats.tick_ns, stats.record_ns);
+    for (uint8_t i = 0; trace_get(i, &record); i++)
+    {
+        vserprintf(".t %u %u %c ", (uint16_t)(record.stamp >> 16), (uint16_t)record.stamp, trace_phase(record.event));
+        virtser_print_P(trace_name_P(record.event));
+        vserprintfln(" %u", record.arg);
+    }
+
+    trace_resume();
+    return true;
+}
+#endif
+
 bool cmd_user_bootloader_jump(uint8_t argc, char **argv)
 {
     bootloader_jump();
@@ -799,13 +893,12 @@ int virtser_print_P(const char *progmem_s)
 
 void shell_command(uint8_t *buffer, uint8_t length)
 {
-    uint8_t pos = 0;
     char *str = (char *)buffer;
     char *token;
     char *command;
     uint8_t argc = 0;
     char *argv[10];
-    struct user_command_t user_command;
+    shell_command_t user_command;
 
     // dprintf("buffer: <%s> l:%u\n", buffer, length);
     command = strsep(&str, " ");
@@ -816,38 +909,23 @@ void shell_command(uint8_t *buffer, uint8_t length)
         argc++;
     }
 
-    memcpy_P(&user_command, &user_command_table[pos++], sizeof(struct user_command_t));
-
-    // dprintf("uc: [%s] [%s]\n", user_command.cmd, user_command.help_msg);
-
-    while (user_command.pfn_command)
+    if (!shell_command_find(&user_commands, command, &user_command))
     {
-        if (strcmp(user_command.cmd, command) == 0)
-        {
-            dprintf("exec: %s\n", command);
-            dump_args(argc, argv);
-
-            bool success = user_command.pfn_command(argc, argv);
-            if (success)
-            {
-                vserprintfln(">OK");
-            }
-            else
-            {
-                vserprintfln(">ERR");
-            }
-
-            break;
-        }
+        vserprintfln(">NC");
+        return;
+    }
 
-        memcpy_P(&user_command, &user_command_table[pos++], sizeof(struct user_command_t));
+    dprintf("exec: %s\n", command);
+    dump_args(argc, argv);
 
-        // dprintf("uc: [%s] [%s]\n", user_command.cmd, user_command.help_msg);
+    bool success = user_command.fn(argc, argv);
+    if (success)
+    {
+        vserprintfln(">OK");
     }
-
-    if (!user_command.pfn_command)
+    else
     {
-    	vserprintfln(">NC");
+        vserprintfln(">ERR");
     }
 }
 
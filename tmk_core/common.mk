@@ -62,6 +62,7 @@ ifeq (yes,$(strip $(COMMAND_ENABLE)))
 endif
 
 ifeq (yes,$(strip $(VIRTSER_ENABLE)))    
+    SRC += $(COMMON_DIR)/shell_dispatch.c
     OPT_DEFS += -DVIRTSER_ENABLE
 endif
 
@@ -97,11 +98,47 @@ ifeq (yes,$(strip $(SLEEP_LED_USE_TIMER_3)))
 	endif
 endif
 
+ifeq (yes,$(strip $(EEPROM_CACHE_ENABLE)))
+    SRC += $(COMMON_DIR)/avr/eeprom_cache.c
+    OPT_DEFS += -DEEPROM_CACHE_ENABLE
+endif
+
+ifeq (yes,$(strip $(PERF_ENABLE)))
+    SRC += $(COMMON_DIR)/avr/perf.c
+    OPT_DEFS += -DPERF_ENABLE
+endif
+
+ifeq (yes,$(strip $(TRACE_ENABLE)))
+    SRC += $(COMMON_DIR)/avr/trace.c
+    OPT_DEFS += -DTRACE_ENABLE
+endif
+
 ifeq (yes,$(strip $(BACKLIGHT_ENABLE)))
     SRC += $(COMMON_DIR)/backlight.c
     OPT_DEFS += -DBACKLIGHT_ENABLE
 endif
 
+ifeq (yes,$(strip $(LED_MATRIX_ENABLE)))
+    SRC += $(COMMON_DIR)/led_matrix/led_matrix.c
+    SRC += $(COMMON_DIR)/led_matrix/led_surface_buffer.c
+    SRC += $(COMMON_DIR)/led_matrix/led_matrix_event.c
+    OPT_DEFS += -DLED_MATRIX_ENABLE
+
+    ifneq (,$(filter type_o_matic,$(LED_MATRIX_ANIMATIONS)))
+	SRC += $(COMMON_DIR)/led_matrix/animations/type_o_matic.c
+	OPT_DEFS += -DLED_MATRIX_ANIMATION_TYPE_O_MATIC
+    endif
+    ifneq (,$(filter sweep,$(LED_MATRIX_ANIMATIONS)))
+	SRC += $(COMMON_DIR)/led_matrix/animations/sweep.c
+	OPT_DEFS += -DLED_MATRIX_ANIMATION_SWEEP
+    endif
+    ifneq (,$(filter flame,$(LED_MATRIX_ANIMATIONS)))
+	SRC += $(COMMON_DIR)/led_matrix/particles.c
+	SRC += $(COMMON_DIR)/led_matrix/animations/flame.c
+	OPT_DEFS += -DLED_MATRIX_ANIMATION_FLAME
+    endif
+endif
+
 ifeq (yes,$(strip $(KEYMAP_SECTION_ENABLE)))
     OPT_DEFS += -DKEYMAP_SECTION_ENABLE
 
@@ -5,6 +5,7 @@
 #include <avr/wdt.h>
 #include <util/delay.h>
 #include "bootloader.h"
+#include "eeprom_cache.h"
 
 #ifdef PROTOCOL_LUFA
 #include <LUFA/Drivers/USB/USB.h>
@@ -73,6 +74,9 @@ uint32_t reset_key  __attribute__ ((section (".noinit")));
 
 /* initialize MCU status by watchdog reset */
 void bootloader_jump(void) {
+    // queued settings are lost otherwise
+    eeprom_cache_flush();
+
 #ifdef PROTOCOL_LUFA
     USB_Disable();
     cli();
@@ -122,6 +126,9 @@ void bootloader_jump_after_watchdog_reset(void)
  * - needs to initialize more regisers or interrupt setting?
  */
 void bootloader_jump(void) {
+    // queued settings are lost otherwise
+    eeprom_cache_flush();
+
 #ifdef PROTOCOL_LUFA
     USB_Disable();
     cli();
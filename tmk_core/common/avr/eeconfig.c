@@ -1,72 +1,75 @@
 #include "eeconfig.h"
-#include <avr/eeprom.h>
+#include "eeprom_cache.h"
 #include <stdbool.h>
 #include <stdint.h>
 
 void eeconfig_init(void)
 {
-    eeprom_write_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
-    eeprom_write_byte(EECONFIG_DEBUG, 0);
-    eeprom_write_byte(EECONFIG_DEFAULT_LAYER, 0);
-    eeprom_write_byte(EECONFIG_KEYMAP, 0);
-    eeprom_write_byte(EECONFIG_MOUSEKEY_ACCEL, 0);
+    eeprom_cache_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
+    eeprom_cache_update_byte(EECONFIG_DEBUG, 0);
+    eeprom_cache_update_byte(EECONFIG_DEFAULT_LAYER, 0);
+    eeprom_cache_update_byte(EECONFIG_KEYMAP, 0);
+    eeprom_cache_update_byte(EECONFIG_MOUSEKEY_ACCEL, 0);
 #ifdef BACKLIGHT_ENABLE
-    eeprom_write_byte(EECONFIG_BACKLIGHT, 0);
+    eeconfig_write_backlight(0);
 #endif
 }
 
 void eeconfig_enable(void)
 {
-    eeprom_write_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
+    eeprom_cache_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
 }
 
 void eeconfig_disable(void)
 {
-    eeprom_write_word(EECONFIG_MAGIC, 0xFFFF);
+    eeprom_cache_update_word(EECONFIG_MAGIC, 0xFFFF);
 }
 
 bool eeconfig_is_enabled(void)
 {
-    return (eeprom_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER);
+    return (eeprom_cache_read_word(EECONFIG_MAGIC) == EECONFIG_MAGIC_NUMBER);
 }
 
 uint8_t eeconfig_read_debug(void)
 {
-    return eeprom_read_byte(EECONFIG_DEBUG);
+    return eeprom_cache_read_byte(EECONFIG_DEBUG);
 }
 void eeconfig_write_debug(uint8_t val)
 {
-    eeprom_write_byte(EECONFIG_DEBUG, val);
+    eeprom_cache_update_byte(EECONFIG_DEBUG, val);
 }
 
 uint8_t eeconfig_read_default_layer(void)
 {
-    return eeprom_read_byte(EECONFIG_DEFAULT_LAYER);
+    return eeprom_cache_read_byte(EECONFIG_DEFAULT_LAYER);
 }
 
 void eeconfig_write_default_layer(uint8_t val)
 {
-    eeprom_write_byte(EECONFIG_DEFAULT_LAYER, val);
+    eeprom_cache_update_byte(EECONFIG_DEFAULT_LAYER, val);
 }
 
 uint8_t eeconfig_read_keymap(void)
 {
-    return eeprom_read_byte(EECONFIG_KEYMAP);
+    return eeprom_cache_read_byte(EECONFIG_KEYMAP);
 }
 
 void eeconfig_write_keymap(uint8_t val)
 {
-    eeprom_write_byte(EECONFIG_KEYMAP, val);
+    eeprom_cache_update_byte(EECONFIG_KEYMAP, val);
 }
 
 #ifdef BACKLIGHT_ENABLE
+/* weak, a keyboard may keep the backlight config elsewhere */
+uint8_t eeconfig_read_backlight(void) __attribute__ ((weak));
 uint8_t eeconfig_read_backlight(void)
 {
-    return eeprom_read_byte(EECONFIG_BACKLIGHT);
+    return eeprom_cache_read_byte(EECONFIG_BACKLIGHT);
 }
 
+void eeconfig_write_backlight(uint8_t val) __attribute__ ((weak));
 void eeconfig_write_backlight(uint8_t val)
 {
-    eeprom_write_byte(EECONFIG_BACKLIGHT, val);
+    eeprom_cache_update_byte(EECONFIG_BACKLIGHT, val);
 }
 #endif
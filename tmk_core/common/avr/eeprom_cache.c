@@ -0,0 +1,297 @@
+#include "eeprom_cache.h"
+#include <avr/eeprom.h>
+#include <string.h>
+
+#if EEPROM_CACHE_SHADOW_SIZE % 8
+#   error "EEPROM_CACHE_SHADOW_SIZE must be a multiple of 8"
+#endif
+
+/* bytes compared per pass before a write is started, unchanged bytes are skipped */
+#define EEPROM_CACHE_COMPARES 16
+
+/* the settings at the start of the EEPROM, a set bit in dirty marks a byte still to write */
+static uint8_t shadow[EEPROM_CACHE_SHADOW_SIZE];
+static uint8_t dirty[EEPROM_CACHE_SHADOW_SIZE / 8];
+static uint16_t dirty_count = 0;
+static bool shadow_loaded = false;
+/* next shadow byte looked at by the drain, no dirty byte is below it */
+static uint16_t cursor = 0;
+
+typedef struct {
+    const uint8_t *src;
+    uint16_t address;
+    /* 0: free */
+    uint16_t size;
+    /* offset of the next byte to write */
+    uint16_t next;
+} eeprom_cache_range_t;
+
+static eeprom_cache_range_t ranges[EEPROM_CACHE_RANGES];
+
+static eeprom_cache_stats_t stats;
+
+static inline bool is_dirty(uint16_t address)
+{
+    return dirty[address >> 3] & (1 << (address & 7));
+}
+
+/* the cached value of a byte behind the shadow, false if it is not in a range */
+static bool range_value(uint16_t address, uint8_t *value)
+{
+    for (uint8_t i = 0; i < EEPROM_CACHE_RANGES; i++)
+    {
+        uint16_t offset = address - ranges[i].address;
+
+        if (offset < ranges[i].size)
+        {
+            *value = ranges[i].src[offset];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static inline void shadow_load(void)
+{
+    if (!shadow_loaded)
+        eeprom_cache_init();
+}
+
+/* takes the next byte to write: dirty shadow bytes by rising address first, then the ranges */
+static bool next_byte(uint16_t *address, uint8_t *value)
+{
+    if (dirty_count)
+    {
+        for (;;)
+        {
+            // an update below the cursor moves it back, the wrap is only a guard
+            if (cursor == EEPROM_CACHE_SHADOW_SIZE)
+                cursor = 0;
+
+            // whole clean bytes of the bitmap at once
+            if (!dirty[cursor >> 3])
+            {
+                cursor = (cursor | 7) + 1;
+                continue;
+            }
+
+            if (is_dirty(cursor))
+                break;
+
+            cursor++;
+        }
+
+        dirty[cursor >> 3] &= ~(1 << (cursor & 7));
+        dirty_count--;
+        *address = cursor;
+        *value = shadow[cursor];
+        cursor++;
+        return true;
+    }
+
+    for (uint8_t i = 0; i < EEPROM_CACHE_RANGES; i++)
+    {
+        eeprom_cache_range_t *range = &ranges[i];
+
+        if (!range->size)
+            continue;
+
+        *address = range->address + range->next;
+        *value = range->src[range->next];
+
+        if (++range->next == range->size)
+            range->size = 0;
+        return true;
+    }
+
+    return false;
+}
+
+void eeprom_cache_init(void)
+{
+    eeprom_read_block(shadow, 0, EEPROM_CACHE_SHADOW_SIZE);
+    memset(dirty, 0, sizeof(dirty));
+    dirty_count = 0;
+    cursor = 0;
+    shadow_loaded = true;
+}
+
+void eeprom_cache_task(void)
+{
+    uint16_t address;
+    uint8_t value;
+
+    if (!eeprom_is_ready())
+        return;
+
+    for (uint8_t i = 0; i < EEPROM_CACHE_COMPARES && next_byte(&address, &value); i++)
+    {
+        if (eeprom_read_byte((const uint8_t *)(uintptr_t)address) == value)
+        {
+            stats.skipped++;
+            continue;
+        }
+
+        /* starts the write and returns */
+        eeprom_write_byte((uint8_t *)(uintptr_t)address, value);
+        stats.written++;
+        return;
+    }
+}
+
+void eeprom_cache_flush(void)
+{
+    while (eeprom_cache_pending())
+    {
+        eeprom_busy_wait();
+        eeprom_cache_task();
+    }
+
+    eeprom_busy_wait();
+}
+
+uint16_t eeprom_cache_pending(void)
+{
+    uint16_t pending = dirty_count;
+
+    for (uint8_t i = 0; i < EEPROM_CACHE_RANGES; i++)
+    {
+        if (ranges[i].size)
+            pending += ranges[i].size - ranges[i].next;
+    }
+
+    return pending;
+}
+
+eeprom_cache_stats_t eeprom_cache_stats(void)
+{
+    return stats;
+}
+
+void eeprom_cache_update_byte(uint8_t *addr, uint8_t value)
+{
+    uint16_t address = (uint16_t)(uintptr_t)addr;
+
+    if (address >= EEPROM_CACHE_SHADOW_SIZE)
+    {
+        stats.refused++;
+        return;
+    }
+
+    shadow_load();
+
+    if (is_dirty(address))
+    {
+        shadow[address] = value;
+        return;
+    }
+
+    /* a clean shadow byte is the EEPROM byte */
+    if (shadow[address] == value)
+    {
+        stats.skipped++;
+        return;
+    }
+
+    shadow[address] = value;
+    dirty[address >> 3] |= 1 << (address & 7);
+    dirty_count++;
+    if (address < cursor)
+        cursor = address;
+}
+
+void eeprom_cache_update_word(uint16_t *addr, uint16_t value)
+{
+    eeprom_cache_update_block(&value, addr, sizeof(value));
+}
+
+void eeprom_cache_update_block(const void *src, void *addr, uint16_t size)
+{
+    const uint8_t *data = src;
+    uint8_t *address = addr;
+
+    while (size--)
+        eeprom_cache_update_byte(address++, *data++);
+}
+
+bool eeprom_cache_update_range(const void *src, void *addr, uint16_t size)
+{
+    uint16_t address = (uint16_t)(uintptr_t)addr;
+    eeprom_cache_range_t *slot = 0;
+
+    if (address < EEPROM_CACHE_SHADOW_SIZE)
+    {
+        stats.refused++;
+        return false;
+    }
+
+    for (uint8_t i = 0; i < EEPROM_CACHE_RANGES; i++)
+    {
+        // the same range again starts over, its new data is compared from the first byte
+        if (ranges[i].size && ranges[i].address == address)
+        {
+            slot = &ranges[i];
+            break;
+        }
+
+        if (!ranges[i].size && !slot)
+            slot = &ranges[i];
+    }
+
+    if (!slot)
+    {
+        stats.refused++;
+        return false;
+    }
+
+    slot->src = src;
+    slot->address = address;
+    slot->size = size;
+    slot->next = 0;
+    return true;
+}
+
+bool eeprom_cache_range_pending(const void *src)
+{
+    for (uint8_t i = 0; i < EEPROM_CACHE_RANGES; i++)
+    {
+        if (ranges[i].size && ranges[i].src == src)
+            return true;
+    }
+
+    return false;
+}
+
+uint8_t eeprom_cache_read_byte(const uint8_t *addr)
+{
+    uint16_t address = (uint16_t)(uintptr_t)addr;
+    uint8_t value;
+
+    if (address < EEPROM_CACHE_SHADOW_SIZE)
+    {
+        shadow_load();
+        return shadow[address];
+    }
+
+    if (range_value(address, &value))
+        return value;
+
+    return eeprom_read_byte(addr);
+}
+
+uint16_t eeprom_cache_read_word(const uint16_t *addr)
+{
+    uint16_t value;
+    eeprom_cache_read_block(&value, addr, sizeof(value));
+    return value;
+}
+
+void eeprom_cache_read_block(void *dst, const void *addr, uint16_t size)
+{
+    uint8_t *data = dst;
+    uint16_t start = (uint16_t)(uintptr_t)addr;
+
+    for (uint16_t i = 0; i < size; i++)
+        data[i] = eeprom_cache_read_byte((const uint8_t *)(uintptr_t)(start + i));
+}
@@ -0,0 +1,95 @@
+#include "perf.h"
+#include "timer.h"
+#include <avr/pgmspace.h>
+#include <string.h>
+
+// ticks of 16us, the upper bound of the first bucket
+#define PERF_BUCKET_TICKS ((TIMER_RAW_FREQ * 16UL + 999999UL) / 1000000UL)
+
+static perf_counter_t counters[PERF_COUNTERS];
+
+static const char name_loop[] PROGMEM = "loop";
+static const char name_matrix_scan[] PROGMEM = "matrix_scan";
+static const char name_action_exec[] PROGMEM = "action_exec";
+static const char name_send_keyboard[] PROGMEM = "send_keyboard";
+static const char name_animate[] PROGMEM = "animate";
+static const char name_i2c_upload[] PROGMEM = "i2c_upload";
+static const char name_split_receive[] PROGMEM = "split_receive";
+static const char name_usb_host[] PROGMEM = "usb_host";
+
+static PGM_P const names[PERF_COUNTERS] PROGMEM = {
+    name_loop,
+    name_matrix_scan,
+    name_action_exec,
+    name_send_keyboard,
+    name_animate,
+    name_i2c_upload,
+    name_split_receive,
+    name_usb_host
+};
+
+// halves the counter, keeps min, max and the averages
+static void halve(perf_counter_t *counter)
+{
+    counter->count >>= 1;
+    counter->sum >>= 1;
+    for (uint8_t b = 0; b < PERF_BUCKETS; b++)
+        counter->buckets[b] >>= 1;
+}
+
+void perf_record(uint8_t counter, uint32_t start)
+{
+    uint32_t elapsed = timer_read_raw32() - start;
+    uint16_t ticks = (elapsed > UINT16_MAX) ? UINT16_MAX : elapsed;
+    perf_counter_t *c = &counters[counter];
+
+    if (c->count == UINT16_MAX)
+        halve(c);
+
+    if (c->count == 0 || ticks < c->min)
+        c->min = ticks;
+    if (ticks > c->max)
+        c->max = ticks;
+
+    c->count++;
+    c->sum += ticks;
+
+    uint16_t bucket_ticks = ticks / PERF_BUCKET_TICKS;
+    uint8_t b = 0;
+    while (bucket_ticks && b < PERF_BUCKETS - 1)
+    {
+        bucket_ticks >>= 1;
+        b++;
+    }
+
+    if (c->buckets[b] < UINT16_MAX)
+        c->buckets[b]++;
+}
+
+void perf_reset(void)
+{
+    memset(counters, 0, sizeof(counters));
+}
+
+bool perf_get(uint8_t counter, perf_counter_t *out)
+{
+    if (counter >= PERF_COUNTERS)
+        return false;
+
+    *out = counters[counter];
+    return (out->count != 0);
+}
+
+const char *perf_name_P(uint8_t counter)
+{
+    if (counter >= PERF_COUNTERS)
+        return 0;
+
+    return (const char *)pgm_read_word(&names[counter]);
+}
+
+uint16_t perf_us(uint32_t ticks)
+{
+    uint32_t us = ticks * (1000000UL / TIMER_RAW_FREQ);
+    return (us > UINT16_MAX) ? UINT16_MAX : us;
+}
@@ -84,6 +84,24 @@ uint32_t timer_read32(void)
     return t;
 }
 
+uint32_t timer_read_raw32(void)
+{
+    uint32_t t;
+    uint8_t raw;
+
+    uint8_t sreg = SREG;
+    cli();
+    t = timer_count;
+    raw = TIMER_RAW;
+    // the counter restarted but the compare match interrupt is still pending
+    if ((TIFR0 & (1<<OCF0A)) && raw < TIMER_RAW_TOP / 2) {
+        t++;
+    }
+    SREG = sreg;
+
+    return t * TIMER_RAW_PER_MS + raw;
+}
+
 inline
 uint16_t timer_elapsed(uint16_t last)
 {
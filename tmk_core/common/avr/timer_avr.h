@@ -39,4 +39,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #   error "Timer0 can't count 1ms at this clock freq. Use larger prescaler."
 #endif
 
+/* CTC mode counts from 0 to TIMER_RAW_TOP */
+#define TIMER_RAW_PER_MS    (TIMER_RAW_TOP + 1UL)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* raw timer ticks since power on, for time stamps below a millisecond */
+uint32_t timer_read_raw32(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
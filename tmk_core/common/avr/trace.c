@@ -0,0 +1,221 @@
+#include "trace.h"
+#include "timer.h"
+#include <avr/pgmspace.h>
+
+#if (TRACE_SIZE > 255)
+#   error "TRACE_SIZE must fit an uint8_t"
+#endif
+
+#define TRACE_TICK_NS (1000000000UL / TIMER_RAW_FREQ)
+
+static trace_record_t ring[TRACE_SIZE];
+// the next record is stored at head
+static uint8_t head = 0;
+static uint8_t count = 0;
+
+static uint16_t recorded = 0;
+static uint16_t overwritten = 0;
+static uint16_t record_ns = 0;
+static bool calibrated = false;
+static bool frozen = false;
+// ticks
+static uint32_t armed = 0;
+static uint16_t mask = TRACE_MASK_DEFAULT | TRACE_MASK(traceLoop) | TRACE_MASK(traceFreeze);
+
+static uint32_t loop_start = 0;
+static bool in_loop = false;
+// the begin of the pass is stored with its first event
+static bool loop_pending = false;
+static uint16_t idle_passes = 0;
+
+static const char name_loop[] PROGMEM = "loop";
+static const char name_action_exec[] PROGMEM = "action_exec";
+static const char name_send_keyboard[] PROGMEM = "send_keyboard";
+static const char name_animate[] PROGMEM = "animate";
+static const char name_twi_wait[] PROGMEM = "twi_wait";
+static const char name_split_send[] PROGMEM = "split_send";
+static const char name_split_receive[] PROGMEM = "split_receive";
+static const char name_freeze[] PROGMEM = "freeze";
+
+static PGM_P const names[TRACE_EVENTS] PROGMEM = {
+    name_loop,
+    name_action_exec,
+    name_send_keyboard,
+    name_animate,
+    name_twi_wait,
+    name_split_send,
+    name_split_receive,
+    name_freeze
+};
+
+static void store(uint32_t stamp, uint8_t event, uint16_t arg)
+{
+    trace_record_t *record = &ring[head];
+
+    record->stamp = stamp;
+    record->event = event;
+    record->arg = arg;
+
+    if (++head == TRACE_SIZE)
+        head = 0;
+
+    if (count < TRACE_SIZE)
+        count++;
+    else if (overwritten < UINT16_MAX)
+        overwritten++;
+
+    if (recorded < UINT16_MAX)
+        recorded++;
+}
+
+static void store_loop_begin(void)
+{
+    if (!loop_pending)
+        return;
+
+    loop_pending = false;
+    store(loop_start, traceLoop | TRACE_PHASE_BEGIN, idle_passes);
+    idle_passes = 0;
+}
+
+static void clear(void)
+{
+    head = 0;
+    count = 0;
+    recorded = 0;
+    overwritten = 0;
+    in_loop = false;
+    loop_pending = false;
+    idle_passes = 0;
+}
+
+// times TRACE_CALIBRATE records into the empty ring, interrupts are running by now
+static void calibrate(void)
+{
+    uint32_t start = timer_read_raw32();
+
+    for (uint8_t i = 0; i < TRACE_CALIBRATE; i++)
+        trace_record(traceLoop, i);
+
+    uint32_t ns = (timer_read_raw32() - start) * TRACE_TICK_NS / TRACE_CALIBRATE;
+    record_ns = (ns > UINT16_MAX) ? UINT16_MAX : ns;
+    clear();
+}
+
+void trace_record(uint8_t event, uint16_t arg)
+{
+    if (frozen || !(mask & TRACE_MASK(event & ~TRACE_PHASE_MASK)))
+        return;
+
+    uint32_t stamp = timer_read_raw32();
+    store_loop_begin();
+    store(stamp, event, arg);
+}
+
+void trace_loop_begin(void)
+{
+    if (!calibrated)
+    {
+        calibrated = true;
+        calibrate();
+    }
+
+    if (frozen)
+        return;
+
+    loop_start = timer_read_raw32();
+    in_loop = true;
+    loop_pending = true;
+}
+
+void trace_loop_end(void)
+{
+    if (frozen || !in_loop)
+        return;
+
+    uint32_t stamp = timer_read_raw32();
+    uint32_t elapsed = stamp - loop_start;
+    in_loop = false;
+
+    if (armed && elapsed > armed)
+    {
+        store_loop_begin();
+        store(stamp, traceLoop | TRACE_PHASE_END, 0);
+        store(stamp, traceFreeze, (elapsed > UINT16_MAX) ? UINT16_MAX : elapsed);
+        frozen = true;
+        return;
+    }
+
+    if (loop_pending)
+    {
+        loop_pending = false;
+        if (idle_passes < UINT16_MAX)
+            idle_passes++;
+        return;
+    }
+
+    store(stamp, traceLoop | TRACE_PHASE_END, 0);
+}
+
+void trace_freeze(void)
+{
+    frozen = true;
+}
+
+void trace_resume(void)
+{
+    clear();
+    frozen = false;
+}
+
+void trace_arm(uint16_t us)
+{
+    armed = us * 1000UL / TRACE_TICK_NS;
+}
+
+void trace_set_mask(uint16_t events)
+{
+    mask = events | TRACE_MASK(traceLoop) | TRACE_MASK(traceFreeze);
+}
+
+uint16_t trace_mask(void)
+{
+    return mask;
+}
+
+trace_stats_t trace_stats(void)
+{
+    trace_stats_t stats = { count, recorded, overwritten, TRACE_TICK_NS, record_ns, frozen };
+    return stats;
+}
+
+bool trace_get(uint8_t index, trace_record_t *out)
+{
+    if (index >= count)
+        return false;
+
+    *out = ring[(head + TRACE_SIZE - count + index) % TRACE_SIZE];
+    return true;
+}
+
+const char *trace_name_P(uint8_t event)
+{
+    event &= ~TRACE_PHASE_MASK;
+    if (event >= TRACE_EVENTS)
+        return 0;
+
+    return (const char *)pgm_read_word(&names[event]);
+}
+
+char trace_phase(uint8_t event)
+{
+    switch (event & TRACE_PHASE_MASK)
+    {
+    case TRACE_PHASE_BEGIN:
+        return 'B';
+    case TRACE_PHASE_END:
+        return 'E';
+    default:
+        return 'i';
+    }
+}
@@ -33,6 +33,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "led.h"
 #include "command.h"
 #include "backlight.h"
+#include "perf.h"
+#include "trace.h"
 
 #ifdef MOUSEKEY_ENABLE
 #include "mousekey.h"
@@ -140,9 +142,63 @@ static void command_common_help(void)
 #ifdef SLEEP_LED_ENABLE
           "z:	sleep LED test\n"
 #endif
+
+#ifdef PERF_ENABLE
+          "p:	perf counters, reset\n"
+#endif
+
+#ifdef TRACE_ENABLE
+          "t:	timeline trace, restart\n"
+#endif
     );
 }
 
+#ifdef PERF_ENABLE
+static void print_perf(void)
+{
+    perf_counter_t counter;
+
+    print("\n\t- Perf (us) -\n");
+    print("name: count min avg max | <16 <32 <64 <128 <256 <512 <1024 more\n");
+
+    for (uint8_t i = 0; i < PERF_COUNTERS; i++) {
+        if (!perf_get(i, &counter)) continue;
+
+        xputs(perf_name_P(i));
+        xprintf(": %u %u %u %u |", counter.count, perf_us(counter.min),
+                perf_us(counter.sum / counter.count), perf_us(counter.max));
+        for (uint8_t b = 0; b < PERF_BUCKETS; b++) {
+            xprintf(" %u", counter.buckets[b]);
+        }
+        print("\n");
+    }
+
+    // the next print shows the time since this one
+    perf_reset();
+}
+#endif
+
+#ifdef TRACE_ENABLE
+/* same format as '.trace' of the virtual serial shells, see tmk_core/tool/trace_json */
+static void print_trace(void)
+{
+    trace_record_t record;
+
+    trace_freeze();
+    trace_stats_t stats = trace_stats();
+
+    xprintf(".trace %u %u %u %u\n", stats.count, stats.overwritten, stats.tick_ns, stats.record_ns);
+    for (uint8_t i = 0; trace_get(i, &record); i++) {
+        xprintf(".t %u %u %c ", (uint16_t)(record.stamp >> 16), (uint16_t)record.stamp,
+                trace_phase(record.event));
+        xputs(trace_name_P(record.event));
+        xprintf(" %u\n", record.arg);
+    }
+
+    trace_resume();
+}
+#endif
+
 #ifdef BOOTMAGIC_ENABLE
 static void print_eeconfig(void)
 {
@@ -330,6 +386,16 @@ static bool command_common(uint8_t code)
             );
 #endif
             break;
+#ifdef PERF_ENABLE
+        case KC_P:
+            print_perf();
+            break;
+#endif
+#ifdef TRACE_ENABLE
+        case KC_T:
+            print_trace();
+            break;
+#endif
         case KC_S:
             print("\n\t- Status -\n");
             print_val_hex8(host_keyboard_leds());
@@ -0,0 +1,111 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef EEPROM_CACHE_H
+#define EEPROM_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Write-behind EEPROM cache
+ *
+ * An EEPROM byte takes 3.4ms to write. Writes are kept in RAM instead and
+ * written from the main loop, eeprom_cache_task() starts one byte per pass
+ * when the EEPROM is ready. No write ever waits for the EEPROM:
+ *
+ *  - the first EEPROM_CACHE_SHADOW_SIZE bytes (the settings) have a RAM
+ *    shadow, an update stores the value there and marks the byte dirty.
+ *    Any number of updates fit, writing a byte again replaces the value.
+ *    Dirty bytes are written by rising address, the last byte of an
+ *    updated block is written after the bytes before it.
+ *  - larger blocks behind them (maps) are written as a dirty range over
+ *    the caller's buffer with eeprom_cache_update_range(). The buffer has
+ *    to keep the data until eeprom_cache_pending() drops to 0, updating
+ *    the same range again starts it over with the new data.
+ *  - bytes that already hold the value are not written
+ *  - reads return the cached value. The shadow mirrors the EEPROM, it is
+ *    read once by eeprom_cache_init() or the first access, its reads never
+ *    wait. A read behind it waits for a byte write in flight (3.4ms).
+ *
+ * Updates outside the shadow and ranges beyond EEPROM_CACHE_RANGES are
+ * refused and counted. Cached bytes are lost on power loss,
+ * eeprom_cache_flush() writes them before a bootloader jump.
+ *
+ * Without EEPROM_CACHE_ENABLE the functions map to avr-libc.
+ */
+
+#ifdef EEPROM_CACHE_ENABLE
+
+#ifndef EEPROM_CACHE_SHADOW_SIZE
+#   define EEPROM_CACHE_SHADOW_SIZE 128
+#endif
+
+#ifndef EEPROM_CACHE_RANGES
+#   define EEPROM_CACHE_RANGES 2
+#endif
+
+typedef struct {
+    /* bytes written by the cache */
+    uint16_t written;
+    /* bytes not written because the EEPROM already held the value */
+    uint16_t skipped;
+    /* updates outside the shadow and ranges without a free slot, not written */
+    uint16_t refused;
+} eeprom_cache_stats_t;
+
+/* loads the shadow, drops dirty bytes */
+void eeprom_cache_init(void);
+
+uint8_t eeprom_cache_read_byte(const uint8_t *addr);
+uint16_t eeprom_cache_read_word(const uint16_t *addr);
+void eeprom_cache_read_block(void *dst, const void *addr, uint16_t size);
+
+/* the shadow only */
+void eeprom_cache_update_byte(uint8_t *addr, uint8_t value);
+void eeprom_cache_update_word(uint16_t *addr, uint16_t value);
+void eeprom_cache_update_block(const void *src, void *addr, uint16_t size);
+/* behind the shadow, src has to stay valid until written, false if refused */
+bool eeprom_cache_update_range(const void *src, void *addr, uint16_t size);
+/* true while a range over src is not written */
+bool eeprom_cache_range_pending(const void *src);
+
+/* starts the write of the next dirty byte if the EEPROM is ready, call once per main loop pass */
+void eeprom_cache_task(void);
+/* writes all dirty bytes, blocking */
+void eeprom_cache_flush(void);
+uint16_t eeprom_cache_pending(void);
+eeprom_cache_stats_t eeprom_cache_stats(void);
+
+#else
+
+#include <avr/eeprom.h>
+
+#define eeprom_cache_init()
+#define eeprom_cache_read_byte(addr) eeprom_read_byte(addr)
+#define eeprom_cache_read_word(addr) eeprom_read_word(addr)
+#define eeprom_cache_read_block(dst, addr, size) eeprom_read_block(dst, addr, size)
+#define eeprom_cache_update_byte(addr, value) eeprom_update_byte(addr, value)
+#define eeprom_cache_update_word(addr, value) eeprom_update_word(addr, value)
+#define eeprom_cache_update_block(src, addr, size) eeprom_update_block(src, addr, size)
+#define eeprom_cache_update_range(src, addr, size) (eeprom_update_block(src, addr, size), true)
+#define eeprom_cache_range_pending(src) false
+#define eeprom_cache_task()
+#define eeprom_cache_flush()
+
+#endif
+
+#endif
@@ -21,6 +21,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "perf.h"
+#include "trace.h"
 
 
 #ifdef NKRO_ENABLE
@@ -51,7 +53,11 @@ uint8_t host_keyboard_leds(void)
 void host_keyboard_send(report_keyboard_t *report)
 {
     if (!driver) return;
+    PERF_START(send);
+    TRACE_BEGIN(traceSendKeyboard, report->mods);
     (*driver->send_keyboard)(report);
+    TRACE_END(traceSendKeyboard, 0);
+    PERF_STOP(send, perfSendKeyboard);
 
     if (debug_keyboard) {
         dprint("keyboard: ");
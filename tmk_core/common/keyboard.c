@@ -31,6 +31,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "eeconfig.h"
 #include "backlight.h"
 #include "hook.h"
+#include "eeprom_cache.h"
+#include "perf.h"
+#include "trace.h"
 #ifdef MOUSEKEY_ENABLE
 #   include "mousekey.h"
 #endif
@@ -111,7 +114,11 @@ void keyboard_task(void)
     matrix_row_t matrix_row = 0;
     matrix_row_t matrix_change = 0;
 
+    TRACE_LOOP_BEGIN();
+    PERF_START(loop);
+    PERF_START(scan);
     matrix_scan();
+    PERF_STOP(scan, perfMatrixScan);
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
         matrix_row = matrix_get_row(r);
         matrix_change = matrix_row ^ matrix_prev[r];
@@ -138,7 +145,11 @@ void keyboard_task(void)
                         .pressed = (matrix_row & ((matrix_row_t)1<<c)),
                         .time = (timer_read() | 1) /* time should not be 0 */
                     };
+                    PERF_START(action);
+                    TRACE_BEGIN(traceActionExec, (e.pressed ? 0x8000 : 0) | (r << 8) | c);
                     action_exec(e);
+                    TRACE_END(traceActionExec, 0);
+                    PERF_STOP(action, perfActionExec);
                     hook_matrix_change(e);
                     // record a processed key
                     matrix_prev[r] ^= ((matrix_row_t)1<<c);
@@ -172,12 +183,18 @@ MATRIX_LOOP_END:
 	adb_mouse_task();
 #endif
 
+    // one dirty EEPROM byte per pass
+    eeprom_cache_task();
+
     // update LED
     if (led_status != host_keyboard_leds()) {
         led_status = host_keyboard_leds();
         if (debug_keyboard) dprintf("LED: %02X\n", led_status);
         hook_keyboard_leds_change(led_status);
     }
+
+    PERF_STOP(loop, perfLoop);
+    TRACE_LOOP_END();
 }
 
 void keyboard_set_leds(uint8_t leds)
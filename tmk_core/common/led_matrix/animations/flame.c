@@ -0,0 +1,108 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "led_matrix/led_matrix.h"
+#include <string.h>
+
+/*
+ * Flames rising from fountains along the bottom row,
+ * every key press sends up a burst of sparks from the key.
+ */
+
+#define FLAME_FOUNTAINS     3
+#define FLAME_BURST         6
+/* heat of a particle: life * FLAME_GAIN / 16 */
+#define FLAME_GAIN          24
+
+static const particle_emitter spark = {
+    .type = PARTICLE_EMITTER_BURST,
+    .vx = 0,
+    .vy = -32,
+    .spread = 24,
+    .min_life = 8,
+    .max_life = 20,
+};
+
+/* black, red, yellow, white */
+static led_pixel heat_color(uint8_t heat)
+{
+    led_pixel pixel;
+    uint16_t h = (uint16_t)heat * 3;
+
+    pixel.r = (h > 0xFF) ? 0xFF : h;
+    pixel.g = (h > 0xFF) ? ((h > 0x1FE) ? 0xFF : h - 0xFF) : 0;
+    pixel.b = (h > 0x1FE) ? h - 0x1FE : 0;
+    return pixel;
+}
+
+static void flame_start(led_surface *surface)
+{
+    led_matrix_flame_state *state = (led_matrix_flame_state *)led_matrix_state;
+
+    particles_init(&state->ps);
+    state->ps.ay = -2;
+
+    for (uint8_t i = 0; i < FLAME_FOUNTAINS; i++) {
+        particle_emitter *emitter = particles_add_emitter(&state->ps, PARTICLE_EMITTER_FOUNTAIN);
+
+        emitter->rate = 1;
+        emitter->x = PARTICLE_KEY((surface->cols * (i + 1)) / (FLAME_FOUNTAINS + 1)) + 128;
+        emitter->y = PARTICLE_KEY(surface->rows) - 1;
+        emitter->vy = -24;
+        emitter->spread = 16;
+        emitter->min_life = 10;
+        emitter->max_life = 30;
+    }
+
+    led_matrix_clear(surface);
+    led_surface_commit(surface);
+}
+
+static void flame_key_event(led_surface *surface, led_matrix_key_event const *event)
+{
+    led_matrix_flame_state *state = (led_matrix_flame_state *)led_matrix_state;
+
+    if (event->flags & LED_MATRIX_EVENT_PRESSED)
+        particles_spawn_burst(&state->ps, &spark, event->row, event->col, FLAME_BURST);
+}
+
+static void flame_loop(led_surface *surface)
+{
+    led_matrix_flame_state *state = (led_matrix_flame_state *)led_matrix_state;
+
+    particles_update(&state->ps, surface->rows, surface->cols);
+
+    memset(state->heat, 0, surface->rows * surface->cols);
+    particles_render(&state->ps, state->heat, surface->cols, FLAME_GAIN);
+
+    uint8_t *heat = state->heat;
+    for (uint8_t row = 0; row < surface->rows; row++) {
+        for (uint8_t col = 0; col < surface->cols; col++)
+            surface->set(surface, row, col, heat_color(*heat++));
+    }
+
+    led_surface_commit(surface);
+}
+
+const led_matrix_animation led_matrix_flame = {
+    .name = "flame",
+    .delay_in_ms = 1000 / 25,
+    .state_size = sizeof(led_matrix_flame_state),
+    .start = &flame_start,
+    .loop = &flame_loop,
+    .key_event = &flame_key_event,
+};
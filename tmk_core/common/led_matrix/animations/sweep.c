@@ -0,0 +1,79 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "led_matrix/led_matrix.h"
+#include <stdlib.h>
+
+/*
+ * A brightness ramp in led_matrix_color moving over the columns,
+ * key presses pick a new speed and direction.
+ */
+
+static uint8_t offset = 0;
+static int8_t direction = 1;
+
+static void sweep_start(led_surface *surface)
+{
+    offset = 0;
+    direction = 1;
+
+    led_matrix_clear(surface);
+    led_surface_commit(surface);
+}
+
+static void sweep_loop(led_surface *surface)
+{
+    uint16_t delta = 510 / surface->cols;
+
+    for (uint8_t row = 0; row < surface->rows; row++) {
+        uint8_t c = 0;
+        int8_t d = 1;
+
+        for (uint8_t col = 0; col < surface->cols; col++) {
+            uint16_t level = delta * c;
+            if (level > 0xFF)
+                level = 0xFF;
+
+            surface->set(surface, row, (col + offset) % surface->cols, led_pixel_scale(led_matrix_color, level));
+
+            c += d;
+            if (c >= surface->cols / 2)
+                d = -1;
+        }
+    }
+
+    led_surface_commit(surface);
+
+    offset += direction;
+}
+
+static void sweep_key_event(led_surface *surface, led_matrix_key_event const *event)
+{
+    if (!(event->flags & LED_MATRIX_EVENT_PRESSED))
+        return;
+
+    uint8_t speed = (rand() & 0x01) + 1;
+    direction = speed * ((rand() & 0x01) ? -1 : 1);
+}
+
+const led_matrix_animation led_matrix_sweep = {
+    .name = "sweep",
+    .delay_in_ms = 1000 / 10,
+    .start = &sweep_start,
+    .loop = &sweep_loop,
+    .key_event = &sweep_key_event,
+};
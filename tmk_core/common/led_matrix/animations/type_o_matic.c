@@ -0,0 +1,107 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "led_matrix/led_matrix.h"
+
+/*
+ * Pressed keys light up in led_matrix_color and fade out after release.
+ * Only the held and fading keys are visited by a frame.
+ */
+
+#define TYPE_O_MATIC_FADE_STEP  3
+
+#define KEY_FADING  0
+#define KEY_HELD    1
+
+static inline uint8_t fade(uint8_t value)
+{
+    return (value > TYPE_O_MATIC_FADE_STEP) ? value - TYPE_O_MATIC_FADE_STEP : 0;
+}
+
+static void type_o_matic_start(led_surface *surface)
+{
+    led_matrix_type_o_matic_state *state = (led_matrix_type_o_matic_state *)led_matrix_state;
+
+    led_matrix_effect_init(&state->keys, state->items, LED_MATRIX_TYPE_O_MATIC_EFFECTS);
+
+    led_matrix_clear(surface);
+    led_surface_commit(surface);
+}
+
+static void type_o_matic_key_event(led_surface *surface, led_matrix_key_event const *event)
+{
+    led_matrix_type_o_matic_state *state = (led_matrix_type_o_matic_state *)led_matrix_state;
+
+    if (event->flags & LED_MATRIX_EVENT_PRESSED) {
+        // keys beyond LED_MATRIX_TYPE_O_MATIC_EFFECTS stay dark
+        if (!led_matrix_effect_add(&state->keys, event->row, event->col, KEY_HELD))
+            return;
+        led_surface_set(surface, event->row, event->col, led_matrix_color);
+        led_surface_commit(surface);
+    } else {
+        led_matrix_effect_add(&state->keys, event->row, event->col, KEY_FADING);
+    }
+}
+
+static void type_o_matic_loop(led_surface *surface)
+{
+    led_matrix_type_o_matic_state *state = (led_matrix_type_o_matic_state *)led_matrix_state;
+    led_pixel pixel;
+    bool changed = false;
+
+    for (uint8_t i = 0; i < state->keys.count;) {
+        led_matrix_effect *key = &state->keys.items[i];
+
+        if (!led_surface_get(surface, key->row, key->col, &pixel)) {
+            led_matrix_effect_remove(&state->keys, key);
+            continue;
+        }
+
+        if (key->value == KEY_HELD) {
+            // follows color changes while held
+            if (!led_pixel_equal(pixel, led_matrix_color)) {
+                surface->set(surface, key->row, key->col, led_matrix_color);
+                changed = true;
+            }
+            i++;
+            continue;
+        }
+
+        pixel.r = fade(pixel.r);
+        pixel.g = fade(pixel.g);
+        pixel.b = fade(pixel.b);
+        surface->set(surface, key->row, key->col, pixel);
+        changed = true;
+
+        if (!pixel.r && !pixel.g && !pixel.b)
+            led_matrix_effect_remove(&state->keys, key);
+        else
+            i++;
+    }
+
+    if (changed)
+        led_surface_commit(surface);
+}
+
+const led_matrix_animation led_matrix_type_o_matic = {
+    .name = "type_o_matic",
+    .delay_in_ms = 1000 / 6,
+    .state_size = sizeof(led_matrix_type_o_matic_state),
+    .start = &type_o_matic_start,
+    .loop = &type_o_matic_loop,
+    .key_event = &type_o_matic_key_event,
+};
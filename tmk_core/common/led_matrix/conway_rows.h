@@ -0,0 +1,95 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LED_MATRIX_CONWAY_ROWS_H
+#define LED_MATRIX_CONWAY_ROWS_H
+
+#include "matrix.h"
+
+/*
+ * Conway's game of life on matrix_row_t bitboards, one bit per key.
+ *
+ * The board is a torus of MATRIX_COLS columns, bit 0 is column 0. A whole
+ * row is computed at once from the row and its neighbors above and below.
+ * Header only, so the shifts by MATRIX_COLS stay constant, the host check
+ * in tmk_core/tool/led_matrix builds it for several widths.
+ */
+
+#define CONWAY_ROW_MASK (((matrix_row_t)1 << (MATRIX_COLS - 1) << 1) - 1)
+
+/* neighbors to the west and east, wrapping around at the edges of the row */
+static inline matrix_row_t conway_west(matrix_row_t row)
+{
+    return ((row << 1) | (row >> (MATRIX_COLS - 1))) & CONWAY_ROW_MASK;
+}
+
+static inline matrix_row_t conway_east(matrix_row_t row)
+{
+    return ((row >> 1) | (row << (MATRIX_COLS - 1))) & CONWAY_ROW_MASK;
+}
+
+static inline uint8_t conway_count_bits(matrix_row_t row)
+{
+    uint8_t count = 0;
+    for (; row; ++count)
+        row &= row - 1;
+    return count;
+}
+
+/*
+ * Next generation of all cells of a row at once.
+ *
+ * The eight neighbor bits of every cell are added with bitwise full adders
+ * into a 3 bit count per column (ones, twos, fours). A count of 8 wraps to 0,
+ * both are fatal. Alive: count 3, or count 2 and alive before.
+ */
+static inline matrix_row_t conway_next_row(matrix_row_t up, matrix_row_t mid, matrix_row_t down)
+{
+    matrix_row_t a, b, c;
+
+    // full adder: up west, up, up east
+    a = conway_west(up);
+    b = conway_east(up);
+    matrix_row_t up_ones = a ^ up ^ b;
+    matrix_row_t up_twos = (a & up) | (b & (a ^ up));
+
+    // full adder: down west, down, down east
+    a = conway_west(down);
+    b = conway_east(down);
+    matrix_row_t down_ones = a ^ down ^ b;
+    matrix_row_t down_twos = (a & down) | (b & (a ^ down));
+
+    // half adder: west, east
+    a = conway_west(mid);
+    b = conway_east(mid);
+    matrix_row_t mid_ones = a ^ b;
+    matrix_row_t mid_twos = a & b;
+
+    // add up the ones
+    matrix_row_t ones = up_ones ^ down_ones ^ mid_ones;
+    matrix_row_t ones_carry = (up_ones & down_ones) | (mid_ones & (up_ones ^ down_ones));
+
+    // add up the twos
+    c = up_twos ^ down_twos ^ mid_twos;
+    matrix_row_t fours = (up_twos & down_twos) | (mid_twos & (up_twos ^ down_twos));
+    matrix_row_t twos = c ^ ones_carry;
+    fours |= c & ones_carry;
+
+    return ~fours & twos & (ones | mid);
+}
+
+#endif
@@ -0,0 +1,56 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "led_matrix.h"
+#include <string.h>
+
+led_pixel led_matrix_color = { 0xFF, 0xFF, 0xFF };
+void *led_matrix_state = 0;
+
+const led_matrix_animation *const led_matrix_animations[] = {
+#ifdef LED_MATRIX_ANIMATION_TYPE_O_MATIC
+    &led_matrix_type_o_matic,
+#endif
+#ifdef LED_MATRIX_ANIMATION_SWEEP
+    &led_matrix_sweep,
+#endif
+#ifdef LED_MATRIX_ANIMATION_FLAME
+    &led_matrix_flame,
+#endif
+    0
+};
+
+const uint8_t led_matrix_animation_count = sizeof(led_matrix_animations) / sizeof(led_matrix_animations[0]) - 1;
+
+const led_matrix_animation *led_matrix_animation_by_name(const char *name)
+{
+    for (uint8_t i = 0; i < led_matrix_animation_count; i++) {
+        if (strcmp(led_matrix_animations[i]->name, name) == 0)
+            return led_matrix_animations[i];
+    }
+    return 0;
+}
+
+void led_matrix_clear(led_surface *surface)
+{
+    led_pixel black = { 0, 0, 0 };
+
+    for (uint8_t row = 0; row < surface->rows; row++) {
+        for (uint8_t col = 0; col < surface->cols; col++)
+            surface->set(surface, row, col, black);
+    }
+}
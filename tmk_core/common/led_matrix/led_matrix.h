@@ -0,0 +1,93 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LED_MATRIX_LED_MATRIX_H
+#define LED_MATRIX_LED_MATRIX_H
+
+#include "led_surface.h"
+#include "led_matrix_event.h"
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Board independent key backlight animations.
+ *
+ * An animation only draws to a led_surface, the board keeps the timing
+ * (call loop every delay_in_ms) and hands the queued key events to key_event.
+ * Animations are selected at compile time with LED_MATRIX_ANIMATIONS in the
+ * Makefile, see common.mk. Unselected animations are not built.
+ * An animation with a state_size works in led_matrix_state, which the board
+ * points to state_size bytes of zeroed memory before start.
+ */
+
+typedef struct {
+    const char *name;
+    uint16_t delay_in_ms;
+    /* bytes of led_matrix_state needed while running, 0: none */
+    uint16_t state_size;
+
+    void (*start)(led_surface *surface);
+    void (*loop)(led_surface *surface);
+    void (*key_event)(led_surface *surface, led_matrix_key_event const *event);
+} led_matrix_animation;
+
+/* foreground color of all animations */
+extern led_pixel led_matrix_color;
+/* memory of the running animation, see state_size */
+extern void *led_matrix_state;
+
+#ifdef LED_MATRIX_ANIMATION_TYPE_O_MATIC
+extern const led_matrix_animation led_matrix_type_o_matic;
+/* keys held or fading out */
+#ifndef LED_MATRIX_TYPE_O_MATIC_EFFECTS
+#define LED_MATRIX_TYPE_O_MATIC_EFFECTS 24
+#endif
+typedef struct {
+    led_matrix_effect_list keys;
+    led_matrix_effect items[LED_MATRIX_TYPE_O_MATIC_EFFECTS];
+} led_matrix_type_o_matic_state;
+#endif
+#ifdef LED_MATRIX_ANIMATION_SWEEP
+extern const led_matrix_animation led_matrix_sweep;
+#endif
+#ifdef LED_MATRIX_ANIMATION_FLAME
+#include "particles.h"
+extern const led_matrix_animation led_matrix_flame;
+/* particles and one heat byte per key */
+typedef struct {
+    particle_system ps;
+    uint8_t heat[MATRIX_ROWS * MATRIX_COLS];
+} led_matrix_flame_state;
+#endif
+
+/* all selected animations */
+extern const led_matrix_animation *const led_matrix_animations[];
+extern const uint8_t led_matrix_animation_count;
+
+const led_matrix_animation *led_matrix_animation_by_name(const char *name);
+
+/* clear all keys of a surface, does not commit */
+void led_matrix_clear(led_surface *surface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "led_matrix_event.h"
+
+static matrix_row_t last_rows[LED_MATRIX_EVENT_SOURCES][MATRIX_ROWS];
+
+static led_matrix_key_event queue[LED_MATRIX_EVENT_QUEUE_SIZE];
+static uint8_t queue_head = 0;
+static uint8_t queue_tail = 0;
+static uint8_t dropped = 0;
+
+#define QUEUE_MASK (LED_MATRIX_EVENT_QUEUE_SIZE - 1)
+
+static void push(uint8_t row, uint8_t col, uint8_t flags, uint16_t time)
+{
+    uint8_t next = (queue_head + 1) & QUEUE_MASK;
+
+    if (next == queue_tail) {
+        if (dropped < 0xFF)
+            dropped++;
+        return;
+    }
+
+    queue[queue_head].row = row;
+    queue[queue_head].col = col;
+    queue[queue_head].flags = flags;
+    queue[queue_head].time = time;
+    queue_head = next;
+}
+
+void led_matrix_event_row(uint8_t source, uint8_t row, matrix_row_t state, uint16_t time)
+{
+    if (source >= LED_MATRIX_EVENT_SOURCES || row >= MATRIX_ROWS)
+        return;
+
+    matrix_row_t changed = state ^ last_rows[source][row];
+    last_rows[source][row] = state;
+
+    uint8_t flags = (source == LED_MATRIX_EVENT_SOURCE_REMOTE) ? LED_MATRIX_EVENT_REMOTE : 0;
+
+    for (uint8_t col = 0; changed; col++, changed >>= 1, state >>= 1) {
+        if (changed & 1)
+            push(row, col, flags | ((state & 1) ? LED_MATRIX_EVENT_PRESSED : 0), time);
+    }
+}
+
+bool led_matrix_event_pop(led_matrix_key_event *event)
+{
+    if (queue_tail == queue_head)
+        return false;
+
+    *event = queue[queue_tail];
+    queue_tail = (queue_tail + 1) & QUEUE_MASK;
+    return true;
+}
+
+void led_matrix_event_clear(void)
+{
+    queue_tail = queue_head;
+    dropped = 0;
+}
+
+uint8_t led_matrix_event_dropped(void)
+{
+    return dropped;
+}
+
+void led_matrix_effect_init(led_matrix_effect_list *list, led_matrix_effect *items, uint8_t size)
+{
+    list->count = 0;
+    list->size = size;
+    list->items = items;
+}
+
+led_matrix_effect *led_matrix_effect_find(led_matrix_effect_list *list, uint8_t row, uint8_t col)
+{
+    for (uint8_t i = 0; i < list->count; i++) {
+        if (list->items[i].row == row && list->items[i].col == col)
+            return &list->items[i];
+    }
+    return 0;
+}
+
+led_matrix_effect *led_matrix_effect_add(led_matrix_effect_list *list, uint8_t row, uint8_t col, uint8_t value)
+{
+    led_matrix_effect *effect = led_matrix_effect_find(list, row, col);
+
+    if (!effect) {
+        if (list->count >= list->size)
+            return 0;
+        effect = &list->items[list->count++];
+        effect->row = row;
+        effect->col = col;
+    }
+
+    effect->value = value;
+    return effect;
+}
+
+void led_matrix_effect_remove(led_matrix_effect_list *list, led_matrix_effect *effect)
+{
+    *effect = list->items[--list->count];
+}
@@ -0,0 +1,95 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LED_MATRIX_LED_MATRIX_EVENT_H
+#define LED_MATRIX_LED_MATRIX_EVENT_H
+
+#include "matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Key events for reactive animations.
+ *
+ * The board feeds debounced matrix rows per source (this half, the other
+ * half of a split keyboard), changed keys are queued as press and release
+ * events and handed to the running animation. A full queue drops new events.
+ *
+ * Effects of a reactive animation are kept in a sparse led_matrix_effect_list,
+ * a frame only visits the live effects instead of all keys.
+ */
+
+#define LED_MATRIX_EVENT_PRESSED    (1 << 0)
+/* the key is on the other half of a split keyboard */
+#define LED_MATRIX_EVENT_REMOTE     (1 << 1)
+
+#define LED_MATRIX_EVENT_SOURCE_LOCAL   0
+#define LED_MATRIX_EVENT_SOURCE_REMOTE  1
+
+/* set to 2 on split keyboards */
+#ifndef LED_MATRIX_EVENT_SOURCES
+#define LED_MATRIX_EVENT_SOURCES 1
+#endif
+
+/* must be a power of 2 */
+#ifndef LED_MATRIX_EVENT_QUEUE_SIZE
+#define LED_MATRIX_EVENT_QUEUE_SIZE 16
+#endif
+
+typedef struct {
+    uint8_t row;
+    uint8_t col;
+    uint8_t flags;
+    uint16_t time;
+} led_matrix_key_event;
+
+/* queue the keys of row that changed since the last call for source */
+void led_matrix_event_row(uint8_t source, uint8_t row, matrix_row_t state, uint16_t time);
+/* oldest queued event, false if there is none */
+bool led_matrix_event_pop(led_matrix_key_event *event);
+/* drop all queued events, the row states are kept */
+void led_matrix_event_clear(void);
+/* events lost to a full queue since the last clear */
+uint8_t led_matrix_event_dropped(void);
+
+typedef struct {
+    uint8_t row;
+    uint8_t col;
+    /* animation defined: remaining steps, held or fading, ... */
+    uint8_t value;
+} led_matrix_effect;
+
+typedef struct {
+    uint8_t count;
+    uint8_t size;
+    led_matrix_effect *items;
+} led_matrix_effect_list;
+
+void led_matrix_effect_init(led_matrix_effect_list *list, led_matrix_effect *items, uint8_t size);
+led_matrix_effect *led_matrix_effect_find(led_matrix_effect_list *list, uint8_t row, uint8_t col);
+/* the effect of the key, a new one if it has none, 0 if the list is full */
+led_matrix_effect *led_matrix_effect_add(led_matrix_effect_list *list, uint8_t row, uint8_t col, uint8_t value);
+/* the last effect takes the place of the removed one, do not advance when removing while iterating */
+void led_matrix_effect_remove(led_matrix_effect_list *list, led_matrix_effect *effect);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
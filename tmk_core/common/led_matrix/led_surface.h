@@ -0,0 +1,114 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LED_MATRIX_LED_SURFACE_H
+#define LED_MATRIX_LED_SURFACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Pixel surface of a key backlight.
+ *
+ * Pixels are addressed by key matrix position, every board maps its keys to
+ * its LED driver (IS31FL3731 mono, IS31FL3733 RGB, ...) in its own surface.
+ * Mono surfaces show the brightest channel of a pixel, see led_pixel_level().
+ */
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} led_pixel;
+
+/* surface flags */
+#define LED_SURFACE_RGB     (1 << 0)
+
+typedef struct led_surface led_surface;
+
+struct led_surface {
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t flags;
+    /* board or buffer specific data */
+    void *context;
+
+    /* set a key, keys without LED are ignored */
+    void (*set)(led_surface *surface, uint8_t row, uint8_t col, led_pixel pixel);
+    /* read back a key, false if the key has no LED */
+    bool (*get)(led_surface *surface, uint8_t row, uint8_t col, led_pixel *pixel);
+    /* show all keys set since the last commit */
+    void (*commit)(led_surface *surface);
+};
+
+static inline uint8_t led_pixel_level(led_pixel pixel)
+{
+    uint8_t level = pixel.r;
+    if (pixel.g > level) level = pixel.g;
+    if (pixel.b > level) level = pixel.b;
+    return level;
+}
+
+static inline bool led_pixel_equal(led_pixel a, led_pixel b)
+{
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+/* scale all channels of a pixel by level/256 */
+static inline led_pixel led_pixel_scale(led_pixel pixel, uint8_t level)
+{
+    pixel.r = ((uint16_t)pixel.r * (level + 1)) >> 8;
+    pixel.g = ((uint16_t)pixel.g * (level + 1)) >> 8;
+    pixel.b = ((uint16_t)pixel.b * (level + 1)) >> 8;
+    return pixel;
+}
+
+static inline void led_surface_set(led_surface *surface, uint8_t row, uint8_t col, led_pixel pixel)
+{
+    if (row < surface->rows && col < surface->cols)
+        surface->set(surface, row, col, pixel);
+}
+
+static inline bool led_surface_get(led_surface *surface, uint8_t row, uint8_t col, led_pixel *pixel)
+{
+    if (row >= surface->rows || col >= surface->cols)
+        return false;
+    return surface->get(surface, row, col, pixel);
+}
+
+static inline void led_surface_commit(led_surface *surface)
+{
+    surface->commit(surface);
+}
+
+/*
+ * Surface in RAM, one byte (mono) or three bytes (LED_SURFACE_RGB) per key.
+ * Used to render off screen and to run animations on a host.
+ * buffer holds rows * cols * (flags & LED_SURFACE_RGB ? 3 : 1) bytes.
+ */
+void led_surface_buffer_init(led_surface *surface, uint8_t *buffer, uint8_t rows, uint8_t cols, uint8_t flags);
+void led_surface_buffer_clear(led_surface *surface);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,83 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "led_surface.h"
+#include <string.h>
+
+/*
+ * No AVR headers in here: this surface is also built on the host.
+ */
+
+static inline uint8_t pixel_size(led_surface *surface)
+{
+    return (surface->flags & LED_SURFACE_RGB) ? 3 : 1;
+}
+
+static inline uint8_t *pixel_at(led_surface *surface, uint8_t row, uint8_t col)
+{
+    return (uint8_t *)surface->context + ((uint16_t)row * surface->cols + col) * pixel_size(surface);
+}
+
+static void buffer_set(led_surface *surface, uint8_t row, uint8_t col, led_pixel pixel)
+{
+    uint8_t *p = pixel_at(surface, row, col);
+
+    if (surface->flags & LED_SURFACE_RGB) {
+        p[0] = pixel.r;
+        p[1] = pixel.g;
+        p[2] = pixel.b;
+    } else {
+        p[0] = led_pixel_level(pixel);
+    }
+}
+
+static bool buffer_get(led_surface *surface, uint8_t row, uint8_t col, led_pixel *pixel)
+{
+    uint8_t *p = pixel_at(surface, row, col);
+
+    if (surface->flags & LED_SURFACE_RGB) {
+        pixel->r = p[0];
+        pixel->g = p[1];
+        pixel->b = p[2];
+    } else {
+        pixel->r = pixel->g = pixel->b = p[0];
+    }
+    return true;
+}
+
+static void buffer_commit(led_surface *surface)
+{
+    // the buffer is the frame, nothing to upload
+}
+
+void led_surface_buffer_init(led_surface *surface, uint8_t *buffer, uint8_t rows, uint8_t cols, uint8_t flags)
+{
+    surface->rows = rows;
+    surface->cols = cols;
+    surface->flags = flags;
+    surface->context = buffer;
+    surface->set = &buffer_set;
+    surface->get = &buffer_get;
+    surface->commit = &buffer_commit;
+
+    led_surface_buffer_clear(surface);
+}
+
+void led_surface_buffer_clear(led_surface *surface)
+{
+    memset(surface->context, 0, (uint16_t)surface->rows * surface->cols * pixel_size(surface));
+}
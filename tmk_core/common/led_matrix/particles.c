@@ -0,0 +1,155 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "particles.h"
+#include <string.h>
+
+static uint16_t seed = 0xACE1;
+
+/* xorshift, rand() of avr-libc is far too slow for a few hundred calls per frame */
+static inline uint8_t random8(void)
+{
+    seed ^= seed << 7;
+    seed ^= seed >> 9;
+    seed ^= seed << 8;
+    return seed;
+}
+
+static inline int8_t random_spread(uint8_t spread)
+{
+    if (!spread)
+        return 0;
+    return (int8_t)(random8() % (2 * spread + 1)) - spread;
+}
+
+static inline int8_t add_saturated(int8_t a, int8_t b)
+{
+    int16_t sum = a + b;
+    if (sum > 127)
+        return 127;
+    if (sum < -128)
+        return -128;
+    return sum;
+}
+
+void particles_init(particle_system *ps)
+{
+    memset(ps, 0, sizeof(particle_system));
+}
+
+particle_emitter *particles_add_emitter(particle_system *ps, uint8_t type)
+{
+    for (uint8_t i = 0; i < PARTICLE_EMITTERS_MAX; i++) {
+        if (ps->emitters[i].type == PARTICLE_EMITTER_NONE) {
+            memset(&ps->emitters[i], 0, sizeof(particle_emitter));
+            ps->emitters[i].type = type;
+            return &ps->emitters[i];
+        }
+    }
+    return 0;
+}
+
+bool particles_spawn_burst(particle_system *ps, particle_emitter const *like, uint8_t row, uint8_t col, uint8_t count)
+{
+    particle_emitter *emitter = particles_add_emitter(ps, PARTICLE_EMITTER_BURST);
+    if (!emitter)
+        return false;
+
+    *emitter = *like;
+    emitter->type = PARTICLE_EMITTER_BURST;
+    emitter->rate = count;
+    emitter->x = PARTICLE_KEY(col) + 128;
+    emitter->y = PARTICLE_KEY(row) + 128;
+    return true;
+}
+
+static void emit(particle_system *ps, particle_emitter const *emitter)
+{
+    uint8_t i = ps->count;
+    uint8_t life_range = emitter->max_life - emitter->min_life;
+
+    ps->x[i] = emitter->x;
+    ps->y[i] = emitter->y;
+    ps->vx[i] = add_saturated(emitter->vx, random_spread(emitter->spread));
+    ps->vy[i] = add_saturated(emitter->vy, random_spread(emitter->spread));
+    ps->life[i] = emitter->min_life + (life_range ? random8() % (life_range + 1) : 0);
+    ps->count++;
+}
+
+static void kill(particle_system *ps, uint8_t i)
+{
+    uint8_t last = --ps->count;
+
+    ps->x[i] = ps->x[last];
+    ps->y[i] = ps->y[last];
+    ps->vx[i] = ps->vx[last];
+    ps->vy[i] = ps->vy[last];
+    ps->life[i] = ps->life[last];
+}
+
+void particles_update(particle_system *ps, uint8_t rows, uint8_t cols)
+{
+    int16_t max_x = PARTICLE_KEY(cols);
+    int16_t max_y = PARTICLE_KEY(rows);
+
+    for (uint8_t i = 0; i < ps->count;) {
+        if (ps->life[i] <= 1) {
+            kill(ps, i);
+            continue;
+        }
+
+        ps->life[i]--;
+        ps->vx[i] = add_saturated(ps->vx[i], ps->ax);
+        ps->vy[i] = add_saturated(ps->vy[i], ps->ay);
+        ps->x[i] += ps->vx[i];
+        ps->y[i] += ps->vy[i];
+
+        if (ps->x[i] < 0 || ps->x[i] >= max_x || ps->y[i] < 0 || ps->y[i] >= max_y) {
+            kill(ps, i);
+            continue;
+        }
+
+        i++;
+    }
+
+    for (uint8_t e = 0; e < PARTICLE_EMITTERS_MAX; e++) {
+        particle_emitter *emitter = &ps->emitters[e];
+
+        if (emitter->type == PARTICLE_EMITTER_NONE)
+            continue;
+
+        uint8_t n = emitter->rate;
+        while (n && ps->count < PARTICLES_MAX) {
+            emit(ps, emitter);
+            n--;
+        }
+
+        // a burst emits what fits now, the rest is dropped
+        if (emitter->type == PARTICLE_EMITTER_BURST)
+            emitter->type = PARTICLE_EMITTER_NONE;
+    }
+}
+
+void particles_render(particle_system const *ps, uint8_t *heat, uint8_t cols, uint8_t gain)
+{
+    for (uint8_t i = 0; i < ps->count; i++) {
+        uint8_t *key = heat + (uint8_t)(ps->y[i] >> 8) * cols + (uint8_t)(ps->x[i] >> 8);
+        uint16_t value = *key + (((uint16_t)ps->life[i] * gain) >> 4);
+
+        *key = (value > 0xFF) ? 0xFF : value;
+    }
+}
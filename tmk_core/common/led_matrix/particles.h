@@ -0,0 +1,104 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef LED_MATRIX_PARTICLES_H
+#define LED_MATRIX_PARTICLES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Fixed point particle system for key backlights.
+ *
+ * Positions are 8.8 fixed point in keys (x: column, y: row, 0 is the top
+ * row), velocities are 1/256 key per frame, accelerations 1/256 key per
+ * frame squared. Particles are kept as structure of arrays in a pool of
+ * PARTICLES_MAX, live particles are packed at the front. The caller owns
+ * the particle_system, nothing is allocated.
+ */
+
+#ifndef PARTICLES_MAX
+#define PARTICLES_MAX 64
+#endif
+
+#ifndef PARTICLE_EMITTERS_MAX
+#define PARTICLE_EMITTERS_MAX 8
+#endif
+
+#define PARTICLE_KEY(k) ((int16_t)(k) << 8)
+
+enum particle_emitter_type {
+    PARTICLE_EMITTER_NONE,
+    /* emits rate particles every frame */
+    PARTICLE_EMITTER_FOUNTAIN,
+    /* emits rate particles once and frees itself, see particles_spawn_burst() */
+    PARTICLE_EMITTER_BURST,
+};
+
+typedef struct {
+    uint8_t type;
+    uint8_t rate;
+    int16_t x;
+    int16_t y;
+    int8_t vx;
+    int8_t vy;
+    /* random velocity added per axis: -spread..spread */
+    uint8_t spread;
+    uint8_t min_life;
+    uint8_t max_life;
+} particle_emitter;
+
+typedef struct {
+    int16_t x[PARTICLES_MAX];
+    int16_t y[PARTICLES_MAX];
+    int8_t vx[PARTICLES_MAX];
+    int8_t vy[PARTICLES_MAX];
+    uint8_t life[PARTICLES_MAX];
+    uint8_t count;
+
+    int8_t ax;
+    int8_t ay;
+
+    particle_emitter emitters[PARTICLE_EMITTERS_MAX];
+} particle_system;
+
+void particles_init(particle_system *ps);
+
+/* returns a free emitter set to type or 0 if all are in use */
+particle_emitter *particles_add_emitter(particle_system *ps, uint8_t type);
+
+/* one shot burst of count particles, copies the settings of like (position and type are replaced) */
+bool particles_spawn_burst(particle_system *ps, particle_emitter const *like, uint8_t row, uint8_t col, uint8_t count);
+
+/* emit, move and age all particles, particles leaving rows x cols die */
+void particles_update(particle_system *ps, uint8_t rows, uint8_t cols);
+
+/*
+ * Add the particles to heat, one byte per key, rows x cols.
+ * A particle adds life * gain / 16 to the key it is on, saturating at 255.
+ */
+void particles_render(particle_system const *ps, uint8_t *heat, uint8_t cols, uint8_t gain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,100 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Main loop performance counters
+ *
+ * A counter keeps the number of samples, the min, sum and max duration
+ * and a histogram of the durations:
+ *
+ *   PERF_START(scan);
+ *   matrix_scan();
+ *   PERF_STOP(scan, perfMatrixScan);
+ *
+ * The time base is the raw timer 0 count behind timer_read(), 4us at
+ * 16MHz. A sample costs two reads of the timer and a few additions.
+ * Durations are kept in ticks and saturate at 0xFFFF (262ms at 16MHz).
+ * The counters halve themselves before the sample count overflows, the
+ * averages stay valid in long sessions.
+ *
+ * Without PERF_ENABLE the macros are empty.
+ */
+
+enum perf_counter
+{
+    perfLoop = 0,
+    perfMatrixScan,
+    perfActionExec,
+    perfSendKeyboard,
+    perfAnimate,
+    perfI2CUpload,
+    perfSplitReceive,
+    perfUsbHost,
+    PERF_COUNTERS
+};
+
+/* bucket b holds durations below 16us << b, the last one all longer ones */
+#define PERF_BUCKETS 8
+
+typedef struct
+{
+    uint16_t count;
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+    uint16_t buckets[PERF_BUCKETS];
+} perf_counter_t;
+
+#ifdef PERF_ENABLE
+
+#include "timer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* start is a timer_read_raw32() stamp */
+void perf_record(uint8_t counter, uint32_t start);
+
+void perf_reset(void);
+/* copies the counter, false if it has no samples */
+bool perf_get(uint8_t counter, perf_counter_t *out);
+/* name of the counter in flash */
+const char *perf_name_P(uint8_t counter);
+/* microseconds of a number of ticks, UINT16_MAX for 65ms and more */
+uint16_t perf_us(uint32_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define PERF_START(name) uint32_t perf_start_##name = timer_read_raw32()
+#define PERF_STOP(name, counter) perf_record(counter, perf_start_##name)
+
+#else
+
+#define PERF_START(name)
+#define PERF_STOP(name, counter)
+
+#endif
+
+#endif
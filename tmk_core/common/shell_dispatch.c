@@ -0,0 +1,89 @@
+#include "shell_dispatch.h"
+#include "debug.h"
+#include <string.h>
+
+#if defined(__AVR__)
+#   include <avr/pgmspace.h>
+#   define pgm_read_name(p)     ((const char *)pgm_read_word(p))
+#else
+#   define pgm_read_name(p)     (*(p))
+#   define memcpy_P             memcpy
+#endif
+
+enum shell_table_order
+{
+    shellOrderUnchecked = 0,
+    shellOrderSorted,
+    shellOrderUnsorted
+};
+
+static const char *command_name(const shell_table_t *table, uint8_t index)
+{
+    return pgm_read_name(&table->commands[index].name);
+}
+
+static bool table_sorted(const shell_table_t *table)
+{
+    for (uint8_t i = 1; i < table->count; i++)
+    {
+        if (strcmp(command_name(table, i - 1), command_name(table, i)) >= 0)
+        {
+            dprintf("shell: '%s' out of order, linear search\n", command_name(table, i));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static int16_t find_sorted(const shell_table_t *table, const char *name)
+{
+    uint8_t first = 0;
+    uint8_t last = table->count;
+
+    while (first < last)
+    {
+        uint8_t middle = first + (last - first) / 2;
+        int order = strcmp(name, command_name(table, middle));
+
+        if (order == 0)
+            return middle;
+
+        if (order < 0)
+            last = middle;
+        else
+            first = middle + 1;
+    }
+
+    return -1;
+}
+
+static int16_t find_unsorted(const shell_table_t *table, const char *name)
+{
+    for (uint8_t i = 0; i < table->count; i++)
+    {
+        if (strcmp(name, command_name(table, i)) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+bool shell_command_find(shell_table_t *table, const char *name, shell_command_t *command)
+{
+    if (table->order == shellOrderUnchecked)
+        table->order = table_sorted(table) ? shellOrderSorted : shellOrderUnsorted;
+
+    int16_t index = (table->order == shellOrderSorted) ? find_sorted(table, name) : find_unsorted(table, name);
+
+    if (index < 0)
+        return false;
+
+    shell_command_get(table, index, command);
+    return true;
+}
+
+void shell_command_get(const shell_table_t *table, uint8_t index, shell_command_t *command)
+{
+    memcpy_P(command, &table->commands[index], sizeof(shell_command_t));
+}
@@ -0,0 +1,64 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SHELL_DISPATCH_H
+#define SHELL_DISPATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Command table of the virtual serial shells
+ *
+ * The commands live in flash, sorted by name:
+ *
+ *   static const shell_command_t commands[] PROGMEM = {
+ *       SHELL_COMMAND("?", cmd_help, 0, "help"),
+ *       SHELL_COMMAND("map", cmd_map, "save | #", "control"),
+ *   };
+ *   static shell_table_t table = SHELL_TABLE(commands);
+ *
+ * A lookup is a binary search that reads only the name pointers of the
+ * probed entries from flash. The first lookup checks the order: a table
+ * out of order still works, with a linear search and a debug message.
+ */
+
+typedef bool (*shell_command_fn)(uint8_t argc, char **argv);
+
+typedef struct
+{
+    const char *name;
+    shell_command_fn fn;
+    const char *help_args;
+    const char *help_msg;
+} shell_command_t;
+
+typedef struct
+{
+    const shell_command_t *commands;
+    uint8_t count;
+    uint8_t order;
+} shell_table_t;
+
+#define SHELL_COMMAND(name, fn, help_args, help_msg) { name, fn, help_args, help_msg }
+#define SHELL_TABLE(commands) { commands, sizeof(commands) / sizeof(commands[0]), 0 }
+
+/* copies the command called name into *command, false if there is none */
+bool shell_command_find(shell_table_t *table, const char *name, shell_command_t *command);
+/* copies the command at index into *command, in table order */
+void shell_command_get(const shell_table_t *table, uint8_t index, shell_command_t *command);
+
+#endif
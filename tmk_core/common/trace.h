@@ -0,0 +1,147 @@
+/*
+Copyright 2017 anorak-47
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Main loop timeline trace
+ *
+ * A ring of the last TRACE_SIZE events, each with the raw timer stamp
+ * (see timer_read_raw32()), the event id and a 16 bit argument:
+ *
+ *   TRACE_BEGIN(traceActionExec, key);
+ *   action_exec(e);
+ *   TRACE_END(traceActionExec, 0);
+ *
+ * keyboard_task() passes without an event are not recorded, the next
+ * recorded pass carries their number. That keeps minutes of typing in
+ * the ring instead of the last few milliseconds of idle scans.
+ *
+ * Only the events of the mask are recorded. A running animation adds a
+ * frame or a row slice to nearly every pass, each of them with the pass
+ * takes four records: with animate recorded the ring holds about a dozen
+ * passes, a few milliseconds. animate is therefore left out by default,
+ * trace_set_mask() ('.trace mask') records it when the frames matter.
+ *
+ * Recording is frozen on demand or by a pass longer than the armed
+ * time, the ring then keeps the events that led up to it. Events are
+ * recorded from the main loop only. A record is a timer read and a
+ * store, its cost is measured on the first pass and reported with the
+ * dump. tmk_core/tool/trace_json converts a dump to Chrome trace JSON.
+ *
+ * Without TRACE_ENABLE the macros are empty.
+ */
+
+#ifndef TRACE_SIZE
+#define TRACE_SIZE 48
+#endif
+
+enum trace_event
+{
+    traceLoop = 0,      // idle passes before it
+    traceActionExec,    // pressed << 15 | row << 8 | col
+    traceSendKeyboard,  // modifiers
+    traceAnimate,       // animation, a sliced frame traces its rows
+    traceTwiWait,       // slave address, the TWI queue is full
+    traceSplitSend,     // datagram command << 8 | length
+    traceSplitReceive,  // datagram command << 8 | length
+    traceFreeze,        // pass time in ticks, the armed time is exceeded
+    TRACE_EVENTS
+};
+
+#define TRACE_MASK(event) (1 << (event))
+#ifndef TRACE_MASK_DEFAULT
+#define TRACE_MASK_DEFAULT ((TRACE_MASK(TRACE_EVENTS) - 1) & ~TRACE_MASK(traceAnimate))
+#endif
+
+/* the phase is kept in the upper bits of the event */
+#define TRACE_PHASE_BEGIN 0x40
+#define TRACE_PHASE_END 0x80
+#define TRACE_PHASE_MASK 0xC0
+
+typedef struct
+{
+    uint32_t stamp;
+    uint8_t event;
+    uint16_t arg;
+} trace_record_t;
+
+typedef struct
+{
+    uint8_t count;
+    uint16_t recorded;
+    uint16_t overwritten;
+    uint16_t tick_ns;
+    // measured cost of a record, 0 until the first pass
+    uint16_t record_ns;
+    bool frozen;
+} trace_stats_t;
+
+/* records timed on the first pass */
+#define TRACE_CALIBRATE 32
+
+#ifdef TRACE_ENABLE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void trace_record(uint8_t event, uint16_t arg);
+void trace_loop_begin(void);
+void trace_loop_end(void);
+
+void trace_freeze(void);
+/* clears the ring and records again */
+void trace_resume(void);
+/* freezes after a pass longer than us, 0 disarms */
+void trace_arm(uint16_t us);
+/* events recorded from now on, a TRACE_MASK() per event, the passes and the freeze are always in */
+void trace_set_mask(uint16_t mask);
+uint16_t trace_mask(void);
+
+trace_stats_t trace_stats(void);
+/* copies the record at index, 0 is the oldest, false past the last */
+bool trace_get(uint8_t index, trace_record_t *out);
+/* name of the event in flash */
+const char *trace_name_P(uint8_t event);
+/* 'B' for a begin, 'E' for an end, 'i' for a mark */
+char trace_phase(uint8_t event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define TRACE_BEGIN(event, arg) trace_record((event) | TRACE_PHASE_BEGIN, arg)
+#define TRACE_END(event, arg) trace_record((event) | TRACE_PHASE_END, arg)
+#define TRACE_MARK(event, arg) trace_record(event, arg)
+#define TRACE_LOOP_BEGIN() trace_loop_begin()
+#define TRACE_LOOP_END() trace_loop_end()
+
+#else
+
+#define TRACE_BEGIN(event, arg)
+#define TRACE_END(event, arg)
+#define TRACE_MARK(event, arg)
+#define TRACE_LOOP_BEGIN()
+#define TRACE_LOOP_END()
+
+#endif
+
+#endif
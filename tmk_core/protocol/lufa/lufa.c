@@ -668,7 +668,7 @@ int8_t sendchar(uint8_t c)
     uart_putc(c);
 #endif
 #ifdef VIRTSER_ENABLE
-    virtser_send(c);
+    virtser_send_diagnostic(c);
 #endif
 
     return 0;
@@ -680,6 +680,67 @@ int8_t sendchar(uint8_t c)
  ******************************************************************************/
 
 #ifdef VIRTSER_ENABLE
+/*
+ * virtser_send only queues, the queue goes out in CDC_EPSIZE packets: full ones as soon as
+ * they are complete, the rest once per main loop pass from virtser_task and CDC_Device_USBTask.
+ * A full queue waits for the host, the budget of the pass bounds only the time in which the host
+ * takes no packet: a reply to a reading host is never cut, one to a host that stopped reading is
+ * dropped after the budget.
+ */
+#ifndef VIRTSER_TX_BUFFER_SIZE
+#define VIRTSER_TX_BUFFER_SIZE 128
+#endif
+#ifndef VIRTSER_TX_BUDGET_US
+#define VIRTSER_TX_BUDGET_US 1000
+#endif
+#define VIRTSER_TX_WAIT_US 20
+/* queue space debug output leaves to the replies */
+#define VIRTSER_TX_RESERVE (VIRTSER_TX_BUFFER_SIZE / 2)
+
+#if VIRTSER_TX_BUFFER_SIZE > 256 || (VIRTSER_TX_BUFFER_SIZE & (VIRTSER_TX_BUFFER_SIZE - 1))
+#error VIRTSER_TX_BUFFER_SIZE must be a power of two up to 256
+#endif
+
+static uint8_t virtser_tx_buffer[VIRTSER_TX_BUFFER_SIZE];
+static uint8_t virtser_tx_head;
+static uint8_t virtser_tx_tail;
+static uint8_t virtser_tx_count;
+static uint16_t virtser_tx_budget_us = VIRTSER_TX_BUDGET_US;
+static virtser_tx_stats_t virtser_tx_stat;
+
+static bool virtser_tx_connected(void)
+{
+    return cdc_device.State.ControlLineStates.HostToDevice & CDC_CONTROL_LINE_OUT_DTR;
+}
+
+/* moves the queue into the IN endpoint while the host takes the packets */
+static void virtser_tx_flush(void)
+{
+    if (!virtser_tx_count)
+        return;
+
+    uint8_t ep = Endpoint_GetCurrentEndpoint();
+    Endpoint_SelectEndpoint(cdc_device.Config.DataINEndpoint.Address);
+
+    if (Endpoint_IsEnabled() && Endpoint_IsConfigured())
+    {
+        while (virtser_tx_count && Endpoint_IsINReady())
+        {
+            Endpoint_Write_8(virtser_tx_buffer[virtser_tx_tail]);
+            virtser_tx_tail = (virtser_tx_tail + 1) & (VIRTSER_TX_BUFFER_SIZE - 1);
+            virtser_tx_count--;
+
+            if (!Endpoint_IsReadWriteAllowed())
+            {
+                Endpoint_ClearIN();
+                virtser_tx_stat.packets++;
+            }
+        }
+    }
+
+    Endpoint_SelectEndpoint(ep);
+}
+
 void virtser_init(void)
 {
     cdc_device.State.ControlLineStates.DeviceToHost = CDC_CONTROL_LINE_IN_DSR;
@@ -693,46 +754,103 @@ void virtser_recv(uint8_t c)
     // Ignore by default
 }
 
+bool virtser_recv_ready(void) __attribute__((weak));
+bool virtser_recv_ready(void)
+{
+    return true;
+}
+
 void virtser_task(void)
 {
+    virtser_tx_budget_us = VIRTSER_TX_BUDGET_US;
+    virtser_tx_flush();
+
+    /* drain the whole OUT packet, one byte per task call caps binary frames at one byte per scan */
     uint16_t count = CDC_Device_BytesReceived(&cdc_device);
-    uint8_t ch;
-    if (count)
+    while (count-- && virtser_recv_ready())
     {
-        ch = CDC_Device_ReceiveByte(&cdc_device);
+        int16_t ch = CDC_Device_ReceiveByte(&cdc_device);
+        if (ch < 0)
+            break;
         virtser_recv(ch);
     }
+
+    /* the replies, a partial packet is sent by CDC_Device_USBTask */
+    virtser_tx_flush();
 }
 
 void virtser_send(const uint8_t byte)
 {
-    uint8_t timeout = 255;
-    uint8_t ep = Endpoint_GetCurrentEndpoint();
+    if (!virtser_tx_connected())
+        return;
 
-    if (cdc_device.State.ControlLineStates.HostToDevice & CDC_CONTROL_LINE_OUT_DTR)
+    if (virtser_tx_count == VIRTSER_TX_BUFFER_SIZE)
     {
-        /* IN packet */
-        Endpoint_SelectEndpoint(cdc_device.Config.DataINEndpoint.Address);
+        virtser_tx_flush();
+
+        if (virtser_tx_count == VIRTSER_TX_BUFFER_SIZE && virtser_tx_budget_us)
+        {
+            virtser_tx_stat.stalls++;
+
+            while (virtser_tx_count == VIRTSER_TX_BUFFER_SIZE && virtser_tx_budget_us >= VIRTSER_TX_WAIT_US)
+            {
+                _delay_us(VIRTSER_TX_WAIT_US);
+                virtser_tx_flush();
+                if (virtser_tx_count == VIRTSER_TX_BUFFER_SIZE)
+                    virtser_tx_budget_us -= VIRTSER_TX_WAIT_US;
+            }
+        }
 
-        if (!Endpoint_IsEnabled() || !Endpoint_IsConfigured())
+        if (virtser_tx_count == VIRTSER_TX_BUFFER_SIZE)
         {
-            Endpoint_SelectEndpoint(ep);
+            virtser_tx_stat.dropped++;
             return;
         }
+    }
 
-        while (timeout-- && !Endpoint_IsReadWriteAllowed())
-            _delay_us(40);
+    virtser_tx_buffer[virtser_tx_head] = byte;
+    virtser_tx_head = (virtser_tx_head + 1) & (VIRTSER_TX_BUFFER_SIZE - 1);
+    virtser_tx_count++;
 
-        Endpoint_Write_8(byte);
-        CDC_Device_Flush(&cdc_device);
+    if (virtser_tx_count >= CDC_EPSIZE)
+        virtser_tx_flush();
+}
 
-        if (Endpoint_IsINReady())
-        {
-            Endpoint_ClearIN();
-        }
+void virtser_send_budget(uint16_t us)
+{
+    virtser_tx_budget_us = us;
+}
 
-        Endpoint_SelectEndpoint(ep);
+uint8_t virtser_send_free(void)
+{
+    return VIRTSER_TX_BUFFER_SIZE - virtser_tx_count;
+}
+
+/*
+ * Debug output without a console. It only takes the free space of the queue above
+ * VIRTSER_TX_RESERVE, the rest is left for the shell replies. It never waits: with less
+ * room it is deferred to the packets of the next passes, and dropped if there is none.
+ */
+void virtser_send_diagnostic(const uint8_t byte)
+{
+    if (!virtser_tx_connected())
+        return;
+
+    if (virtser_send_free() <= VIRTSER_TX_RESERVE)
+        virtser_tx_flush();
+
+    if (virtser_send_free() <= VIRTSER_TX_RESERVE)
+    {
+        virtser_tx_stat.diagnostic_dropped++;
+        return;
     }
+
+    virtser_send(byte);
+}
+
+virtser_tx_stats_t virtser_tx_stats(void)
+{
+    return virtser_tx_stat;
 }
 #endif
 
@@ -1,9 +1,34 @@
 #ifndef VIRTSER_H_
 #define VIRTSER_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+    /* full packets sent while the queue was moved into the endpoint */
+    uint16_t packets;
+    /* virtser_send found the queue full and waited for the host */
+    uint16_t stalls;
+    /* bytes lost after the host took nothing for the wait budget of the main loop pass */
+    uint16_t dropped;
+    /* debug output lost for lack of room, see virtser_send_diagnostic */
+    uint16_t diagnostic_dropped;
+} virtser_tx_stats_t;
+
 void virtser_init(void);
 void virtser_recv(uint8_t c);
+/* false keeps the received data in the endpoint, the host is held back by flow control */
+bool virtser_recv_ready(void);
 void virtser_task(void);
+/* queues the byte, see lufa.c */
 void virtser_send(const uint8_t byte);
+/* the time virtser_send may still wait for a host that takes nothing in this main loop pass, virtser_task resets it */
+void virtser_send_budget(uint16_t us);
+/* free bytes in the queue, virtser_send does not wait for them */
+uint8_t virtser_send_free(void);
+/* queues debug output only while there is room left for the replies, it never waits */
+void virtser_send_diagnostic(const uint8_t byte);
+virtser_tx_stats_t virtser_tx_stats(void);
 
 #endif
@@ -0,0 +1,484 @@
+/*
+ * Host benchmark of the keyboard/anorak_91tkl backlight animations, cycles per frame.
+ *
+ * Runs every animation through animation.c as the firmware does (set_animation(),
+ * start_animation(), animate() and animation_typematrix_row() with simulated key presses)
+ * against the real IS31FL3733 driver and its PWM output stage. The I2C functions, the
+ * timer and the rest of the board are replaced by the model below.
+ *
+ * The AVR cycles of a frame come from a cost model over what the frame did:
+ *
+ *  - HSV conversions of color.c, the cycles per conversion of tmk_core/tool/hsv_convert
+ *  - keys drawn and read through animation_utils.c
+ *  - PWM bytes uploaded, each passes the output stage (CIE, brightness and white balance)
+ *  - the I2C bus time of all register writes, the upload of a frame has to fit in as well
+ *
+ * The computation of the animations themselves is not in the model, the host time per
+ * frame is printed for it. Calibrate the model with -K/-R/-U against the animate counter
+ * of a PERF_ENABLE build (.perf). An animation whose worst frame does not fit into its
+ * delay_in_ms is flagged and the tool exits with 1, as it does when an animation starts while
+ * a virtual serial stream holds the animation arena.
+ *
+ *   make && ./animation_bench -n 300
+ */
+
+#include "animations/animation.h"
+#include "animations/animation_utils.h"
+#include "animations/animation_arena.h"
+#include "led_matrix/led_matrix_event.h"
+#include "issi/is31fl3733_91tkl.h"
+#include "issi/is31fl3733_twi.h"
+#include "issi/is31fl3733_sdb.h"
+#include "issi/is31fl3733_iicrst.h"
+#include "key_led_map.h"
+#include "timer.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define F_CPU 16000000UL
+/* TWBR 0x0C, no prescaler: 16 MHz / (16 + 2 * 12) */
+#define F_SCL 400000UL
+/* 8 data bits and the ack */
+#define BITS_PER_BYTE 9
+/* start and stop condition, address byte and register byte of every transaction */
+#define BITS_PER_TRANSACTION (2 + 2 * BITS_PER_BYTE)
+
+/* cost model, cycles */
+static uint16_t cycles_per_key = 45;          // key_pwm() lookup and three PWM stores
+static uint16_t cycles_per_read = 40;         // key_pwm() lookup and three PWM loads
+static uint16_t cycles_per_upload_byte = 24;  // output stage LUT, white balance, sum and queueing
+// see tmk_core/tool/hsv_convert, the array calls save the call overhead
+static uint16_t cycles_hsv_to_rgb = 339;
+static uint16_t cycles_rainbow = 84;
+static uint16_t cycles_rainbow_array = 74;
+static uint16_t cycles_spectrum = 76;
+static uint16_t cycles_spectrum_array = 66;
+
+typedef struct
+{
+    uint32_t hsv_to_rgb;
+    uint32_t rainbow;
+    uint32_t rainbow_array;
+    uint32_t spectrum;
+    uint32_t spectrum_array;
+    uint32_t keys;
+    uint32_t reads;
+    uint32_t i2c_bytes;
+    uint32_t i2c_transactions;
+    uint32_t upload_bytes;
+} frame_stats;
+
+static frame_stats stats;
+static uint32_t now_ms;
+
+/*
+ * timer
+ */
+
+uint16_t timer_read(void) { return now_ms; }
+uint32_t timer_read32(void) { return now_ms; }
+uint16_t timer_elapsed(uint16_t last) { return TIMER_DIFF_16((uint16_t)now_ms, last); }
+uint32_t timer_elapsed32(uint32_t last) { return TIMER_DIFF_32(now_ms, last); }
+
+/*
+ * I2C, everything is counted, nothing is sent
+ */
+
+static uint8_t i2c_write(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *buffer, uint8_t count)
+{
+    stats.i2c_bytes += count;
+    stats.i2c_transactions++;
+    // the PWM page is written in lines of IS31FL3733_CS bytes, everything else byte by byte
+    if (count == IS31FL3733_CS)
+        stats.upload_bytes += count;
+    return 0;
+}
+
+static uint8_t i2c_write8(uint8_t i2c_addr, uint8_t reg_addr, uint8_t data)
+{
+    return i2c_write(i2c_addr, reg_addr, &data, 1);
+}
+
+static uint8_t i2c_read(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *buffer, uint8_t count)
+{
+    memset(buffer, 0, count);
+    stats.i2c_bytes += count;
+    stats.i2c_transactions++;
+    return 0;
+}
+
+static uint8_t i2c_read8(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *data)
+{
+    return i2c_read(i2c_addr, reg_addr, data, 1);
+}
+
+uint8_t i2c_queued_write_reg(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *buffer, uint8_t count)
+{
+    return i2c_write(i2c_addr, reg_addr, buffer, count);
+}
+
+uint8_t i2c_queued_write_reg8(uint8_t i2c_addr, uint8_t reg_addr, uint8_t data)
+{
+    return i2c_write8(i2c_addr, reg_addr, data);
+}
+
+uint8_t i2c_read_no_errorhandling_reg(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *buffer, uint8_t count)
+{
+    return i2c_read(i2c_addr, reg_addr, buffer, count);
+}
+
+uint8_t i2c_read_no_errorhandling_reg8(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *data)
+{
+    return i2c_read8(i2c_addr, reg_addr, data);
+}
+
+void sdb_hardware_shutdown_enable_upper(bool enabled) {}
+void sdb_hardware_shutdown_enable_lower(bool enabled) {}
+void iic_reset_upper(void) {}
+void iic_reset_lower(void) {}
+
+/*
+ * board
+ */
+
+bool led_health_is_scanning(void) { return false; }
+// the stream would release the arena here, the bench takes it with taken_arena_check()
+void virtser_stream_stop(void) {}
+void sector_enable_all_leds(void) {}
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+int freeRam(void) { return 0; }
+uint8_t increment(uint8_t value, uint8_t step, uint8_t min, uint8_t max) { return MIN(MAX(value + step, min), max); }
+uint8_t decrement(uint8_t value, uint8_t step, uint8_t min, uint8_t max) { return MIN(MAX(value - step, min), max); }
+uint16_t increment16(uint16_t value, uint8_t step, uint16_t min, uint16_t max) { return MIN(MAX(value + step, min), max); }
+uint16_t decrement16(uint16_t value, uint8_t step, uint16_t min, uint16_t max) { return MIN(MAX(value - step, min), max); }
+
+/*
+ * counters, the calls of the animations into color.c and animation_utils.c are wrapped by the linker
+ */
+
+RGB __real_hsv_to_rgb(HSV hsv);
+RGB __real_hsv_to_rgb_rainbow(HSV hsv);
+RGB __real_hsv_to_rgb_spectrum(HSV hsv);
+void __real_hsv_to_rgb_rainbow_array(HSV const *hsv, RGB *rgb, uint8_t count);
+void __real_hsv_to_rgb_spectrum_array(HSV const *hsv, RGB *rgb, uint8_t count);
+
+RGB __wrap_hsv_to_rgb(HSV hsv)
+{
+    stats.hsv_to_rgb++;
+    return __real_hsv_to_rgb(hsv);
+}
+
+RGB __wrap_hsv_to_rgb_rainbow(HSV hsv)
+{
+    stats.rainbow++;
+    return __real_hsv_to_rgb_rainbow(hsv);
+}
+
+RGB __wrap_hsv_to_rgb_spectrum(HSV hsv)
+{
+    stats.spectrum++;
+    return __real_hsv_to_rgb_spectrum(hsv);
+}
+
+void __wrap_hsv_to_rgb_rainbow_array(HSV const *hsv, RGB *rgb, uint8_t count)
+{
+    stats.rainbow_array += count;
+    __real_hsv_to_rgb_rainbow_array(hsv, rgb, count);
+}
+
+void __wrap_hsv_to_rgb_spectrum_array(HSV const *hsv, RGB *rgb, uint8_t count)
+{
+    stats.spectrum_array += count;
+    __real_hsv_to_rgb_spectrum_array(hsv, rgb, count);
+}
+
+void __real_draw_keymatrix_rgb_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, RGB color);
+void __wrap_draw_keymatrix_rgb_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, RGB color)
+{
+    stats.keys++;
+    __real_draw_keymatrix_rgb_pixel(device, row, col, color);
+}
+
+void __real_draw_keymatrix_hsv_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, HSV color);
+void __wrap_draw_keymatrix_hsv_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, HSV color)
+{
+    stats.keys++;
+    __real_draw_keymatrix_hsv_pixel(device, row, col, color);
+}
+
+bool __real_read_keymatrix_rgb_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, RGB *color);
+bool __wrap_read_keymatrix_rgb_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, RGB *color)
+{
+    stats.reads++;
+    return __real_read_keymatrix_rgb_pixel(device, row, col, color);
+}
+
+void __real_draw_keymatrix_row(IS31FL3733_91TKL *device, uint8_t row, RGB const *colors);
+void __wrap_draw_keymatrix_row(IS31FL3733_91TKL *device, uint8_t row, RGB const *colors)
+{
+    stats.keys += MATRIX_COLS;
+    __real_draw_keymatrix_row(device, row, colors);
+}
+
+void __real_draw_keymatrix_hsv_row(IS31FL3733_91TKL *device, uint8_t row, HSV const *colors);
+void __wrap_draw_keymatrix_hsv_row(IS31FL3733_91TKL *device, uint8_t row, HSV const *colors)
+{
+    stats.keys += MATRIX_COLS;
+    __real_draw_keymatrix_hsv_row(device, row, colors);
+}
+
+void __real_draw_keymatrix_spectrum_row(IS31FL3733_91TKL *device, uint8_t row, HSV const *colors);
+void __wrap_draw_keymatrix_spectrum_row(IS31FL3733_91TKL *device, uint8_t row, HSV const *colors)
+{
+    stats.keys += MATRIX_COLS;
+    __real_draw_keymatrix_spectrum_row(device, row, colors);
+}
+
+// written to the chip at once, the I2C bytes are counted by the model
+void __real_draw_direct_keymatrix_rgb_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, RGB color);
+void __wrap_draw_direct_keymatrix_rgb_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, RGB color)
+{
+    stats.keys++;
+    __real_draw_direct_keymatrix_rgb_pixel(device, row, col, color);
+}
+
+void __real_draw_direct_keymatrix_hsv_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, HSV color);
+void __wrap_draw_direct_keymatrix_hsv_pixel(IS31FL3733_91TKL *device, int16_t row, int16_t col, HSV color)
+{
+    stats.keys++;
+    __real_draw_direct_keymatrix_hsv_pixel(device, row, col, color);
+}
+
+void __real_fill_keys_by_mask(IS31FL3733_91TKL *device, matrix_row_t const *mask, RGB color);
+void __wrap_fill_keys_by_mask(IS31FL3733_91TKL *device, matrix_row_t const *mask, RGB color)
+{
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++)
+        stats.keys += __builtin_popcount(mask[row]);
+    __real_fill_keys_by_mask(device, mask, color);
+}
+
+/*
+ * frames
+ */
+
+static uint32_t frame_cycles(void)
+{
+    return stats.hsv_to_rgb * cycles_hsv_to_rgb + stats.rainbow * cycles_rainbow +
+           stats.rainbow_array * cycles_rainbow_array + stats.spectrum * cycles_spectrum +
+           stats.spectrum_array * cycles_spectrum_array + stats.keys * cycles_per_key +
+           stats.reads * cycles_per_read + stats.upload_bytes * cycles_per_upload_byte;
+}
+
+static uint32_t frame_i2c_cycles(void)
+{
+    uint32_t bits = stats.i2c_bytes * BITS_PER_BYTE + stats.i2c_transactions * BITS_PER_TRANSACTION;
+    return bits * (F_CPU / F_SCL);
+}
+
+static double seconds(struct timespec const *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static bool run(animation_names index, uint32_t frames, uint16_t press_interval, FILE *csv)
+{
+    uint64_t sum_cycles = 0;
+    uint64_t sum_conversions = 0;
+    uint64_t sum_keys = 0;
+    uint32_t max_cycles = 0;
+    uint32_t max_i2c = 0;
+    uint32_t drawn = 0;
+    double host = 0;
+    char *name = animation_name(index);
+
+    set_animation(index);
+    start_animation();
+
+    uint16_t delay = animation.delay_in_ms ? animation.delay_in_ms : 1;
+    uint32_t budget = delay * (F_CPU / 1000);
+    bool pressed = false;
+    uint8_t key_row = 0;
+    uint8_t key_col = 0;
+
+    for (uint32_t frame = 0; frame < frames; frame++)
+    {
+        struct timespec start;
+
+        memset(&stats, 0, sizeof(stats));
+
+        if (press_interval && frame % press_interval == 0)
+        {
+            key_row = rand() % MATRIX_ROWS;
+            key_col = rand() % MATRIX_COLS;
+            animation_typematrix_row(key_row, (matrix_row_t)1 << key_col);
+            pressed = true;
+        }
+        else if (pressed)
+        {
+            animation_typematrix_row(key_row, 0);
+            pressed = false;
+        }
+
+        now_ms += delay;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        // the first call draws the frame, the others finish its slices
+        for (uint8_t pass = 0; pass < MATRIX_ROWS + 1; pass++)
+            animate();
+        host += seconds(&start);
+
+        uint32_t cycles = frame_cycles();
+        uint32_t i2c = frame_i2c_cycles();
+        uint32_t conversions = stats.hsv_to_rgb + stats.rainbow + stats.rainbow_array + stats.spectrum +
+                               stats.spectrum_array;
+
+        if (stats.i2c_bytes)
+            drawn++;
+
+        sum_cycles += cycles;
+        sum_conversions += conversions;
+        sum_keys += stats.keys;
+        if (cycles + i2c > max_cycles + max_i2c)
+        {
+            max_cycles = cycles;
+            max_i2c = i2c;
+        }
+
+        if (csv)
+            fprintf(csv, "%s,%u,%u,%u,%u,%u,%u,%u\n", name, frame, conversions, stats.keys, stats.reads,
+                    stats.upload_bytes, cycles, i2c);
+    }
+
+    stop_animation();
+
+    bool flagged = max_cycles + max_i2c > budget;
+
+    printf("%-22s %4u ms %7u %6.1f %6.1f %8llu %8u %8u %4u%% %8.1f %s\n", name, delay, budget,
+           frames ? (double)sum_conversions / frames : 0.0, frames ? (double)sum_keys / frames : 0.0,
+           frames ? (unsigned long long)(sum_cycles / frames) : 0ULL, max_cycles, max_i2c,
+           (unsigned)((uint64_t)(max_cycles + max_i2c) * 100 / budget), frames ? host * 1e6 / frames : 0.0,
+           flagged ? "DROPS" : (drawn ? "ok" : "ok, no frames"));
+
+    free(name);
+    return !flagged;
+}
+
+// with the arena taken no animation may start, nor write through a null pointer
+static bool taken_arena_check(void)
+{
+    bool ok = true;
+
+    for (uint8_t i = 0; i < animation_LAST; i++)
+    {
+        animation_arena_alloc(ANIMATION_ARENA_SIZE);
+
+        set_animation(i);
+        start_animation();
+        animate();
+        ok &= !animation_is_running() && !animation_is_prepared();
+
+        stop_animation();
+        animation_arena_reset();
+    }
+
+    printf("no animation starts without the arena %s\n\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -a number     run only this animation (default all)\n"
+            "  -n frames     frames per animation (default 100)\n"
+            "  -k frames     press a key every k frames, 0: no keys (default 10)\n"
+            "  -c file       write per frame statistics as csv\n"
+            "  -K/-R/-U n    cycles per key drawn, key read and uploaded PWM byte\n"
+            "  -l            list animations\n",
+            name);
+}
+
+int main(int argc, char **argv)
+{
+    int only = -1;
+    const char *csv_name = 0;
+    uint32_t frames = 100;
+    uint16_t press_interval = 10;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "a:n:k:c:K:R:U:lh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'a': only = strtol(optarg, 0, 0); break;
+        case 'n': frames = strtoul(optarg, 0, 0); break;
+        case 'k': press_interval = strtoul(optarg, 0, 0); break;
+        case 'c': csv_name = optarg; break;
+        case 'K': cycles_per_key = strtoul(optarg, 0, 0); break;
+        case 'R': cycles_per_read = strtoul(optarg, 0, 0); break;
+        case 'U': cycles_per_upload_byte = strtoul(optarg, 0, 0); break;
+        case 'l':
+            for (uint8_t i = 0; i < animation_LAST; i++)
+            {
+                char *name = animation_name(i);
+                printf("%2u %s\n", i, name);
+                free(name);
+            }
+            return 0;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (only >= animation_LAST)
+    {
+        fprintf(stderr, "unknown animation: %d\n", only);
+        return 2;
+    }
+
+    FILE *csv = 0;
+    if (csv_name)
+    {
+        csv = fopen(csv_name, "w");
+        if (!csv)
+        {
+            perror(csv_name);
+            return 2;
+        }
+        fprintf(csv, "animation,frame,conversions,keys,reads,upload_bytes,cycles,i2c_cycles\n");
+    }
+
+    srand(1);
+    is31fl3733_91tkl_init(&issi);
+    initialize_animation();
+    animation.hsv = (HSV){ .h = 0, .s = 255, .v = 255 };
+    animation.hsv2 = (HSV){ .h = 128, .s = 255, .v = 255 };
+    animation.rgb = hsv_to_rgb(animation.hsv);
+
+    bool ok = taken_arena_check();
+
+    printf("%-22s %7s %7s %6s %6s %8s %8s %8s %5s %8s\n", "animation", "delay", "budget", "hsv", "keys", "avg",
+           "max", "max i2c", "load", "host us");
+
+    for (uint8_t i = 0; i < animation_LAST; i++)
+    {
+        if (only >= 0 && i != only)
+            continue;
+        ok &= run(i, frames, press_interval, csv);
+    }
+
+    if (csv)
+        fclose(csv);
+
+    return ok ? 0 : 1;
+}
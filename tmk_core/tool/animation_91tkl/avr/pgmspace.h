@@ -0,0 +1,18 @@
+/* Host stand-in for avr-libc <avr/pgmspace.h>, flash data lives in RAM. */
+#ifndef ANIMATION_91TKL_PGMSPACE_H
+#define ANIMATION_91TKL_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define pgm_read_ptr(address) (*(void *const *)(address))
+#define strlen_P strlen
+#define strcpy_P strcpy
+#define memcpy_P memcpy
+
+#endif
@@ -0,0 +1,8 @@
+/* Host stand-in for avr-libc <util/delay.h>, the model does not wait. */
+#ifndef ANIMATION_91TKL_DELAY_H
+#define ANIMATION_91TKL_DELAY_H
+
+#define _delay_ms(ms)
+#define _delay_us(us)
+
+#endif
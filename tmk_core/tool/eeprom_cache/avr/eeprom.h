@@ -0,0 +1,22 @@
+/* Host model of avr-libc <avr/eeprom.h>, see eeprom_model.c. */
+#ifndef EEPROM_MODEL_EEPROM_H
+#define EEPROM_MODEL_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+int eeprom_is_ready(void);
+void eeprom_busy_wait(void);
+
+uint8_t eeprom_read_byte(const uint8_t *addr);
+uint16_t eeprom_read_word(const uint16_t *addr);
+void eeprom_read_block(void *dst, const void *addr, size_t size);
+
+void eeprom_write_byte(uint8_t *addr, uint8_t value);
+void eeprom_write_block(const void *src, void *addr, size_t size);
+
+void eeprom_update_byte(uint8_t *addr, uint8_t value);
+void eeprom_update_word(uint16_t *addr, uint16_t value);
+void eeprom_update_block(const void *src, void *addr, size_t size);
+
+#endif
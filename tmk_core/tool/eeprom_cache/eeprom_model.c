@@ -0,0 +1,306 @@
+/*
+ * Host model of the EEPROM timing, measures the main loop blocking removed by eeprom_cache.
+ *
+ * The avr-libc EEPROM functions are replaced by a model with a simulated clock: a byte
+ * write takes 3.4 ms, a busy EEPROM blocks the caller until the write is done. The main
+ * loop is modelled as passes of -p microseconds, each pass calls eeprom_cache_task().
+ * The cached column has to stay at 0 ms, no cached write may wait for the EEPROM.
+ *
+ * Every scenario runs twice: with the writes of the firmware before the cache (direct)
+ * and through the cache and the journal of keyboard/anorak_91tkl/backlight/eeconfig_backlight.c.
+ * After the journal scenarios every journal slot has to have its sequence byte written
+ * after its data, the model exits with 1 otherwise.
+ *
+ *   make && ./eeprom_model
+ */
+
+#include "eeprom_cache.h"
+#include "eeconfig.h"
+#include "eeconfig_backlight.h"
+#include <avr/eeprom.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define EEPROM_SIZE 2048
+#define WRITE_US 3400
+
+static uint8_t  memory[EEPROM_SIZE];
+static uint32_t wear[EEPROM_SIZE];
+// number of the last write of each byte
+static uint32_t order[EEPROM_SIZE];
+static uint32_t writes;
+static uint64_t now_us;
+static uint64_t busy_until_us;
+static uint64_t blocked_us;
+static uint32_t pass_us = 1000;
+
+/*
+ * avr-libc
+ */
+
+int eeprom_is_ready(void) { return now_us >= busy_until_us; }
+
+void eeprom_busy_wait(void) {
+    if (eeprom_is_ready()) return;
+
+    blocked_us += busy_until_us - now_us;
+    now_us = busy_until_us;
+}
+
+uint8_t eeprom_read_byte(const uint8_t *addr) {
+    eeprom_busy_wait();
+    return memory[(uintptr_t)addr];
+}
+
+uint16_t eeprom_read_word(const uint16_t *addr) { return eeprom_read_byte((const uint8_t *)addr) | (eeprom_read_byte((const uint8_t *)addr + 1) << 8); }
+
+void eeprom_read_block(void *dst, const void *addr, size_t size) {
+    for (size_t i = 0; i < size; ++i) ((uint8_t *)dst)[i] = eeprom_read_byte((const uint8_t *)addr + i);
+}
+
+// starts the write and returns, like the AVR
+void eeprom_write_byte(uint8_t *addr, uint8_t value) {
+    eeprom_busy_wait();
+
+    memory[(uintptr_t)addr] = value;
+    wear[(uintptr_t)addr]++;
+    order[(uintptr_t)addr] = ++writes;
+    busy_until_us = now_us + WRITE_US;
+}
+
+void eeprom_write_block(const void *src, void *addr, size_t size) {
+    for (size_t i = 0; i < size; ++i) eeprom_write_byte((uint8_t *)addr + i, ((const uint8_t *)src)[i]);
+}
+
+void eeprom_update_byte(uint8_t *addr, uint8_t value) {
+    if (eeprom_read_byte(addr) != value) eeprom_write_byte(addr, value);
+}
+
+void eeprom_update_word(uint16_t *addr, uint16_t value) { eeprom_update_block(&value, addr, sizeof(value)); }
+
+void eeprom_update_block(const void *src, void *addr, size_t size) {
+    for (size_t i = 0; i < size; ++i) eeprom_update_byte((uint8_t *)addr + i, ((const uint8_t *)src)[i]);
+}
+
+/*
+ * main loop
+ */
+
+static void main_loop_pass(void) {
+    now_us += pass_us;
+    eeprom_cache_task();
+}
+
+struct result_t {
+    double   blocked_ms;
+    double   drain_ms;
+    uint32_t max_wear;
+};
+
+typedef void (*action_fn)(bool cached, int step);
+
+static void reset(void) {
+    memset(wear, 0, sizeof(wear));
+    memset(order, 0, sizeof(order));
+    now_us        = 0;
+    busy_until_us = 0;
+    blocked_us    = 0;
+    // the direct variants write behind the shadow
+    eeprom_cache_init();
+}
+
+// runs the action steps passes apart, then the main loop until every byte is written
+static struct result_t run(action_fn action, bool cached, int steps, int passes_between) {
+    struct result_t result = {0};
+
+    for (int step = 0; step < steps; ++step) {
+        action(cached, step);
+        for (int i = 0; i < passes_between; ++i) main_loop_pass();
+    }
+
+    result.blocked_ms = blocked_us / 1000.0;
+
+    uint64_t start = now_us;
+    while (eeprom_cache_pending() || !eeprom_is_ready()) main_loop_pass();
+    result.drain_ms = (now_us - start) / 1000.0;
+
+    for (int i = 0; i < EEPROM_SIZE; ++i)
+        if (wear[i] > result.max_wear) result.max_wear = wear[i];
+
+    return result;
+}
+
+/*
+ * scenarios, the direct variants are the writes of the firmware before the cache
+ */
+
+// the raw map of both chips, as the firmware stored it before the encoded maps
+#define MAP_SIZE_HALF 192
+#define MAP_SIZE (MAP_SIZE_HALF * 2)
+
+static uint8_t map_half[2][MAP_SIZE_HALF];
+
+static void prepare_map(int changed) {
+    for (int half = 0; half < 2; ++half)
+        for (int i = 0; i < MAP_SIZE_HALF; ++i) map_half[half][i] = rand();
+
+    eeprom_write_block(map_half, EECONFIG_BACKLIGHT_PWM_MAP, MAP_SIZE);
+    reset();
+
+    // 37 and the map size are coprime, every position is hit once
+    for (int i = 0; i < changed; ++i) {
+        int position = (i * 37) % MAP_SIZE;
+        map_half[position / MAP_SIZE_HALF][position % MAP_SIZE_HALF] ^= 0x5A;
+    }
+}
+
+static void save_map(bool cached, int step) {
+    (void)step;
+
+    for (int half = 0; half < 2; ++half) {
+        uint16_t offset = half * MAP_SIZE_HALF;
+        if (cached)
+            eeprom_cache_update_range(map_half[half], EECONFIG_BACKLIGHT_PWM_MAP + offset, MAP_SIZE_HALF);
+        else
+            eeprom_write_block(map_half[half], EECONFIG_BACKLIGHT_PWM_MAP + offset, MAP_SIZE_HALF);
+    }
+}
+
+static void save_sectors(bool cached, int step) {
+    // sector_save_state(): mask and 8 sectors, one of them changed
+    uint8_t v = step + 1;
+
+    if (cached) {
+        eeconfig_write_backlight_sectors_state(0xFF);
+        for (uint8_t s = 0; s < EECONFIG_BACKLIGHT_SECTOR_COUNT; ++s) eeconfig_write_backlight_sector_values(s, s == 3 ? v : 130, 70, 194);
+    } else {
+        eeprom_update_byte(EECONFIG_BACKLIGHT_SECTORS, 0xFF);
+        for (uint8_t s = 0; s < EECONFIG_BACKLIGHT_SECTOR_COUNT; ++s) {
+            eeprom_update_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (s * 3), s == 3 ? v : 130);
+            eeprom_update_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (s * 3) + 1, 70);
+            eeprom_update_byte(EECONFIG_BACKLIGHT_SECTOR_PWM + (s * 3) + 2, 194);
+        }
+    }
+}
+
+static void next_animation(bool cached, int step) {
+    if (cached)
+        eeconfig_write_animation_current(step % 10);
+    else
+        eeprom_update_byte(EECONFIG_BACKLIGHT_ANIMATION, step % 10);
+}
+
+static void journal_lap(bool cached, int step) {
+    // eight more journal writes come back to the slot of the first one while it is written
+    static uint8_t animation = 0;
+
+    for (int i = 0; i < ((step & 1) ? EECONFIG_BACKLIGHT_JOURNAL_SLOTS : 1); ++i) next_animation(cached, ++animation);
+}
+
+static void backlight_level(bool cached, int step) {
+    // tmk backlight.c writes the config with every level change
+    if (cached)
+        eeconfig_write_backlight(0x80 | (step % 4));
+    else
+        eeprom_write_byte(EECONFIG_BACKLIGHT, 0x80 | (step % 4));
+}
+
+static void keymap_config(bool cached, int step) {
+    if (cached)
+        eeconfig_write_keymap(step & 1);
+    else
+        eeprom_write_byte(EECONFIG_KEYMAP, step & 1);
+}
+
+static void read_settings(bool cached, int step) {
+    uint8_t settings[EEPROM_CACHE_SHADOW_SIZE];
+
+    // a map is written meanwhile
+    if (step == 0) save_map(cached, step);
+
+    if (cached)
+        eeprom_cache_read_block(settings, 0, sizeof(settings));
+    else
+        eeprom_read_block(settings, 0, sizeof(settings));
+}
+
+// the sequence byte of a slot marks its data valid, it has to be written last
+static bool journal_in_order(void) {
+    for (int slot = 0; slot < EECONFIG_BACKLIGHT_JOURNAL_SLOTS; ++slot) {
+        uintptr_t start    = (uintptr_t)EECONFIG_BACKLIGHT_JOURNAL + slot * EECONFIG_BACKLIGHT_JOURNAL_SLOT_SIZE;
+        uintptr_t sequence = start + EECONFIG_BACKLIGHT_JOURNAL_SLOT_SIZE - 1;
+
+        for (uintptr_t address = start; address < sequence; ++address)
+            if (order[address] > order[sequence]) return false;
+    }
+
+    return true;
+}
+
+static void compare(char const *name, action_fn action, int steps, int passes_between, void (*prepare)(int), int changed) {
+    struct result_t direct, cached;
+
+    if (prepare) prepare(changed);
+    reset();
+    direct = run(action, false, steps, passes_between);
+
+    if (prepare) prepare(changed);
+    reset();
+    cached = run(action, true, steps, passes_between);
+
+    printf("%-28s %10.1f %10.1f %10.1f %8u %8u\n", name, direct.blocked_ms, cached.blocked_ms, cached.drain_ms, direct.max_wear, cached.max_wear);
+}
+
+static int failed = 0;
+
+static void check_journal(char const *name) {
+    bool ok = journal_in_order();
+    printf("%-28s %s\n", name, ok ? "ok" : "FAILED");
+    if (!ok) failed++;
+}
+
+int main(int argc, char **argv) {
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:h")) != -1) {
+        switch (opt) {
+            case 'p':
+                pass_us = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-p main_loop_pass_us]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    memset(memory, 0xFF, sizeof(memory));
+    srand(91);
+
+    printf("main loop pass %u us, EEPROM write %u us, %u shadow bytes, %u ranges\n\n", pass_us, WRITE_US, EEPROM_CACHE_SHADOW_SIZE,
+           EEPROM_CACHE_RANGES);
+    printf("%-28s %10s %10s %10s %8s %8s\n", "", "direct", "cached", "drain", "wear", "wear");
+    printf("%-28s %10s %10s %10s %8s %8s\n", "scenario", "block ms", "block ms", "ms", "direct", "cached");
+
+    compare("map save, all bytes new", save_map, 1, 0, prepare_map, MAP_SIZE);
+    compare("map save, 30 bytes new", save_map, 1, 0, prepare_map, 30);
+    compare("map save, unchanged", save_map, 1, 0, prepare_map, 0);
+    compare("map save x 10 while writing", save_map, 10, 50, prepare_map, MAP_SIZE);
+    compare("settings read while writing", read_settings, 20, 1, prepare_map, MAP_SIZE);
+    compare("sector save x 20", save_sectors, 20, 50, 0, 0);
+    compare("animation next x 100", next_animation, 100, 50, 0, 0);
+    check_journal("  journal sequence last");
+    compare("backlight level x 100", backlight_level, 100, 50, 0, 0);
+    compare("journal lap x 20", journal_lap, 20, 2, 0, 0);
+    check_journal("  journal sequence last");
+    compare("keymap config x 20", keymap_config, 20, 50, 0, 0);
+
+    eeprom_cache_stats_t stats = eeprom_cache_stats();
+    printf("\ncache: %u written, %u skipped, %u refused\n", stats.written, stats.skipped, stats.refused);
+
+    (void)argc;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,8 @@
+/* Host stand-in for avr-libc <avr/pgmspace.h>, the tables of color.c live in RAM. */
+#ifndef HSV_CONVERT_PGMSPACE_H
+#define HSV_CONVERT_PGMSPACE_H
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+
+#endif
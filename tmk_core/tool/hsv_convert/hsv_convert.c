@@ -0,0 +1,307 @@
+/*
+ * Host test and benchmark of the HSV to RGB conversions in keyboard/anorak_91tkl/backlight/color.c.
+ *
+ * The tests run over all 2^24 HSV values and exit with 1 on a failure:
+ *
+ *  - rainbow is bit exact to hsv_to_rgb for grays (s = 0) and black (v = 0), elsewhere no
+ *    channel is off by more than RAINBOW_MAX_ERROR and the sectors differ only at their borders
+ *  - spectrum keeps the channel sum at 3 * floor + amplitude (the truncation of the two ramps
+ *    may lose up to 2), and both ramps end at the primaries
+ *  - the array calls give the same colors as the single calls
+ *  - cie_inverse gives the smallest value the CIE curve brings to at least the PWM value
+ *
+ * The AVR cost per pixel comes from a model: the multiplications and divisions of each
+ * conversion are counted from the code below them, the cycles per operation are those of
+ * avr-gcc on an ATmega with MUL. Calibrate it with -M/-W/-D/-B/-C/-L against the animate
+ * counter of a PERF_ENABLE build (.perf). The host ns per pixel are printed as well.
+ *
+ *   make && ./hsv_convert -n 1000
+ */
+
+#include "color.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// keys of the 91tkl, one conversion each for a full frame
+#define KEYS 91
+#define ARRAY_SIZE 17
+
+// largest channel difference of rainbow against hsv_to_rgb, found by this test
+#define RAINBOW_MAX_ERROR 10
+
+/* cost model, cycles */
+static uint16_t cycles_mul8 = 4;      // 8 x 8 bit, mul and moving the result
+static uint16_t cycles_mul16 = 12;    // 16 x 16 bit, three muls
+static uint16_t cycles_div16 = 215;   // __udivmodhi4
+static uint16_t cycles_body = 40;     // loads, sector switch and the RGB return
+static uint16_t cycles_call = 20;     // call and register saves of a single conversion
+static uint16_t cycles_loop = 10;     // pointer increments and loop of the array calls
+
+typedef struct
+{
+    const char *name;
+    uint8_t mul8;
+    uint8_t mul16;
+    uint8_t div16;
+    bool array;
+} conversion_model;
+
+static const conversion_model models[] = {
+    // region * 43, five 16 bit products of v and s, h / 43
+    { "hsv_to_rgb", 1, 5, 1, false },
+    // h * 6, five 8 bit products
+    { "rainbow", 6, 0, 0, false },
+    { "rainbow_array", 6, 0, 0, true },
+    // h * 3, floor and both ramps
+    { "spectrum", 4, 0, 0, false },
+    { "spectrum_array", 4, 0, 0, true },
+};
+
+#define MODEL_COUNT (sizeof(models) / sizeof(models[0]))
+
+static uint32_t model_cycles(conversion_model const *model)
+{
+    return model->mul8 * cycles_mul8 + model->mul16 * cycles_mul16 + model->div16 * cycles_div16 + cycles_body +
+           (model->array ? cycles_loop : cycles_call);
+}
+
+static int channel_error(RGB a, RGB b)
+{
+    int error = 0;
+
+    for (uint8_t c = 0; c < 3; c++)
+    {
+        int e = abs(a.rgb[c] - b.rgb[c]);
+        if (e > error)
+            error = e;
+    }
+
+    return error;
+}
+
+static bool test_rainbow(void)
+{
+    unsigned long histogram[256] = { 0 };
+    unsigned long failures = 0;
+    int max_error = 0;
+
+    for (uint32_t i = 0; i < (1UL << 24); i++)
+    {
+        HSV hsv = { .h = i >> 16, .s = i >> 8, .v = i };
+        RGB exact = hsv_to_rgb(hsv);
+        RGB fast = hsv_to_rgb_rainbow(hsv);
+        int error = channel_error(exact, fast);
+
+        histogram[error]++;
+        if (error > max_error)
+            max_error = error;
+
+        if ((hsv.s == 0 || hsv.v == 0) && error)
+            failures++;
+        else if (error > RAINBOW_MAX_ERROR)
+            failures++;
+    }
+
+    for (uint16_t h = 0; h < 256; h++)
+    {
+        int sector = h / 43;
+        int fast_sector = (h * 6) >> 8;
+
+        // only the last hue of a sector may already be in the next one
+        if (sector != fast_sector && (fast_sector != sector + 1 || h % 43 != 42))
+            failures++;
+    }
+
+    unsigned long above = 0;
+    for (int e = 6; e <= max_error; e++)
+        above += histogram[e];
+
+    printf("rainbow:  max error %d, exact %.1f%%, error above 5 %.2f%% %s\n", max_error,
+           100.0 * histogram[0] / (1UL << 24), 100.0 * above / (1UL << 24), failures ? "FAILED" : "ok");
+
+    return failures == 0;
+}
+
+static bool test_spectrum(void)
+{
+    unsigned long failures = 0;
+
+    for (uint32_t i = 0; i < (1UL << 24); i++)
+    {
+        HSV hsv = { .h = i >> 16, .s = i >> 8, .v = i };
+        RGB rgb = hsv_to_rgb_spectrum(hsv);
+        uint8_t floor = ((uint16_t)hsv.v * (uint8_t)(255 - hsv.s)) >> 8;
+        int sum = rgb.r + rgb.g + rgb.b;
+        int expected = 3 * floor + (hsv.v - floor);
+
+        if (sum > expected || sum < expected - 2)
+            failures++;
+        if (rgb.r < floor || rgb.g < floor || rgb.b < floor)
+            failures++;
+    }
+
+    // the sections start at red, green and blue
+    static const uint8_t starts[3] = { 0, 86, 171 };
+    for (uint8_t c = 0; c < 3; c++)
+    {
+        HSV hsv = { .h = starts[c], .s = 255, .v = 255 };
+        RGB rgb = hsv_to_rgb_spectrum(hsv);
+        if (rgb.rgb[c] < 250)
+            failures++;
+    }
+
+    printf("spectrum: channel sum within 2 of v + 2 * floor %s\n", failures ? "FAILED" : "ok");
+    return failures == 0;
+}
+
+static bool test_arrays(void)
+{
+    HSV hsv[ARRAY_SIZE];
+    RGB rgb[ARRAY_SIZE];
+    unsigned long failures = 0;
+
+    srand(1);
+    for (uint16_t round = 0; round < 10000; round++)
+    {
+        for (uint8_t i = 0; i < ARRAY_SIZE; i++)
+        {
+            hsv[i].h = rand();
+            hsv[i].s = rand();
+            hsv[i].v = rand();
+        }
+
+        hsv_to_rgb_rainbow_array(hsv, rgb, ARRAY_SIZE);
+        for (uint8_t i = 0; i < ARRAY_SIZE; i++)
+            failures += channel_error(rgb[i], hsv_to_rgb_rainbow(hsv[i])) != 0;
+
+        hsv_to_rgb_spectrum_array(hsv, rgb, ARRAY_SIZE);
+        for (uint8_t i = 0; i < ARRAY_SIZE; i++)
+            failures += channel_error(rgb[i], hsv_to_rgb_spectrum(hsv[i])) != 0;
+    }
+
+    printf("arrays:   same colors as the single calls %s\n", failures ? "FAILED" : "ok");
+    return failures == 0;
+}
+
+static bool test_cie_inverse(void)
+{
+    unsigned long failures = 0;
+
+    for (uint16_t pwm = 0; pwm < 256; pwm++)
+    {
+        uint8_t v = cie_inverse(pwm);
+        failures += g_cie_curve[v] < pwm;
+        failures += v && g_cie_curve[v - 1] >= pwm;
+    }
+
+    printf("cie:      inverse is the first value reaching the PWM value %s\n", failures ? "FAILED" : "ok");
+    return failures == 0;
+}
+
+static double seconds(struct timespec const *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static volatile uint8_t sink;
+
+static double host_ns(uint8_t index, HSV const *hsv, unsigned long rounds)
+{
+    RGB rgb[ARRAY_SIZE];
+    struct timespec start;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (unsigned long round = 0; round < rounds; round++)
+    {
+        switch (index)
+        {
+        case 0:
+            for (uint8_t i = 0; i < ARRAY_SIZE; i++)
+                rgb[i] = hsv_to_rgb(hsv[i]);
+            break;
+        case 1:
+            for (uint8_t i = 0; i < ARRAY_SIZE; i++)
+                rgb[i] = hsv_to_rgb_rainbow(hsv[i]);
+            break;
+        case 2:
+            hsv_to_rgb_rainbow_array(hsv, rgb, ARRAY_SIZE);
+            break;
+        case 3:
+            for (uint8_t i = 0; i < ARRAY_SIZE; i++)
+                rgb[i] = hsv_to_rgb_spectrum(hsv[i]);
+            break;
+        default:
+            hsv_to_rgb_spectrum_array(hsv, rgb, ARRAY_SIZE);
+            break;
+        }
+        sink += rgb[round % ARRAY_SIZE].g;
+    }
+
+    return seconds(&start) * 1e9 / rounds / ARRAY_SIZE;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -n rounds     timed rounds of %u pixels in thousands (default 1000)\n"
+            "  -M/-W/-D n    cycles per 8 bit multiplication, 16 bit multiplication and 16 bit division\n"
+            "  -B/-C/-L n    cycles per conversion, per single call and per array element\n",
+            name, ARRAY_SIZE);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long rounds = 1000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:M:W:D:B:C:L:h")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': rounds = strtoul(optarg, 0, 0); break;
+        case 'M': cycles_mul8 = strtoul(optarg, 0, 0); break;
+        case 'W': cycles_mul16 = strtoul(optarg, 0, 0); break;
+        case 'D': cycles_div16 = strtoul(optarg, 0, 0); break;
+        case 'B': cycles_body = strtoul(optarg, 0, 0); break;
+        case 'C': cycles_call = strtoul(optarg, 0, 0); break;
+        case 'L': cycles_loop = strtoul(optarg, 0, 0); break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    bool ok = test_rainbow();
+    ok &= test_spectrum();
+    ok &= test_arrays();
+    ok &= test_cie_inverse();
+
+    HSV hsv[ARRAY_SIZE];
+    for (uint8_t i = 0; i < ARRAY_SIZE; i++)
+    {
+        hsv[i].h = i * 15;
+        hsv[i].s = 255 - i;
+        hsv[i].v = 200;
+    }
+
+    printf("\n%-16s %5s %6s %4s %13s %13s %8s\n", "conversion", "mul8", "mul16", "div", "AVR cycles/px",
+           "cycles/frame", "host ns");
+
+    for (uint8_t i = 0; i < MODEL_COUNT; i++)
+    {
+        conversion_model const *model = &models[i];
+        uint32_t cycles = model_cycles(model);
+
+        printf("%-16s %5u %6u %4u %13u %13u %8.2f\n", model->name, model->mul8, model->mul16, model->div16, cycles,
+               cycles * KEYS, host_ns(i, hsv, rounds * 1000));
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,774 @@
+/*
+ * Generator of the PROGMEM lookup tables of the LED animations.
+ *
+ * Reads the physical key layout of a board from its key_led_map files:
+ *
+ *  - the position of the keys from the layout drawing in the comment of
+ *    key_led_map.c, one character is a quarter key unit,
+ *  - the matrix row and column of the keys from the KEY_TO_LED_MAP_* macro
+ *    of key_led_map.h. The macro arguments follow the drawing from left to
+ *    right and top to bottom.
+ *
+ * and writes <output>.c/.h with
+ *
+ *  - key_layout_position: position of every key in quarter key units
+ *  - key_layout_polar_<center>: distance (0..255, the farthest key is 255)
+ *    and angle (0..255, counterclockwise from the right) to every center
+ *  - key_layout_order_polar_<center>: the keys by their distance to the
+ *    center, a circle around any key is a band of it
+ *  - key_layout_hypot: distance in quarter key units by the distance of two
+ *    keys in half key units along x and y, for ripples from any key
+ *  - key_layout_neighbors: the nearest keys within 1.5 key units
+ *  - key_layout_order_x/y: the keys from left to right, top to bottom
+ *  - sin_lut and PlasmaColorSpace of the floating plasma
+ *
+ * The flash size of every table is printed and written into the .c file.
+ * Unused tables are dropped by --gc-sections of the firmware build.
+ *
+ *   ./led_layout_gen -m key_led_map.h -l key_led_map.c -o animations/animation_lut
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_KEYS        256
+#define MAX_ROWS        16
+#define MAX_COLS        32
+#define MAX_CENTERS     8
+#define MAX_NEIGHBORS   8
+#define NAME_SIZE       16
+#define LINE_SIZE       512
+
+/* quarter key units */
+#define NEIGHBOR_RANGE  6
+
+typedef struct {
+    char name[NAME_SIZE];
+    /* quarter key units */
+    int x;
+    int y;
+    int row;
+    int col;
+} key;
+
+typedef struct {
+    char name[NAME_SIZE];
+    double x;
+    double y;
+    /* placed in the middle of the keys */
+    int automatic;
+    /* distance 255 in quarter key units, rounded up */
+    int range;
+    /* the distance of every key as in the table */
+    int distance[MAX_KEYS];
+} center;
+
+static key keys[MAX_KEYS];
+static int key_count;
+static int rows;
+static int cols;
+/* index into keys or -1 */
+static int matrix[MAX_ROWS][MAX_COLS];
+
+static center centers[MAX_CENTERS];
+static int center_count;
+static int neighbor_count = 6;
+
+typedef struct {
+    char name[64];
+    unsigned bytes;
+} table_size;
+
+static table_size sizes[2 * MAX_CENTERS + 8];
+static int size_count;
+
+static void add_size(const char *name, unsigned bytes)
+{
+    snprintf(sizes[size_count].name, sizeof(sizes[size_count].name), "%s", name);
+    sizes[size_count].bytes = bytes;
+    size_count++;
+}
+
+static char *read_file(const char *file_name)
+{
+    FILE *file = fopen(file_name, "r");
+    if (!file) {
+        perror(file_name);
+        exit(2);
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *text = malloc(size + 1);
+    if (!text || fread(text, 1, size, file) != (size_t)size) {
+        fprintf(stderr, "%s: read failed\n", file_name);
+        exit(2);
+    }
+    text[size] = 0;
+    fclose(file);
+    return text;
+}
+
+/* next identifier of text, skips everything else and line continuations */
+static const char *next_token(const char *text, const char *end, char *token)
+{
+    while (text < end && !(isalnum((unsigned char)*text) || *text == '_'))
+        text++;
+
+    int length = 0;
+    while (text < end && (isalnum((unsigned char)*text) || *text == '_')) {
+        if (length < NAME_SIZE - 1)
+            token[length++] = *text;
+        text++;
+    }
+    token[length] = 0;
+    return text;
+}
+
+/*
+ * #define KEY_TO_LED_MAP_X( K5A, K5B, ... ) { { K5A, K5B, ... }, ... }
+ * the arguments in drawing order, the body places them in the matrix
+ */
+static void parse_map_macro(const char *file_name)
+{
+    char *text = read_file(file_name);
+    const char *define = strstr(text, "#define KEY_TO_LED_MAP_");
+    if (!define) {
+        fprintf(stderr, "%s: no KEY_TO_LED_MAP_ macro\n", file_name);
+        exit(2);
+    }
+
+    const char *args = strchr(define, '(');
+    const char *args_end = args ? strchr(args, ')') : 0;
+    const char *body = args_end ? strchr(args_end, '{') : 0;
+    if (!body) {
+        fprintf(stderr, "%s: malformed KEY_TO_LED_MAP_ macro\n", file_name);
+        exit(2);
+    }
+
+    char token[NAME_SIZE];
+    const char *p = args + 1;
+    for (;;) {
+        p = next_token(p, args_end, token);
+        if (!token[0])
+            break;
+        if (strcmp(token, "NLED") == 0)
+            continue;
+        if (key_count == MAX_KEYS) {
+            fprintf(stderr, "%s: more than %d keys\n", file_name, MAX_KEYS);
+            exit(2);
+        }
+        snprintf(keys[key_count].name, NAME_SIZE, "%s", token);
+        keys[key_count].row = -1;
+        key_count++;
+    }
+
+    for (int r = 0; r < MAX_ROWS; r++)
+        for (int c = 0; c < MAX_COLS; c++)
+            matrix[r][c] = -1;
+
+    /* the rows of the body: { K5A, ... }, */
+    p = body + 1;
+    for (;;) {
+        const char *row_begin = strchr(p, '{');
+        const char *macro_end = strstr(p, "\n\n");
+        if (!row_begin || (macro_end && row_begin > macro_end))
+            break;
+        const char *row_end = strchr(row_begin, '}');
+
+        if (rows == MAX_ROWS) {
+            fprintf(stderr, "%s: more than %d rows\n", file_name, MAX_ROWS);
+            exit(2);
+        }
+
+        int c = 0;
+        for (p = row_begin + 1;; c++) {
+            p = next_token(p, row_end, token);
+            if (!token[0])
+                break;
+            if (c == MAX_COLS) {
+                fprintf(stderr, "%s: more than %d columns\n", file_name, MAX_COLS);
+                exit(2);
+            }
+            for (int k = 0; k < key_count; k++) {
+                if (strcmp(keys[k].name, token) == 0) {
+                    keys[k].row = rows;
+                    keys[k].col = c;
+                    matrix[rows][c] = k;
+                }
+            }
+        }
+
+        if (cols && c != cols) {
+            fprintf(stderr, "%s: row %d has %d columns, expected %d\n", file_name, rows, c, cols);
+            exit(2);
+        }
+        cols = c;
+        rows++;
+        p = row_end + 1;
+    }
+
+    for (int k = 0; k < key_count; k++) {
+        if (keys[k].row < 0) {
+            fprintf(stderr, "%s: %s is not placed in the matrix\n", file_name, keys[k].name);
+            exit(2);
+        }
+    }
+
+    free(text);
+}
+
+/* a line of key caps: |Esc||F1 |F2 |  |PrS| */
+static int is_key_line(const char *line)
+{
+    const char *bar = strchr(line, '|');
+    if (!bar)
+        return 0;
+
+    /* border lines only have the corners and edges of the caps */
+    for (const char *p = bar; *p; p++) {
+        if (!strchr("|-,.`'", *p) && !isspace((unsigned char)*p))
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ * The first drawing in the comment of key_led_map.c, every cell between two
+ * bars is a key. Cells of less than 3 characters are gaps between the blocks.
+ * One line is half a key unit high.
+ */
+static void parse_layout_drawing(const char *file_name)
+{
+    char *text = read_file(file_name);
+    const char *comment = strstr(text, "/*");
+    const char *comment_end = comment ? strstr(comment, "*/") : 0;
+    if (!comment_end) {
+        fprintf(stderr, "%s: no layout drawing\n", file_name);
+        exit(2);
+    }
+
+    int placed = 0;
+    int line_number = 0;
+    int first_key_line = -1;
+    char line[LINE_SIZE];
+
+    for (const char *p = comment; p < comment_end; line_number++) {
+        const char *eol = strchr(p, '\n');
+        if (!eol || eol > comment_end)
+            eol = comment_end;
+
+        int length = eol - p;
+        if (length >= LINE_SIZE)
+            length = LINE_SIZE - 1;
+        memcpy(line, p, length);
+        line[length] = 0;
+        p = eol + 1;
+
+        if (!is_key_line(line))
+            continue;
+        if (first_key_line < 0)
+            first_key_line = line_number;
+
+        /* the drawing starts after the comment's leading " * " */
+        const char *origin = strchr(line, '|');
+
+        for (const char *bar = origin; (bar = strchr(bar, '|')) != 0;) {
+            const char *next = strchr(bar + 1, '|');
+            if (!next)
+                break;
+
+            if (next - bar - 1 >= 3) {
+                if (placed == key_count) {
+                    fprintf(stderr, "%s: the drawing has more keys than the macro (%d)\n", file_name, key_count);
+                    exit(2);
+                }
+                /* center of the cell, the bars are shared with the neighbors */
+                keys[placed].x = (int)((bar - origin) + (next - origin));
+                keys[placed].y = (line_number - first_key_line) * 2;
+                placed++;
+            }
+            bar = next;
+        }
+    }
+
+    if (placed != key_count) {
+        fprintf(stderr, "%s: the drawing has %d keys, the macro %d\n", file_name, placed, key_count);
+        exit(2);
+    }
+
+    /* a cell is 4 characters wide including one bar, 2 x center gives half characters */
+    int min_x = 0x7FFF;
+    for (int k = 0; k < key_count; k++) {
+        keys[k].x /= 2;
+        if (keys[k].x < min_x)
+            min_x = keys[k].x;
+    }
+    /* the left key's center at half a key */
+    for (int k = 0; k < key_count; k++)
+        keys[k].x = keys[k].x - min_x + 2;
+
+    free(text);
+}
+
+static void add_center(const char *argument)
+{
+    if (center_count == MAX_CENTERS) {
+        fprintf(stderr, "more than %d centers\n", MAX_CENTERS);
+        exit(2);
+    }
+
+    center *c = &centers[center_count];
+    const char *equal = strchr(argument, '=');
+    int length = equal ? equal - argument : (int)strlen(argument);
+
+    if (length == 0 || length >= NAME_SIZE) {
+        fprintf(stderr, "bad center: %s\n", argument);
+        exit(2);
+    }
+    memcpy(c->name, argument, length);
+    c->name[length] = 0;
+
+    if (!equal) {
+        c->automatic = 1;
+    } else if (sscanf(equal + 1, "%lf,%lf", &c->x, &c->y) != 2) {
+        fprintf(stderr, "bad center: %s, expected name=x,y in key units\n", argument);
+        exit(2);
+    } else {
+        /* quarter key units */
+        c->x *= 4;
+        c->y *= 4;
+    }
+    center_count++;
+}
+
+static double key_distance(int a, int b)
+{
+    return hypot(keys[a].x - keys[b].x, keys[a].y - keys[b].y);
+}
+
+static int key_index(int k)
+{
+    return keys[k].row * cols + keys[k].col;
+}
+
+static void write_matrix_begin(FILE *c_file, const char *declaration)
+{
+    fprintf(c_file, "\nconst %s[%d][%d] PROGMEM = {\n", declaration, rows, cols);
+}
+
+static void write_position(FILE *c_file)
+{
+    write_matrix_begin(c_file, "key_layout_point key_layout_position");
+    for (int r = 0; r < rows; r++) {
+        fprintf(c_file, "    {");
+        for (int c = 0; c < cols; c++) {
+            int k = matrix[r][c];
+            if (k < 0)
+                fprintf(c_file, " { NLED, NLED },");
+            else
+                fprintf(c_file, " { %3d, %3d },", keys[k].x, keys[k].y);
+        }
+        fprintf(c_file, " },\n");
+    }
+    fprintf(c_file, "};\n");
+    add_size("key_layout_position", rows * cols * 2);
+}
+
+static void write_polar(FILE *c_file, center *center)
+{
+    if (center->automatic) {
+        int min_x = 0x7FFF, max_x = 0, min_y = 0x7FFF, max_y = 0;
+        for (int k = 0; k < key_count; k++) {
+            if (keys[k].x < min_x) min_x = keys[k].x;
+            if (keys[k].x > max_x) max_x = keys[k].x;
+            if (keys[k].y < min_y) min_y = keys[k].y;
+            if (keys[k].y > max_y) max_y = keys[k].y;
+        }
+        center->x = (min_x + max_x) / 2.0;
+        center->y = (min_y + max_y) / 2.0;
+    }
+
+    double max_distance = 0;
+    for (int k = 0; k < key_count; k++) {
+        double d = hypot(keys[k].x - center->x, keys[k].y - center->y);
+        if (d > max_distance)
+            max_distance = d;
+    }
+
+    center->range = (int)ceil(max_distance);
+
+    char declaration[NAME_SIZE + 40];
+    snprintf(declaration, sizeof(declaration), "key_layout_polar key_layout_polar_%.*s", NAME_SIZE - 1, center->name);
+
+    fprintf(c_file, "\n// center %.2f, %.2f key units\n", center->x / 4, center->y / 4);
+    write_matrix_begin(c_file, declaration);
+    for (int r = 0; r < rows; r++) {
+        fprintf(c_file, "    {");
+        for (int c = 0; c < cols; c++) {
+            int k = matrix[r][c];
+            if (k < 0) {
+                fprintf(c_file, " { 0, 0 },");
+                continue;
+            }
+            double dx = keys[k].x - center->x;
+            /* y of the drawing grows downwards */
+            double dy = center->y - keys[k].y;
+            int distance = max_distance > 0 ? (int)lround(hypot(dx, dy) * 255 / max_distance) : 0;
+            int angle = (int)lround(atan2(dy, dx) * 128 / M_PI) & 0xFF;
+            center->distance[k] = distance;
+            fprintf(c_file, " { %3d, %3d },", distance, angle);
+        }
+        fprintf(c_file, " },\n");
+    }
+    fprintf(c_file, "};\n");
+
+    add_size(declaration + strlen("key_layout_polar "), rows * cols * 2);
+
+    /* insertion sort by the distance in the table, the firmware searches the order by it */
+    int order[MAX_KEYS];
+    for (int k = 0; k < key_count; k++) {
+        int i = k;
+        for (; i > 0 && center->distance[order[i - 1]] > center->distance[k]; i--)
+            order[i] = order[i - 1];
+        order[i] = k;
+    }
+
+    char name[NAME_SIZE + 40];
+    snprintf(name, sizeof(name), "key_layout_order_polar_%.*s", NAME_SIZE - 1, center->name);
+    fprintf(c_file, "\nconst uint8_t %s[KEY_LAYOUT_KEYS] PROGMEM = {", name);
+    for (int i = 0; i < key_count; i++)
+        fprintf(c_file, "%s%3d,", i % 16 ? " " : "\n    ", key_index(order[i]));
+    fprintf(c_file, "\n};\n");
+    add_size(name, key_count);
+}
+
+/* the include of the map header from the directory of the output, both may be relative to the working directory */
+static void map_include(char *include, size_t size, const char *map_name, const char *output)
+{
+    char map_path[PATH_MAX];
+    char output_dir[PATH_MAX];
+    char output_path[PATH_MAX];
+
+    snprintf(output_dir, sizeof(output_dir), "%s", output);
+    char *slash = strrchr(output_dir, '/');
+    if (slash)
+        *slash = 0;
+    else
+        strcpy(output_dir, ".");
+
+    if (!realpath(map_name, map_path) || !realpath(output_dir, output_path)) {
+        perror(map_name);
+        exit(2);
+    }
+
+    /* the common directories, then one ../ for every directory left in the output path */
+    size_t common = 0;
+    for (size_t i = 0; map_path[i] == output_path[i] || (!output_path[i] && map_path[i] == '/'); i++) {
+        if (map_path[i] == '/')
+            common = i;
+        if (!output_path[i])
+            break;
+    }
+
+    include[0] = 0;
+    for (const char *p = output_path + common; *p; p++) {
+        if (*p == '/')
+            strncat(include, "../", size - strlen(include) - 1);
+    }
+    strncat(include, map_path + common + 1, size - strlen(include) - 1);
+}
+
+static void write_hypot(FILE *c_file, int *width, int *height)
+{
+    int max_x = 0, max_y = 0;
+    for (int k = 0; k < key_count; k++) {
+        if (keys[k].x > max_x) max_x = keys[k].x;
+        if (keys[k].y > max_y) max_y = keys[k].y;
+    }
+
+    /* half key units */
+    *width = max_x / 2 + 1;
+    *height = max_y / 2 + 1;
+
+    fprintf(c_file, "\nconst uint8_t key_layout_hypot[%d][%d] PROGMEM = {\n", *height, *width);
+    for (int y = 0; y < *height; y++) {
+        fprintf(c_file, "    {");
+        for (int x = 0; x < *width; x++) {
+            long d = lround(hypot(x * 2, y * 2));
+            fprintf(c_file, "%s%3ld,", x % 16 ? " " : (x ? "\n     " : " "), d > 255 ? 255 : d);
+        }
+        fprintf(c_file, " },\n");
+    }
+    fprintf(c_file, "};\n");
+    add_size("key_layout_hypot", *width * *height);
+}
+
+static void write_neighbors(FILE *c_file)
+{
+    fprintf(c_file, "\nconst uint8_t key_layout_neighbors[%d][%d][KEY_LAYOUT_NEIGHBORS] PROGMEM = {\n", rows, cols);
+    for (int r = 0; r < rows; r++) {
+        fprintf(c_file, "    {\n");
+        for (int c = 0; c < cols; c++) {
+            int k = matrix[r][c];
+            int found[MAX_NEIGHBORS];
+            int found_count = 0;
+
+            /* insertion sort of the nearest keys in range */
+            for (int n = 0; k >= 0 && n < key_count; n++) {
+                double d = key_distance(k, n);
+                if (n == k || d > NEIGHBOR_RANGE)
+                    continue;
+
+                int i = found_count < neighbor_count ? found_count++ : neighbor_count;
+                while (i > 0 && key_distance(k, found[i - 1]) > d) {
+                    if (i < neighbor_count)
+                        found[i] = found[i - 1];
+                    i--;
+                }
+                if (i < neighbor_count)
+                    found[i] = n;
+            }
+
+            fprintf(c_file, "        {");
+            for (int i = 0; i < neighbor_count; i++) {
+                if (i < found_count)
+                    fprintf(c_file, " %3d,", key_index(found[i]));
+                else
+                    fprintf(c_file, " NLED,");
+            }
+            fprintf(c_file, " },\n");
+        }
+        fprintf(c_file, "    },\n");
+    }
+    fprintf(c_file, "};\n");
+    add_size("key_layout_neighbors", rows * cols * neighbor_count);
+}
+
+static int compare_x(const void *a, const void *b)
+{
+    const key *ka = &keys[*(const int *)a];
+    const key *kb = &keys[*(const int *)b];
+    return ka->x != kb->x ? ka->x - kb->x : ka->y - kb->y;
+}
+
+static int compare_y(const void *a, const void *b)
+{
+    const key *ka = &keys[*(const int *)a];
+    const key *kb = &keys[*(const int *)b];
+    return ka->y != kb->y ? ka->y - kb->y : ka->x - kb->x;
+}
+
+static void write_order(FILE *c_file, const char *name, int (*compare)(const void *, const void *))
+{
+    int order[MAX_KEYS];
+
+    for (int k = 0; k < key_count; k++)
+        order[k] = k;
+    qsort(order, key_count, sizeof(order[0]), compare);
+
+    fprintf(c_file, "\nconst uint8_t %s[KEY_LAYOUT_KEYS] PROGMEM = {", name);
+    for (int i = 0; i < key_count; i++)
+        fprintf(c_file, "%s%3d,", i % 16 ? " " : "\n    ", key_index(order[i]));
+    fprintf(c_file, "\n};\n");
+    add_size(name, key_count);
+}
+
+/* (1 - cos) / 2 over one period, 10 bit */
+static void write_sin(FILE *c_file)
+{
+    fprintf(c_file, "\nconst uint16_t sin_lut[256] PROGMEM = {");
+    for (int i = 0; i < 256; i++) {
+        long value = lround(1023 * (1 - cos(2 * M_PI * i / 256)) / 2);
+        fprintf(c_file, "%s%4ld,", i % 16 ? " " : "\n    ", value);
+    }
+    fprintf(c_file, "\n};\n");
+    add_size("sin_lut", 256 * 2);
+}
+
+/* green -> red -> blue -> green, 256 steps each */
+static void write_plasma(FILE *c_file)
+{
+    fprintf(c_file, "\nconst uint8_t PlasmaColorSpace[3 * 3 * 256] PROGMEM = {");
+    for (int i = 0; i < 3 * 256; i++) {
+        int j = i & 0xFF;
+        int rgb[3];
+
+        switch (i >> 8) {
+        case 0: rgb[0] = j;       rgb[1] = 255 - j; rgb[2] = 0;       break;
+        case 1: rgb[0] = 255 - j; rgb[1] = 0;       rgb[2] = j;       break;
+        default: rgb[0] = 0;      rgb[1] = j;       rgb[2] = 255 - j; break;
+        }
+        fprintf(c_file, "%s%3d, %3d, %3d,", i % 4 ? "  " : "\n    ", rgb[0], rgb[1], rgb[2]);
+    }
+    fprintf(c_file, "\n};\n");
+    add_size("PlasmaColorSpace", 3 * 3 * 256);
+}
+
+static void write_header(FILE *h_file, const char *guard, const char *command, const char *map_header, int hypot_width,
+                         int hypot_height)
+{
+    fprintf(h_file, "/* Generated by tmk_core/tool/led_layout/led_layout_gen, do not edit.\n *   %s\n */\n\n", command);
+    fprintf(h_file, "#ifndef %s\n#define %s\n\n", guard, guard);
+    fprintf(h_file, "#include \"%s\"\n#include <inttypes.h>\n#include <avr/pgmspace.h>\n\n", map_header);
+    fprintf(h_file, "#if MATRIX_ROWS != %d || MATRIX_COLS != %d\n#error \"generated for a %dx%d matrix\"\n#endif\n\n",
+            rows, cols, rows, cols);
+    fprintf(h_file, "// keys with a position\n#define KEY_LAYOUT_KEYS %d\n", key_count);
+    fprintf(h_file, "#define KEY_LAYOUT_NEIGHBORS %d\n", neighbor_count);
+    fprintf(h_file, "#define KEY_LAYOUT_HYPOT_WIDTH %d\n#define KEY_LAYOUT_HYPOT_HEIGHT %d\n\n", hypot_width,
+            hypot_height);
+    for (int i = 0; i < center_count; i++) {
+        char upper[NAME_SIZE];
+        int n = 0;
+        for (; centers[i].name[n]; n++)
+            upper[n] = toupper((unsigned char)centers[i].name[n]);
+        upper[n] = 0;
+        fprintf(h_file, "// quarter key units of the polar distance 255\n#define KEY_LAYOUT_POLAR_%s_RANGE %d\n", upper,
+                centers[i].range);
+    }
+    fprintf(h_file, "\n");
+    fprintf(h_file, "// center of a key in quarter key units, NLED if there is no key\n");
+    fprintf(h_file, "typedef struct\n{\n    uint8_t x;\n    uint8_t y;\n} key_layout_point;\n\n");
+    fprintf(h_file, "// distance 0..255 (the farthest key is 255), angle 0..255 counterclockwise from the right\n");
+    fprintf(h_file, "typedef struct\n{\n    uint8_t distance;\n    uint8_t angle;\n} key_layout_polar;\n\n");
+
+    fprintf(h_file, "extern const key_layout_point key_layout_position[%d][%d] PROGMEM;\n", rows, cols);
+    for (int i = 0; i < center_count; i++) {
+        fprintf(h_file, "extern const key_layout_polar key_layout_polar_%s[%d][%d] PROGMEM;\n", centers[i].name, rows,
+                cols);
+        fprintf(h_file, "// row * MATRIX_COLS + col of the keys by their distance to the center\n");
+        fprintf(h_file, "extern const uint8_t key_layout_order_polar_%s[KEY_LAYOUT_KEYS] PROGMEM;\n", centers[i].name);
+    }
+    fprintf(h_file, "// [dy][dx] in half key units, the distance in quarter key units\n");
+    fprintf(h_file, "extern const uint8_t key_layout_hypot[KEY_LAYOUT_HYPOT_HEIGHT][KEY_LAYOUT_HYPOT_WIDTH] PROGMEM;\n");
+    fprintf(h_file, "// row * MATRIX_COLS + col of the nearest keys within 1.5 key units, NLED padded\n");
+    fprintf(h_file, "extern const uint8_t key_layout_neighbors[%d][%d][KEY_LAYOUT_NEIGHBORS] PROGMEM;\n", rows, cols);
+    fprintf(h_file, "// row * MATRIX_COLS + col of the keys from left to right and from top to bottom\n");
+    fprintf(h_file, "extern const uint8_t key_layout_order_x[KEY_LAYOUT_KEYS] PROGMEM;\n");
+    fprintf(h_file, "extern const uint8_t key_layout_order_y[KEY_LAYOUT_KEYS] PROGMEM;\n\n");
+    fprintf(h_file, "extern const uint16_t sin_lut[256] PROGMEM;\n");
+    fprintf(h_file, "extern const uint8_t PlasmaColorSpace[3 * 3 * 256] PROGMEM;\n\n");
+    fprintf(h_file, "#endif\n");
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s -m key_led_map.h -l key_led_map.c -o output [options]\n"
+            "  -m file       header with the KEY_TO_LED_MAP_ macro\n"
+            "  -l file       source with the layout drawing in its first comment\n"
+            "  -o output     writes output.c and output.h\n"
+            "  -c name[=x,y] polar table to a center in key units, default: center of the keys\n"
+            "  -n count      neighbors per key, at most %d (default 6)\n",
+            name, MAX_NEIGHBORS);
+}
+
+int main(int argc, char **argv)
+{
+    const char *map_name = 0;
+    const char *layout_name = 0;
+    const char *output = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "m:l:o:c:n:h")) != -1) {
+        switch (opt) {
+        case 'm': map_name = optarg; break;
+        case 'l': layout_name = optarg; break;
+        case 'o': output = optarg; break;
+        case 'c': add_center(optarg); break;
+        case 'n': neighbor_count = atoi(optarg); break;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (!map_name || !layout_name || !output || neighbor_count < 1 || neighbor_count > MAX_NEIGHBORS) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (center_count == 0)
+        add_center("center");
+
+    parse_map_macro(map_name);
+    parse_layout_drawing(layout_name);
+
+    /* the command line without directories, the output does not depend on where it ran */
+    char command[LINE_SIZE] = "led_layout_gen";
+    for (int i = 1; i < argc; i++) {
+        const char *slash = strrchr(argv[i], '/');
+        strncat(command, " ", sizeof(command) - strlen(command) - 1);
+        strncat(command, slash && argv[i][0] != '-' ? slash + 1 : argv[i], sizeof(command) - strlen(command) - 1);
+    }
+
+    char c_name[LINE_SIZE];
+    char h_name[LINE_SIZE];
+    snprintf(c_name, sizeof(c_name), "%s.c", output);
+    snprintf(h_name, sizeof(h_name), "%s.h", output);
+
+    const char *base = strrchr(output, '/') ? strrchr(output, '/') + 1 : output;
+    char guard[LINE_SIZE];
+    int i = 0;
+    for (; base[i] && i < LINE_SIZE - 3; i++)
+        guard[i] = toupper((unsigned char)base[i]);
+    strcpy(guard + i, "_H");
+
+    FILE *c_file = fopen(c_name, "w");
+    if (!c_file) {
+        perror(c_name);
+        return 2;
+    }
+
+    /* the tables go to a buffer first, the sizes are written in front of them */
+    char *tables = 0;
+    size_t tables_size = 0;
+    FILE *table_file = open_memstream(&tables, &tables_size);
+    int hypot_width, hypot_height;
+
+    write_position(table_file);
+    for (int c = 0; c < center_count; c++)
+        write_polar(table_file, &centers[c]);
+    write_hypot(table_file, &hypot_width, &hypot_height);
+    write_neighbors(table_file);
+    write_order(table_file, "key_layout_order_x", compare_x);
+    write_order(table_file, "key_layout_order_y", compare_y);
+    write_sin(table_file);
+    write_plasma(table_file);
+    fclose(table_file);
+
+    unsigned total = 0;
+    fprintf(c_file, "/* Generated by tmk_core/tool/led_layout/led_layout_gen, do not edit.\n *   %s\n *\n", command);
+    fprintf(c_file, " * flash bytes per table, only referenced tables are linked:\n");
+    printf("%d keys in a %dx%d matrix\n\n%-30s %6s\n", key_count, rows, cols, "table", "flash");
+    for (int s = 0; s < size_count; s++) {
+        fprintf(c_file, " *   %-30s %5u\n", sizes[s].name, sizes[s].bytes);
+        printf("%-30s %6u\n", sizes[s].name, sizes[s].bytes);
+        total += sizes[s].bytes;
+    }
+    fprintf(c_file, " *   %-30s %5u\n */\n\n", "total", total);
+    printf("%-30s %6u\n", "total", total);
+
+    fprintf(c_file, "#include \"%s.h\"\n", base);
+    fputs(tables, c_file);
+    fclose(c_file);
+    free(tables);
+
+    FILE *h_file = fopen(h_name, "w");
+    if (!h_file) {
+        perror(h_name);
+        return 2;
+    }
+    char map_header[LINE_SIZE];
+    map_include(map_header, sizeof(map_header), map_name, output);
+    write_header(h_file, guard, command, map_header, hypot_width, hypot_height);
+    fclose(h_file);
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Host check of the bitboard game of life in common/led_matrix/conway_rows.h.
+ *
+ * conway_next_row() is compared row by row with the rule counted cell by cell,
+ * on random boards of 7, 8, 16, 17 and 32 columns: the first and the last
+ * width of every matrix_row_t type. Each width is built from
+ * conway_check_width.c, see CONWAY_WIDTHS in the Makefile. The tool exits
+ * with 1 on a failure.
+ *
+ *   make && ./conway_check -n 100000
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+unsigned long conway_check_7(unsigned long boards);
+unsigned long conway_check_8(unsigned long boards);
+unsigned long conway_check_16(unsigned long boards);
+unsigned long conway_check_17(unsigned long boards);
+unsigned long conway_check_32(unsigned long boards);
+
+static const struct {
+    unsigned cols;
+    unsigned long (*check)(unsigned long boards);
+} widths[] = {
+    { 7, conway_check_7 },
+    { 8, conway_check_8 },
+    { 16, conway_check_16 },
+    { 17, conway_check_17 },
+    { 32, conway_check_32 },
+};
+
+int main(int argc, char **argv)
+{
+    unsigned long boards = 100000;
+    bool ok = true;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+        case 'n': boards = strtoul(optarg, 0, 0); break;
+        default:
+            fprintf(stderr, "usage: %s [-n boards]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    srand(1);
+
+    for (unsigned i = 0; i < sizeof(widths) / sizeof(widths[0]); i++) {
+        unsigned long failures = widths[i].check(boards);
+
+        printf("%2u columns: %lu boards, %lu rows off the reference rule %s\n", widths[i].cols, boards, failures,
+               failures ? "FAILED" : "ok");
+        ok &= failures == 0;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+/*
+ * One board width of conway_check, built once per width by the Makefile with
+ * MATRIX_COLS and CONWAY_CHECK set, so matrix_row_t is the type of that width.
+ */
+
+#include "led_matrix/conway_rows.h"
+#include <stdlib.h>
+
+#define ROWS 6
+
+static bool cell(matrix_row_t const *board, int row, int col)
+{
+    row = (row + ROWS) % ROWS;
+    col = (col + MATRIX_COLS) % MATRIX_COLS;
+    return (board[row] >> col) & 1;
+}
+
+/* the rule cell by cell: born with 3 neighbors, survives with 2 or 3 */
+static matrix_row_t reference_row(matrix_row_t const *board, int row)
+{
+    matrix_row_t next = 0;
+
+    for (int col = 0; col < MATRIX_COLS; col++) {
+        int neighbors = 0;
+
+        for (int dr = -1; dr <= 1; dr++) {
+            for (int dc = -1; dc <= 1; dc++) {
+                if (dr || dc)
+                    neighbors += cell(board, row + dr, col + dc);
+            }
+        }
+
+        if (neighbors == 3 || (neighbors == 2 && cell(board, row, col)))
+            next |= (matrix_row_t)1 << col;
+    }
+
+    return next;
+}
+
+/* random boards from empty to full, returns the rows that differ from the reference */
+unsigned long CONWAY_CHECK(unsigned long boards)
+{
+    matrix_row_t board[ROWS];
+    unsigned long failures = 0;
+
+    for (unsigned long n = 0; n < boards; n++) {
+        // one in density cells alive, 1 is a full board
+        int density = 1 + n % 8;
+
+        for (int row = 0; row < ROWS; row++) {
+            board[row] = 0;
+            for (int col = 0; col < MATRIX_COLS; col++) {
+                if (n % 16 != 15 && rand() % density == 0)
+                    board[row] |= (matrix_row_t)1 << col;
+            }
+        }
+
+        for (int row = 0; row < ROWS; row++) {
+            matrix_row_t next = conway_next_row(board[(row + ROWS - 1) % ROWS], board[row], board[(row + 1) % ROWS]);
+
+            if (next != reference_row(board, row) || (next & ~CONWAY_ROW_MASK))
+                failures++;
+        }
+    }
+
+    return failures;
+}
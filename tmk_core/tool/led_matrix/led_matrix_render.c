@@ -0,0 +1,386 @@
+/*
+ * Host renderer and frame time profiler for the led_matrix animations.
+ *
+ * Runs the animations of tmk_core/common/led_matrix on a RAM surface with
+ * simulated key presses, writes the frames as PPM images and estimates the
+ * cost of every frame on the target:
+ *
+ *  - AVR cycles from a cost model: cycles per surface call, per particle of
+ *    the particle engine (moved, emitted and rendered) plus the CPU side of
+ *    the PWM upload of the board. The model is rough, calibrate it with
+ *    -S/-G/-U/-P/-E/-R against the animate counter of a PERF_ENABLE build
+ *    (!perf). The particle calls are wrapped by the linker.
+ *  - I2C bytes and bus time of the upload of the board's LED driver(s).
+ *
+ * An animation whose worst frame does not fit into its delay_in_ms is
+ * flagged and the tool exits with 1, so it can run before flashing.
+ *
+ *   make && ./led_matrix_render -b 91tkl -n 300 -o frames/
+ */
+
+#include "led_matrix/led_matrix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#define F_CPU           16000000UL
+/* TWBR 0x0C, no prescaler: 16 MHz / (16 + 2 * 12) */
+#define F_SCL           400000UL
+/* 8 data bits and the ack */
+#define BITS_PER_BYTE   9
+/* start and stop condition of every transaction */
+#define BITS_PER_TRANSACTION 2
+
+#define PIXEL_SCALE     8
+#define MAX_ROWS        16
+#define MAX_COLS        32
+
+typedef struct {
+    const char *name;
+    uint8_t rows;
+    uint8_t cols;
+    uint8_t flags;
+    /* I2C traffic of one commit */
+    uint16_t i2c_bytes;
+    uint16_t i2c_transactions;
+    /* PWM bytes prepared by the CPU for one commit */
+    uint16_t upload_bytes;
+} board_model;
+
+static const board_model boards[] = {
+    /*
+     * 2x IS31FL3733: unlock and page select (2 x 3 bytes),
+     * 12 SW lines of address, register and 16 PWM bytes
+     */
+    { "91tkl", 6, 17, LED_SURFACE_RGB, 2 * (6 + 12 * 18), 2 * (2 + 12), 2 * 192 },
+    /* IS31FL3731 per half: bank select, 9 rows of address, register and 16 PWM bytes */
+    { "splitbrain", 6, 18, 0, 3 + 9 * 18, 1 + 9, 144 },
+    { "kiibohd", 5, 7, 0, 3 + 9 * 18, 1 + 9, 144 },
+};
+
+/* cost model, cycles */
+static uint16_t cycles_per_set = 70;
+static uint16_t cycles_per_get = 60;
+static uint16_t cycles_per_upload_byte = 24;
+/* age, accelerate, move and bounds check, or the swap of a kill */
+static uint16_t cycles_per_particle_update = 90;
+/* three random8() and two of them through __udivmodqi4 */
+static uint16_t cycles_per_particle_emit = 260;
+/* heat index (one mul), life * gain and the saturation */
+static uint16_t cycles_per_particle_render = 40;
+
+static const board_model *board;
+static matrix_row_t keys[MAX_ROWS];
+
+typedef struct {
+    uint32_t sets;
+    uint32_t gets;
+    uint32_t commits;
+    uint32_t particle_updates;
+    uint32_t particle_emits;
+    uint32_t particle_renders;
+} frame_stats;
+
+static led_surface buffer_surface;
+static led_surface profile_surface;
+static frame_stats stats;
+static uint8_t frame_buffer[MAX_ROWS * MAX_COLS * 3];
+
+bool matrix_is_on(uint8_t row, uint8_t col)
+{
+    return (keys[row] & ((matrix_row_t)1 << col)) != 0;
+}
+
+static void profile_set(led_surface *surface, uint8_t row, uint8_t col, led_pixel pixel)
+{
+    stats.sets++;
+    buffer_surface.set(&buffer_surface, row, col, pixel);
+}
+
+static bool profile_get(led_surface *surface, uint8_t row, uint8_t col, led_pixel *pixel)
+{
+    stats.gets++;
+    return buffer_surface.get(&buffer_surface, row, col, pixel);
+}
+
+static void profile_commit(led_surface *surface)
+{
+    stats.commits++;
+    buffer_surface.commit(&buffer_surface);
+}
+
+/*
+ * particles, the calls of the animations into particles.c are wrapped by the linker
+ */
+
+void __real_particles_update(particle_system *ps, uint8_t rows, uint8_t cols);
+void __real_particles_render(particle_system const *ps, uint8_t *heat, uint8_t cols, uint8_t gain);
+
+void __wrap_particles_update(particle_system *ps, uint8_t rows, uint8_t cols)
+{
+    static particle_system survivors;
+
+    // the survivors come from a copy without emitters, that neither emits nor draws a random number
+    survivors = *ps;
+    memset(survivors.emitters, 0, sizeof(survivors.emitters));
+    __real_particles_update(&survivors, rows, cols);
+
+    stats.particle_updates += ps->count;
+    __real_particles_update(ps, rows, cols);
+    stats.particle_emits += ps->count - survivors.count;
+}
+
+void __wrap_particles_render(particle_system const *ps, uint8_t *heat, uint8_t cols, uint8_t gain)
+{
+    stats.particle_renders += ps->count;
+    __real_particles_render(ps, heat, cols, gain);
+}
+
+static void surface_init(void)
+{
+    led_surface_buffer_init(&buffer_surface, frame_buffer, board->rows, board->cols, board->flags);
+
+    profile_surface = buffer_surface;
+    profile_surface.set = &profile_set;
+    profile_surface.get = &profile_get;
+    profile_surface.commit = &profile_commit;
+}
+
+static uint32_t frame_cycles(frame_stats const *s)
+{
+    return s->sets * cycles_per_set + s->gets * cycles_per_get + s->commits * board->upload_bytes * cycles_per_upload_byte +
+           s->particle_updates * cycles_per_particle_update + s->particle_emits * cycles_per_particle_emit +
+           s->particle_renders * cycles_per_particle_render;
+}
+
+static uint32_t frame_i2c_cycles(frame_stats const *s)
+{
+    uint32_t bits = s->commits * ((uint32_t)board->i2c_bytes * BITS_PER_BYTE + board->i2c_transactions * BITS_PER_TRANSACTION);
+    return bits * (F_CPU / F_SCL);
+}
+
+static void write_frame(const char *prefix, const char *name, uint32_t frame)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s_%05u.ppm", prefix, name, frame);
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        exit(2);
+    }
+
+    fprintf(f, "P6\n%u %u\n255\n", board->cols * PIXEL_SCALE, board->rows * PIXEL_SCALE);
+
+    for (uint16_t y = 0; y < board->rows * PIXEL_SCALE; y++) {
+        for (uint16_t x = 0; x < board->cols * PIXEL_SCALE; x++) {
+            led_pixel pixel;
+            buffer_surface.get(&buffer_surface, y / PIXEL_SCALE, x / PIXEL_SCALE, &pixel);
+            fputc(pixel.r, f);
+            fputc(pixel.g, f);
+            fputc(pixel.b, f);
+        }
+    }
+
+    fclose(f);
+}
+
+static void dispatch_events(led_matrix_animation const *animation)
+{
+    led_matrix_key_event event;
+
+    while (led_matrix_event_pop(&event))
+        animation->key_event(&profile_surface, &event);
+}
+
+/* a key goes down every press_interval frames and stays down for a few frames */
+static void simulate_keys(led_matrix_animation const *animation, uint32_t frame, uint16_t press_interval)
+{
+    static uint8_t down_row;
+    static uint8_t down_col;
+    static uint8_t down_frames;
+
+    if (down_frames && --down_frames == 0) {
+        keys[down_row] &= ~((matrix_row_t)1 << down_col);
+        led_matrix_event_row(LED_MATRIX_EVENT_SOURCE_LOCAL, down_row, keys[down_row], frame);
+    }
+
+    if (press_interval && frame % press_interval == 0 && !down_frames) {
+        down_row = rand() % board->rows;
+        down_col = rand() % board->cols;
+        down_frames = 3;
+        keys[down_row] |= ((matrix_row_t)1 << down_col);
+        led_matrix_event_row(LED_MATRIX_EVENT_SOURCE_LOCAL, down_row, keys[down_row], frame);
+    }
+
+    dispatch_events(animation);
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool run(led_matrix_animation const *animation, uint32_t frames, uint16_t press_interval, const char *prefix, FILE *csv)
+{
+    uint32_t budget = (uint32_t)animation->delay_in_ms * (F_CPU / 1000);
+    uint64_t sum_cycles = 0;
+    uint32_t max_cycles = 0;
+    uint32_t max_i2c = 0;
+    uint32_t dropped = 0;
+    uint64_t native_ns = 0;
+
+    srand(1);
+    memset(keys, 0, sizeof(keys));
+    for (uint8_t row = 0; row < MAX_ROWS; row++)
+        led_matrix_event_row(LED_MATRIX_EVENT_SOURCE_LOCAL, row, 0, 0);
+    led_matrix_event_clear();
+    surface_init();
+
+    led_matrix_state = animation->state_size ? calloc(1, animation->state_size) : 0;
+
+    memset(&stats, 0, sizeof(stats));
+    animation->start(&profile_surface);
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        memset(&stats, 0, sizeof(stats));
+
+        uint64_t t = now_ns();
+        simulate_keys(animation, frame, press_interval);
+        animation->loop(&profile_surface);
+        native_ns += now_ns() - t;
+
+        uint32_t cycles = frame_cycles(&stats);
+        uint32_t i2c = frame_i2c_cycles(&stats);
+
+        // the upload runs from the TWI interrupt, but has to be done before the next frame starts
+        bool drop = cycles + i2c > budget;
+
+        sum_cycles += cycles;
+        if (cycles > max_cycles)
+            max_cycles = cycles;
+        if (i2c > max_i2c)
+            max_i2c = i2c;
+        if (drop)
+            dropped++;
+
+        if (csv)
+            fprintf(csv, "%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", animation->name, frame, stats.sets, stats.gets,
+                    stats.commits, stats.particle_updates, stats.particle_emits, stats.particle_renders, cycles, i2c, drop);
+
+        if (prefix)
+            write_frame(prefix, animation->name, frame);
+    }
+
+    free(led_matrix_state);
+    led_matrix_state = 0;
+
+    uint32_t avg = frames ? sum_cycles / frames : 0;
+    bool flagged = max_cycles + max_i2c > budget;
+
+    printf("%-16s %5u ms %9u %9u %9u %5u%% %6u/%-6u %8.1f %s\n", animation->name, animation->delay_in_ms, budget, avg,
+           max_cycles, budget ? (unsigned)((uint64_t)(max_cycles + max_i2c) * 100 / budget) : 0, dropped, frames,
+           frames ? (double)native_ns / frames / 1000.0 : 0.0, flagged ? "DROPS" : "ok");
+
+    return !flagged;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -b board      91tkl, splitbrain or kiibohd (default 91tkl)\n"
+            "  -a animation  run only this animation (default all)\n"
+            "  -n frames     frames per animation (default 100)\n"
+            "  -k frames     press a key every k frames, 0: no keys (default 10)\n"
+            "  -o prefix     write frames as <prefix><animation>_<frame>.ppm\n"
+            "  -c file       write per frame statistics as csv\n"
+            "  -S/-G/-U n    cycles per surface set, get and uploaded PWM byte\n"
+            "  -P/-E/-R n    cycles per particle update, emit and render\n"
+            "  -l            list animations\n",
+            name);
+}
+
+int main(int argc, char **argv)
+{
+    const char *board_name = "91tkl";
+    const char *animation_name = 0;
+    const char *prefix = 0;
+    const char *csv_name = 0;
+    uint32_t frames = 100;
+    uint16_t press_interval = 10;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:a:n:k:o:c:S:G:U:P:E:R:lh")) != -1) {
+        switch (opt) {
+        case 'b': board_name = optarg; break;
+        case 'a': animation_name = optarg; break;
+        case 'n': frames = strtoul(optarg, 0, 0); break;
+        case 'k': press_interval = strtoul(optarg, 0, 0); break;
+        case 'o': prefix = optarg; break;
+        case 'c': csv_name = optarg; break;
+        case 'S': cycles_per_set = strtoul(optarg, 0, 0); break;
+        case 'G': cycles_per_get = strtoul(optarg, 0, 0); break;
+        case 'U': cycles_per_upload_byte = strtoul(optarg, 0, 0); break;
+        case 'P': cycles_per_particle_update = strtoul(optarg, 0, 0); break;
+        case 'E': cycles_per_particle_emit = strtoul(optarg, 0, 0); break;
+        case 'R': cycles_per_particle_render = strtoul(optarg, 0, 0); break;
+        case 'l':
+            for (uint8_t i = 0; i < led_matrix_animation_count; i++)
+                printf("%s\n", led_matrix_animations[i]->name);
+            return 0;
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint8_t i = 0; i < sizeof(boards) / sizeof(boards[0]); i++) {
+        if (strcmp(boards[i].name, board_name) == 0)
+            board = &boards[i];
+    }
+
+    if (!board) {
+        fprintf(stderr, "unknown board: %s\n", board_name);
+        return 2;
+    }
+
+    FILE *csv = 0;
+    if (csv_name) {
+        csv = fopen(csv_name, "w");
+        if (!csv) {
+            perror(csv_name);
+            return 2;
+        }
+        fprintf(csv, "animation,frame,sets,gets,commits,particle_updates,particle_emits,particle_renders,cycles,i2c_cycles,dropped\n");
+    }
+
+    printf("board %s: %ux%u %s, %u I2C bytes per upload\n\n", board->name, board->rows, board->cols,
+           (board->flags & LED_SURFACE_RGB) ? "rgb" : "mono", board->i2c_bytes);
+    printf("%-16s %8s %9s %9s %9s %6s %13s %8s\n", "animation", "delay", "budget", "avg", "max", "load", "dropped",
+           "host us");
+
+    bool ok = true;
+    bool found = false;
+
+    for (uint8_t i = 0; i < led_matrix_animation_count; i++) {
+        if (animation_name && strcmp(animation_name, led_matrix_animations[i]->name) != 0)
+            continue;
+        found = true;
+        ok &= run(led_matrix_animations[i], frames, press_interval, prefix, csv);
+    }
+
+    if (csv)
+        fclose(csv);
+
+    if (!found) {
+        fprintf(stderr, "unknown animation: %s\n", animation_name);
+        return 2;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+/*
+ * Host benchmark of the shell command lookup in common/shell_dispatch.c.
+ *
+ * The table is the one of keyboard/anorak_91tkl with all optional commands. Every command is
+ * looked up with the linear scan of the shells before shell_dispatch.c, which copied each
+ * entry out of flash and compared its name, and with the binary search of shell_command_find().
+ *
+ * On the AVR the time goes into the flash reads: the scan copies 8 bytes per entry it passes,
+ * the search reads one 2 byte name pointer per probe and copies the entry it found. The host
+ * time is printed as well, it shows the number of name compares more than the AVR would.
+ *
+ *   make && ./shell_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static unsigned long compares;
+
+static int counted_strcmp(const char *a, const char *b)
+{
+    compares++;
+    return strcmp(a, b);
+}
+
+#define strcmp counted_strcmp
+#include "shell_dispatch.c"
+#undef strcmp
+
+// entry size and name pointer size on the AVR
+#define ENTRY_SIZE_AVR 8
+#define NAME_SIZE_AVR 2
+
+static bool cmd(uint8_t argc, char **argv) { return true; }
+
+static const shell_command_t command_list[] = {
+    SHELL_COMMAND("?", cmd, 0, "help"),
+    SHELL_COMMAND("animation", cmd, 0, "control"),
+    SHELL_COMMAND("bee", cmd, 0, "clear bl ee"),
+    SHELL_COMMAND("bl", cmd, 0, "bl"),
+    SHELL_COMMAND("boot", cmd, 0, "jump to bootloader"),
+    SHELL_COMMAND("debug", cmd, 0, "config"),
+    SHELL_COMMAND("ee", cmd, 0, "dump ee"),
+    SHELL_COMMAND("fee", cmd, 0, "clear ee"),
+    SHELL_COMMAND("hsv", cmd, 0, "set hsv"),
+    SHELL_COMMAND("info", cmd, 0, "tmk"),
+    SHELL_COMMAND("issi", cmd, 0, "control"),
+    SHELL_COMMAND("keymap", cmd, 0, "config"),
+    SHELL_COMMAND("layer", cmd, 0, "default"),
+    SHELL_COMMAND("map", cmd, 0, "control"),
+    SHELL_COMMAND("ram", cmd, 0, "free"),
+    SHELL_COMMAND("sector", cmd, 0, "control"),
+    SHELL_COMMAND("see", cmd, 0, "clear leds eeprom"),
+    SHELL_COMMAND("sleepled", cmd, 0, "test sleepled"),
+    SHELL_COMMAND("stabri", cmd, 0, "bstatus leds"),
+    SHELL_COMMAND("thsv", cmd, 0, "set hsv"),
+    SHELL_COMMAND("ti", cmd, 0, "test issi"),
+    SHELL_COMMAND("tled", cmd, 0, "enable/disable led"),
+    SHELL_COMMAND("tpwm", cmd, 0, "set pwm"),
+    SHELL_COMMAND("trgb", cmd, 0, "set rgb"),
+};
+
+static shell_table_t commands = SHELL_TABLE(command_list);
+
+// the order of the table before it was sorted, the scan stops at the 0 entry
+static const char *const linear_order[] = {
+    "?", "info", "ram", "ee", "fee", "bee", "bl", "sector", "animation", "map", "issi", "debug",
+    "keymap", "layer", "boot", "stabri", "see", "sleepled", "ti", "tpwm", "trgb", "thsv", "tled", "hsv",
+};
+
+#define COMMAND_COUNT (sizeof(linear_order) / sizeof(linear_order[0]))
+
+static shell_command_t linear_list[COMMAND_COUNT + 1];
+
+static bool find_linear(const char *name, shell_command_t *command)
+{
+    uint8_t pos = 0;
+
+    memcpy(command, &linear_list[pos++], sizeof(shell_command_t));
+
+    while (command->fn)
+    {
+        if (counted_strcmp(command->name, name) == 0)
+            return true;
+
+        memcpy(command, &linear_list[pos++], sizeof(shell_command_t));
+    }
+
+    return false;
+}
+
+static double seconds(struct timespec const *start)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void lookup(const char *name, unsigned long rounds)
+{
+    shell_command_t command;
+    struct timespec start;
+    unsigned long linear_compares, sorted_compares;
+    double linear_ns, sorted_ns;
+    volatile bool found = false;
+
+    compares = 0;
+    found = find_linear(name, &command);
+    linear_compares = compares;
+
+    compares = 0;
+    found = shell_command_find(&commands, name, &command);
+    sorted_compares = compares;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned long i = 0; i < rounds; i++)
+        found = find_linear(name, &command);
+    linear_ns = seconds(&start) * 1e9 / rounds;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned long i = 0; i < rounds; i++)
+        found = shell_command_find(&commands, name, &command);
+    sorted_ns = seconds(&start) * 1e9 / rounds;
+
+    // a miss copies the 0 entry at the end of the old table
+    unsigned long linear_flash = (linear_compares + 1) * ENTRY_SIZE_AVR;
+    if (found)
+        linear_flash -= ENTRY_SIZE_AVR;
+    unsigned long sorted_flash = sorted_compares * NAME_SIZE_AVR + (found ? ENTRY_SIZE_AVR : 0);
+
+    printf("%-10s %5lu %5lu %9lu %7lu %9.1f %7.1f\n", name, linear_compares, sorted_compares,
+           linear_flash, sorted_flash, linear_ns, sorted_ns);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long rounds = 1000000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n':
+                rounds = strtoul(optarg, 0, 10);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n rounds]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++)
+    {
+        shell_command_t command;
+        if (!shell_command_find(&commands, linear_order[i], &command))
+        {
+            printf("%s not found\n", linear_order[i]);
+            return 1;
+        }
+        linear_list[i] = command;
+    }
+
+    if (commands.order != shellOrderSorted)
+    {
+        printf("table out of order\n");
+        return 1;
+    }
+
+    printf("%-10s %11s %17s %17s\n", "", "compares", "AVR flash bytes", "host ns");
+    printf("%-10s %5s %5s %9s %7s %9s %7s\n", "command", "scan", "bsrch", "scan", "bsrch", "scan", "bsrch");
+
+    for (uint8_t i = 0; i < COMMAND_COUNT; i++)
+        lookup(linear_order[i], rounds);
+    lookup("nope", rounds);
+
+    return 0;
+}
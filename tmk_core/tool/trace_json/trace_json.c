@@ -0,0 +1,198 @@
+/*
+ * Converts a timeline trace dump of common/avr/trace.c to Chrome trace JSON.
+ *
+ * The dump is the output of '.trace' on the virtual serial shells or of the 't' console
+ * command, lines that are not part of it are skipped:
+ *
+ *   .trace <records> <overwritten> <ns per tick> <ns per record>
+ *   .t <stamp high> <stamp low> <B|E|i> <event> <argument>
+ *
+ * The JSON opens in chrome://tracing or ui.perfetto.dev. Every dump in the input becomes a
+ * process of its own. A summary with the recording overhead goes to stderr.
+ *
+ *   make
+ *   ./trace_json dump.txt > trace.json
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LINE 256
+#define MAX_DEPTH 16
+
+typedef struct
+{
+    unsigned pid;
+    unsigned expected;
+    unsigned records;
+    unsigned overwritten;
+    unsigned tick_ns;
+    unsigned record_ns;
+    uint32_t first;
+    uint32_t last;
+    unsigned depth;
+    char open[MAX_DEPTH][32];
+} dump_t;
+
+static bool first_event = true;
+
+static double stamp_us(dump_t const *dump, uint32_t stamp)
+{
+    return (double)(uint32_t)(stamp - dump->first) * dump->tick_ns / 1000.0;
+}
+
+static void print_args(dump_t const *dump, char const *name, unsigned arg)
+{
+    if (strcmp(name, "loop") == 0)
+        printf("{\"idle_passes\":%u}", arg);
+    else if (strcmp(name, "action_exec") == 0)
+        printf("{\"row\":%u,\"col\":%u,\"pressed\":%u}", (arg >> 8) & 0x7F, arg & 0xFF, arg >> 15);
+    else if (strcmp(name, "send_keyboard") == 0)
+        printf("{\"mods\":\"0x%02X\"}", arg);
+    else if (strcmp(name, "animate") == 0 && (arg & 0x8000))
+        printf("{\"slice_row\":%u}", arg & 0x7FFF);
+    else if (strcmp(name, "animate") == 0)
+        printf("{\"animation\":%u}", arg);
+    else if (strcmp(name, "twi_wait") == 0)
+        printf("{\"address\":\"0x%02X\"}", arg);
+    else if (strcmp(name, "split_send") == 0 || strcmp(name, "split_receive") == 0)
+        printf("{\"command\":\"0x%02X\",\"length\":%u}", arg >> 8, arg & 0xFF);
+    else if (strcmp(name, "freeze") == 0)
+        printf("{\"pass_us\":%.0f}", (double)arg * dump->tick_ns / 1000.0);
+    else
+        printf("{\"arg\":%u}", arg);
+}
+
+static void print_event(dump_t const *dump, char const *name, char phase, uint32_t stamp)
+{
+    printf("%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%u,\"tid\":1", first_event ? "" : ",", name,
+           phase, stamp_us(dump, stamp), dump->pid);
+    first_event = false;
+}
+
+static void add_record(dump_t *dump, uint32_t stamp, char phase, char const *name, unsigned arg)
+{
+    if (dump->records == 0)
+        dump->first = stamp;
+
+    dump->records++;
+    dump->last = stamp;
+
+    if (phase == 'E')
+    {
+        // the end of a span that began before the ring
+        if (dump->depth == 0 || strcmp(dump->open[dump->depth - 1], name) != 0)
+            return;
+        dump->depth--;
+        print_event(dump, name, 'E', stamp);
+        printf("}");
+        return;
+    }
+
+    if (phase == 'B')
+    {
+        if (dump->depth == MAX_DEPTH)
+            return;
+        snprintf(dump->open[dump->depth++], sizeof(dump->open[0]), "%s", name);
+    }
+
+    print_event(dump, name, phase == 'B' ? 'B' : 'i', stamp);
+    if (phase != 'B')
+        printf(",\"s\":\"t\"");
+    printf(",\"args\":");
+    print_args(dump, name, arg);
+    printf("}");
+}
+
+static void finish_dump(dump_t *dump)
+{
+    if (dump->pid == 0)
+        return;
+
+    // spans still open when the trace was frozen end with it
+    while (dump->depth > 0)
+    {
+        dump->depth--;
+        print_event(dump, dump->open[dump->depth], 'E', dump->last);
+        printf("}");
+    }
+
+    double span_us = stamp_us(dump, dump->last);
+    double cost_us = dump->records * dump->record_ns / 1000.0;
+
+    fprintf(stderr, "dump %u: %u of %u records, %u overwritten, %.0fus\n", dump->pid, dump->records,
+            dump->expected, dump->overwritten, span_us);
+    fprintf(stderr, "dump %u: %uns per record, %.1fus recording", dump->pid, dump->record_ns, cost_us);
+    if (span_us > 0)
+        fprintf(stderr, " (%.2f%%)", 100.0 * cost_us / span_us);
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char **argv)
+{
+    FILE *in = stdin;
+    char line[MAX_LINE];
+    dump_t dump = {0};
+    unsigned pid = 0;
+
+    if (argc > 2 || (argc == 2 && strcmp(argv[1], "-h") == 0))
+    {
+        fprintf(stderr, "usage: %s [dump]\n", argv[0]);
+        return 1;
+    }
+
+    if (argc == 2 && !(in = fopen(argv[1], "r")))
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+
+    while (fgets(line, sizeof(line), in))
+    {
+        unsigned a, b, c, d;
+        unsigned high, low, arg;
+        char phase;
+        char name[32];
+        char *start;
+
+        // the dump starts anywhere in the line after a prompt or a console prefix
+        if ((start = strstr(line, ".trace ")) && sscanf(start, ".trace %u %u %u %u", &a, &b, &c, &d) == 4)
+        {
+            finish_dump(&dump);
+            memset(&dump, 0, sizeof(dump));
+            dump.pid = ++pid;
+            dump.expected = a;
+            dump.overwritten = b;
+            dump.tick_ns = c;
+            dump.record_ns = d;
+
+            printf("%s\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"dump %u\"}}",
+                   first_event ? "" : ",", pid, pid);
+            first_event = false;
+        }
+        else if (dump.pid && (start = strstr(line, ".t ")) &&
+                 sscanf(start, ".t %u %u %c %31s %u", &high, &low, &phase, name, &arg) == 5)
+        {
+            add_record(&dump, (uint32_t)high << 16 | (low & 0xFFFF), phase, name, arg);
+        }
+    }
+
+    finish_dump(&dump);
+    printf("\n]}\n");
+
+    if (in != stdin)
+        fclose(in);
+
+    if (pid == 0)
+    {
+        fprintf(stderr, "no .trace dump found\n");
+        return 1;
+    }
+
+    return 0;
+}
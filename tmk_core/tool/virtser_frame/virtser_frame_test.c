@@ -0,0 +1,309 @@
+/*
+ * Test of the binary frames of the 91tkl virtual serial port against the '.map set' text command.
+ *
+ * The frame code is the firmware's (keyboard/anorak_91tkl/virt_ser_frame.c and crc8.c):
+ *
+ *  - every length round trips through virtser_frame_encode() and virtser_frame_decode()
+ *  - every single bit error of a frame is caught, by the crc or by the length check
+ *  - the decoder finds the next frame after garbage, a bad length and a cut frame
+ *
+ * Then a full map goes to the keyboard both ways: as map_rgb frames into the frame decoder and
+ * as '.map set' rows into the JSON reader of the text shell (virt_ser_json.c). Both have to
+ * set the same colors. Bytes on the wire (requests and replies), round trips and host decode
+ * time per upload are compared. The tool exits with 1 on a failure.
+ *
+ *   make && ./virtser_frame_test -n 10000
+ */
+
+#include "virt_ser_frame.h"
+#include "virt_ser_json.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ROWS 6
+#define COLS 17
+#define KEYS (ROWS * COLS)
+// map, first key and as many keys as fit into one frame, as virtser_client_upload_map() sends them
+#define KEYS_PER_FRAME ((VIRTSER_FRAME_LENGTH_MAX - 1 - 2) / 3)
+// ".map set <row>\n>OK\n", the answer of the text shell to one row
+#define TEXT_REPLY_SIZE 15
+#define LINE_SIZE 512
+
+static uint8_t colors[KEYS][3];
+static uint8_t received[KEYS][3];
+static unsigned failures;
+
+static void check(int ok, char const *what) {
+    if (ok) return;
+    if (failures++ < 10) printf("  FAILED: %s\n", what);
+}
+
+/*
+ * frames
+ */
+
+static enum virtser_frame_result decode_all(virtser_frame_decoder *decoder, uint8_t const *data, size_t size) {
+    enum virtser_frame_result result = virtser_frame_incomplete;
+
+    for (size_t i = 0; i < size; ++i) {
+        result = virtser_frame_decode(decoder, data[i]);
+        if (result != virtser_frame_incomplete && i + 1 < size) return virtser_frame_too_long;
+    }
+
+    return result;
+}
+
+static void test_round_trip(void) {
+    uint8_t frame[VIRTSER_FRAME_SIZE_MAX];
+    uint8_t payload[VIRTSER_FRAME_LENGTH_MAX];
+    uint8_t buffer[VIRTSER_FRAME_LENGTH_MAX];
+    virtser_frame_decoder decoder;
+
+    virtser_frame_decoder_init(&decoder, buffer);
+
+    for (int length = 0; length < VIRTSER_FRAME_LENGTH_MAX; ++length) {
+        for (int i = 0; i < length; ++i) payload[i] = rand();
+
+        uint8_t size = virtser_frame_encode(frame, virtser_frame_ping, payload, length);
+
+        check(size == length + VIRTSER_FRAME_OVERHEAD + 1, "encoded size");
+        check(decode_all(&decoder, frame, size) == virtser_frame_complete, "round trip");
+        check(buffer[0] == virtser_frame_ping && virtser_frame_payload_length(&decoder) == length, "opcode and length");
+        check(memcmp(buffer + 1, payload, length) == 0, "payload");
+        check(!virtser_frame_decoding(&decoder), "idle after the crc");
+    }
+
+    printf("round trip of all lengths %s\n", failures ? "FAILED" : "ok");
+}
+
+static void test_bit_errors(void) {
+    uint8_t frame[VIRTSER_FRAME_SIZE_MAX];
+    uint8_t payload[VIRTSER_FRAME_LENGTH_MAX];
+    uint8_t buffer[VIRTSER_FRAME_LENGTH_MAX];
+    virtser_frame_decoder decoder;
+    unsigned before = failures;
+    unsigned long errors = 0;
+
+    virtser_frame_decoder_init(&decoder, buffer);
+
+    static int const lengths[] = {0, 1, 16, 61, 248};
+
+    for (unsigned n = 0; n < sizeof(lengths) / sizeof(lengths[0]); ++n) {
+        for (int i = 0; i < lengths[n]; ++i) payload[i] = rand();
+
+        uint8_t size = virtser_frame_encode(frame, virtser_frame_map_rgb, payload, lengths[n]);
+
+        // the sync byte is left alone, without it there is no frame to check
+        for (int byte = 1; byte < size; ++byte) {
+            for (int bit = 0; bit < 8; ++bit) {
+                frame[byte] ^= 1 << bit;
+
+                virtser_frame_decoder_reset(&decoder);
+                enum virtser_frame_result result = virtser_frame_incomplete;
+                for (int i = 0; i < size && result == virtser_frame_incomplete; ++i) result = virtser_frame_decode(&decoder, frame[i]);
+
+                // a longer length waits for more bytes, the firmware drops it after its timeout
+                check(result != virtser_frame_complete, "bit error accepted");
+                errors++;
+
+                frame[byte] ^= 1 << bit;
+            }
+        }
+    }
+
+    printf("%lu single bit errors caught %s\n", errors, failures != before ? "FAILED" : "ok");
+}
+
+static void test_resync(void) {
+    uint8_t stream[4 * VIRTSER_FRAME_SIZE_MAX];
+    uint8_t buffer[VIRTSER_FRAME_LENGTH_MAX];
+    uint8_t payload[] = {1, 2, 3};
+    virtser_frame_decoder decoder;
+    unsigned before = failures;
+    size_t size = 0;
+    int complete = 0;
+    int rejected = 0;
+
+    virtser_frame_decoder_init(&decoder, buffer);
+
+    // text and a sync byte with a bad length before the frame
+    memcpy(stream, "!ram\n", 5);
+    size += 5;
+    stream[size++] = VIRTSER_FRAME_SYNC;
+    stream[size++] = VIRTSER_FRAME_LENGTH_MAX + 1;
+    size += virtser_frame_encode(stream + size, virtser_frame_ping, payload, sizeof(payload));
+
+    for (size_t i = 0; i < size; ++i) {
+        switch (virtser_frame_decode(&decoder, stream[i])) {
+            case virtser_frame_complete:
+                complete++;
+                break;
+            case virtser_frame_too_long:
+            case virtser_frame_corrupt:
+                rejected++;
+                break;
+            case virtser_frame_incomplete:
+                break;
+        }
+    }
+
+    check(complete == 1 && rejected == 1, "frame after garbage and a bad length");
+
+    // a cut frame is dropped by the stall timeout of the firmware, the next one decodes
+    size = virtser_frame_encode(stream, virtser_frame_ping, payload, sizeof(payload));
+    decode_all(&decoder, stream, size - 2);
+    check(virtser_frame_decoding(&decoder), "cut frame pending");
+    virtser_frame_decoder_reset(&decoder);
+    check(decode_all(&decoder, stream, size) == virtser_frame_complete, "frame after a cut frame");
+
+    printf("resync after garbage, bad length and cut frame %s\n", failures != before ? "FAILED" : "ok");
+}
+
+/*
+ * a full map both ways
+ */
+
+static void on_map(uint8_t map) {}
+
+static bool on_key(uint8_t row, uint8_t col, RGB color) {
+    if (row >= ROWS || col >= COLS) return false;
+    memcpy(received[row * COLS + col], color.rgb, 3);
+    return true;
+}
+
+static virtser_json_map reader = {.map = on_map, .key = on_key};
+
+static char text_lines[ROWS][LINE_SIZE];
+static size_t text_sizes[ROWS];
+
+static uint8_t frames[3][VIRTSER_FRAME_SIZE_MAX];
+static uint8_t frame_sizes[3];
+static int frame_count;
+
+static void encode_map(void) {
+    uint8_t payload[VIRTSER_FRAME_LENGTH_MAX];
+
+    frame_count = 0;
+    for (int key = 0; key < KEYS; key += KEYS_PER_FRAME) {
+        int count = KEYS - key;
+        if (count > KEYS_PER_FRAME) count = KEYS_PER_FRAME;
+
+        payload[0] = 0;
+        payload[1] = key;
+        memcpy(payload + 2, colors[key], count * 3);
+        frame_sizes[frame_count] = virtser_frame_encode(frames[frame_count], virtser_frame_map_rgb, payload, 2 + count * 3);
+        frame_count++;
+    }
+    frame_sizes[frame_count] = virtser_frame_encode(frames[frame_count], virtser_frame_map_update, 0, 0);
+    frame_count++;
+
+    for (int row = 0; row < ROWS; ++row) {
+        int n = sprintf(text_lines[row], "{\"map\":0,\"row\":%d,\"cols\":[", row);
+
+        for (int col = 0; col < COLS; ++col) {
+            uint8_t const *c = colors[row * COLS + col];
+            n += sprintf(text_lines[row] + n, "%s[%d,\"%02X%02X%02X\"]", col ? "," : "", col, c[0], c[1], c[2]);
+        }
+
+        n += sprintf(text_lines[row] + n, "]}");
+        text_sizes[row] = n;
+    }
+}
+
+// as frame_command() in virt_ser_rpc.c stores map_rgb
+static bool receive_frames(virtser_frame_decoder *decoder, uint8_t *buffer) {
+    for (int f = 0; f < frame_count; ++f) {
+        if (decode_all(decoder, frames[f], frame_sizes[f]) != virtser_frame_complete) return false;
+
+        uint8_t length = virtser_frame_payload_length(decoder);
+        if (buffer[0] == virtser_frame_map_rgb) memcpy(received[buffer[2]], buffer + 3, length - 2);
+    }
+
+    return true;
+}
+
+// the line after "!map set " goes to the reader byte by byte, as virtser_recv() hands it over
+static bool receive_text(void) {
+    for (int row = 0; row < ROWS; ++row) {
+        virtser_json_map_init(&reader);
+        for (size_t i = 0; i < text_sizes[row]; ++i) virtser_json_map_push(&reader, text_lines[row][i]);
+        if (!virtser_json_map_complete(&reader)) return false;
+    }
+
+    return true;
+}
+
+static double seconds(struct timespec const *start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void test_map(int rounds) {
+    uint8_t buffer[VIRTSER_FRAME_LENGTH_MAX];
+    virtser_frame_decoder decoder;
+    struct timespec start;
+    unsigned before = failures;
+
+    virtser_frame_decoder_init(&decoder, buffer);
+
+    for (int key = 0; key < KEYS; ++key)
+        for (int c = 0; c < 3; ++c) colors[key][c] = rand();
+    encode_map();
+
+    memset(received, 0, sizeof(received));
+    check(receive_frames(&decoder, buffer), "map frames decoded");
+    check(memcmp(received, colors, sizeof(colors)) == 0, "map from frames");
+
+    memset(received, 0, sizeof(received));
+    check(receive_text(), "map rows read");
+    check(memcmp(received, colors, sizeof(colors)) == 0, "map from text");
+
+    unsigned long binary_bytes = 0;
+    for (int f = 0; f < frame_count; ++f) binary_bytes += frame_sizes[f] + VIRTSER_FRAME_OVERHEAD + 2;
+
+    unsigned long text_bytes = 0;
+    for (int row = 0; row < ROWS; ++row) text_bytes += strlen("!map set \n") + text_sizes[row] + TEXT_REPLY_SIZE;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < rounds; ++i) receive_frames(&decoder, buffer);
+    double binary_us = seconds(&start) * 1e6 / rounds;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < rounds; ++i) receive_text();
+    double text_us = seconds(&start) * 1e6 / rounds;
+
+    printf("same map from frames and from '.map set' %s\n\n", failures != before ? "FAILED" : "ok");
+
+    printf("full map, %d keys      bytes  round trips  host decode us\n", KEYS);
+    printf("  binary frames    %8lu %12d %15.2f\n", binary_bytes, frame_count, binary_us);
+    printf("  text '.map set'  %8lu %12d %15.2f\n", text_bytes, ROWS, text_us);
+}
+
+int main(int argc, char **argv) {
+    int rounds = 10000;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                rounds = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n rounds]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    srand(91);
+
+    test_round_trip();
+    test_bit_errors();
+    test_resync();
+    test_map(rounds > 0 ? rounds : 1);
+
+    return failures ? 1 : 0;
+}